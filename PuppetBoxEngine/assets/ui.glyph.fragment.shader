@@ -1,16 +1,16 @@
 #version 330 core
-in GS_OUT
+in VS_OUT
 {
     vec2 uvCoord;
-} gs_out;
+    vec3 colour;
+} vs_out;
 
 out vec4 color;
 
 uniform sampler2D text;
-uniform vec3 textColour;
 
 void main()
 {
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, gs_out.uvCoord).r);
-    color = vec4(textColour, 1.0) * sampled;
+    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, vs_out.uvCoord).r);
+    color = vec4(vs_out.colour, 1.0) * sampled;
 }
\ No newline at end of file
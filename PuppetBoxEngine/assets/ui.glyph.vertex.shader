@@ -2,10 +2,18 @@
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 uv;
 
+/*
+    Per glyph instance data, see GlyphInstance
+*/
+layout (location = 2) in vec3 instancePosition;
+layout (location = 3) in vec2 instanceDimensions;
+layout (location = 4) in vec4 instanceUvRect;
+layout (location = 5) in vec3 instanceColour;
+
 out VS_OUT
 {
     vec2 uvCoord;
-    int instanceIndex;
+    vec3 colour;
 } vs_out;
 
 layout(std140) uniform Transforms
@@ -15,31 +23,12 @@ layout(std140) uniform Transforms
     mat4 view;
 };
 
-/*
-    Instance data is a flat float array that follows the given schema:
-
-    struct GlyphData
-    {
-        vec3 position;
-        vec2 dimension;
-        vec2 uvCoord;
-        vec2 uvDimensions;
-    };
-*/
-
-uniform float instanceData[225];
-
 void main()
 {
-    int instanceIndex = gl_InstanceID * 9;
-    vec3 adjustedPosition;
-
-    /* This remaps all the vertex positions to what they should actually be based on the instance data */
-    adjustedPosition.x = instanceData[instanceIndex] + (instanceData[instanceIndex + 3] * position.x);
-    adjustedPosition.y = instanceData[instanceIndex + 1] + (instanceData[instanceIndex + 4] * position.y);
-    adjustedPosition.z = instanceData[instanceIndex + 2];
+    /* This remaps the quad vertices and UVs to the glyph's placement and its rect within the atlas */
+    vec3 adjustedPosition = vec3(instancePosition.xy + (instanceDimensions * position.xy), instancePosition.z);
 
     gl_Position = uiProjection * vec4(adjustedPosition, 1.0);
-    vs_out.instanceIndex = instanceIndex;
-    vs_out.uvCoord = uv;
+    vs_out.uvCoord = instanceUvRect.xy + (uv * instanceUvRect.zw);
+    vs_out.colour = instanceColour;
 }
\ No newline at end of file
@@ -2,72 +2,37 @@
 
 #include <cmath>
 #include <functional>
-
+#include <limits>
 #include <utility>
 
+#include "BinaryFormat.h"
 #include "GfxMath.h"
+#include "PoseMath.h"
 
 namespace PB
 {
     namespace
     {
         static std::unordered_map<std::string, std::unordered_map<std::uint32_t, std::unordered_map<std::uint32_t, TransformKeyframe>>> CACHED_KEYFRAMES{};
-        static std::unordered_map<std::string, std::unordered_map<std::uint32_t, std::unordered_map<std::uint32_t, mat4>>> CACHED_TRANSFORMATIONS{};
-
-        inline void cacheTransformationMatrix(
-                const std::string& animationPath,
-                const std::uint32_t currentFrame,
-                std::uint32_t boneId,
-                mat4 transformationMatrix)
-        {
-            if (CACHED_TRANSFORMATIONS.find(animationPath) == CACHED_TRANSFORMATIONS.end())
-            {
-                CACHED_TRANSFORMATIONS.insert(
-                        std::pair<std::string, std::unordered_map<std::uint32_t, std::unordered_map<std::uint32_t, mat4>>>{
-                                animationPath, {}}
-                );
-            }
+        static const PoseOverrides NO_OVERRIDES{};
 
-            auto& frameIndexMap = CACHED_TRANSFORMATIONS.at(animationPath);
+        /**
+         * \brief Default number of sampling steps per animation frame, higher values are smoother but
+         * share fewer palettes.
+         */
+        const std::uint32_t DEFAULT_STEPS_PER_FRAME = 4;
 
-            if (frameIndexMap.find(currentFrame) == frameIndexMap.end())
-            {
-                frameIndexMap.insert(
-                        std::pair<std::uint32_t, std::unordered_map<std::uint32_t, mat4>>{currentFrame, {}}
-                );
-            }
-
-            auto& boneMap = frameIndexMap.at(currentFrame);
+        const std::uint32_t NO_PALETTE = std::numeric_limits<std::uint32_t>::max();
 
-            boneMap.insert(
-                    std::pair<std::uint32_t, mat4>{boneId, transformationMatrix}
-            );
-        }
-
-        inline Result<mat4*> findCachedTransformationMatrix(
-                const std::string& animationPath,
-                const std::uint32_t currentFrame,
-                std::uint32_t boneId)
-        {
-            auto animationItr = CACHED_TRANSFORMATIONS.find(animationPath);
-
-            if (animationItr != CACHED_TRANSFORMATIONS.end())
-            {
-                auto frameItr = animationItr->second.find(currentFrame);
-
-                if (frameItr != animationItr->second.end())
-                {
-                    auto boneItr = frameItr->second.find(boneId);
-
-                    if (boneItr != frameItr->second.end())
-                    {
-                        return {&boneItr->second, true};
-                    }
-                }
-            }
+        /**
+         * \brief Minimum number of frames per asynchronous preload job, smaller jobs cost more to schedule
+         * than they save.
+         */
+        const std::uint32_t MIN_FRAMES_PER_PRELOAD_JOB = 4;
 
-            return {nullptr, false};
-        }
+        const std::uint8_t FRAME_UNBAKED = 0;
+        const std::uint8_t FRAME_BAKING = 1;
+        const std::uint8_t FRAME_BAKED = 2;
 
         inline Result<TransformKeyframe*> findCachedTransformKeyframe(
                 const std::string& animationPath,
@@ -97,7 +62,7 @@ namespace PB
         inline Result<RawKeyframe> findExplicitKeyframe(
                 const std::string& boneName,
                 std::uint8_t frameIndexToCheck,
-                std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> keyframes
+                const std::unordered_map<std::uint8_t, std::vector<RawKeyframe>>& keyframes
         )
         {
             Result<RawKeyframe> result{};
@@ -126,7 +91,7 @@ namespace PB
         inline Result<float> findValueAtExplicitKeyframe(
                 const std::string& boneName,
                 std::uint8_t frameIndexToCheck,
-                std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> keyframes,
+                const std::unordered_map<std::uint8_t, std::vector<RawKeyframe>>& keyframes,
                 std::function<Vec4&(RawKeyframe&)> pullVec4,
                 std::function<Result<float>(Vec4&)> pullResult
         )
@@ -147,8 +112,8 @@ namespace PB
                 std::int8_t direction,
                 const std::string& boneName,
                 std::uint8_t currentFrame,
-                std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> keyframes,
-                std::vector<std::uint8_t> keyframeIndexes,
+                const std::unordered_map<std::uint8_t, std::vector<RawKeyframe>>& keyframes,
+                const std::vector<std::uint8_t>& keyframeIndexes,
                 std::function<Vec4&(RawKeyframe&)> pullVec4,
                 std::function<Result<float>(Vec4&)> pullResult
         )
@@ -238,8 +203,8 @@ namespace PB
         inline Result<float> getValueForKeyframe(
                 const std::string& boneName,
                 std::uint8_t currentFrame,
-                std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> keyframes,
-                std::vector<std::uint8_t> keyframeIndexes,
+                const std::unordered_map<std::uint8_t, std::vector<RawKeyframe>>& keyframes,
+                const std::vector<std::uint8_t>& keyframeIndexes,
                 std::function<Vec4&(RawKeyframe&)> pullVec4,
                 std::function<Result<float>(Vec4&)> pullResult,
                 std::function<float(RawKeyframe, RawKeyframe)> tweenTransform
@@ -310,13 +275,7 @@ namespace PB
     {
         LOGGER_INFO("Preloading animation '" + getPath() + "'...");
 
-        for (std::uint32_t i = 0; i < frameCount_; ++i)
-        {
-            for (auto& entry: boneMap.getAllBones())
-            {
-                getKeyFrameForBone(i, entry.first, entry.second.name);
-            }
-        }
+        bakeFrames(PoseMath::BuildSkeletonLayout(boneMap), 0, frameCount_);
 
         LOGGER_INFO("Animation '" + getPath() + "' has been loaded.");
 
@@ -328,9 +287,6 @@ namespace PB
             std::uint32_t boneId,
             const std::string& boneName) const
     {
-        const std::uint32_t MAX_VECTORS = 2;
-        const std::uint32_t MAX_AXES = 3;
-
         Result<TransformKeyframe*> cachedFrame = findCachedTransformKeyframe(getPath(), currentFrame, boneId);
 
         if (cachedFrame.hasResult)
@@ -339,94 +295,14 @@ namespace PB
         }
         else
         {
-            // Otherwise, generate a keyframe for each property and store it in the cache
-            const std::uint8_t totalFrameCount = getFrameCount();
-
-            const std::function<Vec4&(RawKeyframe&)> getVec4[MAX_VECTORS] = {
-                    [](RawKeyframe& k) -> Vec4& { return k.scale; },
-                    [](RawKeyframe& k) -> Vec4& { return k.rotation; }
-            };
-
-            const std::function<void(Vec4&, Result<float>)> setResult[MAX_AXES] = {
-                    [](Vec4& v, Result<float> r) -> void { v.x = r; },
-                    [](Vec4& v, Result<float> r) -> void { v.y = r; },
-                    [](Vec4& v, Result<float> r) -> void { v.z = r; }
-            };
-
-            const std::function<Result<float>(Vec4&)> getResult[MAX_AXES] = {
-                    [](Vec4& v) -> Result<float> { return v.x; },
-                    [](Vec4& v) -> Result<float> { return v.y; },
-                    [](Vec4& v) -> Result<float> { return v.z; }
+            // Otherwise, generate a keyframe and store it in the cache
+            TransformKeyframe transformKeyframe = {
+                    currentFrame,
+                    boneName,
+                    boneId,
+                    evaluateTransform(currentFrame, boneName)
             };
 
-            const std::function<float(float, float, float)> transformAlgo[MAX_VECTORS] = {
-                    [](float prev, float next, float blend) -> float { return prev + ((next - prev) * blend); },
-                    [](float prev, float next, float blend) -> float {
-                        float coef = next > prev ? -1 : 1;
-                        float offset = abs(next - prev) > PI ? TWO_PI : 0;
-                        float delta = ((next - prev) + (offset * coef)) * blend;
-                        return fmod(prev + delta + TWO_PI, TWO_PI);
-                    }
-            };
-
-            std::function<float(RawKeyframe, RawKeyframe)> tweenTransform;
-
-            RawKeyframe currentKey{};
-
-            // For each vector
-            for (std::uint8_t v4 = 0; v4 < MAX_VECTORS; ++v4)
-            {
-                // For each axis
-                for (std::uint8_t r = 0; r < MAX_AXES; ++r)
-                {
-                    tweenTransform = [totalFrameCount, currentFrame, getResult, transformAlgo, getVec4, v4, r](
-                            RawKeyframe prev, RawKeyframe next) -> float {
-                        const uint8_t prevToEnd = totalFrameCount - prev.frameIndex;
-                        const uint8_t prevToNext =
-                                ((next.frameIndex - prev.frameIndex) + totalFrameCount) % totalFrameCount;
-                        const uint8_t prevToCurr =
-                                currentFrame < prev.frameIndex ?
-                                prevToEnd + currentFrame :
-                                currentFrame - prev.frameIndex;
-                        const float blendValue = prevToCurr / (float) prevToNext;
-
-                        float prevValue = getResult[r](getVec4[v4](prev)).result;
-                        float nextValue = getResult[r](getVec4[v4](next)).result;
-
-                        return transformAlgo[v4](prevValue, nextValue, blendValue);
-                    };
-
-                    Result<float> result = getValueForKeyframe(
-                            boneName,
-                            currentFrame,
-                            keyframes_,
-                            keyframeIndexes_,
-                            getVec4[v4],
-                            getResult[r],
-                            tweenTransform
-                    );
-
-                    setResult[r](getVec4[v4](currentKey), result);
-                }
-            }
-
-            vec3 position{};
-
-            // TODO: Scaling comes later, this is a bit messy
-            vec3 scale = {
-                    currentKey.scale.x.orElse(1),
-                    currentKey.scale.y.orElse(1),
-                    currentKey.scale.z.orElse(1)
-            };
-
-            vec3 rotation = {
-                    currentKey.rotation.x.orElse(0),
-                    currentKey.rotation.y.orElse(0),
-                    currentKey.rotation.z.orElse(0)
-            };
-
-            TransformKeyframe transformKeyframe = {currentFrame, boneName, boneId, {position, rotation, scale}};
-
             // If this animation has not been cached at all yet, add it
             if (CACHED_KEYFRAMES.find(getPath()) == CACHED_KEYFRAMES.end())
             {
@@ -459,117 +335,389 @@ namespace PB
         }
     }
 
-    std::string Animation::getPath() const
+    Transform Animation::evaluateTransform(std::uint8_t currentFrame, const std::string& boneName) const
     {
-        return animationPath_;
+        const std::uint32_t MAX_VECTORS = 2;
+        const std::uint32_t MAX_AXES = 3;
+
+        const std::uint8_t totalFrameCount = getFrameCount();
+
+        const std::function<Vec4&(RawKeyframe&)> getVec4[MAX_VECTORS] = {
+                [](RawKeyframe& k) -> Vec4& { return k.scale; },
+                [](RawKeyframe& k) -> Vec4& { return k.rotation; }
+        };
+
+        const std::function<void(Vec4&, Result<float>)> setResult[MAX_AXES] = {
+                [](Vec4& v, Result<float> r) -> void { v.x = r; },
+                [](Vec4& v, Result<float> r) -> void { v.y = r; },
+                [](Vec4& v, Result<float> r) -> void { v.z = r; }
+        };
+
+        const std::function<Result<float>(Vec4&)> getResult[MAX_AXES] = {
+                [](Vec4& v) -> Result<float> { return v.x; },
+                [](Vec4& v) -> Result<float> { return v.y; },
+                [](Vec4& v) -> Result<float> { return v.z; }
+        };
+
+        const std::function<float(float, float, float)> transformAlgo[MAX_VECTORS] = {
+                [](float prev, float next, float blend) -> float { return prev + ((next - prev) * blend); },
+                [](float prev, float next, float blend) -> float {
+                    float coef = next > prev ? -1 : 1;
+                    float offset = abs(next - prev) > PI ? TWO_PI : 0;
+                    float delta = ((next - prev) + (offset * coef)) * blend;
+                    return fmod(prev + delta + TWO_PI, TWO_PI);
+                }
+        };
+
+        std::function<float(RawKeyframe, RawKeyframe)> tweenTransform;
+
+        RawKeyframe currentKey{};
+
+        // For each vector
+        for (std::uint8_t v4 = 0; v4 < MAX_VECTORS; ++v4)
+        {
+            // For each axis
+            for (std::uint8_t r = 0; r < MAX_AXES; ++r)
+            {
+                tweenTransform = [totalFrameCount, currentFrame, getResult, transformAlgo, getVec4, v4, r](
+                        RawKeyframe prev, RawKeyframe next) -> float {
+                    const uint8_t prevToEnd = totalFrameCount - prev.frameIndex;
+                    const uint8_t prevToNext =
+                            ((next.frameIndex - prev.frameIndex) + totalFrameCount) % totalFrameCount;
+                    const uint8_t prevToCurr =
+                            currentFrame < prev.frameIndex ?
+                            prevToEnd + currentFrame :
+                            currentFrame - prev.frameIndex;
+                    const float blendValue = prevToCurr / (float) prevToNext;
+
+                    float prevValue = getResult[r](getVec4[v4](prev)).result;
+                    float nextValue = getResult[r](getVec4[v4](next)).result;
+
+                    return transformAlgo[v4](prevValue, nextValue, blendValue);
+                };
+
+                Result<float> result = getValueForKeyframe(
+                        boneName,
+                        currentFrame,
+                        keyframes_,
+                        keyframeIndexes_,
+                        getVec4[v4],
+                        getResult[r],
+                        tweenTransform
+                );
+
+                setResult[r](getVec4[v4](currentKey), result);
+            }
+        }
+
+        vec3 position{};
+
+        // TODO: Scaling comes later, this is a bit messy
+        vec3 scale = {
+                currentKey.scale.x.orElse(1),
+                currentKey.scale.y.orElse(1),
+                currentKey.scale.z.orElse(1)
+        };
+
+        vec3 rotation = {
+                currentKey.rotation.x.orElse(0),
+                currentKey.rotation.y.orElse(0),
+                currentKey.rotation.z.orElse(0)
+        };
+
+        return {position, rotation, scale};
     }
 
-    std::uint8_t Animation::getFps() const
+    void Animation::samplePose(float frameTime, const SkeletonLayout& skeleton, AnimationPose& pose) const
     {
-        return fps_;
+        const std::size_t boneCount = skeleton.boneCount();
+
+        pose.rotations.resize(boneCount);
+        pose.scales.resize(boneCount);
+
+        if (frameCount_ == 0)
+        {
+            PoseMath::LoadBindPose(skeleton, pose);
+            return;
+        }
+
+        BakedFrames& baked = getBakedFrames(skeleton);
+
+        const float wholeFrame = std::floor(frameTime);
+        const std::uint32_t fromFrame = static_cast<std::uint32_t>(wholeFrame) % frameCount_;
+        const std::uint32_t toFrame = (fromFrame + 1) % frameCount_;
+
+        // Frames still being baked by a preload are evaluated on demand instead of waiting on it
+        AnimationPose onDemand{};
+
+        const vec3* rotations[2];
+        const vec3* scales[2];
+        const std::uint32_t frames[2] = {fromFrame, toFrame};
+
+        for (std::uint32_t i = 0; i < 2; ++i)
+        {
+            if (bakeFrame(baked, skeleton, frames[i]))
+            {
+                rotations[i] = &baked.frames.rotations[frames[i] * boneCount];
+                scales[i] = &baked.frames.scales[frames[i] * boneCount];
+            }
+            else
+            {
+                if (onDemand.rotations.empty())
+                {
+                    onDemand.rotations.resize(boneCount * 2);
+                    onDemand.scales.resize(boneCount * 2);
+                }
+
+                evaluateFrame(frames[i], skeleton, &onDemand.rotations[i * boneCount], &onDemand.scales[i * boneCount]);
+
+                rotations[i] = &onDemand.rotations[i * boneCount];
+                scales[i] = &onDemand.scales[i * boneCount];
+            }
+        }
+
+        PoseMath::Interpolate(
+                rotations[0],
+                scales[0],
+                rotations[1],
+                scales[1],
+                frameTime - wholeFrame,
+                boneCount,
+                pose.rotations.data(),
+                pose.scales.data());
     }
 
-    std::uint8_t Animation::getFrameCount() const
+    void Animation::bakeFrames(const SkeletonLayout& skeleton, std::uint32_t firstFrame, std::uint32_t lastFrame) const
     {
-        return frameCount_;
+        BakedFrames& baked = getBakedFrames(skeleton);
+
+        for (std::uint32_t frame = firstFrame; frame < lastFrame && frame < frameCount_; ++frame)
+        {
+            bakeFrame(baked, skeleton, frame);
+        }
     }
 
-    Animator::Animator(IAnimation* animation)
-            : animation_(animation), sequenceDuration_((float) animation->getFrameCount() / animation->getFps())
+    BakedFrames& Animation::getBakedFrames(const SkeletonLayout& skeleton) const
     {
+        BakedFrames* lastBaked = lastBakedFrames_.load(std::memory_order_acquire);
 
+        if (lastBaked != nullptr && lastBaked->signature == skeleton.signature)
+        {
+            return *lastBaked;
+        }
+
+        std::unique_lock<std::mutex> mlock(bakeMutex_);
+
+        auto itr = bakedFrames_.find(skeleton.signature);
+
+        if (itr == bakedFrames_.end())
+        {
+            const std::size_t boneCount = skeleton.boneCount();
+
+            BakedFrames baked{};
+            baked.signature = skeleton.signature;
+            baked.frames.rotations.resize(boneCount * frameCount_);
+            baked.frames.scales.resize(boneCount * frameCount_);
+            baked.frameStates = std::unique_ptr<std::atomic<std::uint8_t>[]>(
+                    new std::atomic<std::uint8_t>[frameCount_]()
+            );
+
+            itr = bakedFrames_.insert(
+                    std::pair<std::size_t, BakedFrames>{skeleton.signature, std::move(baked)}
+            ).first;
+        }
+
+        // Map nodes never move, so the table can be handed out after the lock is released
+        lastBakedFrames_.store(&itr->second, std::memory_order_release);
+
+        return itr->second;
     }
 
-    std::string Animator::getAnimationName() const
+    bool Animation::bakeFrame(BakedFrames& baked, const SkeletonLayout& skeleton, std::uint32_t frame) const
     {
-        return animation_->getPath();
+        std::uint8_t state = baked.frameStates[frame].load(std::memory_order_acquire);
+
+        if (state == FRAME_UNBAKED
+            && baked.frameStates[frame].compare_exchange_strong(state, FRAME_BAKING, std::memory_order_acq_rel))
+        {
+            const std::size_t boneCount = skeleton.boneCount();
+
+            evaluateFrame(
+                    frame,
+                    skeleton,
+                    &baked.frames.rotations[frame * boneCount],
+                    &baked.frames.scales[frame * boneCount]);
+
+            baked.frameStates[frame].store(FRAME_BAKED, std::memory_order_release);
+
+            state = FRAME_BAKED;
+        }
+
+        return state == FRAME_BAKED;
     }
 
-    void Animator::update(float deltaTime, BoneMap& bones, std::unordered_map<std::uint32_t, mat4> overrides)
+    void Animation::evaluateFrame(
+            std::uint32_t frame,
+            const SkeletonLayout& skeleton,
+            vec3* rotations,
+            vec3* scales) const
     {
-        //TODO: Animations never stop, need to create an animation event.
-        sequenceTime_ += deltaTime;
-        sequenceTime_ = fmod(sequenceTime_, sequenceDuration_);
+        for (std::size_t bone = 0; bone < skeleton.boneCount(); ++bone)
+        {
+            Transform transform = evaluateTransform(frame, skeleton.boneNames[bone]);
 
-        std::uint8_t currentFrame = (sequenceTime_ / sequenceDuration_) * animation_->getFrameCount();
+            rotations[bone] = transform.rotation;
+            scales[bone] = transform.scale;
+        }
+    }
 
-        // If this is still the same frame, nothing to update
-        if (currentFrame == lastFrameIndex_) return;
+    const SharedPalette& Animation::getSharedPalette(
+            std::uint32_t step,
+            std::uint32_t stepsPerFrame,
+            const SkeletonLayout& skeleton) const
+    {
+        const std::uint32_t stepCount = std::max<std::uint32_t>(frameCount_ * stepsPerFrame, 1);
+        const auto key = static_cast<std::size_t>(
+                BinaryFormat::hashWord(stepsPerFrame, BinaryFormat::hashWord(skeleton.signature)));
 
-        lastFrameIndex_ = currentFrame;
+        step %= stepCount;
 
-        std::unordered_map<std::uint32_t, mat4> boneTransformations{};
+        std::vector<std::uint32_t>& slots = paletteSlots_[key];
 
-        for (auto& entry: bones.getAllBones())
+        if (slots.empty())
         {
-            auto override = overrides.find(entry.first);
+            slots.assign(stepCount, NO_PALETTE);
+        }
+
+        std::uint32_t index = slots[step];
 
-            // If there is an override for this bone, don't calculate animation transform
-            if (override != overrides.end())
+        if (index == NO_PALETTE)
+        {
+            // Only the first instance to reach a step this frame evaluates it, the rest share the result
+            if (freePalettes_.empty())
             {
-                boneTransformations.insert(
-                        std::pair<std::uint32_t, mat4>{entry.first, override->second}
-                );
+                index = static_cast<std::uint32_t>(sharedPalettes_.size());
+                sharedPalettes_.push_back(std::make_unique<PooledPalette>());
             }
             else
             {
-                // Check to see if this transformation has been calculated before
-                Result<mat4*> transformationMatrix = findCachedTransformationMatrix(
-                        animation_->getPath(),
-                        currentFrame,
-                        entry.first);
+                index = freePalettes_.back();
+                freePalettes_.pop_back();
+            }
 
-                if (transformationMatrix.hasResult)
-                {
-                    boneTransformations.insert(
-                            std::pair<std::uint32_t, mat4>{entry.first, *transformationMatrix.result}
-                    );
-                }
-                else
-                {
-                    // Get the bone's Transform keyframe
-                    auto& boneKeyframe = animation_->getKeyFrameForBone(currentFrame, entry.first, entry.second.name);
+            PooledPalette& shared = *sharedPalettes_[index];
+            shared.key = key;
+            shared.step = step;
+            shared.inUse = true;
 
-                    //TODO: Need to validate the animation skeleton matches the model skeleton
-                    const BoneNode* boneNode = bones.getBone(entry.first).result;
+            samplePose(static_cast<float>(step) / static_cast<float>(stepsPerFrame), skeleton, sharedPose_);
+            PoseMath::ComposePose(skeleton, sharedPose_, NO_OVERRIDES, shared.palette.transforms);
 
-                    mat4 matrix = GfxMath::CreateTransformation(
-                            boneKeyframe.transform.rotation,
-                            boneKeyframe.transform.scale,
-                            boneNode->bone.position.vec3());
+            slots[step] = index;
+        }
 
-                    // Create a transformation matrix for the bone
-                    boneTransformations.insert(
-                            std::pair<std::uint32_t, mat4>{entry.first, matrix}
-                    );
+        PooledPalette& shared = *sharedPalettes_[index];
+        shared.lastUsedFrame = frame_;
 
-                    cacheTransformationMatrix(animation_->getPath(), currentFrame, entry.first, matrix);
-                }
+        return shared.palette;
+    }
+
+    void Animation::beginFrame(std::uint32_t frame)
+    {
+        frame_ = frame;
+
+        for (std::uint32_t i = 0; i < sharedPalettes_.size(); ++i)
+        {
+            PooledPalette& shared = *sharedPalettes_[i];
+
+            // Palettes used last frame are still referenced by the instances that used them until they update
+            if (shared.inUse && frame - shared.lastUsedFrame > 1)
+            {
+                paletteSlots_[shared.key][shared.step] = NO_PALETTE;
+                shared.inUse = false;
+                // Instances that stopped updating may still hold the palette, this tells them it's gone
+                ++shared.palette.generation;
+                freePalettes_.push_back(i);
             }
         }
+    }
+
+    std::string Animation::getPath() const
+    {
+        return animationPath_;
+    }
+
+    std::uint8_t Animation::getFps() const
+    {
+        return fps_;
+    }
+
+    std::uint8_t Animation::getFrameCount() const
+    {
+        return frameCount_;
+    }
+
+    Animator::Animator(IAnimation* animation, std::uint32_t stepsPerFrame)
+            : animation_(animation),
+              stepsPerFrame_(stepsPerFrame),
+              sequenceDuration_((float) animation->getFrameCount() / animation->getFps())
+    {
+
+    }
 
-        boneTransformations_.clear();
+    std::string Animator::getAnimationName() const
+    {
+        return animation_->getPath();
+    }
+
+    void Animator::update(float deltaTime, const SkeletonLayout& skeleton, const PoseOverrides& overrides)
+    {
+        // Pose and palette storage are reused, only the first update for a skeleton allocates
+        PoseMath::ComposePose(skeleton, samplePose(deltaTime, skeleton), overrides, palette_.transforms);
+    }
+
+    const AnimationPose& Animator::samplePose(float deltaTime, const SkeletonLayout& skeleton)
+    {
+        animation_->samplePose(advance(deltaTime), skeleton, pose_);
+
+        return pose_;
+    }
 
-        // Iteratively compound transform matrix with parent bone
-        for (auto& transform: boneTransformations)
+    const SharedPalette& Animator::sampleSharedPalette(float deltaTime, const SkeletonLayout& skeleton)
+    {
+        if (stepsPerFrame_ == 0)
         {
-            boneTransformations_.insert(
-                    std::pair<std::uint32_t, mat4>{transform.first, transform.second}
-            );
+            update(deltaTime, skeleton, NO_OVERRIDES);
+            return palette_;
+        }
 
-            mat4& matrix = boneTransformations_.at(transform.first);
+        // advance() already quantized the time, rounding just absorbs float error
+        const float frameTime = advance(deltaTime);
 
-            const BoneNode* bone = bones.getBone(transform.first).result;
+        return animation_->getSharedPalette(
+                static_cast<std::uint32_t>((frameTime * static_cast<float>(stepsPerFrame_)) + 0.5f),
+                stepsPerFrame_,
+                skeleton);
+    }
 
-            auto parent = bones.getBone(bone->parentId);
+    float Animator::advance(float deltaTime)
+    {
+        //TODO: Animations never stop, need to create an animation event.
+        sequenceTime_ += deltaTime;
+        sequenceTime_ = fmod(sequenceTime_, sequenceDuration_);
 
-            while (parent.hasResult)
-            {
-                matrix = boneTransformations.at(parent.result->id) * matrix;
+        // Sampling between frames keeps motion smooth regardless of the animation's FPS
+        const float frameTime = (sequenceTime_ / sequenceDuration_) * animation_->getFrameCount();
 
-                parent = bones.getBone(parent.result->parentId);
-            }
+        if (stepsPerFrame_ == 0)
+        {
+            return frameTime;
         }
+
+        // Shared and blended playback sample the same steps, so an instance switching between them doesn't pop
+        const auto stepsPerFrame = static_cast<float>(stepsPerFrame_);
+
+        return std::floor(frameTime * stepsPerFrame) / stepsPerFrame;
     }
 
     void Animator::setCurrentFrame(std::uint32_t frame)
@@ -579,13 +727,17 @@ namespace PB
         sequenceTime_ = fmod(sequenceTime_, sequenceDuration_);
     }
 
-    const std::unordered_map<std::uint32_t, mat4>& Animator::getBoneTransformations() const
+    const std::vector<mat4>& Animator::getBoneTransformations() const
     {
-        return boneTransformations_;
+        return palette_.transforms;
     }
 
-    AnimationCatalogue::AnimationCatalogue(std::shared_ptr<AssetLibrary> assetLibrary)
-            : assetLibrary_(std::move(assetLibrary))
+    AnimationCatalogue::AnimationCatalogue(
+            std::shared_ptr<AssetLibrary> assetLibrary,
+            std::shared_ptr<WorkerPool> workerPool)
+            : stepsPerFrame_(DEFAULT_STEPS_PER_FRAME),
+              assetLibrary_(std::move(assetLibrary)),
+              workerPool_(std::move(workerPool))
     {
 
     }
@@ -607,6 +759,65 @@ namespace PB
         return itr != animations_.end();
     }
 
+    PreloadHandle AnimationCatalogue::preloadAnimationAsync(BoneMap& boneMap, const std::string& animationPath)
+    {
+        auto state = std::make_shared<PreloadState>();
+        PreloadHandle handle{state};
+
+        auto itr = animations_.find(animationPath);
+
+        if (itr == animations_.end())
+        {
+            LOGGER_ERROR("No animation found for '" + animationPath + "' to preload");
+            state->result.set_value(false);
+            return handle;
+        }
+
+        IAnimation* animation = itr->second;
+
+        // The layout is built on the calling thread, the bone map itself is not shared with the workers
+        auto skeleton = std::make_shared<SkeletonLayout>(PoseMath::BuildSkeletonLayout(boneMap));
+
+        const std::uint32_t frameCount = animation->getFrameCount();
+        const std::uint32_t workerCount = workerPool_ != nullptr ? workerPool_->threadCount() : 1;
+        const std::uint32_t jobCount = std::max<std::uint32_t>(
+                std::min(frameCount / MIN_FRAMES_PER_PRELOAD_JOB, workerCount),
+                1);
+        const std::uint32_t framesPerJob = (frameCount + jobCount - 1) / jobCount;
+
+        state->totalUnits = frameCount;
+        state->pendingJobs = jobCount;
+
+        for (std::uint32_t i = 0; i < jobCount; ++i)
+        {
+            const std::uint32_t firstFrame = std::min(i * framesPerJob, frameCount);
+            const std::uint32_t lastFrame = std::min(firstFrame + framesPerJob, frameCount);
+
+            auto job = [animation, skeleton, state, firstFrame, lastFrame]() {
+                animation->bakeFrames(*skeleton, firstFrame, lastFrame);
+
+                state->completedUnits += lastFrame - firstFrame;
+
+                // Whichever job finishes last completes the preload
+                if (state->pendingJobs.fetch_sub(1) == 1)
+                {
+                    state->result.set_value(true);
+                }
+            };
+
+            if (workerPool_ != nullptr)
+            {
+                workerPool_->submit(job);
+            }
+            else
+            {
+                job();
+            }
+        }
+
+        return handle;
+    }
+
     std::unique_ptr<IAnimator> AnimationCatalogue::get(const std::string& animationPath) const
     {
         std::unique_ptr<IAnimator> animator;
@@ -615,7 +826,7 @@ namespace PB
 
         if (itr != animations_.end())
         {
-            animator = std::make_unique<Animator>(itr->second);
+            animator = std::make_unique<Animator>(itr->second, stepsPerFrame_);
         }
         else
         {
@@ -624,4 +835,19 @@ namespace PB
 
         return animator;
     }
+
+    void AnimationCatalogue::setStepsPerFrame(std::uint32_t stepsPerFrame)
+    {
+        stepsPerFrame_ = stepsPerFrame;
+    }
+
+    void AnimationCatalogue::beginFrame()
+    {
+        ++frame_;
+
+        for (auto& animation: animations_)
+        {
+            animation.second->beginFrame(frame_);
+        }
+    }
 }
@@ -2,13 +2,39 @@
 
 #include "puppetbox/IAnimationCatalogue.h"
 #include "AssetLibrary.h"
+#include "WorkerPool.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
 namespace PB
 {
+    /**
+     * \brief Contiguous frame x bone table of local transforms for one skeleton, baked a frame at a time.
+     */
+    struct BakedFrames
+    {
+        std::size_t signature = 0;
+        AnimationPose frames{};
+        std::unique_ptr<std::atomic<std::uint8_t>[]> frameStates{};
+    };
+
+    /**
+     * \brief A shared palette in an animation's pool, and the (skeleton, step) it was composed for.
+     */
+    struct PooledPalette
+    {
+        SharedPalette palette{};
+        /** The skeleton signature and steps per frame the palette was evaluated for */
+        std::size_t key = 0;
+        std::uint32_t step = 0;
+        std::uint32_t lastUsedFrame = 0;
+        bool inUse = false;
+    };
+
     class Animation : public IAnimation
     {
     public:
@@ -26,6 +52,17 @@ namespace PB
                 std::uint32_t boneId,
                 const std::string& boneName) const override;
 
+        void samplePose(float frameTime, const SkeletonLayout& skeleton, AnimationPose& pose) const override;
+
+        const SharedPalette& getSharedPalette(
+                std::uint32_t step,
+                std::uint32_t stepsPerFrame,
+                const SkeletonLayout& skeleton) const override;
+
+        void beginFrame(std::uint32_t frame) override;
+
+        void bakeFrames(const SkeletonLayout& skeleton, std::uint32_t firstFrame, std::uint32_t lastFrame) const override;
+
         std::string getPath() const;
 
         std::uint8_t getFps() const;
@@ -40,42 +77,111 @@ namespace PB
         /** Keyframes are stored as separate scale/rotation/transform vectors */
         const std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> keyframes_{};
         std::vector<std::uint8_t> keyframeIndexes_{};
+        /** Contiguous frame x bone tables of local transforms, keyed by skeleton signature */
+        mutable std::unordered_map<std::size_t, BakedFrames> bakedFrames_{};
+        mutable std::mutex bakeMutex_;
+        /** The last baked table looked up, published so the steady state finds it without taking bakeMutex_ */
+        mutable std::atomic<BakedFrames*> lastBakedFrames_{nullptr};
+        /** Palettes shared across instances, pooled so their storage is reused rather than reallocated */
+        mutable std::vector<std::unique_ptr<PooledPalette>> sharedPalettes_{};
+        mutable std::vector<std::uint32_t> freePalettes_{};
+        /** Indexes into sharedPalettes_ by step, keyed by {\link PooledPalette::key} */
+        mutable std::unordered_map<std::size_t, std::vector<std::uint32_t>> paletteSlots_{};
+        /** Scratch pose the shared palettes are composed from */
+        mutable AnimationPose sharedPose_{};
+        std::uint32_t frame_ = 0;
+
+    private:
+        BakedFrames& getBakedFrames(const SkeletonLayout& skeleton) const;
+
+        bool bakeFrame(BakedFrames& baked, const SkeletonLayout& skeleton, std::uint32_t frame) const;
+
+        void evaluateFrame(std::uint32_t frame, const SkeletonLayout& skeleton, vec3* rotations, vec3* scales) const;
+
+        Transform evaluateTransform(std::uint8_t currentFrame, const std::string& boneName) const;
     };
 
     class Animator : public IAnimator
     {
     public:
-        explicit Animator(IAnimation* animation);
+        /**
+         * \brief Creates an animator for the given animation.
+         *
+         * \param animation     The animation to play.
+         * \param stepsPerFrame The number of steps each frame is split into when sampling, or 0 to sample
+         * in continuous time.
+         */
+        Animator(IAnimation* animation, std::uint32_t stepsPerFrame);
 
         std::string getAnimationName() const override;
 
-        void update(float deltaTime, BoneMap& bones, std::unordered_map<std::uint32_t, mat4> overrides) override;
+        void update(float deltaTime, const SkeletonLayout& skeleton, const PoseOverrides& overrides) override;
+
+        const AnimationPose& samplePose(float deltaTime, const SkeletonLayout& skeleton) override;
+
+        const SharedPalette& sampleSharedPalette(float deltaTime, const SkeletonLayout& skeleton) override;
 
         void setCurrentFrame(std::uint32_t frame) override;
 
-        const std::unordered_map<std::uint32_t, mat4>& getBoneTransformations() const override;
+        const std::vector<mat4>& getBoneTransformations() const override;
+
+    private:
+        /**
+         * \brief Advances the sequence time and gets the resulting fractional frame position, quantized to
+         * the animator's steps per frame.
+         *
+         * \param deltaTime The time since the last update cycle.
+         * \return The fractional frame position for the current sequence time.
+         */
+        float advance(float deltaTime);
 
     private:
         IAnimation* animation_;
+        std::uint32_t stepsPerFrame_;
         float sequenceTime_ = 0;
         float sequenceDuration_;
-        std::int32_t lastFrameIndex_ = -1;
-        std::unordered_map<std::uint32_t, mat4> boneTransformations_;
+        AnimationPose pose_{};
+        /** Composed by the animator itself, so its generation never changes */
+        SharedPalette palette_{};
     };
 
     class AnimationCatalogue : public IAnimationCatalogue
     {
     public:
-        explicit AnimationCatalogue(std::shared_ptr<AssetLibrary> assetLibrary);
+        explicit AnimationCatalogue(
+                std::shared_ptr<AssetLibrary> assetLibrary,
+                std::shared_ptr<WorkerPool> workerPool = nullptr);
 
         bool load(const std::string& assetPath) override;
 
         bool preloadAnimation(BoneMap& boneMap, const std::string& animationPath) override;
 
+        PreloadHandle preloadAnimationAsync(BoneMap& boneMap, const std::string& animationPath) override;
+
         std::unique_ptr<IAnimator> get(const std::string& animationPath) const override;
 
+        /**
+         * \brief Sets the number of steps each animation frame is split into when sampling, for animators
+         * created afterwards.
+         *
+         * <p>Every instance at the same step of an animation shares one palette, so fewer steps share more
+         * but move less smoothly.  0 samples in continuous time and shares nothing.</p>
+         *
+         * \param stepsPerFrame The number of steps per frame, or 0 for continuous time.
+         */
+        void setStepsPerFrame(std::uint32_t stepsPerFrame);
+
+        /**
+         * \brief Starts a new frame for every animation's shared palettes.  Must be called once per frame,
+         * before any models are updated.
+         */
+        void beginFrame();
+
     private:
         std::unordered_map<std::string, IAnimation*> animations_{};
+        std::uint32_t stepsPerFrame_;
+        std::uint32_t frame_ = 0;
         std::shared_ptr<AssetLibrary> assetLibrary_;
+        std::shared_ptr<WorkerPool> workerPool_;
     };
 }
\ No newline at end of file
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BinaryFormat.h"
+
+/**
+ * Layout of the compiled binary animation clip format (.pbanim), shared between the engine loader
+ * and the anim-converter tool, so it must not depend on anything outside the standard library and
+ * {\link BinaryFormat.h}.
+ *
+ * <p>All values are little-endian, regardless of the host.</p>
+ *
+ * <pre>
+ * Header
+ *   char[4]   magic            "PBAC"
+ *   uint16    version
+ *   uint8     fps
+ *   uint8     frameCount
+ *   uint16    boneCount
+ *   uint32    keyframeCount
+ *   float32   rotationStep     Radians per quantized unit
+ *   float32   scaleStep        Scale per quantized unit
+ *   float32   positionStep     Position per quantized unit
+ * Bone table (boneCount entries)
+ *   uint8     nameLength
+ *   char[]    name
+ * Keyframes (keyframeCount entries)
+ *   uint8     frameIndex
+ *   uint16    boneIndex        Index into the bone table
+ *   uint16    channels         Bitmask of {\link AnimationClip::Channel} values present
+ *   int16[]   values           One quantized value per set channel, in channel bit order
+ * </pre>
+ */
+namespace PB::AnimationClip
+{
+    constexpr char MAGIC[4] = {'P', 'B', 'A', 'C'};
+    constexpr std::uint16_t VERSION = 1;
+    constexpr const char* FILE_EXTENSION = ".pbanim";
+
+    constexpr std::uint32_t HEADER_SIZE = 4 + 2 + 1 + 1 + 2 + 4 + 4 + 4 + 4;
+    constexpr std::uint32_t KEYFRAME_HEADER_SIZE = 1 + 2 + 2;
+
+    constexpr std::uint32_t CHANNEL_COUNT = 9;
+    constexpr std::int32_t QUANTIZED_MAX = 32767;
+
+    /**
+     * \brief Quantized rotations cover a full turn, [-PI, PI), across the whole int16 range.
+     */
+    constexpr float ROTATION_STEP = 6.28318530717958647692f / 65536.0f;
+
+    constexpr float PI = 3.14159265358979323846f;
+
+    enum Channel : std::uint16_t
+    {
+        ROTATION_X = 1 << 0,
+        ROTATION_Y = 1 << 1,
+        ROTATION_Z = 1 << 2,
+        SCALE_X = 1 << 3,
+        SCALE_Y = 1 << 4,
+        SCALE_Z = 1 << 5,
+        POSITION_X = 1 << 6,
+        POSITION_Y = 1 << 7,
+        POSITION_Z = 1 << 8
+    };
+
+    /**
+     * \brief Quantizes the given value to the nearest step, clamping it to the int16 range.
+     *
+     * \param value The value to quantize.
+     * \param step  The size of a single quantized unit.
+     *
+     * \return The quantized value.
+     */
+    inline std::int16_t quantize(float value, float step)
+    {
+        std::int32_t quantized = static_cast<std::int32_t>(std::lround(value / step));
+
+        if (quantized > QUANTIZED_MAX)
+        {
+            quantized = QUANTIZED_MAX;
+        }
+        else if (quantized < -QUANTIZED_MAX - 1)
+        {
+            quantized = -QUANTIZED_MAX - 1;
+        }
+
+        return static_cast<std::int16_t>(quantized);
+    }
+
+    inline float dequantize(std::int16_t value, float step)
+    {
+        return static_cast<float>(value) * step;
+    }
+
+    using BinaryFormat::readUInt16;
+    using BinaryFormat::readInt16;
+    using BinaryFormat::readUInt32;
+    using BinaryFormat::readFloat;
+    using BinaryFormat::writeUInt16;
+    using BinaryFormat::writeUInt32;
+    using BinaryFormat::writeFloat;
+
+    /**
+     * \brief Counts the number of quantized values that follow a keyframe with the given channels.
+     *
+     * \param channels The bitmask of channels present in the keyframe.
+     *
+     * \return The number of values stored for the keyframe.
+     */
+    inline std::uint32_t channelCount(std::uint16_t channels)
+    {
+        std::uint32_t count = 0;
+
+        for (std::uint32_t i = 0; i < CHANNEL_COUNT; ++i)
+        {
+            count += (channels >> i) & 1;
+        }
+
+        return count;
+    }
+
+    /**
+     * \brief Holds a single bone's keyframe, with the channel mask indicating which values were defined.
+     */
+    struct Keyframe
+    {
+        std::uint8_t frameIndex = 0;
+        std::uint16_t boneIndex = 0;
+        std::uint16_t channels = 0;
+        float values[CHANNEL_COUNT]{};
+    };
+
+    /**
+     * \brief An uncompressed clip, ready to be encoded, rotations are in radians.
+     */
+    struct Clip
+    {
+        std::uint8_t fps = 0;
+        std::uint8_t frameCount = 0;
+        std::vector<std::string> boneNames{};
+        std::vector<Keyframe> keyframes{};
+    };
+
+    /**
+     * \brief Wraps the given rotation to [-PI, PI), the range covered by quantized rotations.
+     *
+     * \param radians The rotation to wrap.
+     *
+     * \return The wrapped rotation.
+     */
+    inline float wrapRotation(float radians)
+    {
+        float value = std::fmod(radians, 2.0f * PI);
+        return value >= PI ? value - (2.0f * PI) : (value < -PI ? value + (2.0f * PI) : value);
+    }
+
+    /**
+     * \brief Gets the quantization step that fits the largest scale or position value of the clip.
+     *
+     * \param clip   The clip to get the step for.
+     * \param vector The vector of channels, 1 for scale, 2 for position.
+     *
+     * \return The quantization step.
+     */
+    inline float quantizationStep(const Clip& clip, std::uint32_t vector)
+    {
+        float maxAbs = 0;
+
+        for (const auto& keyframe: clip.keyframes)
+        {
+            for (std::uint32_t axis = 0; axis < 3; ++axis)
+            {
+                const std::uint32_t channel = (vector * 3) + axis;
+
+                if (keyframe.channels & (1 << channel))
+                {
+                    maxAbs = std::max(maxAbs, std::abs(keyframe.values[channel]));
+                }
+            }
+        }
+
+        return maxAbs > 0 ? maxAbs / QUANTIZED_MAX : 1.0f;
+    }
+
+    /**
+     * \brief Encodes the given clip into the binary clip format.
+     *
+     * \param clip The clip to encode, rotations must already be wrapped with {\link AnimationClip::wrapRotation}.
+     *
+     * \return The encoded clip.
+     */
+    inline std::vector<std::uint8_t> encode(const Clip& clip)
+    {
+        const float steps[3] = {
+                ROTATION_STEP,
+                quantizationStep(clip, 1),
+                quantizationStep(clip, 2)
+        };
+
+        std::vector<std::uint8_t> bytes(HEADER_SIZE);
+
+        std::copy(MAGIC, MAGIC + 4, bytes.begin());
+        writeUInt16(&bytes[4], VERSION);
+        bytes[6] = clip.fps;
+        bytes[7] = clip.frameCount;
+        writeUInt16(&bytes[8], static_cast<std::uint16_t>(clip.boneNames.size()));
+        writeUInt32(&bytes[10], static_cast<std::uint32_t>(clip.keyframes.size()));
+        writeFloat(&bytes[14], steps[0]);
+        writeFloat(&bytes[18], steps[1]);
+        writeFloat(&bytes[22], steps[2]);
+
+        for (const auto& boneName: clip.boneNames)
+        {
+            const auto nameLength = static_cast<std::uint8_t>(std::min<std::size_t>(boneName.size(), 255));
+            bytes.push_back(nameLength);
+            bytes.insert(bytes.end(), boneName.begin(), boneName.begin() + nameLength);
+        }
+
+        std::uint8_t buffer[2];
+
+        for (const auto& keyframe: clip.keyframes)
+        {
+            bytes.push_back(keyframe.frameIndex);
+            writeUInt16(buffer, keyframe.boneIndex);
+            bytes.insert(bytes.end(), buffer, buffer + 2);
+            writeUInt16(buffer, keyframe.channels);
+            bytes.insert(bytes.end(), buffer, buffer + 2);
+
+            for (std::uint32_t channel = 0; channel < CHANNEL_COUNT; ++channel)
+            {
+                if (keyframe.channels & (1 << channel))
+                {
+                    const std::int16_t value = quantize(keyframe.values[channel], steps[channel / 3]);
+                    writeUInt16(buffer, static_cast<std::uint16_t>(value));
+                    bytes.insert(bytes.end(), buffer, buffer + 2);
+                }
+            }
+        }
+
+        return bytes;
+    }
+}
@@ -0,0 +1,268 @@
+#include "ArchivePrefetcher.h"
+
+#include <memory>
+
+#include "BinaryFormat.h"
+#include "CookedFormat.h"
+#include "Logger.h"
+#include "Utilities.h"
+
+namespace PB
+{
+    namespace
+    {
+        /**
+        * \brief Stride used to touch the pages of stored entries, the smallest common page size.
+        */
+        constexpr std::size_t PAGE_SIZE = 4096;
+
+        std::string entryKey(const std::string& archivePath, const std::string& fileName)
+        {
+            return archivePath + '|' + fileName;
+        }
+    }
+
+    ArchivePrefetcher::ArchivePrefetcher(std::string profilePath, std::uint64_t budgetBytes)
+            : profilePath_(std::move(profilePath)), budgetBytes_(budgetBytes)
+    {
+
+    }
+
+    ArchivePrefetcher::~ArchivePrefetcher()
+    {
+        stop();
+    }
+
+    bool ArchivePrefetcher::start()
+    {
+        const auto status = CookedFormat::readCacheFile(
+                profilePath_,
+                CookedFormat::PREFETCH_PROFILE_MAGIC,
+                "prefetch profile",
+                [this](BinaryFormat::Reader& reader, const std::shared_ptr<std::uint8_t[]>&) {
+                    const std::uint32_t count = reader.readUInt32();
+
+                    for (std::uint32_t i = 0; i < count && !reader.overrun(); ++i)
+                    {
+                        std::string archivePath = reader.readString();
+                        std::string fileName = reader.readString();
+
+                        profile_.emplace_back(std::move(archivePath), std::move(fileName));
+                    }
+
+                    return true;
+                });
+
+        if (status != CookedFormat::CacheFileStatus::READ)
+        {
+            // Startup reads are recorded regardless, and written over the profile when startup is over
+            profile_.clear();
+            return false;
+        }
+
+        thread_ = std::thread(&ArchivePrefetcher::run, this);
+
+        return true;
+    }
+
+    ArchiveEntryData ArchivePrefetcher::take(const std::string& archivePath, const ArchiveEntry& entry)
+    {
+        if (finished_)
+        {
+            return {};
+        }
+
+        const std::string key = entryKey(archivePath, entry.name);
+
+        std::unique_lock<std::mutex> mlock(mutex_);
+
+        if (recordedKeys_.insert(key).second)
+        {
+            recorded_.emplace_back(archivePath, entry.name);
+        }
+
+        if (profile_.empty() || entry.isStored())
+        {
+            return {};
+        }
+
+        condition_.wait(mlock, [this, &key]() {
+            return inFlight_ != key;
+        });
+
+        auto itr = staged_.find(key);
+
+        if (itr == staged_.end())
+        {
+            ++misses_;
+            demanded_.insert(key);
+            return {};
+        }
+
+        ArchiveEntryData entryData = std::move(itr->second);
+        staged_.erase(itr);
+        stagedBytes_ -= entryData.size;
+        ++hits_;
+
+        // Frees budget for the prefetch thread
+        condition_.notify_all();
+
+        return entryData;
+    }
+
+    void ArchivePrefetcher::finish(double firstFrameMilliseconds)
+    {
+        if (finished_.exchange(true))
+        {
+            return;
+        }
+
+        stop();
+
+        std::unique_lock<std::mutex> mlock(mutex_);
+
+        if (profile_.empty())
+        {
+            LOGGER_INFO("First frame after " + StringUtils::formatMilliseconds(firstFrameMilliseconds)
+                        + " without a prefetch profile");
+        }
+        else
+        {
+            LOGGER_INFO("First frame after " + StringUtils::formatMilliseconds(firstFrameMilliseconds)
+                        + " with a prefetch profile, " + std::to_string(hits_) + " of "
+                        + std::to_string(prefetched_) + " prefetched entries used, "
+                        + std::to_string(misses_) + " read on demand");
+        }
+
+        staged_.clear();
+        stagedBytes_ = 0;
+
+        if (recorded_ != profile_)
+        {
+            save();
+        }
+    }
+
+    void ArchivePrefetcher::run()
+    {
+        // Readers of its own, so prefetching never contends with the decompression handles of demand reads
+        std::unordered_map<std::string, std::unique_ptr<ArchiveReader>> readers{};
+
+        for (const auto& profiled: profile_)
+        {
+            const std::string key = entryKey(profiled.first, profiled.second);
+            auto& reader = readers[profiled.first];
+
+            if (reader == nullptr)
+            {
+                reader = std::make_unique<ArchiveReader>();
+
+                if (!reader->open(profiled.first))
+                {
+                    LOGGER_WARN("Profiled archive '" + profiled.first + "' could not be opened for prefetching");
+                }
+            }
+
+            const ArchiveEntry* entry = reader->isOpen() ? reader->findEntry(profiled.second) : nullptr;
+
+            if (entry == nullptr)
+            {
+                continue;
+            }
+
+            bool error = false;
+
+            if (entry->isStored())
+            {
+                // Stored entries are read straight out of the mapping, touching each page has the OS read it in
+                ArchiveEntryData entryData = reader->read(*entry, &error);
+                volatile std::uint8_t sum = 0;
+
+                for (std::size_t offset = 0; offset < entryData.size; offset += PAGE_SIZE)
+                {
+                    sum += entryData.data[offset];
+                }
+
+                continue;
+            }
+
+            {
+                std::unique_lock<std::mutex> mlock(mutex_);
+
+                condition_.wait(mlock, [this, entry]() {
+                    return stopping_ || staged_.empty() || stagedBytes_ + entry->uncompressedSize <= budgetBytes_;
+                });
+
+                if (stopping_)
+                {
+                    break;
+                }
+
+                if (demanded_.find(key) != demanded_.end())
+                {
+                    continue;
+                }
+
+                inFlight_ = key;
+            }
+
+            ArchiveEntryData entryData = reader->read(*entry, &error);
+
+            {
+                std::unique_lock<std::mutex> mlock(mutex_);
+
+                inFlight_.clear();
+
+                if (!error)
+                {
+                    stagedBytes_ += entryData.size;
+                    staged_[key] = std::move(entryData);
+                    ++prefetched_;
+                }
+            }
+
+            condition_.notify_all();
+        }
+    }
+
+    void ArchivePrefetcher::stop()
+    {
+        {
+            std::unique_lock<std::mutex> mlock(mutex_);
+            stopping_ = true;
+        }
+
+        condition_.notify_all();
+
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    bool ArchivePrefetcher::save()
+    {
+        const bool written = CookedFormat::writeCacheFile(
+                profilePath_,
+                CookedFormat::PREFETCH_PROFILE_MAGIC,
+                "prefetch profile",
+                [this](BinaryFormat::Writer& writer) {
+                    writer.writeUInt32(static_cast<std::uint32_t>(recorded_.size()));
+
+                    for (const auto& recorded: recorded_)
+                    {
+                        writer.writeString(recorded.first);
+                        writer.writeString(recorded.second);
+                    }
+                });
+
+        if (!written)
+        {
+            return false;
+        }
+
+        LOGGER_DEBUG("Recorded " + std::to_string(recorded_.size()) + " startup reads to '" + profilePath_ + "'");
+
+        return true;
+    }
+}
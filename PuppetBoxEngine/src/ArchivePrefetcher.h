@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "ArchiveReader.h"
+
+namespace PB
+{
+    /**
+    * \brief Records the order archive entries are first read in during startup into a profile file (see
+    * {\link CookedFormat.h}), and on later runs reads the profiled entries ahead of demand.
+    *
+    * <p>Prefetching runs on its own thread, in profile order, inflating compressed entries into a staging
+    * cache bounded by a byte budget, and paging in stored entries so their first access doesn't wait on
+    * the disk.  {\link ArchiveReader}s hand their reads to {\link ArchivePrefetcher::take}, which records
+    * the read and serves it from the staging cache when it can.  Both stop once startup is over.</p>
+    */
+    class ArchivePrefetcher
+    {
+    public:
+        /**
+        * \brief Creates a prefetcher that records to, and prefetches from, the given profile.
+        *
+        * \param profilePath The path of the profile file.
+        * \param budgetBytes The most inflated bytes to stage ahead of demand at once.
+        */
+        ArchivePrefetcher(std::string profilePath, std::uint64_t budgetBytes);
+
+        ArchivePrefetcher(const ArchivePrefetcher&) = delete;
+
+        ArchivePrefetcher& operator=(const ArchivePrefetcher&) = delete;
+
+        /**
+        * \brief Stops prefetching, dropping anything still staged.
+        */
+        ~ArchivePrefetcher();
+
+        /**
+        * \brief Reads the profile left by an earlier run and starts prefetching its entries.
+        *
+        * \return True if a profile was read and prefetching started, False otherwise.
+        */
+        bool start();
+
+        /**
+        * \brief Records that the given entry is being read, and hands over its prefetched contents if they
+        * are staged, waiting on them if they are being read at that moment.
+        *
+        * \param archivePath The path of the archive the entry is read from.
+        * \param entry       The index entry of the file being read.
+        * \return The prefetched contents, or empty data if the entry has to be read on demand.
+        */
+        ArchiveEntryData take(const std::string& archivePath, const ArchiveEntry& entry);
+
+        /**
+        * \brief Ends startup, stopping prefetching and recording, writing the recorded profile if it
+        * differs from the one read, and reporting the time to the first frame along with how the
+        * prefetching went.
+        *
+        * \param firstFrameMilliseconds The time from startup to the first frame.
+        */
+        void finish(double firstFrameMilliseconds);
+
+    private:
+        /**
+        * \brief Reads the profiled entries in order, run on the prefetch thread.
+        */
+        void run();
+
+        /**
+        * \brief Stops the prefetch thread and waits for it to end.
+        */
+        void stop();
+
+        /**
+        * \brief Writes the recorded profile over the one read.
+        *
+        * \return True if the profile was written, False otherwise.
+        */
+        bool save();
+
+    private:
+        std::string profilePath_;
+        std::uint64_t budgetBytes_;
+        std::thread thread_{};
+        /** Set once startup is over, so reads after it skip the prefetcher entirely */
+        std::atomic<bool> finished_{false};
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        bool stopping_ = false;
+        /** Archive path and file name of each entry, in the order they were first read */
+        std::vector<std::pair<std::string, std::string>> profile_{};
+        std::vector<std::pair<std::string, std::string>> recorded_{};
+        std::unordered_set<std::string> recordedKeys_{};
+        std::unordered_map<std::string, ArchiveEntryData> staged_{};
+        std::uint64_t stagedBytes_ = 0;
+        /** Entries already read on demand, so there is no point prefetching them */
+        std::unordered_set<std::string> demanded_{};
+        std::string inFlight_{};
+        std::uint32_t prefetched_ = 0;
+        std::uint32_t hits_ = 0;
+        std::uint32_t misses_ = 0;
+    };
+}
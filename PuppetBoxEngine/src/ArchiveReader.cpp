@@ -0,0 +1,524 @@
+#include "ArchiveReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <zip/zip.h>
+
+#include "ArchivePrefetcher.h"
+#include "BinaryFormat.h"
+#include "CookedFormat.h"
+#include "Logger.h"
+
+namespace PB
+{
+    namespace
+    {
+        const std::uint32_t END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+        const std::uint32_t CENTRAL_DIRECTORY_SIGNATURE = 0x02014b50;
+        const std::uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+        const std::uint32_t END_OF_CENTRAL_DIRECTORY_SIZE = 22;
+        const std::uint32_t CENTRAL_DIRECTORY_HEADER_SIZE = 46;
+        const std::uint32_t LOCAL_HEADER_SIZE = 30;
+        const std::uint32_t MAX_ARCHIVE_COMMENT_SIZE = 0xFFFF;
+
+        inline std::uint16_t readUInt16(const std::uint8_t* bytes)
+        {
+            return static_cast<std::uint16_t>(bytes[0] | (bytes[1] << 8));
+        }
+
+        inline std::uint32_t readUInt32(const std::uint8_t* bytes)
+        {
+            return static_cast<std::uint32_t>(bytes[0])
+                   | (static_cast<std::uint32_t>(bytes[1]) << 8)
+                   | (static_cast<std::uint32_t>(bytes[2]) << 16)
+                   | (static_cast<std::uint32_t>(bytes[3]) << 24);
+        }
+
+        /**
+         * \brief Stream buffer over the contents of an archive entry, keeping the contents alive.
+         */
+        class EntryStreamBuffer : public std::streambuf
+        {
+        public:
+            explicit EntryStreamBuffer(ArchiveEntryData data) : data_(std::move(data))
+            {
+                char* base = const_cast<char*>(reinterpret_cast<const char*>(data_.data));
+                this->setg(base, base, base + data_.size);
+            }
+
+        protected:
+            pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+            {
+                off_type position = off;
+
+                if (dir == std::ios_base::cur)
+                {
+                    position += gptr() - eback();
+                }
+                else if (dir == std::ios_base::end)
+                {
+                    position += egptr() - eback();
+                }
+
+                if (position < 0 || position > egptr() - eback())
+                {
+                    return pos_type(off_type(-1));
+                }
+
+                setg(eback(), eback() + position, egptr());
+
+                return position;
+            }
+
+            pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+            {
+                return seekoff(pos, std::ios_base::beg, which);
+            }
+
+        private:
+            ArchiveEntryData data_;
+        };
+
+        /**
+         * \brief Input stream over the contents of an archive entry.
+         */
+        class EntryStream : private EntryStreamBuffer, public std::istream
+        {
+        public:
+            explicit EntryStream(ArchiveEntryData data)
+                    : EntryStreamBuffer(std::move(data)), std::istream(static_cast<std::streambuf*>(this))
+            {
+
+            }
+        };
+    }
+
+    ArchiveReader::~ArchiveReader()
+    {
+        close();
+    }
+
+    bool ArchiveReader::open(const std::string& archivePath)
+    {
+        close();
+
+        archivePath_ = archivePath;
+
+        if (!mapArchive())
+        {
+            LOGGER_ERROR("Error reading archive '" + archivePath_ + "'");
+            return false;
+        }
+
+        if (!buildIndex())
+        {
+            LOGGER_ERROR("Error indexing archive '" + archivePath_ + "'");
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void ArchiveReader::close()
+    {
+        {
+            std::unique_lock<std::mutex> mlock(handleMutex_);
+
+            for (auto handle: idleHandles_)
+            {
+                zip_stream_close(handle);
+            }
+
+            idleHandles_.clear();
+        }
+
+        if (bytes_ != nullptr && fallbackBytes_.empty())
+        {
+#ifdef _WIN32
+            UnmapViewOfFile(bytes_);
+#else
+            munmap(const_cast<std::uint8_t*>(bytes_), size_);
+#endif
+        }
+
+        bytes_ = nullptr;
+        size_ = 0;
+        fallbackBytes_.clear();
+        entries_.clear();
+    }
+
+    bool ArchiveReader::isOpen() const
+    {
+        return bytes_ != nullptr;
+    }
+
+    const std::unordered_map<std::string, ArchiveEntry>& ArchiveReader::entries() const
+    {
+        return entries_;
+    }
+
+    const ArchiveEntry* ArchiveReader::findEntry(const std::string& fileName) const
+    {
+        auto itr = entries_.find(fileName);
+
+        return itr != entries_.end() ? &itr->second : nullptr;
+    }
+
+    std::uint32_t ArchiveReader::contentHash() const
+    {
+        std::vector<const ArchiveEntry*> sortedEntries{};
+        sortedEntries.reserve(entries_.size());
+
+        for (const auto& entry: entries_)
+        {
+            sortedEntries.push_back(&entry.second);
+        }
+
+        std::sort(sortedEntries.begin(), sortedEntries.end(), [](const ArchiveEntry* a, const ArchiveEntry* b) {
+            return a->name < b->name;
+        });
+
+        std::uint32_t hash = 0;
+
+        for (const ArchiveEntry* entry: sortedEntries)
+        {
+            std::uint8_t values[8];
+            BinaryFormat::writeUInt32(&values[0], entry->crc32);
+            BinaryFormat::writeUInt32(&values[4], static_cast<std::uint32_t>(entry->uncompressedSize));
+
+            hash = BinaryFormat::crc32(
+                    reinterpret_cast<const std::uint8_t*>(entry->name.data()),
+                    entry->name.size(),
+                    hash);
+            hash = BinaryFormat::crc32(values, sizeof(values), hash);
+        }
+
+        return hash;
+    }
+
+    ArchiveEntryData ArchiveReader::read(const std::string& fileName, bool* error) const
+    {
+        const ArchiveEntry* entry = findEntry(fileName);
+
+        if (entry == nullptr)
+        {
+            *error = true;
+            LOGGER_ERROR("Error reading file '" + fileName + "' from archive '" + archivePath_ + "'");
+            return {};
+        }
+
+        return read(*entry, error);
+    }
+
+    ArchiveEntryData ArchiveReader::read(const ArchiveEntry& entry, bool* error) const
+    {
+        ArchiveEntryData entryData{};
+
+        if (prefetcher_ != nullptr)
+        {
+            entryData = prefetcher_->take(archivePath_, entry);
+
+            if (entryData.data != nullptr)
+            {
+                return entryData;
+            }
+        }
+
+        if (entry.isStored())
+        {
+            // Stored entries are served straight out of the mapping, no copy needed
+            entryData.data = bytes_ + entry.dataOffset;
+            entryData.size = entry.uncompressedSize;
+            return entryData;
+        }
+
+        zip_t* handle = acquireHandle();
+
+        if (handle != nullptr && zip_entry_openbyindex(handle, entry.index) == 0)
+        {
+            entryData.buffer = std::shared_ptr<std::uint8_t[]>(new std::uint8_t[entry.uncompressedSize]);
+            entryData.data = entryData.buffer.get();
+            entryData.size = entry.uncompressedSize;
+
+            if (zip_entry_noallocread(handle, entryData.buffer.get(), entryData.size) < 0)
+            {
+                *error = true;
+                entryData = {};
+            }
+
+            zip_entry_close(handle);
+        }
+        else
+        {
+            *error = true;
+        }
+
+        releaseHandle(handle);
+
+        if (*error)
+        {
+            LOGGER_ERROR("Error reading file '" + entry.name + "' from archive '" + archivePath_ + "'");
+        }
+
+        return entryData;
+    }
+
+    std::istream* ArchiveReader::openStream(const std::string& fileName, bool* error) const
+    {
+        ArchiveEntryData entryData = read(fileName, error);
+
+        return *error ? nullptr : new EntryStream(std::move(entryData));
+    }
+
+    void ArchiveReader::setPrefetcher(std::shared_ptr<ArchivePrefetcher> prefetcher)
+    {
+        prefetcher_ = std::move(prefetcher);
+    }
+
+    bool ArchiveReader::mapArchive()
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(
+                archivePath_.c_str(),
+                GENERIC_READ,
+                FILE_SHARE_READ,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL,
+                nullptr);
+
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER fileSize;
+
+            if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+            {
+                HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+                if (mapping != nullptr)
+                {
+                    bytes_ = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                    size_ = bytes_ != nullptr ? static_cast<std::size_t>(fileSize.QuadPart) : 0;
+
+                    // The view keeps the mapping alive on its own
+                    CloseHandle(mapping);
+                }
+            }
+
+            CloseHandle(file);
+        }
+#else
+        std::int32_t file = ::open(archivePath_.c_str(), O_RDONLY);
+
+        if (file >= 0)
+        {
+            struct stat fileStat{};
+
+            if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+            {
+                void* mapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+                if (mapping != MAP_FAILED)
+                {
+                    bytes_ = static_cast<const std::uint8_t*>(mapping);
+                    size_ = static_cast<std::size_t>(fileStat.st_size);
+                }
+            }
+
+            ::close(file);
+        }
+#endif
+
+        if (bytes_ == nullptr)
+        {
+            // Fall back to holding the whole archive in memory
+            std::ifstream input(archivePath_, std::ios::binary);
+
+            if (input.is_open())
+            {
+                fallbackBytes_.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+
+                if (!fallbackBytes_.empty())
+                {
+                    bytes_ = fallbackBytes_.data();
+                    size_ = fallbackBytes_.size();
+                }
+            }
+        }
+
+        return bytes_ != nullptr;
+    }
+
+    bool ArchiveReader::buildIndex()
+    {
+        if (size_ >= CookedFormat::PACK_HEADER_SIZE
+            && std::memcmp(bytes_, CookedFormat::PACK_MAGIC, sizeof(CookedFormat::PACK_MAGIC)) == 0)
+        {
+            return buildPackIndex();
+        }
+
+        if (size_ < END_OF_CENTRAL_DIRECTORY_SIZE)
+        {
+            return false;
+        }
+
+        // The end of central directory record sits at the end of the archive, followed only by an optional comment
+        const std::size_t searchEnd = size_ - END_OF_CENTRAL_DIRECTORY_SIZE;
+        const std::size_t searchStart = searchEnd > MAX_ARCHIVE_COMMENT_SIZE ? searchEnd - MAX_ARCHIVE_COMMENT_SIZE : 0;
+
+        const std::uint8_t* endRecord = nullptr;
+
+        for (std::size_t offset = searchEnd + 1; offset-- > searchStart;)
+        {
+            if (readUInt32(bytes_ + offset) == END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+            {
+                endRecord = bytes_ + offset;
+                break;
+            }
+        }
+
+        if (endRecord == nullptr)
+        {
+            return false;
+        }
+
+        const std::uint16_t entryCount = readUInt16(endRecord + 10);
+        const std::uint32_t directoryOffset = readUInt32(endRecord + 16);
+
+        if (entryCount == 0xFFFF || directoryOffset == 0xFFFFFFFF)
+        {
+            LOGGER_ERROR("Zip64 archives are not supported");
+            return false;
+        }
+
+        std::size_t offset = directoryOffset;
+
+        for (std::uint32_t i = 0; i < entryCount; ++i)
+        {
+            if (offset + CENTRAL_DIRECTORY_HEADER_SIZE > size_
+                || readUInt32(bytes_ + offset) != CENTRAL_DIRECTORY_SIGNATURE)
+            {
+                return false;
+            }
+
+            const std::uint8_t* header = bytes_ + offset;
+            const std::uint16_t nameLength = readUInt16(header + 28);
+            const std::uint16_t extraLength = readUInt16(header + 30);
+            const std::uint16_t commentLength = readUInt16(header + 32);
+            const std::uint32_t localHeaderOffset = readUInt32(header + 42);
+
+            if (offset + CENTRAL_DIRECTORY_HEADER_SIZE + nameLength > size_
+                || localHeaderOffset + LOCAL_HEADER_SIZE > size_
+                || readUInt32(bytes_ + localHeaderOffset) != LOCAL_HEADER_SIGNATURE)
+            {
+                return false;
+            }
+
+            ArchiveEntry entry{};
+            entry.name = std::string((const char*) header + CENTRAL_DIRECTORY_HEADER_SIZE, nameLength);
+            entry.index = i;
+            entry.compressionMethod = readUInt16(header + 10);
+            entry.crc32 = readUInt32(header + 16);
+            entry.compressedSize = readUInt32(header + 20);
+            entry.uncompressedSize = readUInt32(header + 24);
+
+            // The local header's name and extra field lengths can differ from the central directory's
+            const std::uint8_t* localHeader = bytes_ + localHeaderOffset;
+            entry.dataOffset = localHeaderOffset + LOCAL_HEADER_SIZE
+                               + readUInt16(localHeader + 26)
+                               + readUInt16(localHeader + 28);
+
+            if (entry.dataOffset + entry.compressedSize > size_)
+            {
+                return false;
+            }
+
+            entries_.insert(std::pair<std::string, ArchiveEntry>{entry.name, entry});
+
+            offset += CENTRAL_DIRECTORY_HEADER_SIZE + nameLength + extraLength + commentLength;
+        }
+
+        return true;
+    }
+
+    bool ArchiveReader::buildPackIndex()
+    {
+        BinaryFormat::Reader reader{bytes_, size_};
+        reader.readBytes(sizeof(CookedFormat::PACK_MAGIC));
+
+        const std::uint16_t version = reader.readUInt16();
+
+        if (version != CookedFormat::PACK_VERSION)
+        {
+            LOGGER_ERROR("Unsupported asset pack version " + std::to_string(version));
+            return false;
+        }
+
+        reader.readUInt16();
+        const std::uint32_t entryCount = reader.readUInt32();
+        reader.readUInt32();
+
+        for (std::uint32_t i = 0; i < entryCount && !reader.overrun(); ++i)
+        {
+            // Pack entries are never compressed, so every read is served from the mapping
+            ArchiveEntry entry{};
+            entry.name = reader.readString();
+            entry.index = i;
+            entry.dataOffset = reader.readUInt32();
+            entry.uncompressedSize = reader.readUInt32();
+            entry.compressedSize = entry.uncompressedSize;
+            entry.crc32 = reader.readUInt32();
+
+            if (entry.dataOffset + entry.uncompressedSize > size_)
+            {
+                return false;
+            }
+
+            entries_.insert(std::pair<std::string, ArchiveEntry>{entry.name, entry});
+        }
+
+        return !reader.overrun();
+    }
+
+    zip_t* ArchiveReader::acquireHandle() const
+    {
+        {
+            std::unique_lock<std::mutex> mlock(handleMutex_);
+
+            if (!idleHandles_.empty())
+            {
+                zip_t* handle = idleHandles_.back();
+                idleHandles_.pop_back();
+                return handle;
+            }
+        }
+
+        // Handles read from the existing mapping, so opening another one costs no extra I/O
+        return zip_stream_open(reinterpret_cast<const char*>(bytes_), size_, 0, 'r');
+    }
+
+    void ArchiveReader::releaseHandle(zip_t* handle) const
+    {
+        if (handle != nullptr)
+        {
+            std::unique_lock<std::mutex> mlock(handleMutex_);
+            idleHandles_.push_back(handle);
+        }
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct zip_t;
+
+namespace PB
+{
+    class ArchivePrefetcher;
+
+    /**
+     * \brief Location and size details of a single file within an archive, read from the archive's
+     * central directory.
+     */
+    struct ArchiveEntry
+    {
+        std::string name;
+        std::uint32_t index = 0;
+        std::uint16_t compressionMethod = 0;
+        std::uint32_t crc32 = 0;
+        std::uint64_t compressedSize = 0;
+        std::uint64_t uncompressedSize = 0;
+        /** Offset of the entry's data in the archive, past its local header */
+        std::uint64_t dataOffset = 0;
+
+        bool isStored() const
+        {
+            return compressionMethod == 0;
+        };
+    };
+
+    /**
+     * \brief Contents of an archive entry.
+     *
+     * <p>Stored (uncompressed) entries are views directly into the mapped archive and hold no buffer,
+     * compressed entries own the buffer they were inflated into.  Either way the data stays valid for
+     * as long as the {\link ArchiveEntryData} and the {\link ArchiveReader} it came from.</p>
+     */
+    struct ArchiveEntryData
+    {
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+        std::shared_ptr<std::uint8_t[]> buffer{};
+    };
+
+    /**
+     * \brief Keeps a single archive open and memory mapped for its lifetime, serving reads of its
+     * entries from an index built once when the archive is opened.
+     *
+     * <p>Both zip archives and cooked asset packs (see {\link CookedFormat.h}) are supported, told apart
+     * by their contents.  Reads are positional and may be made from multiple threads at once.</p>
+     */
+    class ArchiveReader
+    {
+    public:
+        ArchiveReader() = default;
+
+        ArchiveReader(const ArchiveReader&) = delete;
+
+        ArchiveReader& operator=(const ArchiveReader&) = delete;
+
+        ~ArchiveReader();
+
+        /**
+         * \brief Maps the given archive into memory and indexes its entries.
+         *
+         * \param archivePath The path to the archive to open.
+         * \return True if the archive was opened and indexed successfully, False otherwise.
+         */
+        bool open(const std::string& archivePath);
+
+        /**
+         * \brief Releases the archive mapping and any cached decompression handles.
+         */
+        void close();
+
+        /**
+         * \brief Checks if the archive is currently open.
+         *
+         * \return True if the archive is open, False otherwise.
+         */
+        bool isOpen() const;
+
+        /**
+         * \brief Gets the index of all entries in the archive, keyed by their file name.
+         *
+         * \return The index of all entries in the archive.
+         */
+        const std::unordered_map<std::string, ArchiveEntry>& entries() const;
+
+        /**
+         * \brief Finds the index entry for the given file name.
+         *
+         * \param fileName The name of the file within the archive.
+         * \return The entry for the file, or nullptr if the archive has no such file.
+         */
+        const ArchiveEntry* findEntry(const std::string& fileName) const;
+
+        /**
+         * \brief Hashes the names, sizes and CRCs of every entry, which changes whenever the contents of
+         * the archive do.
+         *
+         * \return The hash of the archive's contents.
+         */
+        std::uint32_t contentHash() const;
+
+        /**
+         * \brief Reads the contents of the given file.
+         *
+         * \param fileName The name of the file within the archive.
+         * \param error    Flag indicating an error occurred if set to True.
+         * \return The contents of the file, or empty data if an error occurred.
+         */
+        ArchiveEntryData read(const std::string& fileName, bool* error) const;
+
+        /**
+         * \brief Reads the contents of the given entry.
+         *
+         * \param entry The index entry of the file to read.
+         * \param error Flag indicating an error occurred if set to True.
+         * \return The contents of the file, or empty data if an error occurred.
+         */
+        ArchiveEntryData read(const ArchiveEntry& entry, bool* error) const;
+
+        /**
+         * \brief Creates a stream over the contents of the given file, the stream keeps the
+         * contents alive and must be deleted by the caller.
+         *
+         * \param fileName The name of the file within the archive.
+         * \param error    Flag indicating an error occurred if set to True.
+         * \return A stream over the file's contents, or nullptr if an error occurred.
+         */
+        std::istream* openStream(const std::string& fileName, bool* error) const;
+
+        /**
+         * \brief Hands reads to the given prefetcher, which records them and serves those it read ahead.
+         *
+         * \param prefetcher The prefetcher to hand reads to.
+         */
+        void setPrefetcher(std::shared_ptr<ArchivePrefetcher> prefetcher);
+
+    private:
+        bool mapArchive();
+
+        bool buildIndex();
+
+        /**
+         * \brief Indexes a cooked asset pack (see {\link CookedFormat.h}) instead of a zip archive.
+         */
+        bool buildPackIndex();
+
+        zip_t* acquireHandle() const;
+
+        void releaseHandle(zip_t* handle) const;
+
+    private:
+        std::string archivePath_;
+        const std::uint8_t* bytes_ = nullptr;
+        std::size_t size_ = 0;
+        /** Only used if the archive could not be memory mapped */
+        std::vector<std::uint8_t> fallbackBytes_{};
+        std::unordered_map<std::string, ArchiveEntry> entries_{};
+        std::shared_ptr<ArchivePrefetcher> prefetcher_{};
+        /** Idle decompression handles, each reader thread checks one out for the duration of a read */
+        mutable std::mutex handleMutex_;
+        mutable std::vector<zip_t*> idleHandles_{};
+    };
+}
@@ -1,3 +1,4 @@
+#include <chrono>
 #include <utility>
 
 #include <STBI/stb_image.h>
@@ -5,37 +6,18 @@
 #include "puppetbox/IAnimationCatalogue.h"
 
 #include "AnimationCatalogue.h"
+#include "AnimationClipFormat.h"
 #include "AssetArchive.h"
+#include "CookedAssets.h"
+#include "CookedFormat.h"
 #include "GfxMath.h"
+#include "MeshFormat.h"
 #include "PropertyTree.h"
 
 namespace PB
 {
     namespace
     {
-        /**
-         * \brief Maps an input stream to a {\link SizedArray}.
-         *
-         * \param stream The stream to read from.
-         * \return A {\link SizedArray} loaded with the given stream data.
-         */
-        SizedArray<std::uint8_t> mapStreamToByteArray(std::istream* stream)
-        {
-            SizedArray<std::uint8_t> bytes{};
-
-            stream->seekg(0, std::istream::end);
-            bytes.length = stream->tellg();
-            stream->seekg(0, std::istream::beg);
-
-            char* buffer = new char[bytes.length];
-
-            stream->read(buffer, bytes.length);
-
-            bytes.array = (std::uint8_t*) buffer;
-
-            return bytes;
-        }
-
         /**
          * Checks the given {\link PropertyTree} for the given node, returning it's value
          * in a {\link Result} object (or an empty {\link Result} if not found).
@@ -53,7 +35,7 @@ namespace PB
 
             if (propertyNode.hasResult && !propertyNode.result->value().empty())
             {
-                result = {propertyNode.result->value(), true};
+                result = {std::string(propertyNode.result->value()), true};
             }
             else
             {
@@ -79,11 +61,11 @@ namespace PB
 
             if (propertyNode.hasResult && !propertyNode.result->value().empty())
             {
-                T value = NumberUtils::parseValue(propertyNode.result->value().c_str(), (T) 0, error);
+                T value = NumberUtils::parseValue(propertyNode.result->value(), (T) 0, error);
 
                 if (*error)
                 {
-                    LOGGER_ERROR("Could not parse value '" + propertyNode.result->value() + "' as float");
+                    LOGGER_ERROR("Could not parse value '" + std::string(propertyNode.result->value()) + "' as float");
                 }
 
                 result = {value, !*error};
@@ -153,14 +135,14 @@ namespace PB
 
                 if (dataNode.hasResult)
                 {
-                    model.mesh.dataPath = dataNode.result->value();
+                    model.mesh.dataPath = std::string(dataNode.result->value());
                 }
 
                 auto materialNode = meshProperties->get("material");
 
                 if (materialNode.hasResult)
                 {
-                    model.mesh.materialPath = materialNode.result->value();
+                    model.mesh.materialPath = std::string(materialNode.result->value());
 
                     auto meshOffsetNode = meshProperties->get("offset");
 
@@ -202,7 +184,7 @@ namespace PB
                 }
             }
 
-            model.name = rootProperties.name();
+            model.name = std::string(rootProperties.name());
 
             auto rootChildrenNode = rootProperties.get("children");
 
@@ -210,11 +192,10 @@ namespace PB
             {
                 PropertyTree* childrenProperties = rootChildrenNode.result;
 
-                for (auto& childName: childrenProperties->children())
+                for (PropertyTree* child = childrenProperties->firstChild(); child != nullptr;
+                     child = child->nextSibling())
                 {
-                    ModelData child = mapToModelData(*childrenProperties->get(childName).result, error);
-
-                    model.children.push_back(child);
+                    model.children.push_back(mapToModelData(*child, error));
                 }
             }
 
@@ -276,7 +257,7 @@ namespace PB
         {
             RawKeyframe keyframe{};
 
-            keyframe.boneName = pTree->name();
+            keyframe.boneName = std::string(pTree->name());
 
             auto positionNode = pTree->get("position");
 
@@ -320,22 +301,21 @@ namespace PB
         {
             std::vector<RawKeyframe> keyframes{};
 
-            for (auto& childName: pTree->children())
+            keyframes.reserve(pTree->childCount());
+
+            for (PropertyTree* child = pTree->firstChild(); child != nullptr && !*error; child = child->nextSibling())
             {
-                if (!*error)
-                {
-                    RawKeyframe keyframe = mapToKeyframe(pTree->get(childName).result, error);
+                RawKeyframe keyframe = mapToKeyframe(child, error);
 
-                    keyframe.frameIndex = frameIndex;
+                keyframe.frameIndex = frameIndex;
 
-                    if (!*error)
-                    {
-                        keyframes.push_back(keyframe);
-                    }
-                    else
-                    {
-                        LOGGER_ERROR("Invalid keyframe data for bone '" + childName + "'");
-                    }
+                if (!*error)
+                {
+                    keyframes.push_back(keyframe);
+                }
+                else
+                {
+                    LOGGER_ERROR("Invalid keyframe data for bone '" + std::string(child->name()) + "'");
                 }
             }
 
@@ -346,25 +326,24 @@ namespace PB
         {
             std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> keyframes{};
 
-            if (!pTree->children().empty())
+            if (!pTree->isLeaf())
             {
-                for (auto& childName: pTree->children())
+                for (PropertyTree* child = pTree->firstChild(); child != nullptr && !*error;
+                     child = child->nextSibling())
                 {
+                    std::uint8_t frameIndex = NumberUtils::parseValue(child->name(), 0, error);
+
                     if (!*error)
                     {
-                        std::uint8_t frameIndex = NumberUtils::parseValue(childName.c_str(), 0, error);
-
-                        if (!*error)
-                        {
-                            auto keyframeVector = mapToKeyframeVector(pTree->get(childName).result, frameIndex, error);
-                            keyframes.insert(
-                                    std::pair<std::uint8_t, std::vector<RawKeyframe>>{frameIndex, keyframeVector}
-                            );
-                        }
-                        else
-                        {
-                            LOGGER_ERROR("Failed to parse data for keyframe '" + childName + "'");
-                        }
+                        keyframes.insert(
+                                std::pair<std::uint8_t, std::vector<RawKeyframe>>{
+                                        frameIndex,
+                                        mapToKeyframeVector(child, frameIndex, error)}
+                        );
+                    }
+                    else
+                    {
+                        LOGGER_ERROR("Failed to parse data for keyframe '" + std::string(child->name()) + "'");
                     }
                 }
             }
@@ -402,6 +381,281 @@ namespace PB
             return shaderProgram;
         }
 
+        /**
+         * \brief Checks if the given file name ends with the given extension, used to detect compiled
+         * binary asset formats.
+         *
+         * \param fileName  The file name to check.
+         * \param extension The extension to check for, including the leading '.'.
+         * \return True if the file name has the extension, False otherwise.
+         */
+        bool hasFileExtension(const std::string& fileName, const std::string& extension)
+        {
+            return fileName.size() > extension.size()
+                   && fileName.compare(fileName.size() - extension.size(), extension.size(), extension) == 0;
+        }
+
+        /**
+         * \brief Decodes a binary animation clip (see {\link AnimationClipFormat.h}) into keyframes.
+         *
+         * \param bytes      The bytes of the clip.
+         * \param length     The number of bytes in the clip.
+         * \param fps        Set to the frames per second of the clip.
+         * \param frameCount Set to the number of frames in the clip.
+         * \param error      Flag indicating an error occurred if set to True.
+         *
+         * \return The decoded keyframes, keyed by frame index.
+         */
+        std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> mapBytesToAnimationClip(
+                const std::uint8_t* bytes,
+                std::size_t length,
+                std::uint8_t* fps,
+                std::uint8_t* frameCount,
+                bool* error)
+        {
+            std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> keyframes{};
+
+            if (length < AnimationClip::HEADER_SIZE
+                || std::memcmp(bytes, AnimationClip::MAGIC, sizeof(AnimationClip::MAGIC)) != 0)
+            {
+                *error = true;
+                LOGGER_ERROR("Invalid animation clip header");
+                return keyframes;
+            }
+
+            const std::uint16_t version = AnimationClip::readUInt16(bytes + 4);
+
+            if (version != AnimationClip::VERSION)
+            {
+                *error = true;
+                LOGGER_ERROR("Unsupported animation clip version " + std::to_string(version));
+                return keyframes;
+            }
+
+            *fps = bytes[6];
+            *frameCount = bytes[7];
+            const std::uint16_t boneCount = AnimationClip::readUInt16(bytes + 8);
+            const std::uint32_t keyframeCount = AnimationClip::readUInt32(bytes + 10);
+            const float steps[3] = {
+                    AnimationClip::readFloat(bytes + 14),
+                    AnimationClip::readFloat(bytes + 18),
+                    AnimationClip::readFloat(bytes + 22)
+            };
+
+            std::size_t offset = AnimationClip::HEADER_SIZE;
+
+            std::vector<std::string> boneNames{};
+            boneNames.reserve(boneCount);
+
+            for (std::uint16_t i = 0; i < boneCount && !*error; ++i)
+            {
+                if (offset < length && offset + 1 + bytes[offset] <= length)
+                {
+                    boneNames.emplace_back((const char*) (bytes + offset + 1), bytes[offset]);
+                    offset += 1 + bytes[offset];
+                }
+                else
+                {
+                    *error = true;
+                    LOGGER_ERROR("Animation clip bone table is truncated");
+                }
+            }
+
+            for (std::uint32_t i = 0; i < keyframeCount && !*error; ++i)
+            {
+                if (offset + AnimationClip::KEYFRAME_HEADER_SIZE > length)
+                {
+                    *error = true;
+                    LOGGER_ERROR("Animation clip keyframes are truncated");
+                    break;
+                }
+
+                const std::uint8_t frameIndex = bytes[offset];
+                const std::uint16_t boneIndex = AnimationClip::readUInt16(bytes + offset + 1);
+                const std::uint16_t channels = AnimationClip::readUInt16(bytes + offset + 3);
+                offset += AnimationClip::KEYFRAME_HEADER_SIZE;
+
+                if (boneIndex >= boneNames.size()
+                    || offset + (AnimationClip::channelCount(channels) * 2) > length)
+                {
+                    *error = true;
+                    LOGGER_ERROR("Invalid animation clip keyframe for frame " + std::to_string(frameIndex));
+                    break;
+                }
+
+                RawKeyframe keyframe{};
+                keyframe.frameIndex = frameIndex;
+                keyframe.boneName = boneNames[boneIndex];
+
+                // Ordered to match the channel bits
+                Result<float>* components[AnimationClip::CHANNEL_COUNT] = {
+                        &keyframe.rotation.x, &keyframe.rotation.y, &keyframe.rotation.z,
+                        &keyframe.scale.x, &keyframe.scale.y, &keyframe.scale.z,
+                        &keyframe.position.x, &keyframe.position.y, &keyframe.position.z
+                };
+
+                for (std::uint32_t channel = 0; channel < AnimationClip::CHANNEL_COUNT; ++channel)
+                {
+                    if (channels & (1 << channel))
+                    {
+                        Result<float>& component = *components[channel];
+                        component.result = AnimationClip::dequantize(
+                                AnimationClip::readInt16(bytes + offset),
+                                steps[channel / 3]);
+                        component.hasResult = true;
+                        offset += 2;
+                    }
+                }
+
+                keyframes[frameIndex].push_back(keyframe);
+            }
+
+            return keyframes;
+        }
+
+        /**
+         * \brief Maps a binary mesh (see {\link MeshFormat.h}) onto a {\link MeshFormat::MeshBuffer} that
+         * views the given bytes in place, validating that the layout and data fit within them.
+         *
+         * \param bytes  The bytes of the mesh.
+         * \param length The number of bytes in the mesh.
+         * \param error  Flag indicating an error occurred if set to True.
+         *
+         * \return The mesh buffer viewing the given bytes.
+         */
+        MeshFormat::MeshBuffer mapBytesToMeshBuffer(const std::uint8_t* bytes, std::size_t length, bool* error)
+        {
+            MeshFormat::MeshBuffer buffer{};
+
+            if (length < MeshFormat::HEADER_SIZE
+                || std::memcmp(bytes, MeshFormat::MAGIC, sizeof(MeshFormat::MAGIC)) != 0)
+            {
+                *error = true;
+                LOGGER_ERROR("Invalid mesh header");
+                return buffer;
+            }
+
+            const std::uint16_t version = BinaryFormat::readUInt16(bytes + 4);
+
+            if (version != MeshFormat::VERSION)
+            {
+                *error = true;
+                LOGGER_ERROR("Unsupported mesh version " + std::to_string(version));
+                return buffer;
+            }
+
+            const std::uint8_t attributeCount = bytes[6];
+            const std::uint8_t indexSize = bytes[7];
+            const std::uint32_t vertexCount = BinaryFormat::readUInt32(bytes + 8);
+            const std::uint32_t vertexStride = BinaryFormat::readUInt32(bytes + 12);
+            const std::uint32_t indexCount = BinaryFormat::readUInt32(bytes + 16);
+            const std::uint32_t vertexDataOffset = BinaryFormat::readUInt32(bytes + 20);
+            const std::uint32_t indexDataOffset = BinaryFormat::readUInt32(bytes + 24);
+
+            const std::uint64_t vertexDataSize = static_cast<std::uint64_t>(vertexCount) * vertexStride;
+            const std::uint64_t indexDataSize = static_cast<std::uint64_t>(indexCount) * indexSize;
+
+            if ((indexSize != 0 && indexSize != 2 && indexSize != 4)
+                || (indexSize == 0 && indexCount != 0)
+                || MeshFormat::HEADER_SIZE + (attributeCount * MeshFormat::ATTRIBUTE_SIZE) > vertexDataOffset
+                || vertexDataOffset + vertexDataSize > length
+                || (indexCount != 0 && (indexDataOffset < vertexDataOffset + vertexDataSize
+                                        || indexDataOffset + indexDataSize > length)))
+            {
+                *error = true;
+                LOGGER_ERROR("Incomplete/Corrupt mesh layout");
+                return buffer;
+            }
+
+            std::size_t offset = MeshFormat::HEADER_SIZE;
+
+            for (std::uint8_t i = 0; i < attributeCount; ++i)
+            {
+                MeshFormat::VertexAttribute attribute{};
+                attribute.location = bytes[offset];
+                attribute.componentType = static_cast<MeshFormat::ComponentType>(bytes[offset + 1]);
+                attribute.componentCount = bytes[offset + 2];
+                attribute.normalized = bytes[offset + 3] != 0;
+                attribute.offset = BinaryFormat::readUInt32(bytes + offset + 4);
+                offset += MeshFormat::ATTRIBUTE_SIZE;
+
+                const std::uint32_t attributeSize =
+                        MeshFormat::componentSize(attribute.componentType) * attribute.componentCount;
+
+                if (attributeSize == 0 || attribute.componentCount > 4
+                    || attribute.offset + attributeSize > vertexStride)
+                {
+                    *error = true;
+                    LOGGER_ERROR("Invalid mesh vertex attribute at location " + std::to_string(attribute.location));
+                    return buffer;
+                }
+
+                buffer.attributes.push_back(attribute);
+            }
+
+            buffer.vertexCount = vertexCount;
+            buffer.vertexStride = vertexStride;
+            buffer.vertexData = bytes + vertexDataOffset;
+            buffer.indexCount = indexCount;
+            buffer.indexSize = indexSize;
+            buffer.indexData = indexCount != 0 ? bytes + indexDataOffset : nullptr;
+
+            return buffer;
+        }
+
+        /**
+         * \brief Maps a cooked texture (see {\link CookedFormat.h}) to an {\link ImageData} object, copying
+         * its pixels and mip chain into a newly allocated buffer.
+         *
+         * \param bytes  The bytes of the cooked texture.
+         * \param length The number of bytes in the cooked texture.
+         * \param error  Flag indicating an error occurred if set to True.
+         *
+         * \return The {\link ImageData} object read from the given bytes.
+         */
+        ImageData mapBytesToImageData(const std::uint8_t* bytes, std::size_t length, bool* error)
+        {
+            ImageData data{nullptr};
+            BinaryFormat::Reader reader{bytes, length};
+
+            if (!CookedFormat::readHeader(reader, CookedFormat::TEXTURE_MAGIC))
+            {
+                *error = true;
+                LOGGER_ERROR("Invalid cooked texture header");
+                return data;
+            }
+
+            const std::uint32_t width = reader.readUInt32();
+            const std::uint32_t height = reader.readUInt32();
+            const std::uint32_t channels = reader.readUInt32();
+            const std::uint32_t mipLevels = reader.readUInt32();
+
+            const bool validLayout = !reader.overrun() && width != 0 && height != 0 && width <= UINT16_MAX
+                                     && height <= UINT16_MAX && (channels == 3 || channels == 4)
+                                     && mipLevels != 0 && mipLevels <= 32;
+            const std::uint64_t size = validLayout
+                                       ? CookedFormat::mipChainSize(width, height, channels, mipLevels)
+                                       : 0;
+            const std::uint8_t* pixels = validLayout && size <= reader.remaining() ? reader.readBytes(size) : nullptr;
+
+            if (pixels == nullptr)
+            {
+                *error = true;
+                LOGGER_ERROR("Incomplete/Corrupt cooked texture");
+                return data;
+            }
+
+            // Matches stb_image's allocation, so the buffer is released the same way
+            data.bufferData = static_cast<std::uint8_t*>(malloc(size));
+            std::copy(pixels, pixels + size, data.bufferData);
+            data.width = static_cast<std::int32_t>(width);
+            data.height = static_cast<std::int32_t>(height);
+            data.numChannels = static_cast<std::int32_t>(channels);
+            data.mipLevels = static_cast<std::int32_t>(mipLevels);
+
+            return data;
+        }
+
         /**
         * \brief Helper function to acquire the filename associated with the given virtual asset path.
         *
@@ -439,39 +693,54 @@ namespace PB
         }
 
         /**
-        * \brief Helper function that create a property map from a stream object.  Assumes whitespace
-        * delimited key-value pairs within the stream.
+        * \brief Views the contents of an archive entry as text, without copying it.
+        *
+        * \param entryData The archive entry contents.
+        *
+        * \return A view of the entry's contents.
+        */
+        std::string_view asText(const ArchiveEntryData& entryData)
+        {
+            return {reinterpret_cast<const char*>(entryData.data), entryData.size};
+        }
+
+        /**
+        * \brief Helper function that create a property map from text.  Assumes whitespace
+        * delimited key-value pairs, one per line.
         *
-        * \param stream		The stream to read key-value pair data from.
+        * \param text		The text to read key-value pair data from.
         * \param properties	Pointer to the unordered_map to store parsed properties in.
         *
-        * \return True if the properties were successfully read from the stream, False otherwise.
+        * \return True if the properties were successfully read from the text, False otherwise.
         */
-        bool getPropertiesFromStream(std::istream* stream, std::unordered_map<std::string, std::string>* properties)
+        bool getPropertiesFromText(std::string_view text, std::unordered_map<std::string, std::string>* properties)
         {
-            std::string line;
             std::uint32_t lineNumber = 0;
 
-            while (std::getline(*stream, line))
+            while (!text.empty())
             {
+                std::string_view line = StringUtils::nextLine(&text);
                 lineNumber++;
-                StringUtils::trim(&line);
 
-                std::string* splitValues;
-                std::uint32_t splitCount;
+                std::string_view remaining = line;
+                std::string_view key = StringUtils::nextToken(&remaining);
+                std::string_view value = StringUtils::nextToken(&remaining);
 
-                StringUtils::split(line, &splitValues, &splitCount);
+                if (key.empty())
+                {
+                    continue;
+                }
 
-                if (splitCount == 2)
+                if (!value.empty() && StringUtils::nextToken(&remaining).empty())
                 {
                     properties->insert(
-                            std::pair<std::string, std::string>(splitValues[0], splitValues[1])
+                            std::pair<std::string, std::string>(key, value)
                     );
                 }
                 else
                 {
-                    LOGGER_ERROR(
-                            "Invalid property data in stream '" + line + "' on line " + std::to_string(lineNumber));
+                    LOGGER_ERROR("Invalid property data '" + std::string(line) + "' on line "
+                                 + std::to_string(lineNumber));
                     return false;
                 }
             }
@@ -479,150 +748,89 @@ namespace PB
             return true;
         }
 
-        /**
-        * \brief Helper function to count the indentation level of the given string.
-        *
-        * \param line	The string to calculate the indentation level for.
-        *
-        * \return The number of indentations prefixed on the given string.
-        */
-        std::uint32_t countIndents(const std::string& line)
+        double elapsedMilliseconds(std::chrono::steady_clock::time_point start)
         {
-            std::uint32_t indentCount = 0;
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
 
-            for (std::size_t i = 0; i < line.length() && line.c_str()[i] == ' '; ++i)
-            {
-                indentCount++;
-            }
+        std::unordered_map<std::string, std::string> decodeManifest(
+                const std::uint8_t* bytes,
+                std::size_t length,
+                bool* error)
+        {
+            std::unordered_map<std::string, std::string> assetIds{};
+            *error = !CookedAssets::decodeStringPairs(bytes, length, CookedFormat::MANIFEST_MAGIC, assetIds);
+            return assetIds;
+        }
+
+        std::vector<std::uint8_t> encodeManifest(const std::unordered_map<std::string, std::string>& assetIds)
+        {
+            return CookedAssets::encodeStringPairs(CookedFormat::MANIFEST_MAGIC, assetIds);
+        }
 
-            return indentCount;
+        std::unordered_map<std::string, std::string> decodeAnimationSet(
+                const std::uint8_t* bytes,
+                std::size_t length,
+                bool* error)
+        {
+            std::unordered_map<std::string, std::string> animations{};
+            *error = !CookedAssets::decodeStringPairs(bytes, length, CookedFormat::ANIMATION_SET_MAGIC, animations);
+            return animations;
+        }
+
+        std::vector<std::uint8_t> encodeAnimationSet(const std::unordered_map<std::string, std::string>& animations)
+        {
+            return CookedAssets::encodeStringPairs(CookedFormat::ANIMATION_SET_MAGIC, animations);
         }
 
         /**
-        * \brief Helper function that attempts to parse the given stream into a PropertyTree.
+        * \brief Loads a text asset through the archive's parsed asset cache, decoding its cached form if there
+        * is one, otherwise parsing it and caching the result.
         *
-        * \param stream		The stream of data to parse.
-        * \param root		The root of the PropertyTree to parse the data into.
+        * \param cache		The parsed asset cache of the archive, or nullptr to always parse.
+        * \param fileName	The name of the source file within the archive.
+        * \param parse		Parses the source file, setting the given flag if an error occurred.
+        * \param decode	Decodes the asset from its cached form, setting the given flag if an error occurred.
+        * \param encode	Encodes the asset to its cached form.
+        * \param error		Flag indicating an error occurred if set to True.
         *
-        * \return True if the data was successfully parsed, False otherwise.
+        * \return The loaded asset.
         */
-        bool getPropertyTreeFromStream(std::istream* stream, PropertyTree* root)
+        template<typename Parse, typename Decode, typename Encode>
+        auto loadThroughCache(
+                ParsedAssetCache* cache,
+                const std::string& fileName,
+                Parse parse,
+                Decode decode,
+                Encode encode,
+                bool* error)
         {
-            bool success = true;
-            std::string line;
-            std::uint32_t lineNumber = 0;
-            PropertyTree* currentNode = root;
-            std::uint32_t indentLevel;
-            std::uint32_t minIndents = 0;
-            std::uint32_t maxIndents = 0;
+            auto start = std::chrono::steady_clock::now();
+            ArchiveEntryData cached = cache != nullptr ? cache->find(fileName) : ArchiveEntryData{};
 
-            while (std::getline(*stream, line))
+            if (cached.data != nullptr)
             {
-                lineNumber++;
-                indentLevel = countIndents(line);
-                line = StringUtils::trim(line);
+                bool cacheError = false;
+                auto asset = decode(cached.data, cached.size, &cacheError);
 
-                if (indentLevel % 2 == 0)
+                if (!cacheError)
                 {
-                    if (indentLevel >= minIndents && indentLevel <= maxIndents)
-                    {
-                        bool isList;
-
-                        if (StringUtils::startsWith(line, "-"))
-                        {
-                            isList = true;
-                            line = StringUtils::ltrim(line.substr(1));
-                        }
-                        else
-                        {
-                            isList = false;
-                        }
-                        if (indentLevel < maxIndents)
-                        {
-                            if (isList)
-                            {
-                                success = false;
-                                LOGGER_ERROR(
-                                        "Unexpected list item '" + line + "' on line " + std::to_string(lineNumber));
-                            }
-                            else
-                            {
-                                for (std::uint32_t i = maxIndents; i > indentLevel; i -= 2)
-                                {
-                                    currentNode = currentNode->parent();
-                                }
-                            }
-                        }
+                    cache->recordHit(fileName, elapsedMilliseconds(start));
+                    return asset;
+                }
 
-                        if (success)
-                        {
-                            if (isList)
-                            {
-                                currentNode->add(line);
-                                minIndents = 0;
-                                maxIndents = indentLevel;
-                            }
-                            else
-                            {
-                                std::string* splitValues;
-                                std::uint32_t splitCount;
+                LOGGER_WARN("Cached form of '" + fileName + "' is corrupt, parsing it again");
+                start = std::chrono::steady_clock::now();
+            }
 
-                                StringUtils::split(line, ":", 1, &splitValues, &splitCount);
+            auto asset = parse(error);
 
-                                if (splitCount == 2)
-                                {
-                                    StringUtils::rtrim(&splitValues[0]);
-                                    StringUtils::ltrim(&splitValues[1]);
-
-                                    if (splitValues[1].empty())
-                                    {
-                                        minIndents = indentLevel + 2;
-                                        maxIndents = minIndents;
-
-                                        if (currentNode->add(splitValues[0]))
-                                        {
-                                            currentNode = currentNode->get(splitValues[0]).result;
-                                        }
-                                    }
-                                    else
-                                    {
-                                        minIndents = 0;
-                                        maxIndents = indentLevel;
-
-                                        if (currentNode->add(splitValues[0]))
-                                        {
-                                            currentNode->get(splitValues[0]).result->add(splitValues[1]);
-                                        }
-                                        else
-                                        {
-                                            LOGGER_WARN("Property redefinition, '" + splitValues[0] + "' on line " +
-                                                        std::to_string(lineNumber));
-                                        }
-                                    }
-                                }
-                                else
-                                {
-                                    LOGGER_ERROR("Invalid data '" + line + "' on line " + std::to_string(lineNumber));
-                                    return false;
-                                }
-                            }
-                        }
-                    }
-                    else
-                    {
-                        LOGGER_ERROR("Unexpected indentation '" + line + "' on line " + std::to_string(lineNumber));
-                        return false;
-                    }
-                }
-                else
-                {
-                    LOGGER_ERROR(
-                            "Invalid indentation (odd spaces) '" + line + "' on line " + std::to_string(lineNumber));
-                    return false;
-                }
+            if (cache != nullptr && !*error)
+            {
+                cache->store(fileName, encode(asset), elapsedMilliseconds(start));
             }
 
-            return true;
+            return asset;
         }
     }
 
@@ -630,18 +838,71 @@ namespace PB
     {
         bool success;
 
-        success = FileUtils::getFileListFromArchive(archivePath(), &archiveAssets_);
+        cooked_ = allowCooked_
+                  && std::ifstream(archiveRoot_ + archiveName_ + CookedFormat::PACK_EXTENSION).good();
+
+        reader_ = std::make_shared<ArchiveReader>();
+        success = reader_->open(archivePath());
+
+        if (success)
+        {
+            reader_->setPrefetcher(prefetcher_);
+
+            for (auto& entry: reader_->entries())
+            {
+                archiveAssets_.insert(entry.first);
+            }
+        }
+
+        if (cooked_)
+        {
+            bool error = !success;
+            ArchiveEntryData manifest = error ? ArchiveEntryData{} : reader_->read(CookedFormat::MANIFEST_FILE, &error);
+
+            success = !error && CookedAssets::decodeStringPairs(
+                    manifest.data,
+                    manifest.size,
+                    CookedFormat::MANIFEST_MAGIC,
+                    archiveAssetIds_);
+        }
+        else
+        {
+            bool error = !success;
+
+            if (!error)
+            {
+                if (useCache_)
+                {
+                    cache_ = std::make_shared<ParsedAssetCache>(
+                            archiveRoot_ + archiveName_ + CookedFormat::CACHE_EXTENSION,
+                            reader_);
+                    cache_->load();
+                }
 
-        std::istream* stream = nullptr;
-        success = success && FileUtils::getStreamFromArchivedFile(archivePath(), ".manifest", &stream);
-        success = success && getPropertiesFromStream(stream, &archiveAssetIds_);
+                archiveAssetIds_ = loadThroughCache(
+                        cache_.get(),
+                        ".manifest",
+                        [&](bool* parseError) {
+                            std::unordered_map<std::string, std::string> assetIds{};
+                            ArchiveEntryData manifest = reader_->read(".manifest", parseError);
+
+                            *parseError = *parseError || !getPropertiesFromText(asText(manifest), &assetIds);
+
+                            return assetIds;
+                        },
+                        decodeManifest,
+                        encodeManifest,
+                        &error);
+            }
+
+            success = !error;
+        }
 
         if (!success)
         {
             LOGGER_ERROR("Failed to initialize archive");
         }
 
-        delete stream;
         return success;
     }
 
@@ -655,6 +916,44 @@ namespace PB
         return archiveAssets_.size();
     }
 
+    bool AssetArchive::isCooked() const
+    {
+        return cooked_;
+    }
+
+    std::vector<std::string> AssetArchive::assetIds() const
+    {
+        std::vector<std::string> ids{};
+        ids.reserve(archiveAssetIds_.size());
+
+        for (auto& entry: archiveAssetIds_)
+        {
+            ids.push_back(entry.first);
+        }
+
+        return ids;
+    }
+
+    std::string AssetArchive::assetFileName(const std::string& assetPath)
+    {
+        return fileNameOfAsset(assetPath, archiveAssetIds_, archiveAssets_);
+    }
+
+    ArchiveEntryData AssetArchive::loadAssetData(const std::string& assetPath, bool* error)
+    {
+        std::string fileName = fileNameOfAsset(assetPath, archiveAssetIds_, archiveAssets_);
+
+        if (hasAsset(fileName))
+        {
+            return reader_->read(fileName, error);
+        }
+
+        *error = true;
+        LOGGER_ERROR("Failed to retrieve asset '" + assetPath + "'");
+
+        return {};
+    }
+
     std::string AssetArchive::loadAsciiData(const std::string& assetPath, bool* error)
     {
         std::string data;
@@ -662,17 +961,12 @@ namespace PB
 
         if (hasAsset(fileName))
         {
-            std::int8_t* buffer = nullptr;
-            std::size_t bufferSize = 0;
-
-            *error = *error || !FileUtils::getContentsFromArchivedFile(archivePath(), fileName, &buffer, &bufferSize);
+            ArchiveEntryData entryData = reader_->read(fileName, error);
 
             if (!*error)
             {
-                data = std::string((char*) buffer, bufferSize);
+                data = std::string((const char*) entryData.data, entryData.size);
             }
-
-            delete buffer;
         }
         else
         {
@@ -689,20 +983,36 @@ namespace PB
 
         std::string fileName = fileNameOfAsset(assetPath, archiveAssetIds_, archiveAssets_);
 
-        if (hasAsset(fileName))
+        if (hasAsset(fileName) && hasFileExtension(fileName, CookedFormat::SHADER_EXTENSION))
         {
-            std::istream* stream = nullptr;
+            ArchiveEntryData entryData = reader_->read(fileName, error);
 
-            PropertyTree propertyData{"shader"};
+            if (!*error)
+            {
+                ShaderProgram program = CookedAssets::decodeShaderProgram(entryData.data, entryData.size, error);
+                program.programPath = assetPath;
+                return program;
+            }
+        }
+        else if (hasAsset(fileName))
+        {
+            ShaderProgram program = loadThroughCache(
+                    cache_.get(),
+                    fileName,
+                    [&](bool* parseError) {
+                        ArchiveEntryData entryData = reader_->read(fileName, parseError);
+                        PropertyDocument document{"shader"};
 
-            *error = *error || !FileUtils::getStreamFromArchivedFile(archivePath(), fileName, &stream);
-            *error = *error || !getPropertyTreeFromStream(stream, &propertyData);
+                        *parseError = *parseError || !document.parse(asText(entryData));
 
-            delete stream;
+                        return *parseError ? ShaderProgram{} : mapToShaderProgram(document.root(), parseError);
+                    },
+                    CookedAssets::decodeShaderProgram,
+                    CookedAssets::encodeShaderProgram,
+                    error);
 
             if (!*error)
             {
-                ShaderProgram program = mapToShaderProgram(propertyData, error);
                 program.programPath = assetPath;
                 return program;
             }
@@ -722,25 +1032,55 @@ namespace PB
         bool error;
         std::string fileName = fileNameOfAsset(assetPath, archiveAssetIds_, archiveAssets_);
 
-        if (hasAsset(fileName))
+        if (hasAsset(fileName) && hasFileExtension(fileName, CookedFormat::ANIMATION_SET_EXTENSION))
         {
-            std::istream* stream = nullptr;
+            error = false;
 
-            PropertyTree propertyData{"animations"};
+            ArchiveEntryData entryData = reader_->read(fileName, &error);
 
-            error = !FileUtils::getStreamFromArchivedFile(archivePath(), fileName, &stream);
-            error = error || !getPropertyTreeFromStream(stream, &propertyData);
+            error = error || !CookedAssets::decodeStringPairs(
+                    entryData.data,
+                    entryData.size,
+                    CookedFormat::ANIMATION_SET_MAGIC,
+                    map);
 
-            delete stream;
+            if (error)
+            {
+                LOGGER_ERROR("Failed to read asset '" + assetPath + "'");
+            }
+        }
+        else if (hasAsset(fileName))
+        {
+            error = false;
+
+            std::unordered_map<std::string, std::string> animations = loadThroughCache(
+                    cache_.get(),
+                    fileName,
+                    [&](bool* parseError) {
+                        std::unordered_map<std::string, std::string> parsed{};
+                        ArchiveEntryData entryData = reader_->read(fileName, parseError);
+                        PropertyDocument document{"animations"};
+
+                        *parseError = *parseError || !document.parse(asText(entryData));
+
+                        for (PropertyTree* child = document.root().firstChild();
+                             child != nullptr && !*parseError;
+                             child = child->nextSibling())
+                        {
+                            parsed.insert(
+                                    std::pair<std::string, std::string>(child->name(), child->value())
+                            );
+                        }
+
+                        return parsed;
+                    },
+                    decodeAnimationSet,
+                    encodeAnimationSet,
+                    &error);
 
             if (!error)
             {
-                for (auto& childName: propertyData.children())
-                {
-                    map.insert(
-                            std::pair<std::string, std::string>(childName, propertyData.get(childName).result->value())
-                    );
-                }
+                map.insert(animations.begin(), animations.end());
             }
             else
             {
@@ -762,21 +1102,65 @@ namespace PB
             std::unordered_map<std::string, IAnimation*>& animationMap
     )
     {
-        bool error;
+        bool error = false;
+        std::uint8_t fps = 0;
+        std::uint8_t frameCount = 0;
+
+        std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> keyframes = loadAnimationKeyframes(
+                assetPath,
+                &fps,
+                &frameCount,
+                &error);
+
+        if (!error)
+        {
+            animationMap.insert(
+                    std::pair<std::string, IAnimation*>(
+                            archiveName_ + "/" + assetPath,
+                            new Animation(archiveName_ + "/" + assetPath, fps, frameCount, keyframes)
+                    )
+            );
+        }
+
+        return !error;
+    }
+
+    std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> AssetArchive::loadAnimationKeyframes(
+            const std::string& assetPath,
+            std::uint8_t* fps,
+            std::uint8_t* frameCount,
+            bool* error)
+    {
+        std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> keyframes{};
         std::string fileName = fileNameOfAsset(assetPath, archiveAssetIds_, archiveAssets_);
 
-        if (hasAsset(fileName))
+        if (hasAsset(fileName) && hasFileExtension(fileName, AnimationClip::FILE_EXTENSION))
         {
-            std::istream* stream = nullptr;
+            ArchiveEntryData entryData = reader_->read(fileName, error);
 
-            PropertyTree propertyData{"animations"};
+            if (!*error)
+            {
+                keyframes = mapBytesToAnimationClip(entryData.data, entryData.size, fps, frameCount, error);
 
-            error = !FileUtils::getStreamFromArchivedFile(archivePath(), fileName, &stream);
-            error = error || !getPropertyTreeFromStream(stream, &propertyData);
+                if (*error)
+                {
+                    LOGGER_ERROR("Failed to read animation clip '" + assetPath + "'");
+                }
+            }
+            else
+            {
+                LOGGER_ERROR("Failed to read asset '" + assetPath + "'");
+            }
+        }
+        else if (hasAsset(fileName))
+        {
+            ArchiveEntryData entryData = reader_->read(fileName, error);
+            PropertyDocument document{"animations"};
+            PropertyTree& propertyData = document.root();
 
-            delete stream;
+            *error = *error || !document.parse(asText(entryData));
 
-            if (!error)
+            if (!*error)
             {
                 auto skeletonNode = propertyData.get("skeleton");
 
@@ -793,68 +1177,51 @@ namespace PB
 
                         if (fpsNode.hasResult)
                         {
-                            std::uint8_t fps = NumberUtils::parseValue(fpsNode.result->value().c_str(), 0, &error);
+                            *fps = NumberUtils::parseValue(fpsNode.result->value(), 0, error);
 
                             auto lengthNode = propertyData.get("length");
 
                             if (lengthNode.hasResult)
                             {
-                                std::uint8_t frameCount = NumberUtils::parseValue(
-                                        lengthNode.result->value().c_str(),
+                                *frameCount = NumberUtils::parseValue(
+                                        lengthNode.result->value(),
                                         0,
-                                        &error
+                                        error
                                 );
 
                                 auto keyframesNode = propertyData.get("keyframes");
 
                                 if (keyframesNode.hasResult)
                                 {
-                                    std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> keyframes = mapToKeyframes(
-                                            keyframesNode.result,
-                                            &error);
-
-                                    if (!error)
-                                    {
-                                        animationMap.insert(
-                                                std::pair<std::string, IAnimation*>(archiveName_ + "/" + assetPath,
-                                                                                    new Animation(
-                                                                                            this->archiveName_ + "/" +
-                                                                                            assetPath,
-                                                                                            fps,
-                                                                                            frameCount,
-                                                                                            keyframes
-                                                                                    )
-                                                )
-                                        );
-                                    }
+                                    keyframes = mapToKeyframes(keyframesNode.result, error);
                                 }
                                 else
                                 {
-                                    error = true;
+                                    *error = true;
                                     LOGGER_ERROR("No keyframes defined in the loaded animation.");
                                 }
                             }
                             else
                             {
-                                error = true;
+                                *error = true;
                                 LOGGER_ERROR("No length defined in the loaded animatino.");
                             }
                         }
                         else
                         {
-                            error = true;
+                            *error = true;
                             LOGGER_ERROR("No FPS defined in the loaded animation.");
                         }
                     }
                     else
                     {
-                        error = true;
+                        *error = true;
                         LOGGER_ERROR("No root node defined in the loaded animation skeleton.");
                     }
                 }
                 else
                 {
-                    error = true;
+                    *error = true;
                     LOGGER_ERROR("No skeleton defined in the loaded animation.");
                 }
             }
@@ -865,11 +1232,11 @@ namespace PB
         }
         else
         {
-            error = true;
+            *error = true;
             LOGGER_ERROR("Failed to retrieve asset '" + assetPath + "'");
         }
 
-        return !error;
+        return keyframes;
     }
 
     SizedArray<std::uint8_t> AssetArchive::loadAssetBytes(const std::string& assetPath, bool* error)
@@ -880,13 +1247,13 @@ namespace PB
 
         if (hasAsset(fileName))
         {
-            std::istream* stream = nullptr;
-
-            *error = *error || !FileUtils::getStreamFromArchivedFile(archivePath(), fileName, &stream);
+            ArchiveEntryData entryData = reader_->read(fileName, error);
 
             if (!*error)
             {
-                bytesArray = mapStreamToByteArray(stream);
+                bytesArray.array = new std::uint8_t[entryData.size];
+                bytesArray.length = static_cast<std::uint32_t>(entryData.size);
+                std::copy(entryData.data, entryData.data + entryData.size, bytesArray.array);
             }
         }
         else
@@ -898,28 +1265,45 @@ namespace PB
         return bytesArray;
     }
 
-    std::vector<Vertex> AssetArchive::loadMeshDataAsset(const std::string& assetPath, bool* error)
+    MeshSource AssetArchive::loadMeshDataAsset(const std::string& assetPath, bool* error)
     {
-        std::vector<Vertex> meshData{};
+        MeshSource meshSource{};
 
         std::string fileName = fileNameOfAsset(assetPath, archiveAssetIds_, archiveAssets_);
 
-        if (hasAsset(fileName))
+        if (hasAsset(fileName) && hasFileExtension(fileName, MeshFormat::FILE_EXTENSION))
+        {
+            meshSource.bufferBytes = reader_->read(fileName, error);
+
+            if (!*error)
+            {
+                meshSource.buffer = mapBytesToMeshBuffer(
+                        meshSource.bufferBytes.data,
+                        meshSource.bufferBytes.size,
+                        error);
+            }
+
+            if (*error)
+            {
+                LOGGER_ERROR("Incomplete/Corrupt mesh data for asset '" + assetPath + "'");
+            }
+        }
+        else if (hasAsset(fileName))
         {
             std::istream* stream = nullptr;
 
-            *error = !FileUtils::getStreamFromArchivedFile(archivePath(), fileName, &stream);
+            *error = !openStream(fileName, &stream);
 
             float values[8]{};
             std::uint8_t i = 0;
 
-            while (!stream->eof())
+            while (!*error && !stream->eof())
             {
                 *stream >> values[i++];
 
                 if (i >= 8)
                 {
-                    meshData.push_back(Vertex{
+                    meshSource.vertices.push_back(Vertex{
                             vec3{values[0], values[1], values[2]},  // Vertex Coord
                             vec3{values[3], values[4], values[5]},  // Vertex Normal
                             vec2{values[6], values[7]}              // UV Coord
@@ -934,6 +1318,8 @@ namespace PB
                 *error = true;
                 LOGGER_ERROR("Incomplete/Corrupt mesh data for asset '" + assetPath + "'");
             }
+
+            delete stream;
         }
         else
         {
@@ -941,7 +1327,7 @@ namespace PB
             LOGGER_ERROR("Invalid mesh data asset, '" + assetPath + "'");
         }
 
-        return meshData;
+        return meshSource;
     }
 
     ImageData AssetArchive::loadImageAsset(const std::string& assetPath, bool* error)
@@ -952,37 +1338,30 @@ namespace PB
 
         if (hasAsset(fileName))
         {
-            stbi_set_flip_vertically_on_load(true);
+            ArchiveEntryData entryData = reader_->read(fileName, error);
 
-            std::istream* stream = nullptr;
-
-            if (FileUtils::getStreamFromArchivedFile(archivePath(), fileName, &stream))
+            if (*error)
             {
-                //TODO: Revisit this, work on 32 bit max value
-                stream->ignore(INTMAX_MAX);
-                std::int64_t streamLength = stream->gcount();
-                stream->clear();
-                stream->seekg(0, std::istream::beg);
-
-                char* buffer = new char[streamLength];
-
-                stream->read(buffer, streamLength);
+                LOGGER_ERROR(
+                        "Failed to acquire stream for asset '" + assetPath + "' in archive '" + archivePath() + "'");
+            }
+            else if (hasFileExtension(fileName, CookedFormat::TEXTURE_EXTENSION))
+            {
+                data = mapBytesToImageData(entryData.data, entryData.size, error);
+            }
+            else
+            {
+                stbi_set_flip_vertically_on_load(true);
 
-                //TODO: Check if streamLength is too long, expecting only 32bit value
+                //TODO: Check if the size is too long, expecting only 32bit value
                 data.bufferData = stbi_load_from_memory(
-                        (std::uint8_t*) buffer,
-                        streamLength, &data.width,
+                        entryData.data,
+                        static_cast<std::int32_t>(entryData.size),
+                        &data.width,
                         &data.height,
                         &data.numChannels,
                         0);
             }
-            else
-            {
-                LOGGER_ERROR(
-                        "Failed to acquire stream for asset '" + assetPath + "' in archive '" + archivePath() + "'");
-            }
-
-            delete stream;
         }
         else
         {
@@ -997,19 +1376,35 @@ namespace PB
     {
         std::string fileName = fileNameOfAsset(assetPath, archiveAssetIds_, archiveAssets_);
 
-        if (hasAsset(fileName))
+        if (hasAsset(fileName) && hasFileExtension(fileName, CookedFormat::MATERIAL_EXTENSION))
         {
-            std::istream* stream = nullptr;
+            ArchiveEntryData entryData = reader_->read(fileName, error);
 
-            PropertyTree propertyData{"material"};
+            if (!*error)
+            {
+                return CookedAssets::decodeMaterial(entryData.data, entryData.size, error);
+            }
+        }
+        else if (hasAsset(fileName))
+        {
+            Material material = loadThroughCache(
+                    cache_.get(),
+                    fileName,
+                    [&](bool* parseError) {
+                        ArchiveEntryData entryData = reader_->read(fileName, parseError);
+                        PropertyDocument document{"material"};
 
-            *error = *error || !FileUtils::getStreamFromArchivedFile(archivePath(), fileName, &stream);
-            *error = *error || !getPropertyTreeFromStream(stream, &propertyData);
+                        *parseError = *parseError || !document.parse(asText(entryData));
+
+                        return *parseError ? Material{} : mapToMaterial(document.root(), parseError);
+                    },
+                    CookedAssets::decodeMaterial,
+                    CookedAssets::encodeMaterial,
+                    error);
 
-            delete stream;
             if (!*error)
             {
-                return mapToMaterial(propertyData, error);
+                return material;
             }
         }
         else
@@ -1025,31 +1420,13 @@ namespace PB
     {
         std::string fileName = fileNameOfAsset(assetPath, archiveAssetIds_, archiveAssets_);
 
-        if (hasAsset(fileName))
+        if (hasAsset(fileName) && hasFileExtension(fileName, CookedFormat::MODEL_EXTENSION))
         {
-            std::istream* stream = nullptr;
-
-            PropertyTree propertyData{"model"};
-
-            *error = *error || !FileUtils::getStreamFromArchivedFile(archivePath(), fileName, &stream);
-            *error = *error || !getPropertyTreeFromStream(stream, &propertyData);
+            ArchiveEntryData entryData = reader_->read(fileName, error);
 
-            delete stream;
             if (!*error)
             {
-                ModelData model{};
-
-                auto rootNode = propertyData.get("root");
-
-                if (rootNode.hasResult)
-                {
-                    model = mapToModelData(*rootNode.result, error);
-                }
-                else
-                {
-                    *error = true;
-                    LOGGER_ERROR("Invalid Model2D data, must contain root node.");
-                }
+                ModelData model = CookedAssets::decodeModel(entryData.data, entryData.size, error);
 
                 if (*error)
                 {
@@ -1059,6 +1436,46 @@ namespace PB
                 return model;
             }
         }
+        else if (hasAsset(fileName))
+        {
+            ModelData model = loadThroughCache(
+                    cache_.get(),
+                    fileName,
+                    [&](bool* parseError) {
+                        ModelData parsedModel{};
+                        ArchiveEntryData entryData = reader_->read(fileName, parseError);
+                        PropertyDocument document{"model"};
+
+                        *parseError = *parseError || !document.parse(asText(entryData));
+
+                        if (!*parseError)
+                        {
+                            auto rootNode = document.root().get("root");
+
+                            if (rootNode.hasResult)
+                            {
+                                parsedModel = mapToModelData(*rootNode.result, parseError);
+                            }
+                            else
+                            {
+                                *parseError = true;
+                                LOGGER_ERROR("Invalid Model2D data, must contain root node.");
+                            }
+                        }
+
+                        return parsedModel;
+                    },
+                    CookedAssets::decodeModel,
+                    CookedAssets::encodeModel,
+                    error);
+
+            if (*error)
+            {
+                LOGGER_ERROR("Failed to load Model2D data for asset '" + assetPath + "'");
+            }
+
+            return model;
+        }
         else
         {
             *error = true;
@@ -1068,8 +1485,22 @@ namespace PB
         return {};
     }
 
+    bool AssetArchive::openStream(const std::string& fileName, std::istream** stream)
+    {
+        bool error = false;
+
+        *stream = reader_->openStream(fileName, &error);
+
+        if (error)
+        {
+            LOGGER_ERROR("Failed to read contents of '" + archivePath() + "/" + fileName + "'");
+        }
+
+        return !error;
+    }
+
     std::string AssetArchive::archivePath()
     {
-        return archiveRoot_ + archiveName_ + ".zip";
+        return archiveRoot_ + archiveName_ + (cooked_ ? CookedFormat::PACK_EXTENSION : ".zip");
     }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -11,10 +12,14 @@
 
 #include "puppetbox/IAnimationCatalogue.h"
 
+#include "ArchivePrefetcher.h"
+#include "ArchiveReader.h"
 #include "FontLoader.h"
 #include "ImageData.h"
 #include "Logger.h"
 #include "Material.h"
+#include "MeshFormat.h"
+#include "ParsedAssetCache.h"
 #include "Utilities.h"
 
 namespace PB
@@ -40,6 +45,30 @@ namespace PB
         std::vector<ModelData> children{};
     };
 
+    /**
+    * \brief Struct for holding mesh vertex data read from an archive, either as text vertices that still need
+    * indexing, or as a binary mesh buffer that can be handed to the GFX API as is.
+    */
+    struct MeshSource
+    {
+        std::vector<Vertex> vertices{};
+        MeshFormat::MeshBuffer buffer{};
+        /** Keeps the archive bytes viewed by the buffer alive */
+        ArchiveEntryData bufferBytes{};
+
+        bool isBuffer() const
+        {
+            return buffer.vertexData != nullptr;
+        };
+
+        std::size_t size() const
+        {
+            return isBuffer()
+                   ? (buffer.vertexCount * buffer.vertexStride) + (buffer.indexCount * buffer.indexSize)
+                   : vertices.size() * sizeof(Vertex);
+        };
+    };
+
     /**
     * \brief Struct for holding Shader specific data for simple communication between archive & library.
     */
@@ -68,6 +97,31 @@ namespace PB
         AssetArchive(std::string archiveName, std::string archiveRoot)
                 : archiveName_(std::move(archiveName)), archiveRoot_(std::move(archiveRoot)) {};
 
+        /**
+        * \brief Create an AssetArchive for an archive with the given name, at the given archive root directory.
+        *
+        * \param archiveName	The name of the desired archive to load.
+        * \param archiveRoot	The root directory to look in for the archive.
+        * \param allowCooked	If False the source archive is loaded, even if a cooked pack of it exists.
+        * \param useCache		If False every asset of a source archive is parsed, without reading or writing its
+        * parsed asset cache.
+        */
+        AssetArchive(std::string archiveName, std::string archiveRoot, bool allowCooked, bool useCache = true)
+                : archiveName_(std::move(archiveName)), archiveRoot_(std::move(archiveRoot)),
+                  allowCooked_(allowCooked), useCache_(useCache) {};
+
+        /**
+        * \brief Create an AssetArchive for an archive with the given name, at the given archive root directory,
+        * handing its reads to the given prefetcher.
+        *
+        * \param archiveName	The name of the desired archive to load.
+        * \param archiveRoot	The root directory to look in for the archive.
+        * \param prefetcher	The prefetcher that records startup reads and serves those it read ahead.
+        */
+        AssetArchive(std::string archiveName, std::string archiveRoot, std::shared_ptr<ArchivePrefetcher> prefetcher)
+                : archiveName_(std::move(archiveName)), archiveRoot_(std::move(archiveRoot)),
+                  prefetcher_(std::move(prefetcher)) {};
+
         /**
         * \brief Initializes the AssetArchive's initial configurations.  This is needed before any other AssetArchive
         * interations.
@@ -90,6 +144,40 @@ namespace PB
         */
         std::uint64_t assetCount();
 
+        /**
+        * \brief Checks if the AssetArchive was loaded from a cooked asset pack (see {\link CookedFormat.h}),
+        * whose assets are stored already parsed.
+        *
+        * \return True if the AssetArchive is a cooked asset pack, False otherwise.
+        */
+        bool isCooked() const;
+
+        /**
+        * \brief Gives the virtual asset paths of all assets defined in the AssetArchive's manifest.
+        *
+        * \return The virtual asset paths of the AssetArchive's assets.
+        */
+        std::vector<std::string> assetIds() const;
+
+        /**
+        * \brief Gives the name of the file within the archive that holds the given asset.
+        *
+        * \param assetPath	The virtual asset path of the desired asset.
+        *
+        * \return The file name of the asset, or an empty string if the asset does not exist.
+        */
+        std::string assetFileName(const std::string& assetPath);
+
+        /**
+        * \brief Loads an asset's contents without copying them, when the archive allows it.
+        *
+        * \param assetPath	The virtual asset path of the desired asset.
+        * \param error		Flag indicating an error occurred if set to True.
+        *
+        * \return The contents of the requested asset, or empty data if an error occurred.
+        */
+        ArchiveEntryData loadAssetData(const std::string& assetPath, bool* error);
+
         /**
         * \brief Loads an asset's contents as raw ascii data.
         *
@@ -132,6 +220,21 @@ namespace PB
         bool loadAnimationAsset(const std::string& name, const std::string& assetPath,
                                 std::unordered_map<std::string, IAnimation*>& animationMap);
 
+        /**
+         * \brief Loads the keyframes of an individual animation asset, from either a text or a binary clip.
+         *
+         * \param assetPath  The path to the desired animation.
+         * \param fps        Set to the frames per second of the animation.
+         * \param frameCount Set to the number of frames in the animation.
+         * \param error      Error flag to indicate if there was an issue loading the animation.
+         * \return The keyframes of the animation, keyed by frame index.
+         */
+        std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> loadAnimationKeyframes(
+                const std::string& assetPath,
+                std::uint8_t* fps,
+                std::uint8_t* frameCount,
+                bool* error);
+
         /**
          * \brief Load the given asset's data as raw bytes.
          *
@@ -143,13 +246,14 @@ namespace PB
         SizedArray<std::uint8_t> loadAssetBytes(const std::string& assetPath, bool* error);
 
         /**
-         * Loads mesh data assets as a {\link std::vector} of {\link Vertex} elements.
+         * Loads mesh data assets, binary meshes (see {\link MeshFormat.h}) are viewed in place without
+         * parsing, text meshes are parsed into {\link Vertex} elements.
          *
          * \param assetPath The path to the desired mesh data to load.
          * \param error     Error flag to indicate if there was an issue loading the mesh data.
-         * \return A {\link std::vector} of {\link Vertex} elements holding the requested mesh data.
+         * \return A {\link MeshSource} holding the requested mesh data.
          */
-        std::vector<Vertex> loadMeshDataAsset(const std::string& assetPath, bool* error);
+        MeshSource loadMeshDataAsset(const std::string& assetPath, bool* error);
 
         /**
         * \brief Returns a ImageData for the given shader asset.
@@ -184,11 +288,31 @@ namespace PB
     private:
         std::string archiveName_;
         std::string archiveRoot_;
+        bool allowCooked_ = true;
+        bool useCache_ = true;
+        bool cooked_ = false;
         std::unordered_set<std::string> archiveAssets_{};
         std::unordered_map<std::string, std::string> archiveAssetIds_{};
+        /** Shared so copies of the archive keep reading from the same open archive */
+        std::shared_ptr<ArchiveReader> reader_{};
+        /** Parsed text assets, only source archives have one, cooked packs are already parsed */
+        std::shared_ptr<ParsedAssetCache> cache_{};
+        std::shared_ptr<ArchivePrefetcher> prefetcher_{};
     private:
         /**
-        * \brief Returns the path to the AssetArchive.
+        * \brief Creates a stream over the contents of the given file in the archive.
+        *
+        * \param fileName The name of the file within the archive.
+        * \param stream   Pointer to the stream that will be created, which must be deleted by the caller.
+        *
+        * \return True if the stream was created successfully, False otherwise.
+        */
+        bool openStream(const std::string& fileName, std::istream** stream);
+
+
+        /**
+        * \brief Returns the path to the AssetArchive, the cooked asset pack if there is one and it is allowed,
+        * otherwise the source archive.
         *
         * \return A string representing the path to the AssetArchive.
         */
@@ -0,0 +1,678 @@
+#include "AssetCooker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <utility>
+
+#include "AnimationClipFormat.h"
+#include "BinaryFormat.h"
+#include "CookedAssets.h"
+#include "CookedFormat.h"
+#include "MeshFormat.h"
+#include "MeshOptimizer.h"
+
+namespace PB
+{
+    namespace
+    {
+        /**
+        * \brief Welding tolerance for text meshes, matching the tolerance used when they are loaded at runtime.
+        */
+        constexpr float VERTEX_WELD_EPSILON = 0.0000001f;
+
+        constexpr std::uint32_t FLOATS_PER_VERTEX = 8;
+
+        bool endsWith(const std::string& value, const std::string& suffix)
+        {
+            return value.size() > suffix.size()
+                   && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+        }
+
+        /**
+        * \brief Replaces the last extension of the given file name, or appends one if it has none.
+        */
+        std::string replaceExtension(const std::string& fileName, const std::string& extension)
+        {
+            std::size_t separator = fileName.find_last_of('/');
+            std::size_t dot = fileName.find_last_of('.');
+
+            if (dot == std::string::npos || (separator != std::string::npos && dot < separator) || dot == 0)
+            {
+                return fileName + extension;
+            }
+
+            return fileName.substr(0, dot) + extension;
+        }
+
+        /**
+        * \brief Collects the mesh data paths within the given archive, of the given model node and its children.
+        */
+        void collectMeshPaths(
+                const ModelData& model,
+                const std::string& archiveName,
+                std::unordered_set<std::string>& meshAssets)
+        {
+            const std::string archivePrefix = archiveName + "/";
+
+            if (model.mesh.dataPath.compare(0, archivePrefix.size(), archivePrefix) == 0)
+            {
+                meshAssets.insert(model.mesh.dataPath.substr(archivePrefix.size()));
+            }
+
+            for (const auto& child: model.children)
+            {
+                collectMeshPaths(child, archiveName, meshAssets);
+            }
+        }
+
+        /**
+        * \brief Loads a single non model asset of a source archive or cooked pack, the same way the
+        * {\link AssetLibrary} would, telling them apart by their source or cooked extensions.
+        */
+        bool loadAsset(
+                AssetArchive& archive,
+                const std::string& assetPath,
+                const std::string& fileName,
+                const std::unordered_set<std::string>& meshAssets)
+        {
+            bool error = false;
+
+            if (endsWith(fileName, ".m") || endsWith(fileName, CookedFormat::MODEL_EXTENSION))
+            {
+                // Already loaded to find the meshes
+            }
+            else if (endsWith(fileName, ".mat") || endsWith(fileName, CookedFormat::MATERIAL_EXTENSION))
+            {
+                archive.loadMaterialAsset(assetPath, &error);
+            }
+            else if (endsWith(fileName, ".program.shader") || endsWith(fileName, CookedFormat::SHADER_EXTENSION))
+            {
+                archive.loadShaderAsset(assetPath, &error);
+            }
+            else if (endsWith(fileName, ".anims") || endsWith(fileName, CookedFormat::ANIMATION_SET_EXTENSION))
+            {
+                std::unordered_map<std::string, std::string> animations{};
+                error = !archive.loadAnimationSetAsset(assetPath, animations);
+            }
+            else if (endsWith(fileName, ".anim") || endsWith(fileName, AnimationClip::FILE_EXTENSION))
+            {
+                std::uint8_t fps = 0;
+                std::uint8_t frameCount = 0;
+                archive.loadAnimationKeyframes(assetPath, &fps, &frameCount, &error);
+            }
+            else if (endsWith(fileName, ".png") || endsWith(fileName, CookedFormat::TEXTURE_EXTENSION))
+            {
+                archive.loadImageAsset(assetPath, &error).clear();
+            }
+            else if (meshAssets.find(assetPath) != meshAssets.end())
+            {
+                archive.loadMeshDataAsset(assetPath, &error);
+            }
+            else
+            {
+                archive.loadAssetData(assetPath, &error);
+            }
+
+            return !error;
+        }
+
+        /**
+        * \brief Halves the given image level with a box filter, edge pixels are repeated for odd sizes.
+        */
+        void downsample(
+                const std::uint8_t* level,
+                std::uint32_t width,
+                std::uint32_t height,
+                std::uint32_t channels,
+                std::vector<std::uint8_t>& nextLevel)
+        {
+            const std::uint32_t nextWidth = width > 1 ? width / 2 : 1;
+            const std::uint32_t nextHeight = height > 1 ? height / 2 : 1;
+
+            for (std::uint32_t y = 0; y < nextHeight; ++y)
+            {
+                const std::uint32_t y0 = std::min(y * 2, height - 1);
+                const std::uint32_t y1 = std::min((y * 2) + 1, height - 1);
+
+                for (std::uint32_t x = 0; x < nextWidth; ++x)
+                {
+                    const std::uint32_t x0 = std::min(x * 2, width - 1);
+                    const std::uint32_t x1 = std::min((x * 2) + 1, width - 1);
+
+                    for (std::uint32_t c = 0; c < channels; ++c)
+                    {
+                        const std::uint32_t sum = level[(((y0 * width) + x0) * channels) + c]
+                                                  + level[(((y0 * width) + x1) * channels) + c]
+                                                  + level[(((y1 * width) + x0) * channels) + c]
+                                                  + level[(((y1 * width) + x1) * channels) + c];
+
+                        nextLevel.push_back(static_cast<std::uint8_t>((sum + 2) / 4));
+                    }
+                }
+            }
+        }
+    }
+
+    AssetCooker::AssetCooker(std::string archiveName, std::string archiveRoot)
+            : archiveName_(std::move(archiveName)), archiveRoot_(std::move(archiveRoot)),
+              source_(archiveName_, archiveRoot_, false)
+    {
+
+    }
+
+    bool AssetCooker::cook()
+    {
+        if (!source_.init())
+        {
+            LOGGER_ERROR("Failed to open archive '" + archiveName_ + "' for cooking");
+            return false;
+        }
+
+        std::vector<std::string> assetIds = source_.assetIds();
+        std::sort(assetIds.begin(), assetIds.end());
+
+        bool success = true;
+
+        // Models first, to know which assets are their meshes
+        for (const auto& assetPath: assetIds)
+        {
+            std::string fileName = source_.assetFileName(assetPath);
+
+            if (endsWith(fileName, ".m") && cookedAssets_.find(fileName) == cookedAssets_.end())
+            {
+                success = cookModel(assetPath, fileName) && success;
+            }
+        }
+
+        for (const auto& assetPath: assetIds)
+        {
+            std::string fileName = source_.assetFileName(assetPath);
+
+            if (fileName.empty())
+            {
+                success = false;
+            }
+            else if (cookedAssets_.find(fileName) == cookedAssets_.end())
+            {
+                success = cookAsset(assetPath, fileName) && success;
+            }
+        }
+
+        if (success)
+        {
+            success = writePack();
+        }
+        else
+        {
+            LOGGER_ERROR("Failed to cook archive '" + archiveName_ + "'");
+        }
+
+        return success;
+    }
+
+    bool AssetCooker::cookAsset(const std::string& assetPath, const std::string& fileName)
+    {
+        if (endsWith(fileName, ".mat"))
+        {
+            return cookMaterial(assetPath, fileName);
+        }
+        else if (endsWith(fileName, ".program.shader"))
+        {
+            return cookShaderProgram(assetPath, fileName);
+        }
+        else if (endsWith(fileName, ".anims"))
+        {
+            return cookAnimationSet(assetPath, fileName);
+        }
+        else if (endsWith(fileName, ".anim"))
+        {
+            return cookAnimation(assetPath, fileName);
+        }
+        else if (endsWith(fileName, ".png"))
+        {
+            return cookTexture(assetPath, fileName);
+        }
+        else if (meshAssets_.find(assetPath) != meshAssets_.end())
+        {
+            return cookMesh(assetPath, fileName);
+        }
+
+        return copyAsset(assetPath, fileName);
+    }
+
+    bool AssetCooker::cookModel(const std::string& assetPath, const std::string& fileName)
+    {
+        bool error = false;
+
+        ModelData model = source_.loadModelAsset(assetPath, &error);
+
+        if (!error)
+        {
+            collectMeshAssets(model);
+
+            cookedAssets_[fileName] = {
+                    replaceExtension(fileName, CookedFormat::MODEL_EXTENSION),
+                    CookedAssets::encodeModel(model)
+            };
+        }
+
+        return !error;
+    }
+
+    bool AssetCooker::cookMaterial(const std::string& assetPath, const std::string& fileName)
+    {
+        bool error = false;
+
+        Material material = source_.loadMaterialAsset(assetPath, &error);
+
+        if (!error)
+        {
+            cookedAssets_[fileName] = {
+                    replaceExtension(fileName, CookedFormat::MATERIAL_EXTENSION),
+                    CookedAssets::encodeMaterial(material)
+            };
+        }
+
+        return !error;
+    }
+
+    bool AssetCooker::cookShaderProgram(const std::string& assetPath, const std::string& fileName)
+    {
+        bool error = false;
+
+        ShaderProgram program = source_.loadShaderAsset(assetPath, &error);
+
+        error = error || !validateShaderStage(program.vertexShaderPath);
+        error = error || !validateShaderStage(program.fragmentShaderPath);
+        error = error || (!program.geometryShaderPath.empty() && !validateShaderStage(program.geometryShaderPath));
+
+        if (!error)
+        {
+            cookedAssets_[fileName] = {
+                    replaceExtension(fileName, CookedFormat::SHADER_EXTENSION),
+                    CookedAssets::encodeShaderProgram(program)
+            };
+        }
+        else
+        {
+            LOGGER_ERROR("Shader program '" + assetPath + "' failed validation");
+        }
+
+        return !error;
+    }
+
+    bool AssetCooker::cookAnimationSet(const std::string& assetPath, const std::string& fileName)
+    {
+        std::unordered_map<std::string, std::string> animations{};
+
+        if (!source_.loadAnimationSetAsset(assetPath, animations))
+        {
+            return false;
+        }
+
+        cookedAssets_[fileName] = {
+                replaceExtension(fileName, CookedFormat::ANIMATION_SET_EXTENSION),
+                CookedAssets::encodeStringPairs(CookedFormat::ANIMATION_SET_MAGIC, animations)
+        };
+
+        return true;
+    }
+
+    bool AssetCooker::cookAnimation(const std::string& assetPath, const std::string& fileName)
+    {
+        bool error = false;
+
+        AnimationClip::Clip clip{};
+
+        std::unordered_map<std::uint8_t, std::vector<RawKeyframe>> keyframes = source_.loadAnimationKeyframes(
+                assetPath,
+                &clip.fps,
+                &clip.frameCount,
+                &error);
+
+        if (error)
+        {
+            return false;
+        }
+
+        std::vector<std::uint8_t> frameIndices{};
+
+        for (const auto& frame: keyframes)
+        {
+            frameIndices.push_back(frame.first);
+        }
+
+        std::sort(frameIndices.begin(), frameIndices.end());
+
+        std::unordered_map<std::string, std::uint16_t> boneIndices{};
+
+        for (std::uint8_t frameIndex: frameIndices)
+        {
+            for (const auto& rawKeyframe: keyframes.at(frameIndex))
+            {
+                auto bone = boneIndices.find(rawKeyframe.boneName);
+
+                if (bone == boneIndices.end())
+                {
+                    bone = boneIndices.insert(
+                            std::pair<std::string, std::uint16_t>{
+                                    rawKeyframe.boneName,
+                                    static_cast<std::uint16_t>(clip.boneNames.size())
+                            }).first;
+                    clip.boneNames.push_back(rawKeyframe.boneName);
+                }
+
+                AnimationClip::Keyframe keyframe{};
+                keyframe.frameIndex = frameIndex;
+                keyframe.boneIndex = bone->second;
+
+                // Ordered to match the channel bits
+                const Result<float>* components[AnimationClip::CHANNEL_COUNT] = {
+                        &rawKeyframe.rotation.x, &rawKeyframe.rotation.y, &rawKeyframe.rotation.z,
+                        &rawKeyframe.scale.x, &rawKeyframe.scale.y, &rawKeyframe.scale.z,
+                        &rawKeyframe.position.x, &rawKeyframe.position.y, &rawKeyframe.position.z
+                };
+
+                for (std::uint32_t channel = 0; channel < AnimationClip::CHANNEL_COUNT; ++channel)
+                {
+                    if (components[channel]->hasResult)
+                    {
+                        keyframe.channels |= static_cast<std::uint16_t>(1 << channel);
+                        keyframe.values[channel] = channel < 3
+                                                   ? AnimationClip::wrapRotation(components[channel]->result)
+                                                   : components[channel]->result;
+                    }
+                }
+
+                clip.keyframes.push_back(keyframe);
+            }
+        }
+
+        cookedAssets_[fileName] = {
+                replaceExtension(fileName, AnimationClip::FILE_EXTENSION),
+                AnimationClip::encode(clip)
+        };
+
+        return true;
+    }
+
+    bool AssetCooker::cookTexture(const std::string& assetPath, const std::string& fileName)
+    {
+        bool error = false;
+
+        ImageData image = source_.loadImageAsset(assetPath, &error);
+
+        if (error || image.bufferData == nullptr)
+        {
+            LOGGER_ERROR("Failed to decode texture '" + assetPath + "'");
+            return false;
+        }
+
+        if (image.numChannels != 3 && image.numChannels != 4)
+        {
+            // Only RGB and RGBA are uploaded as is, leave anything else to the runtime decoder
+            image.clear();
+            return copyAsset(assetPath, fileName);
+        }
+
+        auto width = static_cast<std::uint32_t>(image.width);
+        auto height = static_cast<std::uint32_t>(image.height);
+        const auto channels = static_cast<std::uint32_t>(image.numChannels);
+
+        std::vector<std::uint8_t> chain(image.bufferData, image.bufferData + (width * height * channels));
+        image.clear();
+
+        // Same number of levels glGenerateMipmap would create, down to 1x1
+        std::uint32_t mipLevels = 1;
+        std::size_t levelOffset = 0;
+
+        while (width > 1 || height > 1)
+        {
+            std::vector<std::uint8_t> nextLevel{};
+            downsample(&chain[levelOffset], width, height, channels, nextLevel);
+
+            levelOffset += static_cast<std::size_t>(width) * height * channels;
+            chain.insert(chain.end(), nextLevel.begin(), nextLevel.end());
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+            ++mipLevels;
+        }
+
+        BinaryFormat::Writer writer{};
+        CookedFormat::writeHeader(writer, CookedFormat::TEXTURE_MAGIC);
+        writer.writeUInt32(static_cast<std::uint32_t>(image.width));
+        writer.writeUInt32(static_cast<std::uint32_t>(image.height));
+        writer.writeUInt32(channels);
+        writer.writeUInt32(mipLevels);
+        writer.writeBytes(chain.data(), chain.size());
+
+        cookedAssets_[fileName] = {
+                replaceExtension(fileName, CookedFormat::TEXTURE_EXTENSION),
+                std::move(writer.bytes())
+        };
+
+        return true;
+    }
+
+    bool AssetCooker::cookMesh(const std::string& assetPath, const std::string& fileName)
+    {
+        bool error = false;
+
+        MeshSource meshSource = source_.loadMeshDataAsset(assetPath, &error);
+
+        if (error)
+        {
+            return false;
+        }
+
+        if (meshSource.isBuffer())
+        {
+            return copyAsset(assetPath, fileName);
+        }
+
+        std::vector<float> values{};
+        values.reserve(meshSource.vertices.size() * FLOATS_PER_VERTEX);
+
+        for (const auto& v: meshSource.vertices)
+        {
+            values.insert(values.end(), {
+                    v.position.x, v.position.y, v.position.z,
+                    v.normal.x, v.normal.y, v.normal.z,
+                    v.uv.x, v.uv.y
+            });
+        }
+
+        std::vector<float> vertices{};
+        std::vector<std::uint32_t> indices{};
+
+        MeshOptimizer::weldVertices(
+                values.data(),
+                static_cast<std::uint32_t>(meshSource.vertices.size()),
+                FLOATS_PER_VERTEX,
+                VERTEX_WELD_EPSILON,
+                vertices,
+                indices);
+        MeshOptimizer::optimizeVertexCache(indices, static_cast<std::uint32_t>(vertices.size() / FLOATS_PER_VERTEX));
+        MeshOptimizer::optimizeVertexFetch(vertices, FLOATS_PER_VERTEX, indices);
+
+        cookedAssets_[fileName] = {
+                replaceExtension(fileName, MeshFormat::FILE_EXTENSION),
+                MeshFormat::encode(MeshFormat::standardMeshBuffer(vertices, indices))
+        };
+
+        return true;
+    }
+
+    bool AssetCooker::copyAsset(const std::string& assetPath, const std::string& fileName)
+    {
+        bool error = false;
+
+        ArchiveEntryData entryData = source_.loadAssetData(assetPath, &error);
+
+        if (!error)
+        {
+            cookedAssets_[fileName] = {
+                    fileName,
+                    std::vector<std::uint8_t>(entryData.data, entryData.data + entryData.size)
+            };
+        }
+
+        return !error;
+    }
+
+    void AssetCooker::collectMeshAssets(const ModelData& model)
+    {
+        collectMeshPaths(model, archiveName_, meshAssets_);
+    }
+
+    bool AssetCooker::timeFullLoad(bool fromPack, double* milliseconds)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        // Without the parsed asset cache every asset is parsed as on a first run, and the cache is left as is
+        AssetArchive archive{archiveName_, archiveRoot_, fromPack, false};
+
+        if (!archive.init() || archive.isCooked() != fromPack)
+        {
+            LOGGER_ERROR("Failed to open " + std::string(fromPack ? "cooked pack" : "source archive")
+                         + " of '" + archiveName_ + "' to time");
+            return false;
+        }
+
+        std::vector<std::string> assetIds = archive.assetIds();
+        std::sort(assetIds.begin(), assetIds.end());
+
+        std::unordered_set<std::string> meshAssets{};
+        bool success = true;
+
+        // Models first, to know which assets are their meshes
+        for (const auto& assetPath: assetIds)
+        {
+            std::string fileName = archive.assetFileName(assetPath);
+
+            if (endsWith(fileName, ".m") || endsWith(fileName, CookedFormat::MODEL_EXTENSION))
+            {
+                bool error = false;
+                collectMeshPaths(archive.loadModelAsset(assetPath, &error), archiveName_, meshAssets);
+                success = success && !error;
+            }
+        }
+
+        for (const auto& assetPath: assetIds)
+        {
+            success = loadAsset(archive, assetPath, archive.assetFileName(assetPath), meshAssets) && success;
+        }
+
+        *milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        return success;
+    }
+
+    bool AssetCooker::validateShaderStage(const std::string& shaderPath)
+    {
+        const std::string archivePrefix = archiveName_ + "/";
+
+        if (shaderPath.compare(0, archivePrefix.size(), archivePrefix) != 0)
+        {
+            LOGGER_WARN("Shader '" + shaderPath + "' is outside of archive '" + archiveName_ + "', not validated");
+            return true;
+        }
+
+        bool error = false;
+
+        std::string code = source_.loadAsciiData(shaderPath.substr(archivePrefix.size()), &error);
+
+        if (!error && code.find("main") == std::string::npos)
+        {
+            error = true;
+            LOGGER_ERROR("Shader '" + shaderPath + "' has no main function");
+        }
+
+        return !error;
+    }
+
+    bool AssetCooker::writePack()
+    {
+        std::unordered_map<std::string, std::string> manifest{};
+
+        for (const auto& assetPath: source_.assetIds())
+        {
+            manifest[assetPath] = cookedAssets_.at(source_.assetFileName(assetPath)).fileName;
+        }
+
+        std::vector<std::uint8_t> manifestBytes = CookedAssets::encodeStringPairs(
+                CookedFormat::MANIFEST_MAGIC,
+                manifest);
+
+        std::vector<std::pair<std::string, const std::vector<std::uint8_t>*>> entries{};
+        entries.emplace_back(CookedFormat::MANIFEST_FILE, &manifestBytes);
+
+        for (const auto& cookedAsset: cookedAssets_)
+        {
+            entries.emplace_back(cookedAsset.second.fileName, &cookedAsset.second.bytes);
+        }
+
+        std::sort(entries.begin(), entries.end());
+
+        std::uint64_t dataOffset = CookedFormat::PACK_HEADER_SIZE;
+
+        for (const auto& entry: entries)
+        {
+            dataOffset += 2 + entry.first.size() + 4 + 4 + 4;
+        }
+
+        dataOffset = ((dataOffset + CookedFormat::DATA_ALIGNMENT - 1) / CookedFormat::DATA_ALIGNMENT)
+                     * CookedFormat::DATA_ALIGNMENT;
+
+        BinaryFormat::Writer writer{};
+        writer.writeBytes(reinterpret_cast<const std::uint8_t*>(CookedFormat::PACK_MAGIC), 4);
+        writer.writeUInt16(CookedFormat::PACK_VERSION);
+        writer.writeUInt16(0);
+        writer.writeUInt32(static_cast<std::uint32_t>(entries.size()));
+        writer.writeUInt32(static_cast<std::uint32_t>(dataOffset));
+
+        std::uint64_t offset = dataOffset;
+
+        for (const auto& entry: entries)
+        {
+            writer.writeString(entry.first);
+            writer.writeUInt32(static_cast<std::uint32_t>(offset));
+            writer.writeUInt32(static_cast<std::uint32_t>(entry.second->size()));
+            writer.writeUInt32(BinaryFormat::crc32(entry.second->data(), entry.second->size()));
+
+            offset += entry.second->size();
+            offset = ((offset + CookedFormat::DATA_ALIGNMENT - 1) / CookedFormat::DATA_ALIGNMENT)
+                     * CookedFormat::DATA_ALIGNMENT;
+        }
+
+        if (offset > UINT32_MAX)
+        {
+            LOGGER_ERROR("Cooked archive '" + archiveName_ + "' is too large for a single pack");
+            return false;
+        }
+
+        for (const auto& entry: entries)
+        {
+            writer.align(CookedFormat::DATA_ALIGNMENT);
+            writer.writeBytes(entry.second->data(), entry.second->size());
+        }
+
+        const std::string packPath = archiveRoot_ + archiveName_ + CookedFormat::PACK_EXTENSION;
+
+        std::ofstream out(packPath, std::ios::binary | std::ios::out | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(writer.bytes().data()), static_cast<std::streamsize>(writer.size()));
+        out.close();
+
+        if (!out)
+        {
+            LOGGER_ERROR("Failed to write cooked archive '" + packPath + "'");
+            return false;
+        }
+
+        LOGGER_INFO("Cooked " + std::to_string(cookedAssets_.size()) + " assets of '" + archiveName_ + "' into '"
+                    + packPath + "', " + std::to_string(writer.size()) + " bytes");
+
+        return true;
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "AssetArchive.h"
+
+namespace PB
+{
+    /**
+    * \brief Cooks a source asset archive into a packed, load-ready asset pack (see {\link CookedFormat.h}).
+    *
+    * <p>Models, materials, shader programs and animation sets are parsed once and stored in their parsed
+    * form, animations and meshes are compiled to their binary formats, and textures are decoded with their
+    * full mip chain.  Shader programs are validated against their stage sources, which are stored as is.
+    * Any other assets are copied over unchanged.  The pack is written next to the source archive, where
+    * {\link AssetArchive} prefers it over the source archive.</p>
+    */
+    class AssetCooker
+    {
+    public:
+        /**
+        * \brief Create an AssetCooker for the archive with the given name, at the given archive root directory.
+        *
+        * \param archiveName	The name of the archive to cook.
+        * \param archiveRoot	The root directory to look in for the archive, and to write the pack to.
+        */
+        AssetCooker(std::string archiveName, std::string archiveRoot);
+
+        /**
+        * \brief Cooks every asset of the archive and writes the asset pack.
+        *
+        * \return True if every asset was cooked and the pack was written, False otherwise.
+        */
+        bool cook();
+
+        /**
+        * \brief Loads every asset of the archive as the engine does, short of uploading them, from either the
+        * source archive or its cooked pack, and times the load.
+        *
+        * <p>The source archive is loaded without its parsed asset cache, so every asset is parsed as on a first
+        * run, and the cache is left untouched.  The pack must have been cooked already.</p>
+        *
+        * \param fromPack		True to load the cooked pack, False to load the source archive.
+        * \param milliseconds	Set to the time taken to open the archive and load every asset.
+        * \return True if every asset was loaded, False otherwise.
+        */
+        bool timeFullLoad(bool fromPack, double* milliseconds);
+
+    private:
+        struct CookedAsset
+        {
+            std::string fileName;
+            std::vector<std::uint8_t> bytes{};
+        };
+
+    private:
+        std::string archiveName_;
+        std::string archiveRoot_;
+        AssetArchive source_;
+        std::unordered_map<std::string, CookedAsset> cookedAssets_{};
+        /** Assets referenced as model mesh data, which are compiled to binary meshes */
+        std::unordered_set<std::string> meshAssets_{};
+
+    private:
+        bool cookAsset(const std::string& assetPath, const std::string& fileName);
+
+        bool cookModel(const std::string& assetPath, const std::string& fileName);
+
+        bool cookMaterial(const std::string& assetPath, const std::string& fileName);
+
+        bool cookShaderProgram(const std::string& assetPath, const std::string& fileName);
+
+        bool cookAnimationSet(const std::string& assetPath, const std::string& fileName);
+
+        bool cookAnimation(const std::string& assetPath, const std::string& fileName);
+
+        bool cookTexture(const std::string& assetPath, const std::string& fileName);
+
+        bool cookMesh(const std::string& assetPath, const std::string& fileName);
+
+        bool copyAsset(const std::string& assetPath, const std::string& fileName);
+
+        /**
+        * \brief Collects the mesh data paths within this archive, of the given model node and its children.
+        */
+        void collectMeshAssets(const ModelData& model);
+
+        /**
+        * \brief Validates that the given shader stage exists and has source code, stages outside of this
+        * archive can't be checked until they are loaded.
+        */
+        bool validateShaderStage(const std::string& shaderPath);
+
+        bool writePack();
+    };
+}
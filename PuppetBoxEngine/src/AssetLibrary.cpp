@@ -5,6 +5,7 @@
 
 #include "../generated/DefaultAssets.h"
 
+#include "CookedFormat.h"
 #include "GfxMath.h"
 #include "OpenGLModel.h"
 #include "Rendered2DMesh.h"
@@ -14,6 +15,11 @@ namespace PB
 {
     namespace
     {
+        /**
+        * \brief Most inflated bytes the startup prefetcher stages ahead of demand at once.
+        */
+        constexpr std::uint64_t PREFETCH_BUDGET_BYTES = 64 * 1024 * 1024;
+
         /**
         * \brief Structure used to help destruct virtual asset paths into separate archive and asset paths.
         */
@@ -51,48 +57,6 @@ namespace PB
             return AssetStruct{};
         }
 
-        /**
-        * \brief Helper function to get the raw shader code for a given shader asset.
-        *
-        * \param assetPath			The virtual asset path for the desired shader asset.
-        * \param assetArchiveMap	The AssetArchive to search for the given shader asset.
-        * \param error				Flag indicating an error occurred if set to True.
-        *
-        * \return A string containing the raw shader code of the requested shader asset, or an empty
-        * string if an error occurred fetching the asset.
-        */
-        std::string loadShaderCode(
-                const std::string& assetPath,
-                std::unordered_map<std::string, AssetArchive>& assetArchiveMap,
-                bool* error)
-        {
-            if (!StringUtils::trim(assetPath).empty())
-            {
-                AssetStruct asset = parseAssetPath(assetPath, error);
-
-                if (!*error)
-                {
-                    std::string data = assetArchiveMap.at(asset.archiveName).loadAsciiData(asset.assetName, error);
-
-                    if (!*error)
-                    {
-                        LOGGER_INFO("Shader '" + assetPath + "' read...");
-                        return data;
-                    }
-                    else
-                    {
-                        LOGGER_ERROR("Unable to load ascii data for asset '" + assetPath + "'");
-                    }
-                }
-                else
-                {
-                    LOGGER_ERROR("Invalid asset, '" + assetPath + "'");
-                }
-            }
-
-            return "";
-        }
-
         Mesh loadDefaultSpriteMesh(const std::shared_ptr<IGfxApi>& gfxApi)
         {
             float spriteMeshData[] = {
@@ -120,39 +84,18 @@ namespace PB
             return gfxApi->loadMesh(&spriteMeshVertices[0], spriteMeshVertices.size());
         }
 
-        Shader loadDefaultGlyphShader(const std::shared_ptr<IGfxApi>& gfxApi, bool* error)
+        ShaderSource defaultGlyphShaderSource()
         {
             const std::string defaultAssetPath = "Default/Shader/UI/Glyph";
 
-            Shader shader = Shader{
-                    defaultAssetPath,
-                    defaultAssetPath + "/Vertex",
-                    defaultAssetPath + "/Geometry",
-                    defaultAssetPath + "/Fragment"};
-
-            bool loaded;
-            loaded = shader.loadVertexShader(DEFAULT_ASSET_UI_GLYPH_VERTEX_SHADER);
-            loaded = loaded && shader.loadGeometryShader(DEFAULT_ASSET_UI_GLYPH_GEOMETRY_SHADER);
-            loaded = loaded && shader.loadFragmentShader(DEFAULT_ASSET_UI_GLYPH_FRAGMENT_SHADER);
+            ShaderSource source{};
+            source.program.programPath = defaultAssetPath;
+            source.program.vertexShaderPath = defaultAssetPath + "/Vertex";
+            source.program.fragmentShaderPath = defaultAssetPath + "/Fragment";
+            source.vertexCode = DEFAULT_ASSET_UI_GLYPH_VERTEX_SHADER;
+            source.fragmentCode = DEFAULT_ASSET_UI_GLYPH_FRAGMENT_SHADER;
 
-            if (loaded)
-            {
-                if (shader.init())
-                {
-                    LOGGER_INFO("Shader program '" + defaultAssetPath + "' loaded.");
-                }
-                else
-                {
-                    LOGGER_ERROR("Failed to compile shader program '" + defaultAssetPath + "'");
-                }
-            }
-            else
-            {
-                *error = true;
-                LOGGER_ERROR("Failed to load shader '" + defaultAssetPath + "'");
-            }
-
-            return shader;
+            return source;
         }
     }
 
@@ -166,13 +109,48 @@ namespace PB
     {
         bool error = false;
 
+        // Started before anything is read, so prefetching gets ahead of the archives being loaded
+        prefetcher_ = std::make_shared<ArchivePrefetcher>(
+                archiveRoot_ + CookedFormat::PREFETCH_PROFILE_FILE,
+                PREFETCH_BUDGET_BYTES);
+        prefetcher_->start();
+
+        if (gfxApi_->supportsShaderBinaries())
+        {
+            shaderCache_ = std::make_unique<ShaderBinaryCache>(
+                    archiveRoot_ + CookedFormat::SHADER_CACHE_FILE,
+                    gfxApi_->driverId());
+            shaderCache_->load();
+        }
+
+        // Started first so the driver can compile it while the rest of the defaults load
+        beginShaderCompile("Default/Shader/UI/Glyph", defaultGlyphShaderSource(), &error);
+
+        spriteBatch_ = std::make_shared<SpriteBatch>();
+
+        Mesh spriteMesh = loadDefaultSpriteMesh(gfxApi_);
         loadedMeshes_.insert(
-                std::pair<std::string, Mesh>{"Default/Mesh/Sprite", loadDefaultSpriteMesh(gfxApi_)}
+                std::pair<std::string, Mesh>{"Default/Mesh/Sprite", spriteMesh}
         );
+        residency_.track("Default/Mesh/Sprite", AssetType::MESH, sizeof(Mesh), spriteMesh.byteSize);
+        residency_.pin("Default/Mesh/Sprite");
 
-        loadedShaders_.insert(
-                std::pair<std::string, Shader>{"Default/Shader/UI/Glyph", loadDefaultGlyphShader(gfxApi_, &error)}
-        );
+        Shader glyphShader = finishShaderCompile("Default/Shader/UI/Glyph", &error);
+        residency_.pin("Default/Shader/UI/Glyph");
+
+        if (!error)
+        {
+            glyphBatch_ = std::make_shared<GlyphBatch>(glyphShader);
+
+            if (!glyphBatch_->init())
+            {
+                LOGGER_ERROR("Failed to initialize glyph batch");
+                error = true;
+            }
+
+            // The batch sets up its quad with OpenGL directly, behind the gfx API's back
+            gfxApi_->invalidateState();
+        }
 
         return !error;
     }
@@ -183,15 +161,18 @@ namespace PB
 
         if (assetArchives_.find(archiveName) == assetArchives_.end())
         {
-            AssetArchive archive{archiveName, archiveRoot_};
+            AssetArchive archive{archiveName, archiveRoot_, prefetcher_};
 
             if (archive.init())
             {
+                std::unique_lock<std::mutex> mlock(archivesMutex_);
+
                 assetArchives_.insert(
                         std::pair<std::string, AssetArchive>{archiveName, archive}
                 );
 
-                LOGGER_DEBUG("'" + archiveName + "' loaded " + std::to_string(archive.assetCount()) + " assets");
+                LOGGER_DEBUG("'" + archiveName + "' loaded " + std::to_string(archive.assetCount()) + " assets"
+                             + (archive.isCooked() ? " from its cooked pack" : ""));
             }
             else
             {
@@ -206,76 +187,224 @@ namespace PB
         return !error;
     }
 
-    Shader AssetLibrary::loadShaderAsset(const std::string& assetPath, bool* error)
+    AssetArchive* AssetLibrary::findArchive(const std::string& archiveName)
     {
-        Shader shader{assetPath};
+        std::unique_lock<std::mutex> mlock(archivesMutex_);
+
+        auto itr = assetArchives_.find(archiveName);
 
-        if (loadedShaders_.find(assetPath) == loadedShaders_.end())
+        // Archives are never removed, and map nodes don't move, so the pointer stays valid
+        return itr != assetArchives_.end() ? &itr->second : nullptr;
+    }
+
+    std::string AssetLibrary::readShaderCode(const std::string& assetPath, bool* error)
+    {
+        if (!StringUtils::trim(assetPath).empty())
         {
             AssetStruct asset = parseAssetPath(assetPath, error);
+            AssetArchive* archive = *error ? nullptr : findArchive(asset.archiveName);
 
-            if (!*error)
+            if (archive != nullptr)
             {
-                ShaderProgram program = assetArchives_.at(asset.archiveName).loadShaderAsset(asset.assetName, error);
-
-                std::string vertexCode;
-                std::string geometryCode;
-                std::string fragmentCode;
-
-                if (!*error)
-                {
-                    vertexCode = loadShaderCode(program.vertexShaderPath, assetArchives_, error);
-                }
+                std::string data = archive->loadAsciiData(asset.assetName, error);
 
                 if (!*error)
                 {
-                    geometryCode = loadShaderCode(program.geometryShaderPath, assetArchives_, error);
-                }
-
-                if (!*error)
-                {
-                    fragmentCode = loadShaderCode(program.fragmentShaderPath, assetArchives_, error);
-                }
-
-                shader = Shader{assetPath, program.vertexShaderPath, program.geometryShaderPath,
-                                program.fragmentShaderPath};
-                bool loaded;
-                loaded = shader.loadVertexShader(vertexCode);
-                loaded = loaded && shader.loadGeometryShader(geometryCode);
-                loaded = loaded && shader.loadFragmentShader(fragmentCode);
-
-                if (loaded)
-                {
-                    if (shader.init())
-                    {
-                        LOGGER_INFO("Shader program '" + assetPath + "' loaded.");
-                        loadedShaders_.insert(
-                                std::pair<std::string, Shader>{assetPath, shader}
-                        );
-                    }
-                    else
-                    {
-                        LOGGER_ERROR("Failed to compile shader program '" + assetPath + "'");
-                    }
+                    LOGGER_INFO("Shader '" + assetPath + "' read...");
+                    return data;
                 }
                 else
                 {
-                    LOGGER_ERROR("Failed to load shader '" + assetPath + "'");
+                    LOGGER_ERROR("Unable to load ascii data for asset '" + assetPath + "'");
                 }
             }
             else
             {
+                *error = true;
                 LOGGER_ERROR("Invalid asset, '" + assetPath + "'");
             }
         }
+
+        return "";
+    }
+
+    Shader AssetLibrary::loadShaderAsset(const std::string& assetPath, bool* error)
+    {
+        Shader shader{assetPath};
+
+        if (pendingShaders_.find(assetPath) != pendingShaders_.end())
+        {
+            shader = finishShaderCompile(assetPath, error);
+        }
+        else if (loadedShaders_.find(assetPath) == loadedShaders_.end())
+        {
+            ShaderSource source = readShaderSource(assetPath, error);
+
+            if (!*error)
+            {
+                shader = compileShader(assetPath, source, error);
+            }
+        }
         else
         {
             shader = loadedShaders_.at(assetPath);
+            residency_.touch(assetPath);
         }
 
         return shader;
     }
 
+    ShaderSource AssetLibrary::readShaderSource(const std::string& assetPath, bool* error)
+    {
+        ShaderSource source{};
+
+        AssetStruct asset = parseAssetPath(assetPath, error);
+        AssetArchive* archive = *error ? nullptr : findArchive(asset.archiveName);
+
+        if (archive != nullptr)
+        {
+            source.program = archive->loadShaderAsset(asset.assetName, error);
+
+            if (!*error)
+            {
+                source.vertexCode = readShaderCode(source.program.vertexShaderPath, error);
+            }
+
+            if (!*error)
+            {
+                source.geometryCode = readShaderCode(source.program.geometryShaderPath, error);
+            }
+
+            if (!*error)
+            {
+                source.fragmentCode = readShaderCode(source.program.fragmentShaderPath, error);
+            }
+        }
+        else
+        {
+            *error = true;
+            LOGGER_ERROR("Invalid asset, '" + assetPath + "'");
+        }
+
+        return source;
+    }
+
+    Shader AssetLibrary::compileShader(const std::string& assetPath, const ShaderSource& source, bool* error)
+    {
+        beginShaderCompile(assetPath, source, error);
+
+        return finishShaderCompile(assetPath, error);
+    }
+
+    bool AssetLibrary::beginShaderCompile(const std::string& assetPath, const ShaderSource& source, bool* error)
+    {
+        if (loadedShaders_.find(assetPath) != loadedShaders_.end())
+        {
+            return true;
+        }
+
+        if (pendingShaders_.find(assetPath) != pendingShaders_.end())
+        {
+            return false;
+        }
+
+        Shader shader = Shader{assetPath, source.program.vertexShaderPath, source.program.geometryShaderPath,
+                               source.program.fragmentShaderPath};
+        const std::uint64_t sourceKey = ShaderBinaryCache::sourceKey(
+                source.vertexCode,
+                source.geometryCode,
+                source.fragmentCode);
+
+        if (shaderCache_ != nullptr)
+        {
+            ShaderBinary binary{};
+
+            if (shaderCache_->find(sourceKey, &binary))
+            {
+                if (gfxApi_->loadShaderBinary(shader, binary))
+                {
+                    LOGGER_INFO("Shader program '" + assetPath + "' loaded from shader cache.");
+                    registerShader(assetPath, shader);
+                    return true;
+                }
+
+                shaderCache_->remove(sourceKey);
+            }
+        }
+
+        if (gfxApi_->beginShader(shader, source.vertexCode, source.geometryCode, source.fragmentCode))
+        {
+            pendingShaders_.insert(
+                    std::pair<std::string, PendingShader>{assetPath, PendingShader{shader, sourceKey}}
+            );
+            return false;
+        }
+
+        *error = true;
+        LOGGER_ERROR("Failed to load shader '" + assetPath + "'");
+        gfxApi_->freeShader(shader);
+
+        return true;
+    }
+
+    bool AssetLibrary::pollShaderCompile(const std::string& assetPath, bool* error)
+    {
+        auto itr = pendingShaders_.find(assetPath);
+
+        if (itr != pendingShaders_.end() && !gfxApi_->isShaderReady(itr->second.shader))
+        {
+            return false;
+        }
+
+        finishShaderCompile(assetPath, error);
+
+        return true;
+    }
+
+    Shader AssetLibrary::finishShaderCompile(const std::string& assetPath, bool* error)
+    {
+        auto itr = pendingShaders_.find(assetPath);
+
+        if (itr == pendingShaders_.end())
+        {
+            auto loaded = loadedShaders_.find(assetPath);
+
+            return loaded != loadedShaders_.end() ? loaded->second : Shader{assetPath};
+        }
+
+        PendingShader pending = itr->second;
+        pendingShaders_.erase(itr);
+
+        if (gfxApi_->finishShader(pending.shader))
+        {
+            LOGGER_INFO("Shader program '" + assetPath + "' loaded.");
+            registerShader(assetPath, pending.shader);
+
+            ShaderBinary binary{};
+
+            if (shaderCache_ != nullptr && gfxApi_->getShaderBinary(pending.shader, &binary))
+            {
+                shaderCache_->store(pending.sourceKey, std::move(binary));
+            }
+
+            return pending.shader;
+        }
+
+        *error = true;
+        LOGGER_ERROR("Failed to compile shader program '" + assetPath + "'");
+        gfxApi_->freeShader(pending.shader);
+
+        return Shader{assetPath};
+    }
+
+    void AssetLibrary::registerShader(const std::string& assetPath, const Shader& shader)
+    {
+        loadedShaders_.insert(
+                std::pair<std::string, Shader>{assetPath, shader}
+        );
+        residency_.track(assetPath, AssetType::SHADER, sizeof(Shader), shader.binarySize());
+    }
+
     bool AssetLibrary::loadAnimationSetAsset(
             const std::string& assetPath,
             std::unordered_map<std::string, IAnimation*>& animationMap
@@ -361,6 +490,7 @@ namespace PB
                     loadedFonts_.insert(
                             std::pair<std::string, Font>(fontPath, font)
                     );
+                    residency_.track(fontPath, AssetType::FONT, sizeof(Font), font.byteSize());
                 }
                 else
                 {
@@ -377,6 +507,7 @@ namespace PB
         else
         {
             font = loadedFonts_.at(fontPath);
+            residency_.touch(fontPath);
         }
 
         return font;
@@ -388,68 +519,144 @@ namespace PB
 
         if (loadedMeshes_.find(assetPath) == loadedMeshes_.end())
         {
-            AssetStruct asset = parseAssetPath(assetPath, error);
+            MeshSource meshData = readMeshData(assetPath, error);
 
             if (!*error)
             {
-                std::vector<Vertex> meshData = assetArchives_
-                        .at(asset.archiveName)
-                        .loadMeshDataAsset(asset.assetName, error);
-
-                mesh = gfxApi_->loadMesh(&meshData[0], meshData.size());
-                loadedMeshes_.insert(
-                        std::pair<std::string, Mesh>{assetPath, mesh}
-                );
-            }
-            else
-            {
-                LOGGER_ERROR("Invalid mesh asset, '" + assetPath + "'");
+                mesh = uploadMesh(assetPath, meshData);
             }
         }
         else
         {
             mesh = loadedMeshes_.at(assetPath);
+            residency_.touch(assetPath);
         }
 
         return mesh;
     }
 
+    MeshSource AssetLibrary::readMeshData(const std::string& assetPath, bool* error)
+    {
+        MeshSource meshData{};
+
+        AssetStruct asset = parseAssetPath(assetPath, error);
+        AssetArchive* archive = *error ? nullptr : findArchive(asset.archiveName);
+
+        if (archive != nullptr)
+        {
+            meshData = archive->loadMeshDataAsset(asset.assetName, error);
+        }
+        else
+        {
+            *error = true;
+            LOGGER_ERROR("Invalid mesh asset, '" + assetPath + "'");
+        }
+
+        return meshData;
+    }
+
+    Mesh AssetLibrary::uploadMesh(const std::string& assetPath, MeshSource& meshData)
+    {
+        auto itr = loadedMeshes_.find(assetPath);
+
+        if (itr != loadedMeshes_.end())
+        {
+            return itr->second;
+        }
+
+        Mesh mesh = meshData.isBuffer()
+                    ? gfxApi_->loadMesh(meshData.buffer)
+                    : gfxApi_->loadMesh(&meshData.vertices[0], meshData.vertices.size());
+        loadedMeshes_.insert(
+                std::pair<std::string, Mesh>{assetPath, mesh}
+        );
+        residency_.track(assetPath, AssetType::MESH, sizeof(Mesh), mesh.byteSize);
+
+        return mesh;
+    }
+
     ImageReference AssetLibrary::loadImageAsset(const std::string& assetPath, ImageOptions imageOptions, bool* error)
     {
         ImageReference imageReference{0};
 
         if (loadedImages_.find(assetPath) == loadedImages_.end())
         {
-            AssetStruct asset = parseAssetPath(assetPath, error);
+            ImageData imageData = readImageData(assetPath, error);
 
             if (!*error)
             {
-                ImageData imageData = assetArchives_.at(asset.archiveName).loadImageAsset(asset.assetName, error);
-                imageReference = gfxApi_->loadImage(imageData, imageOptions);
-                imageReference.width = imageData.width;
-                imageReference.height = imageData.height;
-                imageReference.requiresAlphaBlending = imageData.numChannels == 4;
-                imageData.clear();
-
-                if (!*error)
-                {
-                    loadedImages_.insert(
-                            std::pair<std::string, ImageReference>{assetPath, imageReference}
-                    );
-                }
-                else
-                {
-                    LOGGER_ERROR("Failed to load asset '" + assetPath + "'");
-                }
+                imageReference = uploadImage(assetPath, imageData, imageOptions, error);
             }
-            else
+        }
+        else
+        {
+            imageReference = loadedImages_.at(assetPath);
+            residency_.touch(assetPath);
+        }
+
+        return imageReference;
+    }
+
+    ImageData AssetLibrary::readImageData(const std::string& assetPath, bool* error)
+    {
+        ImageData imageData{nullptr};
+
+        AssetStruct asset = parseAssetPath(assetPath, error);
+        AssetArchive* archive = *error ? nullptr : findArchive(asset.archiveName);
+
+        if (archive != nullptr)
+        {
+            imageData = archive->loadImageAsset(asset.assetName, error);
+
+            if (*error)
             {
-                LOGGER_ERROR("Invalid asset, '" + assetPath + "'");
+                LOGGER_ERROR("Failed to load asset '" + assetPath + "'");
             }
         }
         else
         {
-            imageReference = loadedImages_.at(assetPath);
+            *error = true;
+            LOGGER_ERROR("Invalid asset, '" + assetPath + "'");
+        }
+
+        return imageData;
+    }
+
+    ImageReference AssetLibrary::uploadImage(
+            const std::string& assetPath,
+            ImageData& imageData,
+            ImageOptions imageOptions,
+            bool* error)
+    {
+        auto itr = loadedImages_.find(assetPath);
+
+        if (itr != loadedImages_.end())
+        {
+            imageData.clear();
+            return itr->second;
+        }
+
+        ImageReference imageReference = gfxApi_->loadImage(imageData, imageOptions);
+        imageReference.width = imageData.width;
+        imageReference.height = imageData.height;
+        imageReference.requiresAlphaBlending = imageData.numChannels == 4;
+
+        // A single level image has its mip chain generated by the GFX API, adding about a third again
+        std::uint64_t gpuBytes = imageData.mipLevels > 1
+                                 ? imageData.byteSize()
+                                 : imageData.byteSize() + (imageData.byteSize() / 3);
+        imageData.clear();
+
+        if (!*error)
+        {
+            loadedImages_.insert(
+                    std::pair<std::string, ImageReference>{assetPath, imageReference}
+            );
+            residency_.track(assetPath, AssetType::IMAGE, sizeof(ImageReference), gpuBytes);
+        }
+        else
+        {
+            LOGGER_ERROR("Failed to load asset '" + assetPath + "'");
         }
 
         return imageReference;
@@ -461,70 +668,98 @@ namespace PB
 
         if (loadedMaterials_.find(assetPath) == loadedMaterials_.end())
         {
-            AssetStruct asset = parseAssetPath(assetPath, error);
+            material = readMaterialData(assetPath, error);
 
             if (!*error)
             {
-                material = assetArchives_.at(asset.archiveName).loadMaterialAsset(asset.assetName, error);
+                material = registerMaterial(assetPath, material, error);
+            }
+        }
+        else
+        {
+            material = loadedMaterials_.at(assetPath);
+            residency_.touch(assetPath);
+        }
 
-                if (!*error)
-                {
-                    if (!material.diffuseData.image.empty())
-                    {
-                        ImageReference imageReference = loadImageAsset(material.diffuseData.image,
-                                                                       {ImageOptions::Mode::CLAMP_TO_BORDER}, error);
+        return material;
+    }
 
-                        if (!*error)
-                        {
-                            material.diffuseMap = imageReference;
-                            material.requiresAlphaBlending = imageReference.requiresAlphaBlending;
-                        }
-                        else
-                        {
-                            LOGGER_ERROR("Failed to load image, '" + material.diffuseData.image + "' for asset '" +
-                                         assetPath + "'");
-                        }
-                    }
+    Material AssetLibrary::readMaterialData(const std::string& assetPath, bool* error)
+    {
+        Material material{};
 
-                    loadedMaterials_.insert(
-                            std::pair<std::string, Material>{assetPath, material}
-                    );
-                }
-                else
-                {
-                    LOGGER_ERROR("Failed to load material, '" + assetPath + "'");
-                }
-            }
-            else
+        AssetStruct asset = parseAssetPath(assetPath, error);
+        AssetArchive* archive = *error ? nullptr : findArchive(asset.archiveName);
+
+        if (archive != nullptr)
+        {
+            material = archive->loadMaterialAsset(asset.assetName, error);
+
+            if (*error)
             {
-                LOGGER_ERROR("Invalid asset, '" + assetPath + "'");
+                LOGGER_ERROR("Failed to load material, '" + assetPath + "'");
             }
         }
         else
         {
-            material = loadedMaterials_.at(assetPath);
+            *error = true;
+            LOGGER_ERROR("Invalid asset, '" + assetPath + "'");
         }
 
         return material;
     }
 
-    ModelData AssetLibrary::loadModelDataAsset(const std::string& assetPath, bool* error)
+    Material AssetLibrary::registerMaterial(const std::string& assetPath, Material material, bool* error)
     {
-        ModelData data;
+        auto itr = loadedMaterials_.find(assetPath);
 
-        if (loadedModelData_.find(assetPath) == loadedModelData_.end())
+        if (itr != loadedMaterials_.end())
         {
-            AssetStruct asset = parseAssetPath(assetPath, error);
+            return itr->second;
+        }
+
+        if (!material.diffuseData.image.empty())
+        {
+            ImageReference imageReference = loadImageAsset(material.diffuseData.image,
+                                                           {ImageOptions::Mode::CLAMP_TO_BORDER}, error);
 
             if (!*error)
             {
-                data = assetArchives_.at(asset.archiveName).loadModelAsset(asset.assetName, error);
+                material.diffuseMap = imageReference;
+                material.requiresAlphaBlending = imageReference.requiresAlphaBlending;
             }
             else
             {
-                LOGGER_ERROR("Invalid asset, '" + assetPath + "'");
+                LOGGER_ERROR("Failed to load image, '" + material.diffuseData.image + "' for asset '" +
+                             assetPath + "'");
             }
         }
+
+        loadedMaterials_.insert(
+                std::pair<std::string, Material>{assetPath, material}
+        );
+
+        // The material holds on to its image for as long as it is loaded itself
+        std::vector<AssetHandle> dependencies{};
+
+        if (!material.diffuseData.image.empty())
+        {
+            dependencies.push_back(residency_.acquire(material.diffuseData.image));
+        }
+
+        residency_.track(assetPath, AssetType::MATERIAL, sizeof(Material), 0, std::move(dependencies));
+
+        return material;
+    }
+
+    ModelData AssetLibrary::loadModelDataAsset(const std::string& assetPath, bool* error)
+    {
+        ModelData data;
+
+        if (loadedModelData_.find(assetPath) == loadedModelData_.end())
+        {
+            data = readModelData(assetPath, error);
+        }
         else
         {
             data = loadedModelData_.at(assetPath);
@@ -533,6 +768,26 @@ namespace PB
         return data;
     }
 
+    ModelData AssetLibrary::readModelData(const std::string& assetPath, bool* error)
+    {
+        ModelData data;
+
+        AssetStruct asset = parseAssetPath(assetPath, error);
+        AssetArchive* archive = *error ? nullptr : findArchive(asset.archiveName);
+
+        if (archive != nullptr)
+        {
+            data = archive->loadModelAsset(asset.assetName, error);
+        }
+        else
+        {
+            *error = true;
+            LOGGER_ERROR("Invalid asset, '" + assetPath + "'");
+        }
+
+        return data;
+    }
+
     bool AssetLibrary::loadSceneObject(
             const std::string& assetPath,
             SceneObject* sceneObject,
@@ -545,42 +800,54 @@ namespace PB
 
         if (!error)
         {
-            std::unique_ptr<IModel> model;
+            error = !buildSceneObject(assetPath, modelData, sceneObject, uuid, animationCatalogue);
+        }
+        else
+        {
+            LOGGER_ERROR("Model data was corrupt for asset '" + assetPath + "'");
+        }
 
-            std::unordered_map<std::uint32_t, RenderedMesh*> meshes{};
-            BoneMap bones{};
-            error = !buildMeshAndBones(modelData, "", bones, meshes);
+        return !error;
+    }
 
-            if (!error)
-            {
-                model = std::make_unique<OpenGLModel>(bones, meshes, animationCatalogue);
-
-                /**
-                * Make a copy of the previous SceneObject property data so that
-                * it can be restored after a new instance is made.
-                */
-                vec3 position = sceneObject->position;
-                vec3 rotation = sceneObject->rotation;
-                vec3 scale = sceneObject->scale;
-                float speed = sceneObject->speed;
-                vec3 velocity = sceneObject->velocity;
-
-                //TODO: Revisit "base scale"
-                *sceneObject = SceneObject{uuid, vec3{1.0f, 1.0f, 1.0f}, std::move(model)};
-                sceneObject->position = position;
-                sceneObject->rotation = rotation;
-                sceneObject->scale = scale;
-                sceneObject->speed = speed;
-                sceneObject->velocity = velocity;
-            }
-            else
-            {
-                LOGGER_ERROR("Failed to load model data for asset '" + assetPath + "'");
-            }
+    bool AssetLibrary::buildSceneObject(
+            const std::string& assetPath,
+            const ModelData& modelData,
+            SceneObject* sceneObject,
+            UUID uuid,
+            IAnimationCatalogue* animationCatalogue)
+    {
+        std::unique_ptr<IModel> model;
+
+        std::unordered_map<std::uint32_t, RenderedMesh*> meshes{};
+        BoneMap bones{};
+        bool error = !buildMeshAndBones(modelData, "", bones, meshes);
+
+        if (!error)
+        {
+            model = std::make_unique<OpenGLModel>(bones, meshes, animationCatalogue);
+
+            /**
+            * Make a copy of the previous SceneObject property data so that
+            * it can be restored after a new instance is made.
+            */
+            vec3 position = sceneObject->position;
+            vec3 rotation = sceneObject->rotation;
+            vec3 scale = sceneObject->scale;
+            float speed = sceneObject->speed;
+            vec3 velocity = sceneObject->velocity;
+
+            //TODO: Revisit "base scale"
+            *sceneObject = SceneObject{uuid, vec3{1.0f, 1.0f, 1.0f}, std::move(model)};
+            sceneObject->position = position;
+            sceneObject->rotation = rotation;
+            sceneObject->scale = scale;
+            sceneObject->speed = speed;
+            sceneObject->velocity = velocity;
         }
         else
         {
-            LOGGER_ERROR("Model data was corrupt for asset '" + assetPath + "'");
+            LOGGER_ERROR("Failed to load model data for asset '" + assetPath + "'");
         }
 
         return !error;
@@ -644,10 +911,16 @@ namespace PB
 
                             mesh.transform = meshOffset * meshScale;
 
+                            std::vector<AssetHandle> assets{
+                                    residency_.acquire(modelData.mesh.dataPath),
+                                    residency_.acquire(modelData.mesh.materialPath),
+                                    residency_.acquire(material.shaderId)
+                            };
+
                             meshes.insert(
                                     std::pair<std::uint32_t , RenderedMesh*>{
                                         boneId,
-                                        new Rendered2DMesh(mesh, material)}
+                                        new Rendered2DMesh(mesh, material, std::move(assets), spriteBatch_, commandList_)}
                             );
                         }
                         else
@@ -679,4 +952,136 @@ namespace PB
 
         return !error;
     }
+
+    AssetHandle AssetLibrary::acquireAsset(const std::string& assetPath)
+    {
+        return residency_.acquire(assetPath);
+    }
+
+    void AssetLibrary::setMemoryBudget(std::uint64_t cpuBytes, std::uint64_t gpuBytes)
+    {
+        residency_.setBudget(cpuBytes, gpuBytes);
+    }
+
+    std::vector<std::function<void()>> AssetLibrary::evictUnused()
+    {
+        std::vector<std::function<void()>> releases{};
+
+        for (const auto& asset: residency_.evict())
+        {
+            switch (asset.type)
+            {
+                case AssetType::MESH:
+                {
+                    auto itr = loadedMeshes_.find(asset.assetPath);
+
+                    if (itr != loadedMeshes_.end())
+                    {
+                        releases.emplace_back([gfxApi = gfxApi_, mesh = itr->second]() mutable {
+                            gfxApi->freeMesh(mesh);
+                        });
+                        loadedMeshes_.erase(itr);
+                    }
+                    break;
+                }
+                case AssetType::IMAGE:
+                {
+                    auto itr = loadedImages_.find(asset.assetPath);
+
+                    if (itr != loadedImages_.end())
+                    {
+                        releases.emplace_back([gfxApi = gfxApi_, image = itr->second]() mutable {
+                            gfxApi->freeImage(image);
+                        });
+                        loadedImages_.erase(itr);
+                    }
+                    break;
+                }
+                case AssetType::SHADER:
+                {
+                    auto itr = loadedShaders_.find(asset.assetPath);
+
+                    if (itr != loadedShaders_.end())
+                    {
+                        releases.emplace_back([gfxApi = gfxApi_, shader = itr->second]() mutable {
+                            gfxApi->freeShader(shader);
+                        });
+                        loadedShaders_.erase(itr);
+                    }
+                    break;
+                }
+                case AssetType::FONT:
+                {
+                    auto itr = loadedFonts_.find(asset.assetPath);
+
+                    if (itr != loadedFonts_.end())
+                    {
+                        // Only the atlas holds GFX API memory, the rest of the font goes with the map entry
+                        releases.emplace_back([gfxApi = gfxApi_, atlas = itr->second.atlas()]() mutable {
+                            gfxApi->freeImage(atlas);
+                        });
+                        loadedFonts_.erase(itr);
+                    }
+                    break;
+                }
+                case AssetType::MATERIAL:
+                    // The material's image is released along with it, and evicted on its own
+                    loadedMaterials_.erase(asset.assetPath);
+                    break;
+            }
+
+            LOGGER_DEBUG("Evicted asset '" + asset.assetPath + "', freeing " + std::to_string(asset.cpuBytes)
+                         + " CPU bytes and " + std::to_string(asset.gpuBytes) + " GPU bytes");
+        }
+
+        return releases;
+    }
+
+    std::vector<ResidentAsset> AssetLibrary::residentAssets() const
+    {
+        return residency_.residentAssets();
+    }
+
+    void AssetLibrary::finishStartup()
+    {
+        if (prefetcher_ != nullptr)
+        {
+            prefetcher_->finish(std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - startTime_).count());
+        }
+    }
+
+    void AssetLibrary::shutdown()
+    {
+        // The library outlives the context, so the batch can't be left to go with it
+        glyphBatch_ = nullptr;
+    }
+
+    void AssetLibrary::flushBatches()
+    {
+        if (spriteBatch_ != nullptr)
+        {
+            spriteBatch_->flush(*commandList_);
+        }
+
+        if (glyphBatch_ != nullptr)
+        {
+            glyphBatch_->flush(*commandList_);
+        }
+    }
+
+    const std::shared_ptr<SpriteBatch>& AssetLibrary::spriteBatch() const
+    {
+        return spriteBatch_;
+    }
+
+    const std::shared_ptr<GlyphBatch>& AssetLibrary::glyphBatch() const
+    {
+        return glyphBatch_;
+    }
+
+    const std::shared_ptr<CommandList>& AssetLibrary::commandList() const
+    {
+        return commandList_;
+    }
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -7,8 +11,12 @@
 #include "puppetbox/SceneObject.h"
 
 #include "puppetbox/IModel.h"
+#include "ArchivePrefetcher.h"
 #include "AssetArchive.h"
+#include "AssetResidency.h"
+#include "CommandList.h"
 #include "Font.h"
+#include "GlyphBatch.h"
 #include "IGfxApi.h"
 #include "ImageReference.h"
 #include "Logger.h"
@@ -16,11 +24,24 @@
 #include "Mesh.h"
 #include "RenderedMesh.h"
 #include "Shader.h"
+#include "ShaderBinaryCache.h"
+#include "SpriteBatch.h"
 
 namespace PB
 {
     class IAnimation;
 
+    /**
+    * \brief Struct for holding a shader program definition along with the source code of each of its stages.
+    */
+    struct ShaderSource
+    {
+        ShaderProgram program{};
+        std::string vertexCode;
+        std::string geometryCode;
+        std::string fragmentCode;
+    };
+
     /**
     * \brief Manages loading and organization of all asset archives.  Asset loading is all done through
     * the AssetLibrary, which will then facilitate specific archive loads and caching of assets.
@@ -148,18 +169,303 @@ namespace PB
         */
         ImageReference loadImageAsset(const std::string& assetPath, ImageOptions imageOptions, bool* error);
 
+        /**
+        * \brief Builds the given scene object from already loaded model data, loading any mesh, material
+        * and shader assets that aren't already cached.
+        *
+        * \param assetPath		    Virtual path of the model asset, used for logging.
+        * \param modelData          The model data to build the scene object from.
+        * \param sceneObject	    The instantiated scene object to load with asset data.
+        * \param uuid               The UUID to use for the created {\link SceneObject}
+        * \param animationCatalogue The {\link PB::IAnimationCatalogue} to use with the object model.
+        *
+        * \return True if the scene object was successfully loaded with assets, False otherwise.
+        */
+        bool buildSceneObject(
+                const std::string& assetPath,
+                const ModelData& modelData,
+                SceneObject* sceneObject,
+                UUID uuid,
+                IAnimationCatalogue* animationCatalogue);
+
+        // The read* methods only touch the asset archives and are safe to call from worker threads, the
+        // upload*, compile*, and register* methods make the GFX API calls and must be called from the main thread.
+
+        /**
+        * \brief Reads and parses the model data for the given virtual asset path, without caching it.
+        *
+        * \param assetPath	Virtual path to the requested asset.
+        * \param error		Flag indicating an error occurred if set to True.
+        *
+        * \return The parsed model data, or an empty object if an error occurred.
+        */
+        ModelData readModelData(const std::string& assetPath, bool* error);
+
+        /**
+        * \brief Reads and parses the vertex data for the given mesh asset.
+        *
+        * \param assetPath	Virtual path to the requested asset.
+        * \param error		Flag indicating an error occurred if set to True.
+        *
+        * \return The mesh data, or empty mesh data if an error occurred.
+        */
+        MeshSource readMeshData(const std::string& assetPath, bool* error);
+
+        /**
+        * \brief Reads and decodes the pixel data for the given image asset.
+        *
+        * \param assetPath	Virtual path to the requested asset.
+        * \param error		Flag indicating an error occurred if set to True.
+        *
+        * \return The decoded image data, which must be passed to {\link AssetLibrary::uploadImage} or cleared.
+        */
+        ImageData readImageData(const std::string& assetPath, bool* error);
+
+        /**
+        * \brief Reads and parses the given material asset, without loading its images.
+        *
+        * \param assetPath	Virtual path to the requested asset.
+        * \param error		Flag indicating an error occurred if set to True.
+        *
+        * \return The parsed material, or an empty object if an error occurred.
+        */
+        Material readMaterialData(const std::string& assetPath, bool* error);
+
+        /**
+        * \brief Reads the program definition and stage source code for the given shader asset.
+        *
+        * \param assetPath	Virtual path to the requested asset.
+        * \param error		Flag indicating an error occurred if set to True.
+        *
+        * \return The shader source, or an empty object if an error occurred.
+        */
+        ShaderSource readShaderSource(const std::string& assetPath, bool* error);
+
+        /**
+        * \brief Uploads the given mesh data and caches the resulting mesh, returning the cached
+        * mesh instead if one was already loaded for the path.
+        *
+        * \param assetPath	Virtual path of the mesh asset.
+        * \param meshData   The mesh data to upload.
+        *
+        * \return The uploaded mesh.
+        */
+        Mesh uploadMesh(const std::string& assetPath, MeshSource& meshData);
+
+        /**
+        * \brief Uploads the given image data and caches the resulting image reference, the image data
+        * is cleared either way.
+        *
+        * \param assetPath		Virtual path of the image asset.
+        * \param imageData      The decoded image data to upload.
+        * \param imageOptions	Image loading options to use when loading into memory.
+        * \param error			Flag indicating an error occurred if set to True.
+        *
+        * \return The uploaded image reference.
+        */
+        ImageReference uploadImage(
+                const std::string& assetPath,
+                ImageData& imageData,
+                ImageOptions imageOptions,
+                bool* error);
+
+        /**
+        * \brief Compiles the given shader source and caches the resulting shader, waiting on the driver
+        * to finish compiling it.
+        *
+        * \param assetPath	Virtual path of the shader asset.
+        * \param source     The shader source to compile.
+        * \param error		Flag indicating an error occurred if set to True.
+        *
+        * \return The compiled shader.
+        */
+        Shader compileShader(const std::string& assetPath, const ShaderSource& source, bool* error);
+
+        /**
+        * \brief Starts compiling the given shader source, or loads the shader from its cached program binary
+        * if the shader cache has one.  Compiles that aren't finished right away continue in the driver, to be
+        * polled with {\link AssetLibrary::pollShaderCompile}.
+        *
+        * \param assetPath	Virtual path of the shader asset.
+        * \param source     The shader source to compile.
+        * \param error		Flag indicating an error occurred if set to True.
+        *
+        * \return True if the shader is loaded or failed to load, False if it is still compiling.
+        */
+        bool beginShaderCompile(const std::string& assetPath, const ShaderSource& source, bool* error);
+
+        /**
+        * \brief Checks on a compile started by {\link AssetLibrary::beginShaderCompile}, caching the shader
+        * once it's done.  Never blocks when the driver compiles in parallel.
+        *
+        * \param assetPath	Virtual path of the shader asset.
+        * \param error		Flag indicating an error occurred if set to True.
+        *
+        * \return True if the shader is loaded or failed to load, False if it is still compiling.
+        */
+        bool pollShaderCompile(const std::string& assetPath, bool* error);
+
+        /**
+        * \brief Caches the given material, loading its diffuse image if it isn't already loaded.
+        *
+        * \param assetPath	Virtual path of the material asset.
+        * \param material   The parsed material.
+        * \param error		Flag indicating an error occurred if set to True.
+        *
+        * \return The cached material.
+        */
+        Material registerMaterial(const std::string& assetPath, Material material, bool* error);
+
+        /**
+        * \brief Takes a reference to the given loaded asset, keeping it from being evicted while the handle exists.
+        *
+        * \param assetPath	Virtual path of the loaded asset.
+        *
+        * \return A handle to the asset, or an empty handle if the asset isn't loaded.
+        */
+        AssetHandle acquireAsset(const std::string& assetPath);
+
+        /**
+        * \brief Sets the memory budgets for loaded assets, unreferenced assets are evicted least recently used
+        * first while either budget is exceeded.  Both are unlimited by default.
+        *
+        * \param cpuBytes	The main memory budget, in bytes.
+        * \param gpuBytes	The GFX API memory budget, in bytes.
+        */
+        void setMemoryBudget(std::uint64_t cpuBytes, std::uint64_t gpuBytes);
+
+        /**
+        * \brief Evicts unreferenced assets until the memory budgets are met.  Must be called from the main
+        * thread, once per frame.
+        *
+        * <p>The evicted assets' GFX API objects may still be drawn by frames submitted before the eviction, so
+        * they are left for the caller to release, on the thread holding the GFX API context, once those frames
+        * are done.</p>
+        *
+        * \return The releases of the evicted assets' GFX API objects.
+        */
+        std::vector<std::function<void()>> evictUnused();
+
+        /**
+        * \brief Lists the currently loaded assets.
+        *
+        * \return The loaded assets, largest first by combined CPU and GPU bytes.
+        */
+        std::vector<ResidentAsset> residentAssets() const;
+
+        /**
+        * \brief Marks the end of startup once the first frame is presented, reporting the time it took and
+        * recording the archive reads made until then, so later runs can prefetch them.  Only the first call
+        * has any effect.
+        */
+        void finishStartup();
+
+        /**
+        * \brief Releases the GFX API resources the library created for itself, such as the glyph batch's quad.
+        * Must be called while the GFX context is still current, after which no more text can be drawn.
+        */
+        void shutdown();
+
+        /**
+        * \brief Records the draws of the sprites and then the text batched since the last flush into the
+        * library's command list, so text always lands on top of the sprites.  Called once the scene and its UI
+        * are rendered.
+        */
+        void flushBatches();
+
+        /**
+        * \brief Gets the batch that instanced sprites are drawn through.
+        *
+        * \return The sprite batch, or nullptr before the library is initialized.
+        */
+        const std::shared_ptr<SpriteBatch>& spriteBatch() const;
+
+        /**
+        * \brief Gets the batch that text glyphs are drawn through.
+        *
+        * \return The glyph batch, or nullptr before the library is initialized.
+        */
+        const std::shared_ptr<GlyphBatch>& glyphBatch() const;
+
+        /**
+        * \brief Gets the list the draws of loaded assets are recorded into, to be submitted to the gfx API once
+        * the frame is rendered.
+        *
+        * \return The command list of the library.
+        */
+        const std::shared_ptr<CommandList>& commandList() const;
+
+    private:
+        /**
+        * \brief A shader program the driver is still compiling, along with the key its binary is cached under.
+        */
+        struct PendingShader
+        {
+            Shader shader;
+            std::uint64_t sourceKey = 0;
+        };
+
     private:
         std::string archiveRoot_;
         std::shared_ptr<IGfxApi> gfxApi_;
         FontLoader* fontLoader_;
         std::unordered_map<std::string, AssetArchive> assetArchives_{};
+        /** Guards archive lookups from worker threads against archives being loaded */
+        std::mutex archivesMutex_;
         std::unordered_map<std::string, Mesh> loadedMeshes_{};
         std::unordered_map<std::string, Material> loadedMaterials_{};
         std::unordered_map<std::string, ImageReference> loadedImages_{};
         std::unordered_map<std::string, ModelData> loadedModelData_{};
         std::unordered_map<std::string, Shader> loadedShaders_{};
+        std::unordered_map<std::string, PendingShader> pendingShaders_{};
+        std::unique_ptr<ShaderBinaryCache> shaderCache_{};
+        std::shared_ptr<ArchivePrefetcher> prefetcher_{};
+        std::shared_ptr<SpriteBatch> spriteBatch_{};
+        std::shared_ptr<GlyphBatch> glyphBatch_{};
+        std::shared_ptr<CommandList> commandList_ = std::make_shared<CommandList>();
+        std::chrono::steady_clock::time_point startTime_ = std::chrono::steady_clock::now();
         std::unordered_map<std::string, Font> loadedFonts_{};
+        AssetResidency residency_{};
     private:
+        /**
+        * \brief Finds the loaded archive with the given name.
+        *
+        * \param archiveName The name of the archive to find.
+        *
+        * \return The archive, or nullptr if no archive with the given name is loaded.
+        */
+        AssetArchive* findArchive(const std::string& archiveName);
+
+        /**
+        * \brief Waits on a compile started by {\link AssetLibrary::beginShaderCompile}, caching the shader
+        * and storing its program binary in the shader cache if it compiled successfully.
+        *
+        * \param assetPath	Virtual path of the shader asset.
+        * \param error		Flag indicating an error occurred if set to True.
+        *
+        * \return The compiled shader, the already loaded shader if there is no pending compile, or an
+        * empty object if an error occurred.
+        */
+        Shader finishShaderCompile(const std::string& assetPath, bool* error);
+
+        /**
+        * \brief Caches the given loaded shader and tracks its residency.
+        *
+        * \param assetPath	Virtual path of the shader asset.
+        * \param shader     The loaded shader.
+        */
+        void registerShader(const std::string& assetPath, const Shader& shader);
+
+        /**
+        * \brief Helper function to get the raw shader code for a given shader asset.
+        *
+        * \param assetPath	The virtual asset path for the desired shader asset.
+        * \param error		Flag indicating an error occurred if set to True.
+        *
+        * \return A string containing the raw shader code of the requested shader asset, or an empty
+        * string if an error occurred fetching the asset.
+        */
+        std::string readShaderCode(const std::string& assetPath, bool* error);
 
         /**
         * \brief Loads a Material asset given by the provided virtual asset path.
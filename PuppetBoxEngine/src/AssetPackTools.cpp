@@ -0,0 +1,16 @@
+#include "AssetPackTools.h"
+
+#include "AssetCooker.h"
+
+namespace PB::Tools
+{
+    bool TimeAssetPackLoad(
+            const std::string& archiveRoot,
+            const std::string& archiveName,
+            bool fromPack,
+            double* milliseconds)
+    {
+        AssetCooker cooker{archiveName, archiveRoot};
+        return cooker.timeFullLoad(fromPack, milliseconds);
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+#include "puppetbox/TypeDef.h"
+
+/**
+ * Engine functions exported for the offline tools built alongside the engine, such as pbcook.  They are kept
+ * out of the public headers games build against, and tools include this header from the engine sources.
+ */
+namespace PB::Tools
+{
+    /**
+    * \brief Times a full load of every asset of an asset package, as on a cold start, from either its
+    * source archive or its cooked asset pack.  Nothing is uploaded to the GPU.
+    *
+    * <p>Does not need the engine to be initialized.  The source archive is loaded without its parsed asset
+    * cache, so every asset is parsed as on a first run, and the cache is left untouched.</p>
+    *
+    * \param archiveRoot  The directory containing the asset package, with a trailing separator.
+    * \param archiveName  The name of the asset package to load.
+    * \param fromPack     True to load the cooked asset pack, False to load the source archive.
+    * \param milliseconds Set to the time taken to load every asset.
+    * \return True if every asset was loaded, False otherwise.
+    */
+    extern PUPPET_BOX_API bool TimeAssetPackLoad(
+            const std::string& archiveRoot,
+            const std::string& archiveName,
+            bool fromPack,
+            double* milliseconds);
+}
@@ -0,0 +1,297 @@
+#include "AssetResidency.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "Logger.h"
+
+namespace PB
+{
+    struct ResidencyState
+    {
+        struct Entry
+        {
+            AssetType type = AssetType::MESH;
+            std::uint64_t cpuBytes = 0;
+            std::uint64_t gpuBytes = 0;
+            std::uint32_t references = 0;
+            std::uint64_t lastUsedFrame = 0;
+            bool pinned = false;
+            std::vector<AssetHandle> dependencies{};
+        };
+
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Entry> entries{};
+        std::uint64_t frame = 0;
+        std::uint64_t cpuBytes = 0;
+        std::uint64_t gpuBytes = 0;
+        std::uint64_t cpuBudget = UINT64_MAX;
+        std::uint64_t gpuBudget = UINT64_MAX;
+    };
+
+    namespace
+    {
+        ResidentAsset toResidentAsset(const std::string& assetPath, const ResidencyState::Entry& entry)
+        {
+            return ResidentAsset{
+                    assetPath,
+                    entry.type,
+                    entry.cpuBytes,
+                    entry.gpuBytes,
+                    entry.references,
+                    entry.pinned
+            };
+        }
+    }
+
+    AssetHandle::AssetHandle(std::weak_ptr<ResidencyState> state, std::string assetPath)
+            : state_(std::move(state)), assetPath_(std::move(assetPath))
+    {
+
+    }
+
+    AssetHandle::AssetHandle(const AssetHandle& other) : state_(other.state_), assetPath_(other.assetPath_)
+    {
+        auto state = state_.lock();
+
+        if (state != nullptr)
+        {
+            std::unique_lock<std::mutex> mlock(state->mutex);
+
+            auto itr = state->entries.find(assetPath_);
+
+            if (itr != state->entries.end())
+            {
+                ++itr->second.references;
+            }
+        }
+    }
+
+    AssetHandle::AssetHandle(AssetHandle&& other) noexcept
+            : state_(std::move(other.state_)), assetPath_(std::move(other.assetPath_))
+    {
+        other.state_.reset();
+        other.assetPath_.clear();
+    }
+
+    AssetHandle::~AssetHandle()
+    {
+        release();
+    }
+
+    AssetHandle& AssetHandle::operator=(const AssetHandle& other)
+    {
+        if (this != &other)
+        {
+            // Copy first, so that re-assigning a handle to the same asset never drops it to zero references
+            AssetHandle copy{other};
+            *this = std::move(copy);
+        }
+
+        return *this;
+    }
+
+    AssetHandle& AssetHandle::operator=(AssetHandle&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            state_ = std::move(other.state_);
+            assetPath_ = std::move(other.assetPath_);
+            other.state_.reset();
+            other.assetPath_.clear();
+        }
+
+        return *this;
+    }
+
+    bool AssetHandle::isValid() const
+    {
+        return !assetPath_.empty();
+    }
+
+    const std::string& AssetHandle::assetPath() const
+    {
+        return assetPath_;
+    }
+
+    void AssetHandle::release()
+    {
+        auto state = state_.lock();
+
+        if (state != nullptr)
+        {
+            std::unique_lock<std::mutex> mlock(state->mutex);
+
+            auto itr = state->entries.find(assetPath_);
+
+            if (itr != state->entries.end() && itr->second.references > 0)
+            {
+                --itr->second.references;
+                itr->second.lastUsedFrame = state->frame;
+            }
+        }
+
+        state_.reset();
+        assetPath_.clear();
+    }
+
+    AssetResidency::AssetResidency() : state_(std::make_shared<ResidencyState>())
+    {
+
+    }
+
+    void AssetResidency::track(
+            const std::string& assetPath,
+            AssetType type,
+            std::uint64_t cpuBytes,
+            std::uint64_t gpuBytes,
+            std::vector<AssetHandle> dependencies)
+    {
+        std::unique_lock<std::mutex> mlock(state_->mutex);
+
+        if (state_->entries.find(assetPath) == state_->entries.end())
+        {
+            ResidencyState::Entry entry{};
+            entry.type = type;
+            entry.cpuBytes = cpuBytes;
+            entry.gpuBytes = gpuBytes;
+            entry.lastUsedFrame = state_->frame;
+            entry.dependencies = std::move(dependencies);
+
+            state_->cpuBytes += cpuBytes;
+            state_->gpuBytes += gpuBytes;
+            state_->entries.insert(
+                    std::pair<std::string, ResidencyState::Entry>{assetPath, std::move(entry)}
+            );
+        }
+        else
+        {
+            LOGGER_WARN("Asset '" + assetPath + "' is already tracked as resident");
+        }
+    }
+
+    void AssetResidency::pin(const std::string& assetPath)
+    {
+        std::unique_lock<std::mutex> mlock(state_->mutex);
+
+        auto itr = state_->entries.find(assetPath);
+
+        if (itr != state_->entries.end())
+        {
+            itr->second.pinned = true;
+        }
+    }
+
+    AssetHandle AssetResidency::acquire(const std::string& assetPath)
+    {
+        std::unique_lock<std::mutex> mlock(state_->mutex);
+
+        auto itr = state_->entries.find(assetPath);
+
+        if (itr != state_->entries.end())
+        {
+            ++itr->second.references;
+            itr->second.lastUsedFrame = state_->frame;
+
+            return AssetHandle{state_, assetPath};
+        }
+
+        return AssetHandle{};
+    }
+
+    void AssetResidency::touch(const std::string& assetPath)
+    {
+        std::unique_lock<std::mutex> mlock(state_->mutex);
+
+        auto itr = state_->entries.find(assetPath);
+
+        if (itr != state_->entries.end())
+        {
+            itr->second.lastUsedFrame = state_->frame;
+        }
+    }
+
+    void AssetResidency::setBudget(std::uint64_t cpuBytes, std::uint64_t gpuBytes)
+    {
+        std::unique_lock<std::mutex> mlock(state_->mutex);
+
+        state_->cpuBudget = cpuBytes;
+        state_->gpuBudget = gpuBytes;
+    }
+
+    std::vector<ResidentAsset> AssetResidency::evict()
+    {
+        std::vector<ResidentAsset> evicted{};
+        bool evicting = true;
+
+        while (evicting)
+        {
+            // Declared outside of the lock, releasing the evicted asset's dependencies takes it again
+            std::vector<AssetHandle> dependencies{};
+
+            std::unique_lock<std::mutex> mlock(state_->mutex);
+
+            evicting = state_->cpuBytes > state_->cpuBudget || state_->gpuBytes > state_->gpuBudget;
+
+            if (evicting)
+            {
+                auto leastRecent = state_->entries.end();
+
+                for (auto itr = state_->entries.begin(); itr != state_->entries.end(); ++itr)
+                {
+                    const ResidencyState::Entry& entry = itr->second;
+
+                    if (!entry.pinned && entry.references == 0 && entry.lastUsedFrame < state_->frame
+                        && (leastRecent == state_->entries.end()
+                            || entry.lastUsedFrame < leastRecent->second.lastUsedFrame))
+                    {
+                        leastRecent = itr;
+                    }
+                }
+
+                if (leastRecent != state_->entries.end())
+                {
+                    evicted.push_back(toResidentAsset(leastRecent->first, leastRecent->second));
+                    state_->cpuBytes -= leastRecent->second.cpuBytes;
+                    state_->gpuBytes -= leastRecent->second.gpuBytes;
+                    dependencies = std::move(leastRecent->second.dependencies);
+                    state_->entries.erase(leastRecent);
+                }
+                else
+                {
+                    evicting = false;
+                }
+            }
+
+            mlock.unlock();
+        }
+
+        std::unique_lock<std::mutex> mlock(state_->mutex);
+        ++state_->frame;
+
+        return evicted;
+    }
+
+    std::vector<ResidentAsset> AssetResidency::residentAssets() const
+    {
+        std::vector<ResidentAsset> assets{};
+
+        {
+            std::unique_lock<std::mutex> mlock(state_->mutex);
+
+            assets.reserve(state_->entries.size());
+
+            for (const auto& entry: state_->entries)
+            {
+                assets.push_back(toResidentAsset(entry.first, entry.second));
+            }
+        }
+
+        std::sort(assets.begin(), assets.end(), [](const ResidentAsset& a, const ResidentAsset& b) {
+            return (a.cpuBytes + a.gpuBytes) > (b.cpuBytes + b.gpuBytes);
+        });
+
+        return assets;
+    }
+}
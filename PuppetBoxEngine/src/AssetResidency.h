@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "puppetbox/DataStructures.h"
+
+namespace PB
+{
+    /**
+    * \brief Shared bookkeeping of the assets tracked by an {\link AssetResidency}, outlives it for as
+    * long as any {\link AssetHandle} still refers to it.
+    */
+    struct ResidencyState;
+
+    /**
+    * \brief A counted reference to a resident asset, the asset can't be evicted while any handle to it exists.
+    *
+    * <p>Handles release their reference when destroyed, and copying a handle takes another reference.  A handle
+    * that outlives the {\link AssetResidency} it was acquired from does nothing when released.</p>
+    */
+    class AssetHandle
+    {
+    public:
+        AssetHandle() = default;
+
+        AssetHandle(const AssetHandle& other);
+
+        AssetHandle(AssetHandle&& other) noexcept;
+
+        ~AssetHandle();
+
+        AssetHandle& operator=(const AssetHandle& other);
+
+        AssetHandle& operator=(AssetHandle&& other) noexcept;
+
+        /**
+        * \brief Checks if the handle refers to an asset.
+        *
+        * \return True if the handle holds a reference to an asset, False if it is empty.
+        */
+        bool isValid() const;
+
+        /**
+        * \brief The virtual path of the referenced asset.
+        *
+        * \return The path of the referenced asset, or an empty string if the handle is empty.
+        */
+        const std::string& assetPath() const;
+
+    private:
+        friend class AssetResidency;
+
+        std::weak_ptr<ResidencyState> state_{};
+        std::string assetPath_{};
+
+    private:
+        AssetHandle(std::weak_ptr<ResidencyState> state, std::string assetPath);
+
+        void release();
+    };
+
+    /**
+    * \brief Tracks which assets are resident, how much CPU and GPU memory they hold, and how many references
+    * to them are alive, choosing the least recently used unreferenced assets to evict when over budget.
+    *
+    * <p>Only the bookkeeping lives here, freeing the evicted assets is left to the owner, which must do so on
+    * the thread that owns the GFX context.  Handles may be copied and released from any thread.</p>
+    */
+    class AssetResidency
+    {
+    public:
+        AssetResidency();
+
+        /**
+        * \brief Starts tracking a newly loaded asset, with no references to it.
+        *
+        * \param assetPath      Virtual path of the asset.
+        * \param type           The kind of asset.
+        * \param cpuBytes       Bytes the asset holds in main memory.
+        * \param gpuBytes       Bytes the asset holds in the GFX API.
+        * \param dependencies   Handles to other assets this one uses, released when this asset is evicted.
+        */
+        void track(
+                const std::string& assetPath,
+                AssetType type,
+                std::uint64_t cpuBytes,
+                std::uint64_t gpuBytes,
+                std::vector<AssetHandle> dependencies = {});
+
+        /**
+        * \brief Pins the given asset so that it is never evicted.
+        *
+        * \param assetPath Virtual path of the asset.
+        */
+        void pin(const std::string& assetPath);
+
+        /**
+        * \brief Takes a reference to the given asset, keeping it resident until the handle is released.
+        *
+        * \param assetPath Virtual path of the asset.
+        * \return A handle to the asset, or an empty handle if the asset isn't tracked.
+        */
+        AssetHandle acquire(const std::string& assetPath);
+
+        /**
+        * \brief Marks the given asset as used this frame, for cache hits that don't take a reference.
+        *
+        * \param assetPath Virtual path of the asset.
+        */
+        void touch(const std::string& assetPath);
+
+        /**
+        * \brief Sets the memory budgets that eviction brings resident assets back under.
+        *
+        * \param cpuBytes The main memory budget, in bytes.
+        * \param gpuBytes The GFX API memory budget, in bytes.
+        */
+        void setBudget(std::uint64_t cpuBytes, std::uint64_t gpuBytes);
+
+        /**
+        * \brief Ends the current frame, and stops tracking the least recently used unreferenced assets until
+        * both budgets are met, or no more assets can be evicted.  Pinned assets and assets used in the ending
+        * frame are never chosen.
+        *
+        * \return The evicted assets, in the order they were evicted, for the owner to free.
+        */
+        std::vector<ResidentAsset> evict();
+
+        /**
+        * \brief Lists the currently resident assets.
+        *
+        * \return The resident assets, largest first by combined CPU and GPU bytes.
+        */
+        std::vector<ResidentAsset> residentAssets() const;
+
+    private:
+        std::shared_ptr<ResidencyState> state_;
+    };
+}
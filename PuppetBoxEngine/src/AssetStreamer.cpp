@@ -0,0 +1,306 @@
+#include "AssetStreamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <unordered_set>
+
+namespace PB
+{
+    namespace
+    {
+        /**
+         * \brief Number of stages a streamed request goes through, reading, then uploading.
+         */
+        const std::uint32_t STREAM_STAGES = 2;
+
+        /**
+         * \brief Collects the mesh and material paths referenced by the given model data and its children.
+         *
+         * \param modelData     The model data to collect paths from.
+         * \param meshPaths     The set to add referenced mesh paths to.
+         * \param materialPaths The set to add referenced material paths to.
+         */
+        void collectAssetPaths(
+                const ModelData& modelData,
+                std::vector<std::string>& meshPaths,
+                std::vector<std::string>& materialPaths)
+        {
+            if (!modelData.mesh.dataPath.empty())
+            {
+                meshPaths.push_back(modelData.mesh.dataPath);
+
+                if (!modelData.mesh.materialPath.empty())
+                {
+                    materialPaths.push_back(modelData.mesh.materialPath);
+                }
+            }
+
+            for (const auto& child: modelData.children)
+            {
+                collectAssetPaths(child, meshPaths, materialPaths);
+            }
+        }
+    }
+
+    AssetStreamer::AssetStreamer(std::shared_ptr<AssetLibrary> assetLibrary, std::shared_ptr<WorkerPool> workerPool)
+            : assetLibrary_(std::move(assetLibrary)), workerPool_(std::move(workerPool))
+    {
+
+    }
+
+    PreloadHandle AssetStreamer::loadSceneObject(
+            const std::string& assetPath,
+            SceneObject* sceneObject,
+            UUID uuid,
+            IAnimationCatalogue* animationCatalogue)
+    {
+        auto request = std::make_shared<StreamRequest>();
+        request->assetPath = assetPath;
+        request->sceneObject = sceneObject;
+        request->uuid = uuid;
+        request->animationCatalogue = animationCatalogue;
+        request->state = std::make_shared<PreloadState>();
+        request->state->totalUnits = STREAM_STAGES;
+
+        PreloadHandle handle{request->state};
+
+        if (sceneObject == nullptr)
+        {
+            LOGGER_ERROR("SceneObject must be instantiated prior to streaming '" + assetPath + "'");
+            request->state->result.set_value(false);
+            return handle;
+        }
+
+        workerPool_->submit([this, request]() {
+            read(request);
+        });
+
+        return handle;
+    }
+
+    void AssetStreamer::setUploadBudget(float milliseconds, std::uint64_t bytes)
+    {
+        budgetMilliseconds_ = milliseconds;
+        budgetBytes_ = bytes;
+    }
+
+    void AssetStreamer::finalize()
+    {
+        collectReads();
+
+        const auto start = std::chrono::steady_clock::now();
+        std::uint64_t bytes = 0;
+        bool firstUpload = true;
+
+        while (!uploadRequests_.empty())
+        {
+            const float elapsed = std::chrono::duration<float, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+
+            // Always make at least one upload, or a single oversized asset would never load
+            if (!firstUpload && (elapsed >= budgetMilliseconds_ || bytes >= budgetBytes_))
+            {
+                break;
+            }
+
+            firstUpload = false;
+
+            StreamRequest& request = *uploadRequests_.front();
+
+            if (uploadNext(request, &bytes))
+            {
+                uploadRequests_.pop_front();
+            }
+            else if (request.compiling)
+            {
+                // The rest of the frame is left to rendering while the driver compiles
+                request.compiling = false;
+                break;
+            }
+        }
+    }
+
+    bool AssetStreamer::collectReads()
+    {
+        auto readRequest = readRequests_.pop();
+
+        while (readRequest.hasResult)
+        {
+            uploadRequests_.push_back(readRequest.result);
+            readRequest = readRequests_.pop();
+        }
+
+        return !uploadRequests_.empty();
+    }
+
+    std::size_t AssetStreamer::pendingUploads() const
+    {
+        return uploadRequests_.size();
+    }
+
+    void AssetStreamer::read(const std::shared_ptr<StreamRequest>& request)
+    {
+        request->modelData = assetLibrary_->readModelData(request->assetPath, &request->error);
+
+        if (!request->error)
+        {
+            readReferencedAssets(request->modelData, *request);
+        }
+
+        if (request->error)
+        {
+            LOGGER_ERROR("Failed to stream assets for '" + request->assetPath + "'");
+            complete(*request, false);
+        }
+        else
+        {
+            request->state->completedUnits++;
+            readRequests_.push(request);
+        }
+    }
+
+    void AssetStreamer::readReferencedAssets(const ModelData& modelData, StreamRequest& request)
+    {
+        std::vector<std::string> meshPaths{};
+        std::vector<std::string> materialPaths{};
+        collectAssetPaths(modelData, meshPaths, materialPaths);
+
+        std::unordered_set<std::string> readPaths{};
+
+        for (const auto& meshPath: meshPaths)
+        {
+            if (!request.error && readPaths.insert(meshPath).second)
+            {
+                request.meshes.emplace_back(meshPath, assetLibrary_->readMeshData(meshPath, &request.error));
+            }
+        }
+
+        for (const auto& materialPath: materialPaths)
+        {
+            if (!request.error && readPaths.insert(materialPath).second)
+            {
+                Material material = assetLibrary_->readMaterialData(materialPath, &request.error);
+
+                const std::string& imagePath = material.diffuseData.image;
+
+                if (!request.error && !imagePath.empty() && readPaths.insert(imagePath).second)
+                {
+                    request.images.emplace_back(imagePath, assetLibrary_->readImageData(imagePath, &request.error));
+                }
+
+                if (!request.error && readPaths.insert(material.shaderId).second)
+                {
+                    request.shaders.emplace_back(
+                            material.shaderId,
+                            assetLibrary_->readShaderSource(material.shaderId, &request.error));
+                }
+
+                request.materials.emplace_back(materialPath, material);
+            }
+        }
+    }
+
+    bool AssetStreamer::uploadNext(StreamRequest& request, std::uint64_t* bytes)
+    {
+        // Images first, so materials find them cached, and everything before the object that uses them
+        std::size_t upload = request.error ? SIZE_MAX : request.nextUpload++;
+
+        if (upload < request.images.size())
+        {
+            ImageData& imageData = request.images[upload].second;
+            *bytes += imageData.byteSize();
+
+            assetLibrary_->uploadImage(
+                    request.images[upload].first,
+                    imageData,
+                    {ImageOptions::Mode::CLAMP_TO_BORDER},
+                    &request.error);
+
+            return false;
+        }
+
+        upload -= std::min(upload, request.images.size());
+
+        if (upload < request.meshes.size())
+        {
+            MeshSource& meshData = request.meshes[upload].second;
+            *bytes += meshData.size();
+
+            assetLibrary_->uploadMesh(request.meshes[upload].first, meshData);
+
+            return false;
+        }
+
+        upload -= std::min(upload, request.meshes.size());
+
+        if (upload < request.shaders.size())
+        {
+            // Every shader is submitted at once, so a driver that compiles in parallel works on all of them together
+            for (std::size_t i = upload; i < request.shaders.size() && !request.shadersSubmitted; ++i)
+            {
+                const ShaderSource& source = request.shaders[i].second;
+                *bytes += source.vertexCode.size() + source.geometryCode.size() + source.fragmentCode.size();
+
+                assetLibrary_->beginShaderCompile(request.shaders[i].first, source, &request.error);
+            }
+
+            request.shadersSubmitted = true;
+
+            if (!assetLibrary_->pollShaderCompile(request.shaders[upload].first, &request.error))
+            {
+                // Polled again next frame, rather than waiting on the driver
+                request.nextUpload--;
+                request.compiling = true;
+            }
+
+            return false;
+        }
+
+        upload -= std::min(upload, request.shaders.size());
+
+        if (upload < request.materials.size())
+        {
+            assetLibrary_->registerMaterial(
+                    request.materials[upload].first,
+                    request.materials[upload].second,
+                    &request.error);
+
+            return false;
+        }
+
+        // Everything is cached by now, so building the object makes no further reads or uploads
+        bool success = !request.error && assetLibrary_->buildSceneObject(
+                request.assetPath,
+                request.modelData,
+                request.sceneObject,
+                request.uuid,
+                request.animationCatalogue);
+
+        if (!success)
+        {
+            LOGGER_ERROR("Failed to stream assets for '" + request.assetPath + "'");
+        }
+
+        complete(request, success);
+
+        return true;
+    }
+
+    void AssetStreamer::complete(StreamRequest& request, bool success)
+    {
+        // Image data that was never uploaded still holds decoded pixels
+        for (auto& image: request.images)
+        {
+            image.second.clear();
+        }
+
+        request.images.clear();
+        request.meshes.clear();
+        request.shaders.clear();
+        request.materials.clear();
+
+        request.state->completedUnits = STREAM_STAGES;
+        request.state->result.set_value(success);
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "puppetbox/DataStructures.h"
+#include "puppetbox/IAnimationCatalogue.h"
+#include "puppetbox/SceneObject.h"
+
+#include "AssetLibrary.h"
+#include "WorkerPool.h"
+
+namespace PB
+{
+    /**
+     * \brief Streams assets in the background, reading and decoding them on worker threads, then uploading
+     * them to the GFX API on the main thread within a per-frame budget.
+     *
+     * <p>Requests move through two stages, a read stage on a worker thread that produces CPU side data
+     * (archive reads, inflating, image decoding, and text parsing), and an upload stage on the main thread,
+     * run by {\link AssetStreamer::finalize} once per frame, that hands the data to the GFX API.  Shaders are
+     * compiled by the driver across frames where it supports parallel compiles, the upload stage polls them
+     * instead of waiting.</p>
+     */
+    class AssetStreamer
+    {
+    public:
+        /**
+         * \brief Creates an asset streamer that reads through the given library on the given workers.
+         *
+         * \param assetLibrary The {\link AssetLibrary} to read assets through, and cache uploaded assets in.
+         * \param workerPool   The {\link WorkerPool} to run read stages on.
+         */
+        AssetStreamer(std::shared_ptr<AssetLibrary> assetLibrary, std::shared_ptr<WorkerPool> workerPool);
+
+        /**
+         * \brief Starts streaming the given scene object's assets, the scene object is loaded on the main
+         * thread once all of its assets are uploaded.
+         *
+         * <p>The scene object must stay alive until the returned handle is done.  The handle must not be
+         * waited on from the main thread, as the upload stage runs there.</p>
+         *
+         * \param assetPath		    Virtual path to the requested asset.
+         * \param sceneObject	    The instantiated scene object to load with asset data.
+         * \param uuid               The UUID to use for the created {\link SceneObject}
+         * \param animationCatalogue The {\link PB::IAnimationCatalogue} to use with the object model.
+         * \return A {\link PreloadHandle} to track the load with.
+         */
+        PreloadHandle loadSceneObject(
+                const std::string& assetPath,
+                SceneObject* sceneObject,
+                UUID uuid,
+                IAnimationCatalogue* animationCatalogue);
+
+        /**
+         * \brief Sets the budget for uploads per call to {\link AssetStreamer::finalize}, whichever limit is
+         * reached first ends the frame's uploads.  At least one upload is always made per frame.
+         *
+         * \param milliseconds The time budget, in milliseconds.
+         * \param bytes        The byte budget.
+         */
+        void setUploadBudget(float milliseconds, std::uint64_t bytes);
+
+        /**
+         * \brief Runs pending uploads within the upload budget, must be called from the main thread.
+         */
+        void finalize();
+
+        /**
+         * \brief Moves requests that finished their read stage into the upload stage, must be called from the
+         * main thread.  Lets the caller find out whether {\link AssetStreamer::finalize} has any uploads to make
+         * before giving it the GFX API.
+         *
+         * \return True if any requests are waiting on, or in the middle of, uploads, False otherwise.
+         */
+        bool collectReads();
+
+        /**
+         * \brief Gets the number of requests that are read and waiting on, or in the middle of, uploads.
+         *
+         * \return The number of requests in the upload stage.
+         */
+        std::size_t pendingUploads() const;
+
+    private:
+        struct StreamRequest
+        {
+            std::string assetPath;
+            SceneObject* sceneObject = nullptr;
+            UUID uuid{};
+            IAnimationCatalogue* animationCatalogue = nullptr;
+            ModelData modelData{};
+            std::vector<std::pair<std::string, ImageData>> images{};
+            std::vector<std::pair<std::string, MeshSource>> meshes{};
+            std::vector<std::pair<std::string, ShaderSource>> shaders{};
+            std::vector<std::pair<std::string, Material>> materials{};
+            std::uint32_t nextUpload = 0;
+            /** Whether the shaders were handed to the driver to compile */
+            bool shadersSubmitted = false;
+            /** Whether the last upload is still waiting on the driver to compile a shader */
+            bool compiling = false;
+            bool error = false;
+            std::shared_ptr<PreloadState> state{};
+        };
+
+    private:
+        /**
+         * \brief Reads and decodes all the assets of the given request, run on a worker thread.
+         *
+         * \param request The request to read assets for.
+         */
+        void read(const std::shared_ptr<StreamRequest>& request);
+
+        /**
+         * \brief Reads the assets referenced by the given model data and its children.
+         *
+         * \param modelData The model data to read referenced assets for.
+         * \param request   The request to add read assets to.
+         */
+        void readReferencedAssets(const ModelData& modelData, StreamRequest& request);
+
+        /**
+         * \brief Makes the next upload for the given request, building the scene object once all
+         * uploads are made.
+         *
+         * \param request The request to make the next upload for.
+         * \param bytes   Incremented by the number of bytes uploaded.
+         * \return True if the request is complete, False if it has more uploads to make.
+         */
+        bool uploadNext(StreamRequest& request, std::uint64_t* bytes);
+
+        /**
+         * \brief Completes the given request, releasing any data that wasn't uploaded.
+         *
+         * \param request The request to complete.
+         * \param success Whether the request succeeded.
+         */
+        static void complete(StreamRequest& request, bool success);
+
+    private:
+        std::shared_ptr<AssetLibrary> assetLibrary_;
+        std::shared_ptr<WorkerPool> workerPool_;
+        float budgetMilliseconds_ = 2.0f;
+        std::uint64_t budgetBytes_ = 4 * 1024 * 1024;
+        /** Requests that finished their read stage, handed from worker threads to the main thread */
+        Concurrent::NonBlocking::Queue<std::shared_ptr<StreamRequest>> readRequests_{};
+        /** Requests in the upload stage, only touched by the main thread */
+        std::deque<std::shared_ptr<StreamRequest>> uploadRequests_{};
+    };
+}
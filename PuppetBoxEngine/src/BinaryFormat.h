@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Little-endian readers and writers shared by the engine's binary asset formats and the offline tools
+ * that produce them, so it must not depend on anything outside the standard library.
+ */
+namespace PB::BinaryFormat
+{
+    inline std::uint16_t readUInt16(const std::uint8_t* bytes)
+    {
+        return static_cast<std::uint16_t>(bytes[0] | (bytes[1] << 8));
+    }
+
+    inline std::int16_t readInt16(const std::uint8_t* bytes)
+    {
+        return static_cast<std::int16_t>(readUInt16(bytes));
+    }
+
+    inline std::uint32_t readUInt32(const std::uint8_t* bytes)
+    {
+        return static_cast<std::uint32_t>(bytes[0])
+               | (static_cast<std::uint32_t>(bytes[1]) << 8)
+               | (static_cast<std::uint32_t>(bytes[2]) << 16)
+               | (static_cast<std::uint32_t>(bytes[3]) << 24);
+    }
+
+    inline float readFloat(const std::uint8_t* bytes)
+    {
+        std::uint32_t bits = readUInt32(bytes);
+        float value;
+        std::memcpy(&value, &bits, sizeof(float));
+        return value;
+    }
+
+    inline void writeUInt16(std::uint8_t* bytes, std::uint16_t value)
+    {
+        bytes[0] = static_cast<std::uint8_t>(value & 0xFF);
+        bytes[1] = static_cast<std::uint8_t>((value >> 8) & 0xFF);
+    }
+
+    inline void writeUInt32(std::uint8_t* bytes, std::uint32_t value)
+    {
+        bytes[0] = static_cast<std::uint8_t>(value & 0xFF);
+        bytes[1] = static_cast<std::uint8_t>((value >> 8) & 0xFF);
+        bytes[2] = static_cast<std::uint8_t>((value >> 16) & 0xFF);
+        bytes[3] = static_cast<std::uint8_t>((value >> 24) & 0xFF);
+    }
+
+    inline void writeFloat(std::uint8_t* bytes, float value)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(float));
+        writeUInt32(bytes, bits);
+    }
+
+    /**
+     * \brief Computes the CRC-32 (as used by zip) of the given bytes.
+     *
+     * \param bytes  The bytes to checksum.
+     * \param length The number of bytes.
+     * \param crc    The CRC of any preceding bytes, to checksum data in pieces.
+     * \return The CRC of the bytes.
+     */
+    inline std::uint32_t crc32(const std::uint8_t* bytes, std::size_t length, std::uint32_t crc = 0)
+    {
+        static const auto table = []() {
+            std::vector<std::uint32_t> values(256);
+
+            for (std::uint32_t i = 0; i < 256; ++i)
+            {
+                std::uint32_t value = i;
+
+                for (std::uint32_t bit = 0; bit < 8; ++bit)
+                {
+                    value = (value & 1) ? 0xEDB88320 ^ (value >> 1) : value >> 1;
+                }
+
+                values[i] = value;
+            }
+
+            return values;
+        }();
+
+        crc = ~crc;
+
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+        }
+
+        return ~crc;
+    }
+
+    constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+    /**
+     * \brief Computes the 64-bit FNV-1a hash of the given bytes.
+     *
+     * \param bytes  The bytes to hash.
+     * \param length The number of bytes.
+     * \param hash   The hash of any preceding bytes, to hash data in pieces.
+     * \return The hash of the bytes.
+     */
+    inline std::uint64_t hashBytes(const void* bytes, std::size_t length, std::uint64_t hash = FNV_OFFSET_BASIS)
+    {
+        const auto* data = static_cast<const std::uint8_t*>(bytes);
+
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            hash ^= data[i];
+            hash *= FNV_PRIME;
+        }
+
+        return hash;
+    }
+
+    /**
+     * \brief Mixes a whole word into an FNV-1a style hash in one step, faster than {\link hashBytes} for
+     * in-memory keys but giving different hashes, so it must not be used for anything written to disk.
+     *
+     * \param value The word to mix in.
+     * \param hash  The hash of any preceding words.
+     * \return The hash with the word mixed in.
+     */
+    inline std::uint64_t hashWord(std::uint64_t value, std::uint64_t hash = FNV_OFFSET_BASIS)
+    {
+        return (hash ^ value) * FNV_PRIME;
+    }
+
+    /**
+     * \brief Appends little-endian values to a growing byte buffer.
+     */
+    class Writer
+    {
+    public:
+        void writeUInt8(std::uint8_t value)
+        {
+            bytes_.push_back(value);
+        }
+
+        void writeUInt16(std::uint16_t value)
+        {
+            const std::size_t offset = grow(2);
+            BinaryFormat::writeUInt16(&bytes_[offset], value);
+        }
+
+        void writeUInt32(std::uint32_t value)
+        {
+            const std::size_t offset = grow(4);
+            BinaryFormat::writeUInt32(&bytes_[offset], value);
+        }
+
+        void writeFloat(float value)
+        {
+            const std::size_t offset = grow(4);
+            BinaryFormat::writeFloat(&bytes_[offset], value);
+        }
+
+        /**
+         * \brief Writes a string as a uint16 length followed by its characters, longer strings are cut off.
+         */
+        void writeString(const std::string& value)
+        {
+            const auto length = static_cast<std::uint16_t>(std::min<std::size_t>(value.size(), UINT16_MAX));
+            writeUInt16(length);
+            bytes_.insert(bytes_.end(), value.begin(), value.begin() + length);
+        }
+
+        void writeBytes(const std::uint8_t* data, std::size_t size)
+        {
+            bytes_.insert(bytes_.end(), data, data + size);
+        }
+
+        /**
+         * \brief Pads the buffer with zeros up to the next multiple of the given alignment.
+         */
+        void align(std::size_t alignment)
+        {
+            bytes_.resize(((bytes_.size() + alignment - 1) / alignment) * alignment, 0);
+        }
+
+        std::size_t size() const
+        {
+            return bytes_.size();
+        }
+
+        std::vector<std::uint8_t>& bytes()
+        {
+            return bytes_;
+        }
+
+    private:
+        std::size_t grow(std::size_t size)
+        {
+            const std::size_t offset = bytes_.size();
+            bytes_.resize(offset + size);
+            return offset;
+        }
+
+    private:
+        std::vector<std::uint8_t> bytes_{};
+    };
+
+    /**
+     * \brief Reads little-endian values from a byte buffer in order, reads past the end of the buffer
+     * return 0 or empty values and mark the reader as overrun.
+     */
+    class Reader
+    {
+    public:
+        Reader(const std::uint8_t* bytes, std::size_t length) : bytes_(bytes), length_(length)
+        {
+
+        }
+
+        std::uint8_t readUInt8()
+        {
+            return has(1) ? bytes_[offset_++] : 0;
+        }
+
+        std::uint16_t readUInt16()
+        {
+            return has(2) ? BinaryFormat::readUInt16(advance(2)) : 0;
+        }
+
+        std::uint32_t readUInt32()
+        {
+            return has(4) ? BinaryFormat::readUInt32(advance(4)) : 0;
+        }
+
+        float readFloat()
+        {
+            return has(4) ? BinaryFormat::readFloat(advance(4)) : 0.0f;
+        }
+
+        std::string readString()
+        {
+            const std::uint16_t length = readUInt16();
+            return has(length) ? std::string(reinterpret_cast<const char*>(advance(length)), length) : "";
+        }
+
+        /**
+         * \brief Skips over the given number of bytes, returning a pointer to them.
+         *
+         * \return A pointer to the skipped bytes, or nullptr if there are not enough bytes left.
+         */
+        const std::uint8_t* readBytes(std::size_t size)
+        {
+            return has(size) ? advance(size) : nullptr;
+        }
+
+        std::size_t offset() const
+        {
+            return offset_;
+        }
+
+        std::size_t remaining() const
+        {
+            return length_ - offset_;
+        }
+
+        /**
+         * \brief Checks if any read went past the end of the buffer.
+         */
+        bool overrun() const
+        {
+            return overrun_;
+        }
+
+    private:
+        bool has(std::size_t size)
+        {
+            overrun_ = overrun_ || size > length_ - offset_;
+            return !overrun_;
+        }
+
+        const std::uint8_t* advance(std::size_t size)
+        {
+            const std::uint8_t* position = bytes_ + offset_;
+            offset_ += size;
+            return position;
+        }
+
+    private:
+        const std::uint8_t* bytes_;
+        std::size_t length_;
+        std::size_t offset_ = 0;
+        bool overrun_ = false;
+    };
+}
@@ -0,0 +1,298 @@
+#include "CommandList.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace PB
+{
+    namespace
+    {
+        /**
+        * \brief Alignment of every piece of data in a list, so uniform values can be read in place.
+        */
+        constexpr std::uint32_t DATA_ALIGNMENT = 4;
+    }
+
+    void CommandList::useProgram(std::uint32_t programId)
+    {
+        RenderCommand command{RenderCommandType::USE_PROGRAM};
+        command.useProgram.programId = programId;
+        commands_.push_back(command);
+    }
+
+    void CommandList::bindTexture(std::uint32_t slot, std::uint32_t textureId)
+    {
+        RenderCommand command{RenderCommandType::BIND_TEXTURE};
+        command.bindTexture.slot = slot;
+        command.bindTexture.textureId = textureId;
+        commands_.push_back(command);
+    }
+
+    void CommandList::bindVertexArray(std::uint32_t vertexArrayId)
+    {
+        RenderCommand command{RenderCommandType::BIND_VERTEX_ARRAY};
+        command.bindVertexArray.vertexArrayId = vertexArrayId;
+        commands_.push_back(command);
+    }
+
+    void CommandList::setBlending(bool enabled)
+    {
+        RenderCommand command{RenderCommandType::SET_BLENDING};
+        command.setBlending.enabled = enabled;
+        commands_.push_back(command);
+    }
+
+    void CommandList::setUniform(UniformHandle<bool> uniform, bool value)
+    {
+        const std::int32_t intValue = value;
+        setUniform(uniform.location, UniformType::INT, 1, &intValue, sizeof(intValue));
+    }
+
+    void CommandList::setUniform(UniformHandle<std::int32_t> uniform, std::int32_t value)
+    {
+        setUniform(uniform.location, UniformType::INT, 1, &value, sizeof(value));
+    }
+
+    void CommandList::setUniform(UniformHandle<std::uint32_t> uniform, std::uint32_t value)
+    {
+        setUniform(uniform.location, UniformType::UINT, 1, &value, sizeof(value));
+    }
+
+    void CommandList::setUniform(UniformHandle<float> uniform, float value)
+    {
+        setUniform(uniform.location, UniformType::FLOAT, 1, &value, sizeof(value));
+    }
+
+    void CommandList::setUniform(UniformHandle<float> uniform, std::uint32_t count, const float* values)
+    {
+        setUniform(uniform.location, UniformType::FLOAT, count, values, count * sizeof(float));
+    }
+
+    void CommandList::setUniform(UniformHandle<vec2> uniform, const vec2& value)
+    {
+        setUniform(uniform.location, UniformType::VEC2, 1, &value[0], sizeof(vec2));
+    }
+
+    void CommandList::setUniform(UniformHandle<vec3> uniform, const vec3& value)
+    {
+        setUniform(uniform.location, UniformType::VEC3, 1, &value[0], sizeof(vec3));
+    }
+
+    void CommandList::setUniform(UniformHandle<vec4> uniform, const vec4& value)
+    {
+        setUniform(uniform.location, UniformType::VEC4, 1, &value[0], sizeof(vec4));
+    }
+
+    void CommandList::setUniform(UniformHandle<mat4> uniform, const mat4& value)
+    {
+        setUniform(uniform.location, UniformType::MAT4, 1, &value[0][0], sizeof(mat4));
+    }
+
+    void CommandList::setUniform(
+            std::int32_t location,
+            UniformType type,
+            std::uint32_t count,
+            const void* values,
+            std::uint32_t size)
+    {
+        // Inactive uniforms are skipped here rather than left for the backend to ignore
+        if (location < 0)
+        {
+            return;
+        }
+
+        RenderCommand command{RenderCommandType::SET_UNIFORM};
+        command.setUniform.location = location;
+        command.setUniform.uniformType = type;
+        command.setUniform.count = count;
+        command.setUniform.dataOffset = writeData(values, size);
+        commands_.push_back(command);
+    }
+
+    void CommandList::upload(UploadUsage usage, const void* data, std::uint32_t size)
+    {
+        RenderCommand command{RenderCommandType::UPLOAD};
+        command.upload.usage = usage;
+        command.upload.size = size;
+        command.upload.dataOffset = writeData(data, size);
+        commands_.push_back(command);
+    }
+
+    void CommandList::bindUniformRange(std::uint32_t binding, std::uint32_t offset, std::uint32_t size)
+    {
+        RenderCommand command{RenderCommandType::BIND_UNIFORM_RANGE};
+        command.bindUniformRange.binding = binding;
+        command.bindUniformRange.offset = offset;
+        command.bindUniformRange.size = size;
+        commands_.push_back(command);
+    }
+
+    void CommandList::setInstanceAttribute(
+            std::uint32_t location,
+            std::uint32_t components,
+            std::uint32_t stride,
+            std::uint32_t offset)
+    {
+        RenderCommand command{RenderCommandType::SET_INSTANCE_ATTRIBUTE};
+        command.setInstanceAttribute.location = location;
+        command.setInstanceAttribute.components = components;
+        command.setInstanceAttribute.stride = stride;
+        command.setInstanceAttribute.offset = offset;
+        commands_.push_back(command);
+    }
+
+    void CommandList::clearInstanceAttribute(std::uint32_t location)
+    {
+        RenderCommand command{RenderCommandType::CLEAR_INSTANCE_ATTRIBUTE};
+        command.clearInstanceAttribute.location = location;
+        commands_.push_back(command);
+    }
+
+    void CommandList::draw(const Mesh& mesh, std::uint32_t instanceCount)
+    {
+        RenderCommand command{RenderCommandType::DRAW};
+        command.draw.count = static_cast<std::uint32_t>(mesh.drawCount);
+        command.draw.indexSize = mesh.EBO != 0 ? mesh.indexSize : 0;
+        command.draw.instanceCount = instanceCount;
+        command.draw.firstIndex = mesh.firstIndex;
+        command.draw.baseVertex = mesh.baseVertex;
+        commands_.push_back(command);
+    }
+
+    void CommandList::drawArrays(std::uint32_t vertexCount, std::uint32_t instanceCount)
+    {
+        RenderCommand command{RenderCommandType::DRAW};
+        command.draw.count = vertexCount;
+        command.draw.indexSize = 0;
+        command.draw.instanceCount = instanceCount;
+        command.draw.firstIndex = 0;
+        command.draw.baseVertex = 0;
+        commands_.push_back(command);
+    }
+
+    void CommandList::multiDrawIndirect(
+            const DrawIndirectCommand* commands,
+            std::uint32_t drawCount,
+            std::uint32_t indexSize)
+    {
+        upload(UploadUsage::INDIRECT_COMMANDS, commands, drawCount * static_cast<std::uint32_t>(sizeof(*commands)));
+
+        RenderCommand command{RenderCommandType::MULTI_DRAW_INDIRECT};
+        command.multiDrawIndirect.drawCount = drawCount;
+        command.multiDrawIndirect.indexSize = indexSize;
+        command.multiDrawIndirect.dataOffset = commands_.back().upload.dataOffset;
+        commands_.push_back(command);
+    }
+
+    void CommandList::beginPass(RenderPass pass)
+    {
+        RenderCommand command{RenderCommandType::BEGIN_PASS};
+        command.beginPass.pass = pass;
+        commands_.push_back(command);
+    }
+
+    void CommandList::endPass()
+    {
+        commands_.push_back(RenderCommand{RenderCommandType::END_PASS});
+    }
+
+    void CommandList::addStats(RenderStats& stats) const
+    {
+        for (const RenderCommand& command: commands_)
+        {
+            ++stats.commands;
+
+            switch (command.type)
+            {
+                case RenderCommandType::USE_PROGRAM:
+                    ++stats.programBinds;
+                    break;
+                case RenderCommandType::BIND_TEXTURE:
+                    ++stats.textureBinds;
+                    break;
+                case RenderCommandType::BIND_VERTEX_ARRAY:
+                    ++stats.vertexArrayBinds;
+                    break;
+                case RenderCommandType::SET_BLENDING:
+                    ++stats.stateChanges;
+                    break;
+                case RenderCommandType::SET_UNIFORM:
+                    ++stats.uniformSets;
+                    break;
+                case RenderCommandType::BIND_UNIFORM_RANGE:
+                    ++stats.uniformRangeBinds;
+                    break;
+                case RenderCommandType::SET_INSTANCE_ATTRIBUTE:
+                case RenderCommandType::CLEAR_INSTANCE_ATTRIBUTE:
+                    ++stats.instanceAttributeSets;
+                    break;
+                case RenderCommandType::UPLOAD:
+                    stats.uploadedBytes += command.upload.size;
+                    break;
+                case RenderCommandType::DRAW:
+                    ++stats.drawCalls;
+                    stats.instances += command.draw.instanceCount;
+                    // Everything is drawn as triangle lists
+                    stats.triangles += static_cast<std::uint64_t>(command.draw.count / 3)
+                                       * std::max(command.draw.instanceCount, 1u);
+                    break;
+                case RenderCommandType::MULTI_DRAW_INDIRECT:
+                {
+                    // Submitted with one call, however many draws it makes
+                    ++stats.drawCalls;
+
+                    const auto* draws = reinterpret_cast<const DrawIndirectCommand*>(
+                            data(command.multiDrawIndirect.dataOffset));
+
+                    for (std::uint32_t i = 0; i < command.multiDrawIndirect.drawCount; ++i)
+                    {
+                        stats.instances += draws[i].instanceCount;
+                        stats.triangles += static_cast<std::uint64_t>(draws[i].count / 3) * draws[i].instanceCount;
+                    }
+                    break;
+                }
+                case RenderCommandType::BEGIN_PASS:
+                case RenderCommandType::END_PASS:
+                    break;
+            }
+        }
+    }
+
+    void CommandList::reset()
+    {
+        commands_.clear();
+        data_.clear();
+    }
+
+    void CommandList::swap(CommandList& other)
+    {
+        commands_.swap(other.commands_);
+        data_.swap(other.data_);
+    }
+
+    const std::vector<RenderCommand>& CommandList::commands() const
+    {
+        return commands_;
+    }
+
+    const std::uint8_t* CommandList::data(std::uint32_t offset) const
+    {
+        return data_.data() + offset;
+    }
+
+    std::uint32_t CommandList::dataSize() const
+    {
+        return static_cast<std::uint32_t>(data_.size());
+    }
+
+    std::uint32_t CommandList::writeData(const void* data, std::uint32_t size)
+    {
+        const auto offset = static_cast<std::uint32_t>(data_.size());
+        const std::uint32_t paddedSize = ((size + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT) * DATA_ALIGNMENT;
+
+        data_.resize(offset + paddedSize);
+        std::memcpy(data_.data() + offset, data, size);
+
+        return offset;
+    }
+}
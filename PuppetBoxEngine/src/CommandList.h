@@ -0,0 +1,364 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "puppetbox/DataStructures.h"
+
+#include "Mesh.h"
+#include "Shader.h"
+
+namespace PB
+{
+    /**
+    * \brief The kinds of {\link RenderCommand} a {\link CommandList} can record.
+    */
+    enum class RenderCommandType : std::uint8_t
+    {
+        USE_PROGRAM,
+        BIND_TEXTURE,
+        BIND_VERTEX_ARRAY,
+        SET_BLENDING,
+        SET_UNIFORM,
+        UPLOAD,
+        BIND_UNIFORM_RANGE,
+        SET_INSTANCE_ATTRIBUTE,
+        CLEAR_INSTANCE_ATTRIBUTE,
+        DRAW,
+        MULTI_DRAW_INDIRECT,
+        BEGIN_PASS,
+        END_PASS,
+    };
+
+    /**
+    * \brief The value types a SET_UNIFORM {\link RenderCommand} can hold.
+    */
+    enum class UniformType : std::uint8_t
+    {
+        INT,
+        UINT,
+        FLOAT,
+        VEC2,
+        VEC3,
+        VEC4,
+        MAT4,
+    };
+
+    /**
+    * \brief What the data of an UPLOAD {\link RenderCommand} is read as, deciding how the backend aligns it.
+    */
+    enum class UploadUsage : std::uint8_t
+    {
+        INSTANCE_DATA,
+        UNIFORM_BLOCK,
+        INDIRECT_COMMANDS,
+    };
+
+    /**
+    * \brief Parameters of one indexed draw of a MULTI_DRAW_INDIRECT {\link RenderCommand}, laid out as the
+    * gfx API reads them from the indirect buffer.
+    */
+    struct DrawIndirectCommand
+    {
+        std::uint32_t count = 0;
+        std::uint32_t instanceCount = 0;
+        std::uint32_t firstIndex = 0;
+        std::int32_t baseVertex = 0;
+        /** Offset of the draw's first instance in the instance attributes */
+        std::uint32_t baseInstance = 0;
+    };
+
+    /**
+    * \brief A single recorded rendering command, referring to any data it carries by its offset into the
+    * recording {\link CommandList}.
+    */
+    struct RenderCommand
+    {
+        RenderCommandType type;
+        union
+        {
+            struct
+            {
+                std::uint32_t programId;
+            } useProgram;
+            struct
+            {
+                std::uint32_t slot;
+                std::uint32_t textureId;
+            } bindTexture;
+            struct
+            {
+                std::uint32_t vertexArrayId;
+            } bindVertexArray;
+            struct
+            {
+                bool enabled;
+            } setBlending;
+            struct
+            {
+                std::int32_t location;
+                UniformType uniformType;
+                std::uint32_t count;
+                std::uint32_t dataOffset;
+            } setUniform;
+            struct
+            {
+                UploadUsage usage;
+                std::uint32_t size;
+                std::uint32_t dataOffset;
+            } upload;
+            /** Offset is relative to the start of the last upload */
+            struct
+            {
+                std::uint32_t binding;
+                std::uint32_t offset;
+                std::uint32_t size;
+            } bindUniformRange;
+            /** Offset is relative to the start of the last upload */
+            struct
+            {
+                std::uint32_t location;
+                std::uint32_t components;
+                std::uint32_t stride;
+                std::uint32_t offset;
+            } setInstanceAttribute;
+            struct
+            {
+                std::uint32_t location;
+            } clearInstanceAttribute;
+            /** Index size is 0 for non indexed draws, instance count is 0 for non instanced draws */
+            struct
+            {
+                std::uint32_t count;
+                std::uint32_t indexSize;
+                std::uint32_t instanceCount;
+                std::uint32_t firstIndex;
+                std::int32_t baseVertex;
+            } draw;
+            /** The draws are read from the last upload, which is also kept at dataOffset for the CPU */
+            struct
+            {
+                std::uint32_t drawCount;
+                std::uint32_t indexSize;
+                std::uint32_t dataOffset;
+            } multiDrawIndirect;
+            struct
+            {
+                RenderPass pass;
+            } beginPass;
+        };
+    };
+
+    static_assert(std::is_trivially_copyable<RenderCommand>::value, "RenderCommands are copied as raw bytes");
+
+    /**
+    * \brief Records draw, bind, upload, and state commands to be submitted to an {\link IGfxApi} backend
+    * later, instead of calling the gfx API directly, so draw data can be built without a gfx context.
+    *
+    * <p>Commands are kept as fixed size {\link RenderCommand}s, with uniform values and uploaded data copied
+    * into a single byte buffer alongside them.  Both are kept between frames when the list is reset, so
+    * recording doesn't allocate once the list has grown to fit a frame.</p>
+    *
+    * <p>A list is recorded by one thread at a time, so each thread building draw data records into its own
+    * list, and the lists are submitted in the order they are to be drawn.</p>
+    *
+    * <p>Uploaded data is placed by the backend when the list is submitted, so the commands drawing from it
+    * refer to it by offsets relative to the start of the last upload.</p>
+    */
+    class CommandList
+    {
+    public:
+        /**
+        * \brief Uses the given shader program for the commands that follow.
+        *
+        * \param programId The gfx API specific ID of the program, or 0 for none.
+        */
+        void useProgram(std::uint32_t programId);
+
+        /**
+        * \brief Binds a texture to the given texture slot.
+        *
+        * \param slot      The texture slot to bind to, starting at 0.
+        * \param textureId The gfx API specific ID of the texture, or 0 to unbind the slot.
+        */
+        void bindTexture(std::uint32_t slot, std::uint32_t textureId);
+
+        /**
+        * \brief Binds the vertex array drawn by the draw commands that follow.
+        *
+        * \param vertexArrayId The gfx API specific ID of the vertex array, or 0 for none.
+        */
+        void bindVertexArray(std::uint32_t vertexArrayId);
+
+        /**
+        * \brief Enables or disables alpha blending.
+        *
+        * \param enabled True to enable alpha blending, False to disable it.
+        */
+        void setBlending(bool enabled);
+
+        /**
+        * \brief Sets uniform values of the program in use when the command is executed.
+        *
+        * \param uniform The uniform to set, does nothing if it isn't active.
+        * \param value   The value to set.
+        */
+        void setUniform(UniformHandle<bool> uniform, bool value);
+
+        void setUniform(UniformHandle<std::int32_t> uniform, std::int32_t value);
+
+        void setUniform(UniformHandle<std::uint32_t> uniform, std::uint32_t value);
+
+        void setUniform(UniformHandle<float> uniform, float value);
+
+        void setUniform(UniformHandle<float> uniform, std::uint32_t count, const float* values);
+
+        void setUniform(UniformHandle<vec2> uniform, const vec2& value);
+
+        void setUniform(UniformHandle<vec3> uniform, const vec3& value);
+
+        void setUniform(UniformHandle<vec4> uniform, const vec4& value);
+
+        void setUniform(UniformHandle<mat4> uniform, const mat4& value);
+
+        /**
+        * \brief Copies data into the list to be uploaded to the gfx API when the list is submitted.  Commands
+        * that follow read from it with offsets relative to its start.
+        *
+        * \param usage What the data is read as.
+        * \param data  The data to upload.
+        * \param size  The number of bytes to upload.
+        */
+        void upload(UploadUsage usage, const void* data, std::uint32_t size);
+
+        /**
+        * \brief Binds a range of the last upload to a uniform block binding point.
+        *
+        * \param binding The binding point of the uniform block.
+        * \param offset  Offset of the range from the start of the last upload.
+        * \param size    The number of bytes in the range.
+        */
+        void bindUniformRange(std::uint32_t binding, std::uint32_t offset, std::uint32_t size);
+
+        /**
+        * \brief Points a vertex attribute of the bound vertex array at float data in the last upload,
+        * advancing once per instance.
+        *
+        * \param location   The location of the vertex attribute.
+        * \param components The number of floats in the attribute, 1 to 4.
+        * \param stride     The bytes between the attribute's values of consecutive instances.
+        * \param offset     Offset of the first instance's value from the start of the last upload.
+        */
+        void setInstanceAttribute(
+                std::uint32_t location,
+                std::uint32_t components,
+                std::uint32_t stride,
+                std::uint32_t offset);
+
+        /**
+        * \brief Disables an instance attribute of the bound vertex array again.
+        *
+        * \param location The location of the vertex attribute.
+        */
+        void clearInstanceAttribute(std::uint32_t location);
+
+        /**
+        * \brief Draws the given mesh, which must be bound, using its indices if it has any.  Meshes in the mesh
+        * arena are drawn from their base vertex and first index.
+        *
+        * \param mesh          The mesh to draw.
+        * \param instanceCount The number of instances to draw, 0 for a non instanced draw.
+        */
+        void draw(const Mesh& mesh, std::uint32_t instanceCount = 0);
+
+        /**
+        * \brief Draws triangles from the vertices of the bound vertex array, without indices.
+        *
+        * \param vertexCount   The number of vertices to draw.
+        * \param instanceCount The number of instances to draw, 0 for a non instanced draw.
+        */
+        void drawArrays(std::uint32_t vertexCount, std::uint32_t instanceCount = 0);
+
+        /**
+        * \brief Uploads the given draws as indirect commands, then draws all of them from the indices of the
+        * bound vertex array with a single call.  The draws become the last upload.
+        *
+        * \param commands  The draws to make.
+        * \param drawCount The number of entries in the commands array.
+        * \param indexSize Bytes per index in the bound vertex array's EBO, 2 or 4.
+        */
+        void multiDrawIndirect(const DrawIndirectCommand* commands, std::uint32_t drawCount, std::uint32_t indexSize);
+
+        /**
+        * \brief Starts the given pass, so the GPU time of the commands that follow is measured as part of it.
+        * Passes don't nest, each is ended with {\link CommandList::endPass} before the next begins.
+        *
+        * \param pass The pass the following commands draw.
+        */
+        void beginPass(RenderPass pass);
+
+        /**
+        * \brief Ends the pass started by the last call to {\link CommandList::beginPass}.
+        */
+        void endPass();
+
+        /**
+        * \brief Adds the counts of the recorded commands to the given stats.
+        *
+        * \param stats The stats to add to.
+        */
+        void addStats(RenderStats& stats) const;
+
+        /**
+        * \brief Clears all recorded commands, keeping the memory for the next frame.
+        */
+        void reset();
+
+        /**
+        * \brief Exchanges the recorded commands, and the memory holding them, with another list.
+        *
+        * \param other The list to exchange commands with.
+        */
+        void swap(CommandList& other);
+
+        /**
+        * \brief Gets the recorded commands, in the order they were recorded.
+        *
+        * \return The recorded commands.
+        */
+        const std::vector<RenderCommand>& commands() const;
+
+        /**
+        * \brief Gets the data recorded with a command.
+        *
+        * \param offset The data offset held by the command.
+        * \return Pointer to the command's data.
+        */
+        const std::uint8_t* data(std::uint32_t offset) const;
+
+        /**
+        * \brief Gets the bytes of data recorded with all commands, such as uniform values and uploads.
+        *
+        * \return The bytes of data recorded.
+        */
+        std::uint32_t dataSize() const;
+
+    private:
+        void setUniform(std::int32_t location, UniformType type, std::uint32_t count, const void* values,
+                        std::uint32_t size);
+
+        /**
+        * \brief Copies data to the end of the list's data.
+        *
+        * \param data The data to copy.
+        * \param size The number of bytes to copy.
+        * \return Offset of the copied data.
+        */
+        std::uint32_t writeData(const void* data, std::uint32_t size);
+
+    private:
+        std::vector<RenderCommand> commands_{};
+        std::vector<std::uint8_t> data_{};
+    };
+}
@@ -0,0 +1,248 @@
+#include "CookedAssets.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "BinaryFormat.h"
+#include "CookedFormat.h"
+#include "Logger.h"
+
+namespace PB::CookedAssets
+{
+    namespace
+    {
+        void writeVec3(BinaryFormat::Writer& writer, const vec3& vector)
+        {
+            writer.writeFloat(vector.x);
+            writer.writeFloat(vector.y);
+            writer.writeFloat(vector.z);
+        }
+
+        vec3 readVec3(BinaryFormat::Reader& reader)
+        {
+            vec3 vector{};
+            vector.x = reader.readFloat();
+            vector.y = reader.readFloat();
+            vector.z = reader.readFloat();
+            return vector;
+        }
+
+        void writeModelNode(BinaryFormat::Writer& writer, const ModelData& model)
+        {
+            writer.writeString(model.name);
+            writeVec3(writer, model.offset);
+            writeVec3(writer, model.rotation);
+            writeVec3(writer, model.scale);
+            writeVec3(writer, model.mesh.offset);
+            writeVec3(writer, model.mesh.scale);
+            writer.writeString(model.mesh.materialPath);
+            writer.writeString(model.mesh.dataPath);
+            writer.writeUInt16(static_cast<std::uint16_t>(model.children.size()));
+
+            for (const auto& child: model.children)
+            {
+                writeModelNode(writer, child);
+            }
+        }
+
+        /**
+         * \brief Reads a cooked model node and all of its children, depth first.
+         *
+         * \param reader The reader positioned at the start of the node.
+         * \param error  Flag indicating an error occurred if set to True.
+         *
+         * \return The model node read.
+         */
+        ModelData readModelNode(BinaryFormat::Reader& reader, bool* error)
+        {
+            ModelData model{};
+
+            model.name = reader.readString();
+            model.offset = readVec3(reader);
+            model.rotation = readVec3(reader);
+            model.scale = readVec3(reader);
+            model.mesh.offset = readVec3(reader);
+            model.mesh.scale = readVec3(reader);
+            model.mesh.materialPath = reader.readString();
+            model.mesh.dataPath = reader.readString();
+
+            const std::uint16_t childCount = reader.readUInt16();
+
+            for (std::uint16_t i = 0; i < childCount && !reader.overrun() && !*error; ++i)
+            {
+                model.children.push_back(readModelNode(reader, error));
+            }
+
+            *error = *error || reader.overrun();
+
+            return model;
+        }
+    }
+
+    std::vector<std::uint8_t> encodeModel(const ModelData& model)
+    {
+        BinaryFormat::Writer writer{};
+        CookedFormat::writeHeader(writer, CookedFormat::MODEL_MAGIC);
+        writeModelNode(writer, model);
+
+        return std::move(writer.bytes());
+    }
+
+    ModelData decodeModel(const std::uint8_t* bytes, std::size_t length, bool* error)
+    {
+        BinaryFormat::Reader reader{bytes, length};
+
+        if (!CookedFormat::readHeader(reader, CookedFormat::MODEL_MAGIC))
+        {
+            *error = true;
+            LOGGER_ERROR("Invalid cooked model header");
+            return {};
+        }
+
+        ModelData model = readModelNode(reader, error);
+
+        if (*error)
+        {
+            LOGGER_ERROR("Incomplete/Corrupt cooked model");
+            return {};
+        }
+
+        return model;
+    }
+
+    std::vector<std::uint8_t> encodeMaterial(const Material& material)
+    {
+        BinaryFormat::Writer writer{};
+        CookedFormat::writeHeader(writer, CookedFormat::MATERIAL_MAGIC);
+        writer.writeString(material.diffuseData.image);
+        writer.writeUInt32(material.diffuseData.width);
+        writer.writeUInt32(material.diffuseData.height);
+        writer.writeUInt32(material.diffuseData.xOffset);
+        writer.writeUInt32(material.diffuseData.yOffset);
+        writer.writeString(material.emissionId);
+        writer.writeString(material.specularId);
+        writer.writeString(material.normalId);
+        writer.writeString(material.shaderId);
+        writer.writeUInt32(material.specularValue);
+        writer.writeFloat(material.emissionValue);
+        writer.writeUInt8(material.requiresAlphaBlending ? 1 : 0);
+
+        return std::move(writer.bytes());
+    }
+
+    Material decodeMaterial(const std::uint8_t* bytes, std::size_t length, bool* error)
+    {
+        Material material{};
+        BinaryFormat::Reader reader{bytes, length};
+
+        if (!CookedFormat::readHeader(reader, CookedFormat::MATERIAL_MAGIC))
+        {
+            *error = true;
+            LOGGER_ERROR("Invalid cooked material header");
+            return material;
+        }
+
+        material.diffuseData.image = reader.readString();
+        material.diffuseData.width = reader.readUInt32();
+        material.diffuseData.height = reader.readUInt32();
+        material.diffuseData.xOffset = reader.readUInt32();
+        material.diffuseData.yOffset = reader.readUInt32();
+        material.emissionId = reader.readString();
+        material.specularId = reader.readString();
+        material.normalId = reader.readString();
+        material.shaderId = reader.readString();
+        material.specularValue = reader.readUInt32();
+        material.emissionValue = reader.readFloat();
+        material.requiresAlphaBlending = reader.readUInt8() != 0;
+
+        if (reader.overrun())
+        {
+            *error = true;
+            LOGGER_ERROR("Incomplete/Corrupt cooked material");
+        }
+
+        return material;
+    }
+
+    std::vector<std::uint8_t> encodeShaderProgram(const ShaderProgram& shaderProgram)
+    {
+        BinaryFormat::Writer writer{};
+        CookedFormat::writeHeader(writer, CookedFormat::SHADER_MAGIC);
+        writer.writeString(shaderProgram.vertexShaderPath);
+        writer.writeString(shaderProgram.geometryShaderPath);
+        writer.writeString(shaderProgram.fragmentShaderPath);
+
+        return std::move(writer.bytes());
+    }
+
+    ShaderProgram decodeShaderProgram(const std::uint8_t* bytes, std::size_t length, bool* error)
+    {
+        ShaderProgram shaderProgram{};
+        BinaryFormat::Reader reader{bytes, length};
+
+        if (!CookedFormat::readHeader(reader, CookedFormat::SHADER_MAGIC))
+        {
+            *error = true;
+            LOGGER_ERROR("Invalid cooked shader program header");
+            return shaderProgram;
+        }
+
+        shaderProgram.vertexShaderPath = reader.readString();
+        shaderProgram.geometryShaderPath = reader.readString();
+        shaderProgram.fragmentShaderPath = reader.readString();
+
+        if (reader.overrun())
+        {
+            *error = true;
+            LOGGER_ERROR("Incomplete/Corrupt cooked shader program");
+        }
+
+        return shaderProgram;
+    }
+
+    std::vector<std::uint8_t> encodeStringPairs(
+            const char (& magic)[4],
+            const std::unordered_map<std::string, std::string>& map)
+    {
+        std::vector<std::pair<std::string, std::string>> sortedPairs{map.begin(), map.end()};
+        std::sort(sortedPairs.begin(), sortedPairs.end());
+
+        BinaryFormat::Writer writer{};
+        CookedFormat::writeHeader(writer, magic);
+        writer.writeUInt32(static_cast<std::uint32_t>(sortedPairs.size()));
+
+        for (const auto& pair: sortedPairs)
+        {
+            writer.writeString(pair.first);
+            writer.writeString(pair.second);
+        }
+
+        return std::move(writer.bytes());
+    }
+
+    bool decodeStringPairs(
+            const std::uint8_t* bytes,
+            std::size_t length,
+            const char (& magic)[4],
+            std::unordered_map<std::string, std::string>& map)
+    {
+        BinaryFormat::Reader reader{bytes, length};
+
+        if (!CookedFormat::readHeader(reader, magic))
+        {
+            return false;
+        }
+
+        const std::uint32_t count = reader.readUInt32();
+
+        for (std::uint32_t i = 0; i < count && !reader.overrun(); ++i)
+        {
+            std::string key = reader.readString();
+            std::string value = reader.readString();
+
+            map.insert(std::pair<std::string, std::string>{std::move(key), std::move(value)});
+        }
+
+        return !reader.overrun();
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AssetArchive.h"
+#include "Material.h"
+
+/**
+ * Encoders and decoders of the cooked forms (see {\link CookedFormat.h}) of the assets parsed from text,
+ * shared by the cooker, which stores them in asset packs, and by {\link AssetArchive}, which reads them
+ * back from asset packs and from its parsed asset cache.
+ */
+namespace PB::CookedAssets
+{
+    std::vector<std::uint8_t> encodeModel(const ModelData& model);
+
+    /**
+     * \brief Decodes a cooked model to a {\link ModelData} object.
+     *
+     * \param bytes  The bytes of the cooked model.
+     * \param length The number of bytes in the cooked model.
+     * \param error  Flag indicating an error occurred if set to True.
+     * \return The {\link ModelData} object read from the given bytes.
+     */
+    ModelData decodeModel(const std::uint8_t* bytes, std::size_t length, bool* error);
+
+    std::vector<std::uint8_t> encodeMaterial(const Material& material);
+
+    /**
+     * \brief Decodes a cooked material to a {\link Material} object.
+     *
+     * \param bytes  The bytes of the cooked material.
+     * \param length The number of bytes in the cooked material.
+     * \param error  Flag indicating an error occurred if set to True.
+     * \return The {\link Material} object read from the given bytes.
+     */
+    Material decodeMaterial(const std::uint8_t* bytes, std::size_t length, bool* error);
+
+    std::vector<std::uint8_t> encodeShaderProgram(const ShaderProgram& shaderProgram);
+
+    /**
+     * \brief Decodes a cooked shader program to a {\link ShaderProgram} object, without its program path.
+     *
+     * \param bytes  The bytes of the cooked shader program.
+     * \param length The number of bytes in the cooked shader program.
+     * \param error  Flag indicating an error occurred if set to True.
+     * \return The {\link ShaderProgram} object read from the given bytes.
+     */
+    ShaderProgram decodeShaderProgram(const std::uint8_t* bytes, std::size_t length, bool* error);
+
+    /**
+     * \brief Encodes the string pairs of a manifest or animation set, sorted so the same pairs always
+     * encode to the same bytes.
+     *
+     * \param magic The magic of the cooked asset type.
+     * \param map   The string pairs to encode.
+     * \return The encoded string pairs.
+     */
+    std::vector<std::uint8_t> encodeStringPairs(
+            const char (& magic)[4],
+            const std::unordered_map<std::string, std::string>& map);
+
+    /**
+     * \brief Decodes the string pairs of a cooked manifest or animation set.
+     *
+     * \param bytes  The bytes of the cooked asset.
+     * \param length The number of bytes in the cooked asset.
+     * \param magic  The magic of the expected cooked asset type.
+     * \param map    The map to add the string pairs to.
+     * \return True if the string pairs were read successfully, False otherwise.
+     */
+    bool decodeStringPairs(
+            const std::uint8_t* bytes,
+            std::size_t length,
+            const char (& magic)[4],
+            std::unordered_map<std::string, std::string>& map);
+}
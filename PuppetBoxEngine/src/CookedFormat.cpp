@@ -0,0 +1,73 @@
+#include "CookedFormat.h"
+
+#include <fstream>
+
+#include "Logger.h"
+
+namespace PB::CookedFormat
+{
+    CacheFileStatus readCacheFile(
+            const std::string& path,
+            const char (& magic)[4],
+            const std::string& description,
+            const std::function<bool(BinaryFormat::Reader&, const std::shared_ptr<std::uint8_t[]>&)>& readBody)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+        if (!file.good())
+        {
+            LOGGER_DEBUG("No " + description + " at '" + path + "'");
+            return CacheFileStatus::MISSING;
+        }
+
+        const auto size = static_cast<std::size_t>(file.tellg());
+        std::shared_ptr<std::uint8_t[]> buffer{new std::uint8_t[size]};
+
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(buffer.get()), static_cast<std::streamsize>(size));
+
+        BinaryFormat::Reader reader{buffer.get(), file ? size : 0};
+
+        if (!readHeader(reader, magic))
+        {
+            LOGGER_WARN("Invalid " + description + " '" + path + "', it will be rebuilt");
+            return CacheFileStatus::DISCARDED;
+        }
+
+        if (!readBody(reader, buffer))
+        {
+            return CacheFileStatus::DISCARDED;
+        }
+
+        if (reader.overrun())
+        {
+            LOGGER_WARN("Incomplete/Corrupt " + description + " '" + path + "', it will be rebuilt");
+            return CacheFileStatus::DISCARDED;
+        }
+
+        return CacheFileStatus::READ;
+    }
+
+    bool writeCacheFile(
+            const std::string& path,
+            const char (& magic)[4],
+            const std::string& description,
+            const std::function<void(BinaryFormat::Writer&)>& writeBody)
+    {
+        BinaryFormat::Writer writer{};
+        writeHeader(writer, magic);
+        writeBody(writer);
+
+        std::ofstream out(path, std::ios::binary | std::ios::out | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(writer.bytes().data()), static_cast<std::streamsize>(writer.size()));
+        out.close();
+
+        if (!out)
+        {
+            LOGGER_ERROR("Failed to write " + description + " '" + path + "'");
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BinaryFormat.h"
+
+/**
+ * Layout of cooked asset packs (.pbpak) produced by the pbcook tool, and of the cooked asset formats
+ * stored within them.  Cooked assets hold the already parsed form of their text source assets, so
+ * loading them is a matter of reading values in order.
+ *
+ * <p>All values are little-endian, strings are a uint16 length followed by their characters.</p>
+ *
+ * <pre>
+ * Pack header
+ *   char[4]   magic            "PBPK"
+ *   uint16    version
+ *   uint16    flags            Reserved, 0
+ *   uint32    entryCount
+ *   uint32    dataOffset       Offset of the first entry's data from the start of the file
+ * Entry table (entryCount entries)
+ *   string    name
+ *   uint32    offset           Offset of the entry's data from the start of the file, 16 byte aligned
+ *   uint32    size
+ *   uint32    crc32
+ * Entry data
+ *
+ * Every cooked asset starts with
+ *   char[4]   magic
+ *   uint16    version
+ *
+ * Manifest (.pbmanifest, "PBMF")
+ *   uint32    count
+ *   string[2] assetId, fileName (count entries)
+ * Model (.pbmodel, "PBMD"), a tree of nodes, depth first
+ *   string    name
+ *   float32[9] offset, rotation (radians), scale
+ *   float32[6] mesh offset, mesh scale
+ *   string    materialPath
+ *   string    dataPath
+ *   uint16    childCount
+ * Material (.pbmat, "PBMT")
+ *   string    diffuse image
+ *   uint32[4] diffuse width, height, xOffset, yOffset
+ *   string[4] emissionId, specularId, normalId, shaderId
+ *   uint32    specularValue
+ *   float32   emissionValue
+ *   uint8     requiresAlphaBlending
+ * Shader program (.pbshader, "PBSH")
+ *   string[3] vertex, geometry, fragment shader paths, all validated when cooked
+ * Animation set (.pbanims, "PBAS")
+ *   uint32    count
+ *   string[2] name, animation path (count entries)
+ * Texture (.pbtex, "PBTX")
+ *   uint32[3] width, height, channels
+ *   uint32    mipLevels
+ *   uint8[]   pixels of every mip level, largest first, rows tightly packed
+ *
+ * Parsed asset cache (.pbcache, "PBPC"), written next to a source archive
+ *   uint32    archiveHash      Content hash of the archive it was parsed from
+ *   uint32    entryCount
+ * Cache entry (entryCount entries)
+ *   string    fileName         Name of the source file within the archive
+ *   uint32    crc32            CRC-32 of the source file when it was parsed
+ *   uint32    parseMicros      Time it took to parse the source file
+ *   uint32    size
+ *   uint8[]   the parsed asset, as one of the cooked assets above
+ *
+ * Shader program binary cache (Shaders.pbcache, "PBSC"), written to the archive root
+ *   string    driverId         Vendor, renderer and version of the driver the binaries were linked by
+ *   uint32    entryCount
+ * Shader cache entry (entryCount entries)
+ *   uint32[2] sourceHash       Low and high halves of the 64-bit FNV-1a hash of the stage sources
+ *   uint32    binaryFormat     Driver specific format of the program binary
+ *   uint32    size
+ *   uint8[]   the program binary
+ *
+ * Prefetch profile (Startup.pbprofile, "PBPF"), written to the archive root
+ *   uint32    entryCount
+ *   string[2] archivePath, fileName of each entry, in the order they were first read (entryCount entries)
+ * </pre>
+ */
+namespace PB::CookedFormat
+{
+    constexpr char PACK_MAGIC[4] = {'P', 'B', 'P', 'K'};
+    constexpr std::uint16_t PACK_VERSION = 1;
+    constexpr const char* PACK_EXTENSION = ".pbpak";
+    constexpr std::uint32_t PACK_HEADER_SIZE = 4 + 2 + 2 + 4 + 4;
+
+    /**
+     * \brief Entry data starts on a multiple of this many bytes, so it can be used in place.
+     */
+    constexpr std::uint32_t DATA_ALIGNMENT = 16;
+
+    constexpr std::uint16_t VERSION = 1;
+    constexpr std::uint32_t HEADER_SIZE = 4 + 2;
+
+    constexpr const char* MANIFEST_FILE = ".pbmanifest";
+
+    constexpr char MANIFEST_MAGIC[4] = {'P', 'B', 'M', 'F'};
+    constexpr char MODEL_MAGIC[4] = {'P', 'B', 'M', 'D'};
+    constexpr char MATERIAL_MAGIC[4] = {'P', 'B', 'M', 'T'};
+    constexpr char SHADER_MAGIC[4] = {'P', 'B', 'S', 'H'};
+    constexpr char ANIMATION_SET_MAGIC[4] = {'P', 'B', 'A', 'S'};
+    constexpr char TEXTURE_MAGIC[4] = {'P', 'B', 'T', 'X'};
+
+    constexpr const char* MODEL_EXTENSION = ".pbmodel";
+    constexpr const char* MATERIAL_EXTENSION = ".pbmat";
+    constexpr const char* SHADER_EXTENSION = ".pbshader";
+    constexpr const char* ANIMATION_SET_EXTENSION = ".pbanims";
+    constexpr const char* TEXTURE_EXTENSION = ".pbtex";
+
+    constexpr char CACHE_MAGIC[4] = {'P', 'B', 'P', 'C'};
+    constexpr const char* CACHE_EXTENSION = ".pbcache";
+
+    constexpr char SHADER_CACHE_MAGIC[4] = {'P', 'B', 'S', 'C'};
+    constexpr const char* SHADER_CACHE_FILE = "Shaders.pbcache";
+
+    constexpr char PREFETCH_PROFILE_MAGIC[4] = {'P', 'B', 'P', 'F'};
+    constexpr const char* PREFETCH_PROFILE_FILE = "Startup.pbprofile";
+
+    /**
+     * \brief Starts a cooked asset of the given type.
+     *
+     * \param writer The writer to write the header with.
+     * \param magic  The magic of the cooked asset type.
+     */
+    inline void writeHeader(BinaryFormat::Writer& writer, const char (& magic)[4])
+    {
+        writer.writeBytes(reinterpret_cast<const std::uint8_t*>(magic), 4);
+        writer.writeUInt16(VERSION);
+    }
+
+    /**
+     * \brief Reads past the header of a cooked asset, checking it is of the given type and version.
+     *
+     * \param reader The reader positioned at the start of the cooked asset.
+     * \param magic  The magic of the expected cooked asset type.
+     * \return True if the header matched, False otherwise.
+     */
+    inline bool readHeader(BinaryFormat::Reader& reader, const char (& magic)[4])
+    {
+        const std::uint8_t* bytes = reader.readBytes(4);
+
+        return bytes != nullptr && std::memcmp(bytes, magic, 4) == 0 && reader.readUInt16() == VERSION;
+    }
+
+    /**
+     * \brief How reading a cache file with {\link CookedFormat::readCacheFile} went.
+     */
+    enum class CacheFileStatus : std::uint8_t
+    {
+        /** There is no cache file yet */
+        MISSING,
+        /** The cache file is invalid, corrupt or out of date, and has to be rebuilt */
+        DISCARDED,
+        READ,
+    };
+
+    /**
+     * \brief Reads the cache file at the given path, checking it is of the given type and version, and has
+     * the given function read the rest of it.
+     *
+     * <p>Missing, invalid and incomplete cache files are logged, along with the given description of the
+     * cache.  The cache file is considered incomplete if its body reads past the end of the file, in which
+     * case anything read from it should be dropped.</p>
+     *
+     * \param path        The path of the cache file.
+     * \param magic       The magic of the expected cache type.
+     * \param description What the cache is called in log messages.
+     * \param readBody    Reads the body of the cache file, past its header, returning False if it can't be
+     *                    used.  Handed the buffer the reader reads from, to keep it alive past the read.
+     * \return How reading the cache file went.
+     */
+    CacheFileStatus readCacheFile(
+            const std::string& path,
+            const char (& magic)[4],
+            const std::string& description,
+            const std::function<bool(BinaryFormat::Reader&, const std::shared_ptr<std::uint8_t[]>&)>& readBody);
+
+    /**
+     * \brief Writes the cache file at the given path, the header of the given type followed by the body
+     * written by the given function.
+     *
+     * \param path        The path of the cache file.
+     * \param magic       The magic of the cache type.
+     * \param description What the cache is called in log messages.
+     * \param writeBody   Writes the body of the cache file.
+     * \return True if the cache file was written, False otherwise.
+     */
+    bool writeCacheFile(
+            const std::string& path,
+            const char (& magic)[4],
+            const std::string& description,
+            const std::function<void(BinaryFormat::Writer&)>& writeBody);
+
+    /**
+     * \brief Gets the entries of the given map ordered by their keys, so the same entries are always written
+     * to a cache file the same way.
+     *
+     * \param entries The map to order the entries of.
+     * \return Pointers to the entries of the map, ordered by their keys.
+     */
+    template<typename Map>
+    std::vector<const typename Map::value_type*> sortedEntries(const Map& entries)
+    {
+        std::vector<const typename Map::value_type*> sorted{};
+        sorted.reserve(entries.size());
+
+        for (const auto& entry: entries)
+        {
+            sorted.push_back(&entry);
+        }
+
+        std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) {
+            return a->first < b->first;
+        });
+
+        return sorted;
+    }
+
+    /**
+     * \brief Gets the number of bytes of a mip chain, each level half the size of the previous.
+     *
+     * \param width     The width of the largest level.
+     * \param height    The height of the largest level.
+     * \param channels  The number of bytes per pixel.
+     * \param mipLevels The number of levels.
+     * \return The number of bytes of all levels together.
+     */
+    inline std::uint64_t mipChainSize(std::uint32_t width, std::uint32_t height, std::uint32_t channels,
+                                      std::uint32_t mipLevels)
+    {
+        std::uint64_t size = 0;
+
+        for (std::uint32_t level = 0; level < mipLevels; ++level)
+        {
+            size += static_cast<std::uint64_t>(width) * height * channels;
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+
+        return size;
+    }
+}
@@ -1,3 +1,6 @@
+#include <iomanip>
+#include <sstream>
+
 #include "DefaultSceneGraph.h"
 #include "Engine.h"
 #include "EventDef.h"
@@ -20,10 +23,69 @@ namespace PB
         std::uint32_t NETWORK_EVENT_READER_TOPIC = 0;
         std::uint32_t ENGINE_ADD_SCENE_TOPIC = 0;
         std::uint32_t ENGINE_SET_SCENE_TOPIC = 0;
+        std::uint32_t ENGINE_STATS_OVERLAY_TOPIC = 0;
     }
 
     namespace
     {
+        /**
+        * \brief Binding point of the Transforms uniform block, as bound by {\link Shader}.
+        */
+        constexpr std::uint32_t TRANSFORMS_BINDING = 0;
+
+        /**
+        * \brief Seconds between refreshes of the render stats overlay, so its text stays readable.
+        */
+        constexpr float STATS_OVERLAY_INTERVAL = 0.25f;
+
+        /**
+        * \brief Distance of the render stats overlay from the top left corner of the window.
+        */
+        constexpr std::uint32_t STATS_OVERLAY_MARGIN = 10;
+
+        /**
+        * \brief Formats render stats as lines of text for the render stats overlay.
+        *
+        * \param stats The stats to format.
+        *
+        * \return The formatted stats.
+        */
+        std::string formatRenderStats(const RenderStats& stats)
+        {
+            static const char* PASS_NAMES[] = {"scene", "sprites", "text"};
+
+            std::stringstream stream;
+            stream << "Draws " << stats.drawCalls
+                   << "  Instances " << stats.instances
+                   << "  Triangles " << stats.triangles << "\n"
+                   << "Binds: program " << stats.programBinds
+                   << "  texture " << stats.textureBinds
+                   << "  VAO " << stats.vertexArrayBinds
+                   << "  elided " << stats.elidedCalls << "\n"
+                   << "Uniforms " << stats.uniformSets
+                   << "  ranges " << stats.uniformRangeBinds
+                   << "  instance attrs " << stats.instanceAttributeSets
+                   << "  State " << stats.stateChanges << "\n"
+                   << "Uploaded KB: frame " << (stats.uploadedBytes / 1024)
+                   << "  resources " << (stats.resourceUploadedBytes / 1024) << "\n"
+                   << "GPU ms:";
+
+            if (stats.gpuTimed)
+            {
+                for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(RenderPass::COUNT); ++i)
+                {
+                    stream << "  " << PASS_NAMES[i] << " " << std::fixed << std::setprecision(2)
+                           << stats.passMilliseconds[i];
+                }
+            }
+            else
+            {
+                stream << "  not measured";
+            }
+
+            return stream.str();
+        }
+
         void defaultReader(std::uint8_t* data, std::uint32_t dataLength)
         {
 
@@ -278,8 +340,13 @@ namespace PB
     Engine::Engine(
             std::shared_ptr<IGfxApi>& gfxApi,
             Sdl2Initializer hardwareInitializer,
-            std::shared_ptr<AbstractInputReader>& inputReader)
-            : gfxApi_(gfxApi), hardwareInitializer_(std::move(hardwareInitializer)), inputReader_(inputReader)
+            std::shared_ptr<AbstractInputReader>& inputReader,
+            std::shared_ptr<AssetStreamer> assetStreamer,
+            std::shared_ptr<AssetLibrary> assetLibrary,
+            AnimationCatalogue* animationCatalogue)
+            : gfxApi_(gfxApi), hardwareInitializer_(std::move(hardwareInitializer)), inputReader_(inputReader),
+              assetStreamer_(std::move(assetStreamer)), assetLibrary_(std::move(assetLibrary)),
+              animationCatalogue_(animationCatalogue)
     {
 
     }
@@ -331,47 +398,65 @@ namespace PB
                         LOGGER_ERROR("Unable to locate specified scene: '" + event->sceneName + "'");
                     }
                 });
+
+        // Listener for showing and hiding the render stats overlay.
+        Event::Topic::ENGINE_STATS_OVERLAY_TOPIC = MessageBroker::instance().registerTopic(PB_EVENT_STATS_OVERLAY);
+        MessageBroker::instance().subscribe(
+                PB_EVENT_STATS_OVERLAY,
+                [this](std::shared_ptr<void> data) {
+                    auto event = std::static_pointer_cast<EngineStatsOverlayEvent>(data);
+
+                    statsOverlay_ = event->overlay;
+                    // Filled in on the next frame, rather than after a full interval
+                    statsOverlayElapsed_ = STATS_OVERLAY_INTERVAL;
+                });
     }
 
     void Engine::run(std::function<bool()> onReady)
     {
         std::thread networkThread{&networkRunner};
 
+        mainThreadId_ = std::this_thread::get_id();
+
         if (onReady())
         {
             hardwareInitializer_.initializeGameTime();
 
-            while (!inputReader_->window.windowClose)
+            if (renderThreadEnabled_)
             {
-                float deltaTime = hardwareInitializer_.updateElapsedTime();
+                renderThread_ = std::make_unique<RenderThread>(gfxApi_, &hardwareInitializer_);
 
-                if (nextScene_ != nullptr)
+                if (!renderThread_->start())
                 {
-                    if (resetScene_ && currentScene_ != nullptr)
-                    {
-                        currentScene_->tearDown();
-                    }
-
-                    currentScene_ = nextScene_;
-                    currentScene_->setUp();
-                    nextScene_ = nullptr;
+                    renderThread_ = nullptr;
                 }
+            }
 
-                processInput();
-
-                gfxApi_->preLoopCommands();
-
-                currentScene_->update(deltaTime);
+            while (!inputReader_->window.windowClose)
+            {
+                float deltaTime = hardwareInitializer_.updateElapsedTime();
 
-                // Set common transforms for all shaders
-                gfxApi_->setTransformUBOData(
-                        currentScene_->getView(),
-                        currentScene_->getProjection(),
-                        currentScene_->getUIProjection());
+                if (renderThread_ != nullptr)
+                {
+                    runPipelinedFrame(deltaTime);
+                }
+                else
+                {
+                    runFrame(deltaTime);
+                }
 
-                currentScene_->render();
+                if (assetLibrary_ != nullptr)
+                {
+                    // Startup ends with the first frame, later calls do nothing
+                    assetLibrary_->finishStartup();
+                }
+            }
 
-                hardwareInitializer_.postLoopCommands();
+            if (renderThread_ != nullptr)
+            {
+                // Draws the frames still in flight, and hands the context back for tearing down
+                renderThread_->stop();
+                renderThread_ = nullptr;
             }
 
             currentScene_->tearDown();
@@ -390,11 +475,225 @@ namespace PB
         networkThread.join();
     }
 
+    void Engine::setRenderThreadEnabled(bool enabled)
+    {
+        renderThreadEnabled_ = enabled;
+    }
+
+    bool Engine::acquireContext()
+    {
+        // Unset until the game loop starts, anything before that runs on the thread that owns the context
+        if (mainThreadId_ != std::thread::id{} && std::this_thread::get_id() != mainThreadId_)
+        {
+            LOGGER_ERROR("GFX API resources can only be created from the main thread");
+            return false;
+        }
+
+        if (renderThread_ == nullptr)
+        {
+            return true;
+        }
+
+        if (contextDepth_++ == 0)
+        {
+            renderThread_->acquireContext();
+        }
+
+        return true;
+    }
+
+    void Engine::releaseContext()
+    {
+        if (renderThread_ != nullptr && --contextDepth_ == 0)
+        {
+            renderThread_->releaseContext();
+        }
+    }
+
     void Engine::shutdown()
     {
+        // The render thread is stopped by now, handing the context back to this thread
+        if (assetLibrary_ != nullptr)
+        {
+            assetLibrary_->shutdown();
+        }
+
+        gfxApi_->shutdown();
         hardwareInitializer_.destroy();
     }
 
+    void Engine::runFrame(float deltaTime)
+    {
+        switchScene();
+
+        processInput();
+
+        const RenderWindow window = gfxApi_->getRenderWindow();
+        gfxApi_->preLoopCommands(*window.width, *window.height);
+
+        if (assetStreamer_ != nullptr)
+        {
+            assetStreamer_->finalize();
+        }
+
+        if (animationCatalogue_ != nullptr)
+        {
+            animationCatalogue_->beginFrame();
+        }
+
+        currentScene_->update(deltaTime);
+
+        recordTransforms(frameCommands_);
+        gfxApi_->submit(frameCommands_);
+        frameCommands_.reset();
+
+        renderScene(deltaTime);
+
+        if (assetLibrary_ != nullptr)
+        {
+            // Records the batched sprites, then the batched text on top of them
+            assetLibrary_->flushBatches();
+
+            CommandList& commandList = *assetLibrary_->commandList();
+            gfxApi_->submit(commandList);
+            commandList.reset();
+
+            for (const auto& release: assetLibrary_->evictUnused())
+            {
+                release();
+            }
+        }
+
+        gfxApi_->postLoopCommands();
+        hardwareInitializer_.postLoopCommands();
+    }
+
+    void Engine::runPipelinedFrame(float deltaTime)
+    {
+        FramePacket& packet = renderThread_->beginFrame();
+
+        // Setting up a scene and uploading streamed assets create GFX API resources, which needs the context
+        const bool needsContext = nextScene_ != nullptr
+                                  || (assetStreamer_ != nullptr && assetStreamer_->collectReads());
+
+        if (needsContext)
+        {
+            acquireContext();
+        }
+
+        switchScene();
+
+        processInput();
+
+        if (needsContext)
+        {
+            if (assetStreamer_ != nullptr)
+            {
+                assetStreamer_->finalize();
+            }
+
+            releaseContext();
+        }
+
+        // Read here on the main thread, which is the only one resizing it
+        const RenderWindow window = gfxApi_->getRenderWindow();
+        packet.width = *window.width;
+        packet.height = *window.height;
+
+        if (animationCatalogue_ != nullptr)
+        {
+            animationCatalogue_->beginFrame();
+        }
+
+        currentScene_->update(deltaTime);
+
+        recordTransforms(packet.frameCommands);
+
+        renderScene(deltaTime);
+
+        if (assetLibrary_ != nullptr)
+        {
+            // Records the batched sprites, then the batched text on top of them
+            assetLibrary_->flushBatches();
+
+            // The library records into the packet's emptied list next frame, keeping both lists' memory
+            packet.commands.swap(*assetLibrary_->commandList());
+
+            // Released by the render thread, once the frames that could still draw them are submitted
+            packet.releases = assetLibrary_->evictUnused();
+        }
+
+        renderThread_->publishFrame();
+    }
+
+    void Engine::switchScene()
+    {
+        if (nextScene_ != nullptr)
+        {
+            if (resetScene_ && currentScene_ != nullptr)
+            {
+                currentScene_->tearDown();
+            }
+
+            currentScene_ = nextScene_;
+            currentScene_->setUp();
+            nextScene_ = nullptr;
+        }
+    }
+
+    void Engine::recordTransforms(CommandList& commandList) const
+    {
+        // Set common transforms for all shaders
+        const mat4 transforms[] = {
+                currentScene_->getUIProjection(),
+                currentScene_->getProjection(),
+                currentScene_->getView()
+        };
+        commandList.upload(UploadUsage::UNIFORM_BLOCK, transforms, sizeof(transforms));
+        commandList.bindUniformRange(TRANSFORMS_BINDING, 0, sizeof(transforms));
+    }
+
+    void Engine::renderScene(float deltaTime)
+    {
+        if (assetLibrary_ != nullptr)
+        {
+            assetLibrary_->commandList()->beginPass(RenderPass::SCENE);
+        }
+
+        currentScene_->render();
+
+        if (assetLibrary_ != nullptr)
+        {
+            assetLibrary_->commandList()->endPass();
+        }
+
+        if (statsOverlay_ != nullptr)
+        {
+            updateStatsOverlay(deltaTime);
+
+            // Drawn with the scene's text, on top of everything else
+            statsOverlay_->render();
+        }
+    }
+
+    void Engine::updateStatsOverlay(float deltaTime)
+    {
+        statsOverlayElapsed_ += deltaTime;
+
+        if (statsOverlayElapsed_ >= STATS_OVERLAY_INTERVAL)
+        {
+            statsOverlayElapsed_ = 0.0f;
+
+            statsOverlay_->setStringAttribute(UI::TEXT_CONTENT, formatRenderStats(gfxApi_->lastFrameStats()));
+
+            // Kept in the top left corner as the window is resized
+            const RenderWindow window = gfxApi_->getRenderWindow();
+            statsOverlay_->setUIntAttribute(UI::POS_Y, *window.height - STATS_OVERLAY_MARGIN);
+        }
+
+        statsOverlay_->update(deltaTime);
+    }
+
     void Engine::processInput()
     {
         inputReader_->loadCurrentState();
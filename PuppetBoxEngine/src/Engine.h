@@ -11,8 +11,13 @@
 #include "puppetbox/AbstractInputReader.h"
 #include "puppetbox/AbstractSceneGraph.h"
 #include "puppetbox/Event.h"
+#include "puppetbox/UIComponent.h"
 
+#include "AnimationCatalogue.h"
+#include "AssetStreamer.h"
+#include "CommandList.h"
 #include "IGfxApi.h"
+#include "RenderThread.h"
 #include "Sdl2Initializer.h"
 
 namespace PB
@@ -31,11 +36,17 @@ namespace PB
         * \param gfxApi					The specific GFX API implementation to be used.
         * \param hardwareInitializer	The specific hardware library implementation.
         * \param inputReader			The specific input processor for the given hardware library implementation.
+        * \param assetStreamer			The asset streamer to run pending uploads for between frames, if any.
+        * \param assetLibrary			The asset library to evict unused assets from at the end of each frame, if any.
+        * \param animationCatalogue	The animation catalogue to start a new frame of shared palettes for, if any.
         */
         Engine(
                 std::shared_ptr<IGfxApi>& gfxApi,
                 Sdl2Initializer hardwareInitializer,
-                std::shared_ptr<AbstractInputReader>& inputReader);
+                std::shared_ptr<AbstractInputReader>& inputReader,
+                std::shared_ptr<AssetStreamer> assetStreamer = nullptr,
+                std::shared_ptr<AssetLibrary> assetLibrary = nullptr,
+                AnimationCatalogue* animationCatalogue = nullptr);
 
         /**
          * \brief Initialize engine configurations.
@@ -47,6 +58,30 @@ namespace PB
         */
         void run(std::function<bool()> onReady);
 
+        /**
+        * \brief Sets whether frames are submitted to the GFX API from a dedicated render thread, so the next
+        * frame is updated while the last one is drawn.  Must be set before {\link Engine::run}.
+        *
+        * \param enabled True to render on a dedicated thread, False to render on the main thread.
+        */
+        void setRenderThreadEnabled(bool enabled);
+
+        /**
+        * \brief Makes the GFX API context current on the calling thread, so GFX API resources can be created
+        * outside of the engine's own loading points, taking it back from the render thread if frames are drawn on
+        * one.  Calls nest, the context is given back by the outermost {\link Engine::releaseContext}.
+        *
+        * \return True if the context is current, False if the game loop is running on another thread, in which
+        * case releaseContext must not be called.
+        */
+        bool acquireContext();
+
+        /**
+        * \brief Gives the GFX API context taken by {\link Engine::acquireContext} back to the render thread, if
+        * frames are drawn on one.
+        */
+        void releaseContext();
+
         /**
         * \brief Attempts to shut down the game engine.
         */
@@ -56,12 +91,67 @@ namespace PB
         std::shared_ptr<IGfxApi> gfxApi_{nullptr};
         Sdl2Initializer hardwareInitializer_;
         std::shared_ptr<AbstractInputReader> inputReader_{nullptr};
+        std::shared_ptr<AssetStreamer> assetStreamer_{nullptr};
+        std::shared_ptr<AssetLibrary> assetLibrary_{nullptr};
+        AnimationCatalogue* animationCatalogue_ = nullptr;
         std::shared_ptr<AbstractSceneGraph> currentScene_{nullptr};
         std::shared_ptr<AbstractSceneGraph> nextScene_{nullptr};
         std::unordered_map<std::string, std::shared_ptr<AbstractSceneGraph>> sceneGraphs_{};
+        /** Commands set up once per frame, ahead of anything drawn */
+        CommandList frameCommands_{};
+        std::unique_ptr<RenderThread> renderThread_{nullptr};
+        /** Text area showing the render stats, or nullptr if hidden */
+        std::shared_ptr<UIComponent> statsOverlay_{nullptr};
+        float statsOverlayElapsed_ = 0.0f;
+        /** The thread running the game loop, the only one the render thread hands the context to */
+        std::thread::id mainThreadId_{};
+        /** Number of unreleased calls to acquireContext */
+        std::uint32_t contextDepth_ = 0;
+        bool renderThreadEnabled_ = false;
         bool resetScene_ = false;
 
     private:
+        /**
+        * \brief Updates and draws a frame on the main thread.
+        *
+        * \param deltaTime Time elapsed since the last frame, in seconds.
+        */
+        void runFrame(float deltaTime);
+
+        /**
+        * \brief Updates a frame, recording it into a {\link FramePacket} for the render thread to draw.
+        *
+        * \param deltaTime Time elapsed since the last frame, in seconds.
+        */
+        void runPipelinedFrame(float deltaTime);
+
+        /**
+        * \brief Renders the current scene and the render stats overlay, if it's shown.
+        *
+        * \param deltaTime Time elapsed since the last frame, in seconds.
+        */
+        void renderScene(float deltaTime);
+
+        /**
+        * \brief Refreshes the render stats overlay's text with the stats of the last finished frame, a few
+        * times a second.
+        *
+        * \param deltaTime Time elapsed since the last frame, in seconds.
+        */
+        void updateStatsOverlay(float deltaTime);
+
+        /**
+        * \brief Switches to the scene set by the last scene set event, if there was one.
+        */
+        void switchScene();
+
+        /**
+        * \brief Records the current scene's transforms into the Transforms uniform block.
+        *
+        * \param commandList The list to record into.
+        */
+        void recordTransforms(CommandList& commandList) const;
+
         /**
         * \brief Handles processing of the hardware input.
         */
@@ -7,6 +7,7 @@
 
 #include "puppetbox/AbstractSceneGraph.h"
 #include "puppetbox/Event.h"
+#include "puppetbox/UIComponent.h"
 
 /**
  * These are "hidden" internal events and topics that are not visible to the implementing application.
@@ -21,6 +22,7 @@ namespace PB
         extern std::uint32_t NETWORK_STATUS_TOPIC;
         extern std::uint32_t ENGINE_ADD_SCENE_TOPIC;
         extern std::uint32_t ENGINE_SET_SCENE_TOPIC;
+        extern std::uint32_t ENGINE_STATS_OVERLAY_TOPIC;
     }
 
     struct NetworkEventWriterEvent
@@ -44,4 +46,10 @@ namespace PB
         std::string sceneName;
         bool resetLast = false;
     };
+
+    struct EngineStatsOverlayEvent
+    {
+        /** The overlay to show, or nullptr to hide it */
+        std::shared_ptr<UIComponent> overlay;
+    };
 }
\ No newline at end of file
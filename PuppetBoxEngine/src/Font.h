@@ -61,6 +61,29 @@ namespace PB
             return result;
         }
 
+        /**
+         * \brief Finds the {\link TypeCharacter} object for the given character without copying it.
+         *
+         * \param c The character to find the associated {\link TypeCharacter} for.
+         * \return The associated {\link TypeCharacter}, or nullptr if the font has no such character.
+         */
+        const TypeCharacter* findCharacter(std::int8_t c) const
+        {
+            auto itr = characterMap_.find(c);
+
+            return itr != characterMap_.end() ? &itr->second : nullptr;
+        }
+
+        /**
+         * \brief Gets the glyph atlas image shared by all of the font's characters.
+         *
+         * \return The glyph atlas image, or an empty reference if the font has no characters.
+         */
+        ImageReference atlas() const
+        {
+            return characterMap_.empty() ? ImageReference{0} : characterMap_.begin()->second.image;
+        }
+
         /**
          * \brief The size is determined by the value used when the font is
          * loaded for the first time.
@@ -84,6 +107,23 @@ namespace PB
             return initialized_;
         }
 
+        /**
+         * \brief Gets the size of the glyph atlas image shared by all of the font's characters.
+         *
+         * \return The number of bytes of the glyph atlas, one per pixel.
+         */
+        std::uint64_t byteSize() const
+        {
+            if (characterMap_.empty())
+            {
+                return 0;
+            }
+
+            const ImageReference& atlas = characterMap_.begin()->second.image;
+
+            return static_cast<std::uint64_t>(atlas.width) * atlas.height;
+        }
+
     private:
         std::unordered_map<std::int8_t, TypeCharacter> characterMap_{};
         std::uint32_t fontSize_ = 0;
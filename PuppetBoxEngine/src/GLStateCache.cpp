@@ -0,0 +1,295 @@
+#include "GLStateCache.h"
+
+#include <glad/glad.h>
+
+namespace PB
+{
+    GLStateCache::GLStateCache()
+    {
+        invalidate();
+    }
+
+    void GLStateCache::invalidate()
+    {
+        programId_ = UNKNOWN;
+        vertexArrayId_ = UNKNOWN;
+        activeTextureUnit_ = UNKNOWN;
+        arrayBufferId_ = UNKNOWN;
+        elementArrayBufferId_ = UNKNOWN;
+        copyReadBufferId_ = UNKNOWN;
+        copyWriteBufferId_ = UNKNOWN;
+        uniformBufferId_ = UNKNOWN;
+        drawIndirectBufferId_ = UNKNOWN;
+        blending_ = CAPABILITY_UNKNOWN;
+        depthTest_ = CAPABILITY_UNKNOWN;
+
+        for (auto& textureId: textureIds_)
+        {
+            textureId = UNKNOWN;
+        }
+
+        for (auto& uniformRange: uniformRanges_)
+        {
+            uniformRange = UniformRange{};
+        }
+    }
+
+    void GLStateCache::useProgram(std::uint32_t programId)
+    {
+        if (programId_ == programId)
+        {
+            ++elidedCalls_;
+            return;
+        }
+
+        glUseProgram(programId);
+        programId_ = programId;
+    }
+
+    void GLStateCache::bindVertexArray(std::uint32_t vertexArrayId)
+    {
+        if (vertexArrayId_ == vertexArrayId)
+        {
+            ++elidedCalls_;
+            return;
+        }
+
+        glBindVertexArray(vertexArrayId);
+        vertexArrayId_ = vertexArrayId;
+        elementArrayBufferId_ = UNKNOWN;
+    }
+
+    void GLStateCache::bindTexture(std::uint32_t unit, std::uint32_t textureId)
+    {
+        if (unit < TEXTURE_UNITS && textureIds_[unit] == textureId)
+        {
+            ++elidedCalls_;
+            return;
+        }
+
+        if (activeTextureUnit_ == unit)
+        {
+            ++elidedCalls_;
+        }
+        else
+        {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            activeTextureUnit_ = unit;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, textureId);
+
+        if (unit < TEXTURE_UNITS)
+        {
+            textureIds_[unit] = textureId;
+        }
+    }
+
+    void GLStateCache::bindArrayBuffer(std::uint32_t bufferId)
+    {
+        if (arrayBufferId_ == bufferId)
+        {
+            ++elidedCalls_;
+            return;
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, bufferId);
+        arrayBufferId_ = bufferId;
+    }
+
+    void GLStateCache::bindElementArrayBuffer(std::uint32_t bufferId)
+    {
+        if (elementArrayBufferId_ == bufferId)
+        {
+            ++elidedCalls_;
+            return;
+        }
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferId);
+        elementArrayBufferId_ = bufferId;
+    }
+
+    void GLStateCache::bindCopyReadBuffer(std::uint32_t bufferId)
+    {
+        if (copyReadBufferId_ == bufferId)
+        {
+            ++elidedCalls_;
+            return;
+        }
+
+        glBindBuffer(GL_COPY_READ_BUFFER, bufferId);
+        copyReadBufferId_ = bufferId;
+    }
+
+    void GLStateCache::bindCopyWriteBuffer(std::uint32_t bufferId)
+    {
+        if (copyWriteBufferId_ == bufferId)
+        {
+            ++elidedCalls_;
+            return;
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, bufferId);
+        copyWriteBufferId_ = bufferId;
+    }
+
+    void GLStateCache::bindUniformBuffer(std::uint32_t bufferId)
+    {
+        if (uniformBufferId_ == bufferId)
+        {
+            ++elidedCalls_;
+            return;
+        }
+
+        glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+        uniformBufferId_ = bufferId;
+    }
+
+    void GLStateCache::bindDrawIndirectBuffer(std::uint32_t bufferId)
+    {
+        if (drawIndirectBufferId_ == bufferId)
+        {
+            ++elidedCalls_;
+            return;
+        }
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, bufferId);
+        drawIndirectBufferId_ = bufferId;
+    }
+
+    void GLStateCache::bindUniformRange(
+            std::uint32_t binding,
+            std::uint32_t bufferId,
+            std::uint32_t offset,
+            std::uint32_t size)
+    {
+        if (binding < UNIFORM_BINDINGS)
+        {
+            UniformRange& range = uniformRanges_[binding];
+
+            if (range.bufferId == bufferId && range.offset == offset && range.size == size)
+            {
+                ++elidedCalls_;
+                return;
+            }
+
+            range.bufferId = bufferId;
+            range.offset = offset;
+            range.size = size;
+        }
+
+        glBindBufferRange(GL_UNIFORM_BUFFER, binding, bufferId, offset, size);
+        uniformBufferId_ = bufferId;
+    }
+
+    void GLStateCache::setBlending(bool enabled)
+    {
+        setCapability(GL_BLEND, blending_, enabled);
+    }
+
+    void GLStateCache::setDepthTest(bool enabled)
+    {
+        setCapability(GL_DEPTH_TEST, depthTest_, enabled);
+    }
+
+    void GLStateCache::forgetVertexArray(std::uint32_t vertexArrayId)
+    {
+        if (vertexArrayId_ == vertexArrayId)
+        {
+            vertexArrayId_ = 0;
+            elementArrayBufferId_ = UNKNOWN;
+        }
+    }
+
+    void GLStateCache::forgetProgram(std::uint32_t programId)
+    {
+        if (programId_ == programId)
+        {
+            programId_ = UNKNOWN;
+        }
+    }
+
+    void GLStateCache::forgetTexture(std::uint32_t textureId)
+    {
+        for (auto& unitTextureId: textureIds_)
+        {
+            if (unitTextureId == textureId)
+            {
+                unitTextureId = 0;
+            }
+        }
+    }
+
+    void GLStateCache::forgetBuffer(std::uint32_t bufferId)
+    {
+        if (arrayBufferId_ == bufferId)
+        {
+            arrayBufferId_ = 0;
+        }
+
+        if (elementArrayBufferId_ == bufferId)
+        {
+            elementArrayBufferId_ = 0;
+        }
+
+        if (copyReadBufferId_ == bufferId)
+        {
+            copyReadBufferId_ = 0;
+        }
+
+        if (copyWriteBufferId_ == bufferId)
+        {
+            copyWriteBufferId_ = 0;
+        }
+
+        if (uniformBufferId_ == bufferId)
+        {
+            uniformBufferId_ = 0;
+        }
+
+        if (drawIndirectBufferId_ == bufferId)
+        {
+            drawIndirectBufferId_ = 0;
+        }
+
+        for (auto& uniformRange: uniformRanges_)
+        {
+            if (uniformRange.bufferId == bufferId)
+            {
+                uniformRange = UniformRange{};
+            }
+        }
+    }
+
+    std::uint32_t GLStateCache::elidedCalls() const
+    {
+        return elidedCalls_;
+    }
+
+    void GLStateCache::resetElidedCalls()
+    {
+        elidedCalls_ = 0;
+    }
+
+    void GLStateCache::setCapability(std::uint32_t capability, Capability& state, bool enabled)
+    {
+        const Capability requested = enabled ? CAPABILITY_ENABLED : CAPABILITY_DISABLED;
+
+        if (state == requested)
+        {
+            ++elidedCalls_;
+            return;
+        }
+
+        if (enabled)
+        {
+            glEnable(capability);
+        }
+        else
+        {
+            glDisable(capability);
+        }
+
+        state = requested;
+    }
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstdint>
+
+namespace PB
+{
+    /**
+    * \brief Shadows the OpenGL bindings and capabilities the engine changes while drawing, skipping any call that
+    * would set them to what they already are, and counting the calls skipped.
+    *
+    * <p>Only changes made through the cache are known to it.  Anything changing the same state directly must be
+    * followed by {\link GLStateCache::invalidate}, after which the next change to each piece of state is always
+    * made.</p>
+    */
+    class GLStateCache
+    {
+    public:
+        /**
+        * \brief Creates a cache that knows none of the current state.
+        */
+        GLStateCache();
+
+        /**
+        * \brief Forgets all shadowed state, so the next change to each piece of state is made whatever its value.
+        */
+        void invalidate();
+
+        /**
+        * \brief Makes the given shader program current, if it isn't already.
+        *
+        * \param programId The ID of the shader program, or 0 for none.
+        */
+        void useProgram(std::uint32_t programId);
+
+        /**
+        * \brief Binds the given vertex array, if it isn't already bound.
+        *
+        * \param vertexArrayId The ID of the vertex array, or 0 for none.
+        */
+        void bindVertexArray(std::uint32_t vertexArrayId);
+
+        /**
+        * \brief Binds the given 2D texture to the given texture unit, if it isn't already bound there, making the
+        * unit active first if it isn't already.
+        *
+        * \param unit      The texture unit to bind the texture to, counting from 0.
+        * \param textureId The ID of the texture, or 0 for none.
+        */
+        void bindTexture(std::uint32_t unit, std::uint32_t textureId);
+
+        /**
+        * \brief Binds the given buffer to GL_ARRAY_BUFFER, if it isn't already bound there.
+        *
+        * \param bufferId The ID of the buffer, or 0 for none.
+        */
+        void bindArrayBuffer(std::uint32_t bufferId);
+
+        /**
+        * \brief Binds the given buffer to GL_ELEMENT_ARRAY_BUFFER of the bound vertex array, if it isn't already
+        * bound there.  The binding is part of the vertex array, so it is forgotten whenever another is bound.
+        *
+        * \param bufferId The ID of the buffer, or 0 for none.
+        */
+        void bindElementArrayBuffer(std::uint32_t bufferId);
+
+        /**
+        * \brief Binds the given buffer to GL_COPY_READ_BUFFER, if it isn't already bound there.
+        *
+        * \param bufferId The ID of the buffer, or 0 for none.
+        */
+        void bindCopyReadBuffer(std::uint32_t bufferId);
+
+        /**
+        * \brief Binds the given buffer to GL_COPY_WRITE_BUFFER, if it isn't already bound there.
+        *
+        * \param bufferId The ID of the buffer, or 0 for none.
+        */
+        void bindCopyWriteBuffer(std::uint32_t bufferId);
+
+        /**
+        * \brief Binds the given buffer to GL_UNIFORM_BUFFER, if it isn't already bound there.
+        *
+        * \param bufferId The ID of the buffer, or 0 for none.
+        */
+        void bindUniformBuffer(std::uint32_t bufferId);
+
+        /**
+        * \brief Binds the given buffer to GL_DRAW_INDIRECT_BUFFER, if it isn't already bound there.
+        *
+        * \param bufferId The ID of the buffer, or 0 for none.
+        */
+        void bindDrawIndirectBuffer(std::uint32_t bufferId);
+
+        /**
+        * \brief Binds a range of the given buffer to the given uniform block binding, if that range isn't already
+        * bound there.  As with glBindBufferRange, the buffer is also left bound to GL_UNIFORM_BUFFER.
+        *
+        * \param binding  The uniform block binding to bind the range to.
+        * \param bufferId The ID of the buffer.
+        * \param offset   The offset of the range in the buffer, in bytes.
+        * \param size     The size of the range, in bytes.
+        */
+        void bindUniformRange(std::uint32_t binding, std::uint32_t bufferId, std::uint32_t offset, std::uint32_t size);
+
+        /**
+        * \brief Enables or disables GL_BLEND, if it isn't already.
+        *
+        * \param enabled True to enable blending, False to disable it.
+        */
+        void setBlending(bool enabled);
+
+        /**
+        * \brief Enables or disables GL_DEPTH_TEST, if it isn't already.
+        *
+        * \param enabled True to enable depth testing, False to disable it.
+        */
+        void setDepthTest(bool enabled);
+
+        /**
+        * \brief Forgets a deleted vertex array, which OpenGL unbinds if it was bound, so a new vertex array
+        * reusing its ID isn't taken to be bound already.
+        *
+        * \param vertexArrayId The ID of the deleted vertex array.
+        */
+        void forgetVertexArray(std::uint32_t vertexArrayId);
+
+        /**
+        * \brief Forgets a deleted buffer, which OpenGL unbinds from every target it was bound to, so a new buffer
+        * reusing its ID isn't taken to be bound already.
+        *
+        * \param bufferId The ID of the deleted buffer.
+        */
+        void forgetBuffer(std::uint32_t bufferId);
+
+        /**
+        * \brief Forgets a deleted shader program, so a new program reusing its ID once OpenGL releases it isn't
+        * taken to be in use already.
+        *
+        * \param programId The ID of the deleted shader program.
+        */
+        void forgetProgram(std::uint32_t programId);
+
+        /**
+        * \brief Forgets a deleted texture, which OpenGL unbinds from every texture unit it was bound to, so a new
+        * texture reusing its ID isn't taken to be bound already.
+        *
+        * \param textureId The ID of the deleted texture.
+        */
+        void forgetTexture(std::uint32_t textureId);
+
+        /**
+        * \brief Gets the number of calls skipped since the count was last reset.
+        *
+        * \return The number of calls skipped.
+        */
+        std::uint32_t elidedCalls() const;
+
+        /**
+        * \brief Resets the count of skipped calls.
+        */
+        void resetElidedCalls();
+
+    private:
+        /** Stands in for state the cache doesn't know, no OpenGL object has this ID */
+        static constexpr std::uint32_t UNKNOWN = 0xFFFFFFFF;
+        /** Texture units shadowed, binds to higher units are always made */
+        static constexpr std::uint32_t TEXTURE_UNITS = 16;
+        /** Uniform block bindings shadowed, binds to higher bindings are always made */
+        static constexpr std::uint32_t UNIFORM_BINDINGS = 16;
+
+        /**
+        * \brief A buffer range bound to a uniform block binding.
+        */
+        struct UniformRange
+        {
+            std::uint32_t bufferId = UNKNOWN;
+            std::uint32_t offset = 0;
+            std::uint32_t size = 0;
+        };
+
+        /**
+        * \brief Shadowed state of an enabled capability, GL_BLEND or GL_DEPTH_TEST.
+        */
+        enum Capability : std::uint8_t
+        {
+            CAPABILITY_UNKNOWN,
+            CAPABILITY_ENABLED,
+            CAPABILITY_DISABLED,
+        };
+
+    private:
+        /**
+        * \brief Enables or disables the given capability, if it isn't already.
+        *
+        * \param capability The OpenGL capability to change.
+        * \param state      The shadowed state of the capability.
+        * \param enabled    True to enable the capability, False to disable it.
+        */
+        void setCapability(std::uint32_t capability, Capability& state, bool enabled);
+
+    private:
+        std::uint32_t programId_ = UNKNOWN;
+        std::uint32_t vertexArrayId_ = UNKNOWN;
+        std::uint32_t activeTextureUnit_ = UNKNOWN;
+        std::uint32_t textureIds_[TEXTURE_UNITS]{};
+        std::uint32_t arrayBufferId_ = UNKNOWN;
+        /** Of the vertex array in vertexArrayId_ */
+        std::uint32_t elementArrayBufferId_ = UNKNOWN;
+        std::uint32_t copyReadBufferId_ = UNKNOWN;
+        std::uint32_t copyWriteBufferId_ = UNKNOWN;
+        std::uint32_t uniformBufferId_ = UNKNOWN;
+        std::uint32_t drawIndirectBufferId_ = UNKNOWN;
+        UniformRange uniformRanges_[UNIFORM_BINDINGS] = {};
+        Capability blending_ = CAPABILITY_UNKNOWN;
+        Capability depthTest_ = CAPABILITY_UNKNOWN;
+        std::uint32_t elidedCalls_ = 0;
+    };
+}
@@ -0,0 +1,148 @@
+#include "GlyphBatch.h"
+
+#include <cstddef>
+#include <utility>
+
+#include <glad/glad.h>
+
+namespace PB
+{
+    namespace
+    {
+        constexpr std::uint32_t POSITION_LOCATION = 2;
+        constexpr std::uint32_t DIMENSIONS_LOCATION = 3;
+        constexpr std::uint32_t UV_RECT_LOCATION = 4;
+        constexpr std::uint32_t COLOUR_LOCATION = 5;
+
+        constexpr std::uint32_t INSTANCE_STRIDE = sizeof(GlyphInstance);
+    }
+
+    static_assert(sizeof(GlyphInstance) == 12 * sizeof(float), "GlyphInstance must be tightly packed floats");
+
+    GlyphBatch::GlyphBatch(Shader shader) : shader_(std::move(shader))
+    {
+
+    }
+
+    GlyphBatch::~GlyphBatch()
+    {
+        if (VAO_ != 0)
+        {
+            glDeleteVertexArrays(1, &VAO_);
+            glDeleteBuffers(1, &VBO_);
+        }
+    }
+
+    bool GlyphBatch::init()
+    {
+        // Setting both Vertex and UV origin to 0 to make shader calculations simpler
+        //TODO: This may need to be revisited, offset origin could get weird later
+        float vertices[] = {
+                // Vertex                           // UV
+                0.0f, 1.0f, 0.0f,       0.0f, 1.0f, // Top left
+                0.0f, 0.0f, 0.0f,       0.0f, 0.0f, // Bot left
+                1.0f, 0.0f, 0.0f,       1.0f, 0.0f, // Bot right
+
+                0.0f, 1.0f, 0.0f,       0.0f, 1.0f, // Top left
+                1.0f, 0.0f, 0.0f,       1.0f, 0.0f, // Bot right
+                1.0f, 1.0f, 0.0f,       1.0f, 1.0f  // Top right
+        };
+
+        glGenVertexArrays(1, &VAO_);
+        glGenBuffers(1, &VBO_);
+
+        glBindVertexArray(VAO_);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*) 0);
+
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*) (3 * sizeof(float)));
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+
+        return VAO_ != 0;
+    }
+
+    void GlyphBatch::submit(const ImageReference& atlas, const GlyphInstance& instance)
+    {
+        batchFor(atlas).instances.push_back(instance);
+    }
+
+    void GlyphBatch::submit(const ImageReference& atlas, const std::vector<GlyphInstance>& instances)
+    {
+        std::vector<GlyphInstance>& batchInstances = batchFor(atlas).instances;
+        batchInstances.insert(batchInstances.end(), instances.begin(), instances.end());
+    }
+
+    GlyphBatch::Batch& GlyphBatch::batchFor(const ImageReference& atlas)
+    {
+        auto itr = batchIndexes_.find(atlas.id());
+
+        if (itr == batchIndexes_.end())
+        {
+            if (batchCount_ == batches_.size())
+            {
+                batches_.emplace_back();
+            }
+
+            batches_[batchCount_].atlas = atlas;
+
+            itr = batchIndexes_.emplace(atlas.id(), batchCount_++).first;
+        }
+
+        return batches_[itr->second];
+    }
+
+    void GlyphBatch::flush(CommandList& commandList)
+    {
+        drawCalls_ = 0;
+
+        if (batchCount_ == 0)
+        {
+            return;
+        }
+
+        commandList.beginPass(RenderPass::TEXT);
+        commandList.useProgram(shader_.id());
+        commandList.bindVertexArray(VAO_);
+
+        for (std::uint32_t i = 0; i < batchCount_; ++i)
+        {
+            Batch& batch = batches_[i];
+            const auto count = static_cast<std::uint32_t>(batch.instances.size());
+
+            commandList.upload(
+                    UploadUsage::INSTANCE_DATA,
+                    batch.instances.data(),
+                    count * static_cast<std::uint32_t>(sizeof(GlyphInstance)));
+            commandList.setInstanceAttribute(POSITION_LOCATION, 3, INSTANCE_STRIDE, offsetof(GlyphInstance, position));
+            commandList.setInstanceAttribute(DIMENSIONS_LOCATION, 2, INSTANCE_STRIDE,
+                                             offsetof(GlyphInstance, dimensions));
+            commandList.setInstanceAttribute(UV_RECT_LOCATION, 4, INSTANCE_STRIDE, offsetof(GlyphInstance, uvRect));
+            commandList.setInstanceAttribute(COLOUR_LOCATION, 3, INSTANCE_STRIDE, offsetof(GlyphInstance, colour));
+
+            commandList.setBlending(batch.atlas.requiresAlphaBlending);
+            commandList.bindTexture(0, batch.atlas.id());
+
+            commandList.drawArrays(6, count);
+
+            ++drawCalls_;
+
+            batch.instances.clear();
+        }
+
+        commandList.endPass();
+
+        batchIndexes_.clear();
+        batchCount_ = 0;
+    }
+
+    std::uint32_t GlyphBatch::drawCalls() const
+    {
+        return drawCalls_;
+    }
+}
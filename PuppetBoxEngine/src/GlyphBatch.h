@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "puppetbox/DataStructures.h"
+
+#include "CommandList.h"
+#include "ImageReference.h"
+#include "Shader.h"
+
+namespace PB
+{
+    /**
+    * \brief The per-instance data of a single batched glyph, read by the default glyph shader's instance
+    * attributes.
+    */
+    struct GlyphInstance
+    {
+        /** Bottom left corner of the glyph, in UI coordinates */
+        vec3 position{};
+        vec2 dimensions{};
+        /** Offset (xy) and size (zw) of the glyph within its font atlas, in UV coordinates */
+        vec4 uvRect{};
+        vec3 colour{1.0f, 1.0f, 1.0f};
+    };
+
+    /**
+    * \brief Collects the glyphs of every text area drawn over a frame and renders all of those sharing a font
+    * atlas with a single instanced draw call, uploading their {\link GlyphInstance} data through a
+    * {\link CommandList}, so there is no limit on the glyphs per draw.
+    */
+    class GlyphBatch
+    {
+    public:
+        /**
+        * \brief Creates an empty batch, drawing with the given glyph shader.
+        *
+        * \param shader The linked default glyph shader.
+        */
+        explicit GlyphBatch(Shader shader);
+
+        GlyphBatch(const GlyphBatch&) = delete;
+
+        GlyphBatch& operator=(const GlyphBatch&) = delete;
+
+        /**
+        * \brief Releases the glyph quad.
+        */
+        ~GlyphBatch();
+
+        /**
+        * \brief Creates the quad every glyph is drawn from.
+        *
+        * \return True if the batch is ready to draw, False otherwise.
+        */
+        bool init();
+
+        /**
+        * \brief Adds a glyph to the batch of its font atlas, to be drawn on the next flush.
+        *
+        * \param atlas    The font atlas the glyph is drawn from.
+        * \param instance The per-instance data of the glyph.
+        */
+        void submit(const ImageReference& atlas, const GlyphInstance& instance);
+
+        /**
+        * \brief Adds several glyphs from the same font atlas to its batch, to be drawn on the next flush.
+        *
+        * \param atlas     The font atlas the glyphs are drawn from.
+        * \param instances The per-instance data of the glyphs.
+        */
+        void submit(const ImageReference& atlas, const std::vector<GlyphInstance>& instances);
+
+        /**
+        * \brief Records the draws of all glyphs submitted since the last flush, one draw call per font atlas.
+        *
+        * \param commandList The list to record the draws into.
+        */
+        void flush(CommandList& commandList);
+
+        /**
+        * \brief Gets the number of draw calls made by the last flush.
+        *
+        * \return The number of draw calls made by the last flush.
+        */
+        std::uint32_t drawCalls() const;
+
+    private:
+        struct Batch
+        {
+            ImageReference atlas{0};
+            std::vector<GlyphInstance> instances{};
+        };
+
+    private:
+        /**
+        * \brief Finds the batch of the given font atlas, starting a new one if it has none yet this frame.
+        *
+        * \param atlas The font atlas to find the batch of.
+        * \return The batch of the font atlas.
+        */
+        Batch& batchFor(const ImageReference& atlas);
+
+    private:
+        Shader shader_;
+        std::uint32_t VAO_ = 0;
+        std::uint32_t VBO_ = 0;
+        /** Reused from frame to frame, only the first batchCount_ are in use */
+        std::vector<Batch> batches_{};
+        std::uint32_t batchCount_ = 0;
+        std::unordered_map<std::uint32_t, std::uint32_t> batchIndexes_{};
+        std::uint32_t drawCalls_ = 0;
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 
 //TODO: This is coupled to the FreeType library and it shouldn't be.
 #include <ft2build.h>
@@ -9,11 +10,14 @@
 #include "puppetbox/DataStructures.h"
 #include "puppetbox/RenderWindow.h"
 
+#include "CommandList.h"
 #include "Font.h"
 #include "ImageData.h"
 #include "ImageOptions.h"
 #include "ImageReference.h"
 #include "Mesh.h"
+#include "MeshFormat.h"
+#include "Shader.h"
 #include "TypeDef.h"
 
 namespace PB
@@ -33,10 +37,28 @@ namespace PB
         */
         virtual bool init(PB::ProcAddress procAddress) = 0;
 
+        /**
+        * \brief Releases the GFX API specific resources created by {\link IGfxApi::init}.  Must be called while
+        * the GFX context is still current, before it is destroyed, after which no more frames can be drawn.
+        */
+        virtual void shutdown() = 0;
+
         /**
         * \brief Used to define GFX API specific commands that must execute before each rendering loop.
+        *
+        * <p>The rendering area is passed in rather than read from {\link IGfxApi::setRenderDimensions}, as a
+        * frame may be drawn on a render thread while the main thread takes in the next resize.</p>
+        *
+        * \param width	The width of the rendering area when the frame was recorded.
+        * \param height	The height of the rendering area when the frame was recorded.
+        */
+        virtual void preLoopCommands(std::uint32_t width, std::uint32_t height) const = 0;
+
+        /**
+        * \brief Used to define GFX API specific commands that must execute after everything for a frame is
+        * drawn, before it is presented.
         */
-        virtual void preLoopCommands() const = 0;
+        virtual void postLoopCommands() const = 0;
 
         /**
         * \brief Used to execute GFX API specific command to set renderer dimensions.
@@ -70,6 +92,14 @@ namespace PB
         */
         virtual ImageReference loadImage(ImageData imageData, ImageOptions options) const = 0;
 
+        /**
+        * \brief Used to execute the GFX API specific commands to release the GFX memory of a loaded image,
+        * including font glyph atlases.
+        *
+        * \param image	The image to release, its reference is cleared.
+        */
+        virtual void freeImage(ImageReference& image) const = 0;
+
         /**
          * \brief Generates textures for each glyph of the given font face, adding references to them
          * within the loaded characters {\link unordered_map}.
@@ -92,19 +122,112 @@ namespace PB
         */
         virtual Mesh loadMesh(Vertex* vertexData, std::uint32_t vertexCount) const = 0;
 
+        /**
+        * \brief Used to execute the GFX API specific commands to load an already laid out mesh buffer
+        * into GFX memory, handing its vertex and index data over as is.
+        *
+        * \param meshBuffer	The mesh buffer to load into memory.
+        */
+        virtual Mesh loadMesh(const MeshFormat::MeshBuffer& meshBuffer) const = 0;
+
+        /**
+        * \brief Used to execute the GFX API specific commands to release the GFX memory of a loaded mesh.
+        *
+        * \param mesh	The mesh to release, its references are cleared.
+        */
+        virtual void freeMesh(Mesh& mesh) const = 0;
+
+        /**
+        * \brief Starts building the given shader program from its stage sources, without waiting on the
+        * driver to compile and link it.
+        *
+        * \param shader       The shader program to build, which must not have been built yet.
+        * \param vertexCode   The code of the vertex shader.
+        * \param geometryCode The code of the geometry shader, empty if the program has none.
+        * \param fragmentCode The code of the fragment shader.
+        *
+        * \return True if building was started, False otherwise.
+        */
+        virtual bool beginShader(
+                Shader& shader,
+                const std::string& vertexCode,
+                const std::string& geometryCode,
+                const std::string& fragmentCode) const = 0;
+
+        /**
+        * \brief Checks if the shader program started by {\link IGfxApi::beginShader} can be finished without
+        * blocking.
+        *
+        * \param shader The shader program being built.
+        *
+        * \return True if {\link IGfxApi::finishShader} won't block, False otherwise.
+        */
+        virtual bool isShaderReady(const Shader& shader) const = 0;
+
+        /**
+        * \brief Finishes building the shader program started by {\link IGfxApi::beginShader}, blocking until
+        * it is compiled and linked.
+        *
+        * \param shader The shader program being built.
+        *
+        * \return True if the shader program was built successfully, False otherwise.
+        */
+        virtual bool finishShader(Shader& shader) const = 0;
+
+        /**
+        * \brief Checks if shader programs can be saved as, and created from, program binaries.
+        *
+        * \return True if program binaries are supported, False otherwise.
+        */
+        virtual bool supportsShaderBinaries() const = 0;
+
+        /**
+        * \brief Creates the given shader program from a program binary previously retrieved with
+        * {\link IGfxApi::getShaderBinary}.
+        *
+        * \param shader The shader program to create, which must not have been built yet.
+        * \param binary The program binary to create it from.
+        *
+        * \return True if the program binary was accepted, False otherwise.
+        */
+        virtual bool loadShaderBinary(Shader& shader, const ShaderBinary& binary) const = 0;
+
+        /**
+        * \brief Retrieves the program binary of a built shader program.
+        *
+        * \param shader The shader program to retrieve the binary of.
+        * \param binary The program binary to fill.
+        *
+        * \return True if a program binary was retrieved, False otherwise.
+        */
+        virtual bool getShaderBinary(const Shader& shader, ShaderBinary* binary) const = 0;
+
+        /**
+        * \brief Releases the given shader program, and any shaders it was built from.
+        *
+        * \param shader The shader program to release, its references are cleared.
+        */
+        virtual void freeShader(Shader& shader) const = 0;
+
         /**
         * \brief Initializes the UBO buffer, defining the data ranges.  This is needed before use.
         */
         virtual void initializeUBORanges() = 0;
 
         /**
-        * \brief Sets view/projection matrices in the UBO.  Must initializeUBORanges() before use.
+        * \brief Forgets any GFX state the API shadows, so the next change to each piece of state is made whatever
+        * its value.  Called whenever the GFX context changes hands between threads, or after GFX state was changed
+        * without going through the API.
+        */
+        virtual void invalidateState() const = 0;
+
+        /**
+        * \brief Executes the commands of the given list, in the order they were recorded.  Lists are submitted
+        * in the order they are to be drawn, between preLoopCommands() and postLoopCommands().
         *
-        * \param view		     The View Matrix to set.
-        * \param projection	     The Projection Matrix to set.
-        * \param uiProjection    The UI orthographic projection matrix to set.
+        * \param commandList The commands to execute.
         */
-        virtual void setTransformUBOData(mat4 view, mat4 projection, mat4 uiProjection) const = 0;
+        virtual void submit(const CommandList& commandList) const = 0;
 
         /**
         * \brief Enables GFX API Debugging if it has one.
@@ -112,5 +235,21 @@ namespace PB
         * \return True if the debugger was found and enabled, False otherwise.
         */
         virtual bool initGfxDebug() const = 0;
+
+        /**
+        * \brief Identifies the GFX driver, so data cached from it, such as shader program binaries, is
+        * discarded once the driver changes.
+        *
+        * \return The vendor, renderer and version of the driver.
+        */
+        virtual std::string driverId() const = 0;
+
+        /**
+        * \brief Gets the counts of the rendering work submitted for the last finished frame, and the GPU time of
+        * its passes where the GFX API measures it.  Can be called while another thread is submitting frames.
+        *
+        * \return The stats of the last finished frame.
+        */
+        virtual RenderStats lastFrameStats() const = 0;
     };
 }
\ No newline at end of file
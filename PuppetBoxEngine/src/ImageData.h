@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstdlib>
 
 namespace PB
 {
@@ -14,6 +15,27 @@ namespace PB
         std::int32_t width;
         std::int32_t height;
         std::int32_t numChannels;
+        /** Levels of a pre-built mip chain in the buffer, largest first, or 1 to have mipmaps generated */
+        std::int32_t mipLevels = 1;
+
+        /**
+        * \brief Gets the number of bytes in the buffer, including every mip level.
+        */
+        std::uint64_t byteSize() const
+        {
+            std::uint64_t size = 0;
+            std::int32_t levelWidth = width;
+            std::int32_t levelHeight = height;
+
+            for (std::int32_t level = 0; level < mipLevels; ++level)
+            {
+                size += static_cast<std::uint64_t>(levelWidth) * levelHeight * numChannels;
+                levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+                levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+            }
+
+            return size;
+        }
 
         /**
         * \brief Used to free the buffer data of the image data once it is no longer needed.
@@ -12,7 +12,18 @@ namespace PB
         std::uint32_t EBO = 0;
         std::uint32_t VAO = 0;
         std::int32_t drawCount = 0;
+        /** Bytes per index in the EBO, 2 or 4 */
+        std::uint8_t indexSize = 4;
         std::uint32_t stride = 0;
+        /** Bytes of vertex and index data uploaded for the mesh */
+        std::uint64_t byteSize = 0;
+        /** Whether the mesh is sub-allocated from the shared mesh arena, whose VAO, VBO, and EBO it refers to */
+        bool inArena = false;
+        /** Offset of the mesh's first vertex in the VBO, added to each of its indices */
+        std::int32_t baseVertex = 0;
+        /** Offset of the mesh's first index in the EBO, counted in indices */
+        std::uint32_t firstIndex = 0;
+        std::uint32_t vertexCount = 0;
         vec3 scale{1.0f, 1.0f, 1.0f};
         vec3 offset{0.0f, 0.0f, 0.0f};
         mat4 transform{};
@@ -0,0 +1,281 @@
+#include "MeshArena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include <glad/glad.h>
+
+#include "Logger.h"
+
+namespace PB
+{
+    namespace
+    {
+        constexpr std::uint32_t VERTEX_SIZE = 8 * sizeof(float);
+        constexpr std::uint32_t INDEX_SIZE = sizeof(std::uint16_t);
+
+        /**
+        * \brief Takes a range of the given size from the first free range large enough for it.
+        *
+        * \param freeRanges The free ranges to take from.
+        * \param count      The size of the range to take.
+        * \param range      The range taken.
+        *
+        * \return True if a range was taken, False if no free range is large enough.
+        */
+        bool takeFirstFit(std::vector<ArenaRange>& freeRanges, std::uint32_t count, ArenaRange& range)
+        {
+            for (auto itr = freeRanges.begin(); itr != freeRanges.end(); ++itr)
+            {
+                if (itr->count >= count)
+                {
+                    range = ArenaRange{itr->first, count};
+
+                    itr->first += count;
+                    itr->count -= count;
+
+                    if (itr->count == 0)
+                    {
+                        freeRanges.erase(itr);
+                    }
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+        * \brief Returns a range to the free ranges, merging it with the free ranges either side of it.
+        *
+        * \param freeRanges The free ranges to return the range to.
+        * \param range      The range to return.
+        */
+        void release(std::vector<ArenaRange>& freeRanges, ArenaRange range)
+        {
+            auto next = std::lower_bound(
+                    freeRanges.begin(),
+                    freeRanges.end(),
+                    range,
+                    [](const ArenaRange& a, const ArenaRange& b) {
+                        return a.first < b.first;
+                    });
+
+            if (next != freeRanges.end() && range.first + range.count == next->first)
+            {
+                range.count += next->count;
+                next = freeRanges.erase(next);
+            }
+
+            if (next != freeRanges.begin())
+            {
+                auto previous = next - 1;
+
+                if (previous->first + previous->count == range.first)
+                {
+                    previous->count += range.count;
+                    return;
+                }
+            }
+
+            freeRanges.insert(next, range);
+        }
+    }
+
+    MeshArena::MeshArena(GLStateCache& stateCache) : stateCache_(stateCache)
+    {
+
+    }
+
+    MeshArena::~MeshArena()
+    {
+        if (VAO_ != 0)
+        {
+            glDeleteVertexArrays(1, &VAO_);
+            glDeleteBuffers(1, &VBO_);
+            glDeleteBuffers(1, &EBO_);
+            stateCache_.forgetVertexArray(VAO_);
+            stateCache_.forgetBuffer(VBO_);
+            stateCache_.forgetBuffer(EBO_);
+        }
+    }
+
+    bool MeshArena::init(std::uint32_t vertexCapacity, std::uint32_t indexCapacity)
+    {
+        glGenVertexArrays(1, &VAO_);
+        glGenBuffers(1, &VBO_);
+        glGenBuffers(1, &EBO_);
+
+        if (VAO_ == 0 || VBO_ == 0 || EBO_ == 0)
+        {
+            LOGGER_ERROR("Failed to create mesh arena buffers");
+            return false;
+        }
+
+        stateCache_.bindVertexArray(VAO_);
+
+        stateCache_.bindArrayBuffer(VBO_);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<std::intmax_t>(vertexCapacity) * VERTEX_SIZE, nullptr,
+                     GL_STATIC_DRAW);
+
+        stateCache_.bindElementArrayBuffer(EBO_);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<std::intmax_t>(indexCapacity) * INDEX_SIZE, nullptr,
+                     GL_STATIC_DRAW);
+
+        // The standard vertex layout, see MeshFormat::standardMeshBuffer()
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*) 0); // NOLINT(modernize-use-nullptr)
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*) (3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*) (6 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+
+        stateCache_.bindArrayBuffer(0);
+        stateCache_.bindVertexArray(0);
+
+        vertexCapacity_ = vertexCapacity;
+        indexCapacity_ = indexCapacity;
+        freeVertices_ = {ArenaRange{0, vertexCapacity}};
+        freeIndices_ = {ArenaRange{0, indexCapacity}};
+
+        return true;
+    }
+
+    bool MeshArena::accepts(const MeshFormat::MeshBuffer& meshBuffer)
+    {
+        return MeshFormat::isStandardLayout(meshBuffer)
+               && meshBuffer.vertexCount > 0
+               && meshBuffer.vertexCount <= MAX_MESH_VERTICES;
+    }
+
+    bool MeshArena::add(const MeshFormat::MeshBuffer& meshBuffer, Mesh& mesh)
+    {
+        const std::uint32_t indexCount = meshBuffer.indexCount > 0 ? meshBuffer.indexCount : meshBuffer.vertexCount;
+
+        ArenaRange vertices{};
+        ArenaRange indices{};
+
+        if (!take(VBO_, VERTEX_SIZE, vertexCapacity_, freeVertices_, meshBuffer.vertexCount, vertices))
+        {
+            return false;
+        }
+
+        if (!take(EBO_, INDEX_SIZE, indexCapacity_, freeIndices_, indexCount, indices))
+        {
+            release(freeVertices_, vertices);
+            return false;
+        }
+
+        // Indices stay relative to the mesh, the draw adds its base vertex, which is what keeps them 16 bit
+        std::vector<std::uint16_t> indexData(indexCount);
+
+        for (std::uint32_t i = 0; i < indexCount; ++i)
+        {
+            if (meshBuffer.indexCount == 0)
+            {
+                indexData[i] = static_cast<std::uint16_t>(i);
+            }
+            else if (meshBuffer.indexSize == 2)
+            {
+                std::memcpy(&indexData[i], meshBuffer.indexData + (i * 2), sizeof(std::uint16_t));
+            }
+            else
+            {
+                // Read in host order, as the gfx API would have
+                std::uint32_t index;
+                std::memcpy(&index, meshBuffer.indexData + (i * 4), sizeof(index));
+                indexData[i] = static_cast<std::uint16_t>(index);
+            }
+        }
+
+        // Uploaded through the copy targets, binding GL_ELEMENT_ARRAY_BUFFER would change the bound VAO
+        stateCache_.bindCopyWriteBuffer(VBO_);
+        glBufferSubData(GL_COPY_WRITE_BUFFER,
+                        static_cast<std::intptr_t>(vertices.first) * VERTEX_SIZE,
+                        static_cast<std::intptr_t>(vertices.count) * VERTEX_SIZE,
+                        meshBuffer.vertexData);
+        stateCache_.bindCopyWriteBuffer(EBO_);
+        glBufferSubData(GL_COPY_WRITE_BUFFER,
+                        static_cast<std::intptr_t>(indices.first) * INDEX_SIZE,
+                        static_cast<std::intptr_t>(indices.count) * INDEX_SIZE,
+                        indexData.data());
+        stateCache_.bindCopyWriteBuffer(0);
+
+        mesh.VAO = VAO_;
+        mesh.VBO = VBO_;
+        mesh.EBO = EBO_;
+        mesh.inArena = true;
+        mesh.stride = VERTEX_SIZE / sizeof(float);
+        mesh.indexSize = INDEX_SIZE;
+        mesh.baseVertex = static_cast<std::int32_t>(vertices.first);
+        mesh.vertexCount = vertices.count;
+        mesh.firstIndex = indices.first;
+        mesh.drawCount = static_cast<std::int32_t>(indices.count);
+        mesh.byteSize = (static_cast<std::uint64_t>(vertices.count) * VERTEX_SIZE)
+                        + (static_cast<std::uint64_t>(indices.count) * INDEX_SIZE);
+
+        return true;
+    }
+
+    void MeshArena::remove(const Mesh& mesh)
+    {
+        release(freeVertices_, ArenaRange{static_cast<std::uint32_t>(mesh.baseVertex), mesh.vertexCount});
+        release(freeIndices_, ArenaRange{mesh.firstIndex, static_cast<std::uint32_t>(mesh.drawCount)});
+    }
+
+    bool MeshArena::take(
+            std::uint32_t bufferId,
+            std::uint32_t elementSize,
+            std::uint32_t& capacity,
+            std::vector<ArenaRange>& freeRanges,
+            std::uint32_t count,
+            ArenaRange& range)
+    {
+        if (takeFirstFit(freeRanges, count, range))
+        {
+            return true;
+        }
+
+        const std::uint64_t grownCapacity = std::max(static_cast<std::uint64_t>(capacity) * 2,
+                                                     static_cast<std::uint64_t>(capacity) + count);
+
+        if (grownCapacity > UINT32_MAX)
+        {
+            LOGGER_ERROR("Mesh arena can't grow past " + std::to_string(capacity) + " elements");
+            return false;
+        }
+
+        grow(bufferId, static_cast<std::uint64_t>(capacity) * elementSize, grownCapacity * elementSize);
+
+        release(freeRanges, ArenaRange{capacity, static_cast<std::uint32_t>(grownCapacity) - capacity});
+        capacity = static_cast<std::uint32_t>(grownCapacity);
+
+        return takeFirstFit(freeRanges, count, range);
+    }
+
+    void MeshArena::grow(std::uint32_t bufferId, std::uint64_t oldSize, std::uint64_t newSize)
+    {
+        std::uint32_t copyId = 0;
+        glGenBuffers(1, &copyId);
+
+        stateCache_.bindCopyReadBuffer(bufferId);
+        stateCache_.bindCopyWriteBuffer(copyId);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<std::intptr_t>(oldSize), nullptr, GL_STATIC_COPY);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<std::intptr_t>(oldSize));
+
+        // Reallocating the storage of the same name keeps the VAO and loaded meshes pointing at it
+        stateCache_.bindCopyReadBuffer(copyId);
+        stateCache_.bindCopyWriteBuffer(bufferId);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<std::intptr_t>(newSize), nullptr, GL_STATIC_DRAW);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<std::intptr_t>(oldSize));
+
+        stateCache_.bindCopyReadBuffer(0);
+        stateCache_.bindCopyWriteBuffer(0);
+        glDeleteBuffers(1, &copyId);
+        stateCache_.forgetBuffer(copyId);
+
+        LOGGER_INFO("Mesh arena buffer grown to " + std::to_string(newSize) + " bytes");
+    }
+}
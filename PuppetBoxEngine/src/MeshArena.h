@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "puppetbox/DataStructures.h"
+
+#include "GLStateCache.h"
+#include "Mesh.h"
+#include "MeshFormat.h"
+
+namespace PB
+{
+    /**
+    * \brief A range of vertices or indices in a {\link MeshArena} buffer.
+    */
+    struct ArenaRange
+    {
+        std::uint32_t first = 0;
+        std::uint32_t count = 0;
+    };
+
+    /**
+    * \brief Holds the vertices and indices of every mesh with the standard vertex layout in one VBO and one EBO,
+    * drawn through a single VAO, so switching between those meshes needs no binds and draws of different
+    * meshes can be made with one multi draw call.
+    *
+    * <p>Meshes are sub-allocated first fit, and their ranges are returned to be reused once they are freed.
+    * When a mesh doesn't fit, the buffer it needs is grown to at least double its size, keeping its name so the
+    * VAO and loaded meshes still refer to it.</p>
+    *
+    * <p>Indices are 16 bit and relative to each mesh's base vertex, so only meshes of up to
+    * {\link MeshArena::MAX_MESH_VERTICES} vertices are held.</p>
+    */
+    class MeshArena
+    {
+    public:
+        static constexpr std::uint32_t MAX_MESH_VERTICES = 65536;
+
+    public:
+        /**
+        * \brief Creates an arena binding its buffers through the given state cache.
+        *
+        * \param stateCache The state cache of the gfx API owning the arena.
+        */
+        explicit MeshArena(GLStateCache& stateCache);
+
+        MeshArena(const MeshArena&) = delete;
+
+        MeshArena& operator=(const MeshArena&) = delete;
+
+        ~MeshArena();
+
+        /**
+        * \brief Creates the VAO and the buffers, with room for the given number of vertices and indices.
+        *
+        * \param vertexCapacity The number of vertices to make room for.
+        * \param indexCapacity  The number of indices to make room for.
+        *
+        * \return True if the buffers were created, False otherwise.
+        */
+        bool init(std::uint32_t vertexCapacity, std::uint32_t indexCapacity);
+
+        /**
+        * \brief Checks if the given mesh buffer can be held by the arena.
+        *
+        * \param meshBuffer The mesh buffer to check.
+        *
+        * \return True if the mesh buffer has the standard vertex layout and few enough vertices, False otherwise.
+        */
+        static bool accepts(const MeshFormat::MeshBuffer& meshBuffer);
+
+        /**
+        * \brief Copies the vertices and indices of the given mesh buffer into the arena.  Meshes without indices
+        * are given sequential ones.
+        *
+        * \param meshBuffer The mesh buffer to copy, which the arena must accept.
+        * \param mesh       The mesh to set the arena's VAO, buffers, and the mesh's ranges on.
+        *
+        * \return True if the mesh was added, False otherwise.
+        */
+        bool add(const MeshFormat::MeshBuffer& meshBuffer, Mesh& mesh);
+
+        /**
+        * \brief Returns the ranges of the given mesh to be reused.
+        *
+        * \param mesh The mesh to remove, which must have been added to this arena.
+        */
+        void remove(const Mesh& mesh);
+
+    private:
+        /**
+        * \brief Takes a range of the given size from the given buffer, growing the buffer if no free range is
+        * large enough.
+        *
+        * \param bufferId    The buffer to take the range from.
+        * \param elementSize Bytes per vertex or index in the buffer.
+        * \param capacity    The number of vertices or indices the buffer has room for, updated if it grows.
+        * \param freeRanges  The free ranges of the buffer.
+        * \param count       The number of vertices or indices to take.
+        * \param range       The range taken.
+        *
+        * \return True if a range was taken, False otherwise.
+        */
+        bool take(
+                std::uint32_t bufferId,
+                std::uint32_t elementSize,
+                std::uint32_t& capacity,
+                std::vector<ArenaRange>& freeRanges,
+                std::uint32_t count,
+                ArenaRange& range);
+
+        /**
+        * \brief Reallocates the given buffer with a larger size, keeping its name and contents.
+        *
+        * \param bufferId The buffer to grow.
+        * \param oldSize  The current size of the buffer, in bytes.
+        * \param newSize  The size to grow the buffer to, in bytes.
+        */
+        void grow(std::uint32_t bufferId, std::uint64_t oldSize, std::uint64_t newSize);
+
+    private:
+        GLStateCache& stateCache_;
+        std::uint32_t VAO_ = 0;
+        std::uint32_t VBO_ = 0;
+        std::uint32_t EBO_ = 0;
+        std::uint32_t vertexCapacity_ = 0;
+        std::uint32_t indexCapacity_ = 0;
+        /** Sorted by first, with no two ranges adjacent */
+        std::vector<ArenaRange> freeVertices_{};
+        /** Sorted by first, with no two ranges adjacent */
+        std::vector<ArenaRange> freeIndices_{};
+    };
+}
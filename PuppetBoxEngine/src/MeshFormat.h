@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "BinaryFormat.h"
+
+/**
+ * Layout of the compiled binary mesh format (.pbmesh), shared between the engine loader and the
+ * mesh-converter tool, so it must not depend on anything outside the standard library and
+ * {\link BinaryFormat.h}.
+ *
+ * <p>Header and descriptor values are little-endian.  Vertex and index data are stored exactly as they
+ * are handed to the GFX API, so they are little-endian as well, and are only usable as is on little-endian
+ * hosts.</p>
+ *
+ * <pre>
+ * Header
+ *   char[4]   magic            "PBMS"
+ *   uint16    version
+ *   uint8     attributeCount
+ *   uint8     indexSize        Bytes per index, 2 or 4, or 0 for non-indexed meshes
+ *   uint32    vertexCount
+ *   uint32    vertexStride     Bytes per vertex
+ *   uint32    indexCount
+ *   uint32    vertexDataOffset Offset of the vertex data from the start of the file
+ *   uint32    indexDataOffset  Offset of the index data from the start of the file
+ * Vertex layout (attributeCount entries)
+ *   uint8     location         Shader attribute location
+ *   uint8     componentType    {\link MeshFormat::ComponentType} of each component
+ *   uint8     componentCount
+ *   uint8     normalized       1 if integer components are normalized, 0 otherwise
+ *   uint32    offset           Offset of the attribute within a vertex
+ * Vertex data (vertexCount * vertexStride bytes, interleaved)
+ * Index data (indexCount * indexSize bytes)
+ * </pre>
+ */
+namespace PB::MeshFormat
+{
+    constexpr char MAGIC[4] = {'P', 'B', 'M', 'S'};
+    constexpr std::uint16_t VERSION = 1;
+    constexpr const char* FILE_EXTENSION = ".pbmesh";
+
+    constexpr std::uint32_t HEADER_SIZE = 4 + 2 + 1 + 1 + 4 + 4 + 4 + 4 + 4;
+    constexpr std::uint32_t ATTRIBUTE_SIZE = 1 + 1 + 1 + 1 + 4;
+
+    /**
+     * \brief Vertex and index data start on a multiple of this many bytes.
+     */
+    constexpr std::uint32_t DATA_ALIGNMENT = 4;
+
+    enum ComponentType : std::uint8_t
+    {
+        FLOAT32 = 0,
+        INT8 = 1,
+        UINT8 = 2,
+        INT16 = 3,
+        UINT16 = 4
+    };
+
+    struct VertexAttribute
+    {
+        std::uint8_t location = 0;
+        ComponentType componentType = FLOAT32;
+        std::uint8_t componentCount = 0;
+        bool normalized = false;
+        std::uint32_t offset = 0;
+    };
+
+    /**
+     * \brief View of a mesh's vertex layout, vertex data, and index data, ready to hand to the GFX API.
+     *
+     * <p>The view does not own the data it points to.</p>
+     */
+    struct MeshBuffer
+    {
+        std::vector<VertexAttribute> attributes{};
+        std::uint32_t vertexCount = 0;
+        std::uint32_t vertexStride = 0;
+        const std::uint8_t* vertexData = nullptr;
+        std::uint32_t indexCount = 0;
+        std::uint8_t indexSize = 0;
+        const std::uint8_t* indexData = nullptr;
+    };
+
+    /**
+     * \brief Gets the size in bytes of a single component of the given type.
+     *
+     * \param componentType The type of the component.
+     *
+     * \return The size of the component, or 0 if the type is unknown.
+     */
+    inline std::uint32_t componentSize(std::uint8_t componentType)
+    {
+        switch (componentType)
+        {
+            case FLOAT32:
+                return 4;
+            case INT8:
+            case UINT8:
+                return 1;
+            case INT16:
+            case UINT16:
+                return 2;
+            default:
+                return 0;
+        }
+    }
+
+    /**
+     * \brief Rounds the given offset up to the next multiple of {\link MeshFormat::DATA_ALIGNMENT}.
+     *
+     * \param offset The offset to align.
+     *
+     * \return The aligned offset.
+     */
+    inline std::uint32_t alignOffset(std::uint32_t offset)
+    {
+        return (offset + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+    }
+
+    /**
+     * \brief Encodes the given mesh buffer into the binary mesh format.  Indices are read as the buffer's
+     * index size, and narrowed to 16 bits if all vertices can be addressed with them.
+     *
+     * \param meshBuffer The mesh buffer to encode, its vertex data must already be little-endian.
+     *
+     * \return The encoded mesh.
+     */
+    inline std::vector<std::uint8_t> encode(const MeshBuffer& meshBuffer)
+    {
+        const auto attributeCount = static_cast<std::uint32_t>(meshBuffer.attributes.size());
+        const std::uint8_t indexSize = meshBuffer.indexCount == 0 ? 0 : (meshBuffer.vertexCount <= UINT16_MAX ? 2 : 4);
+
+        const std::uint32_t vertexDataOffset = alignOffset(HEADER_SIZE + (attributeCount * ATTRIBUTE_SIZE));
+        const std::uint32_t vertexDataSize = meshBuffer.vertexCount * meshBuffer.vertexStride;
+        const std::uint32_t indexDataOffset = alignOffset(vertexDataOffset + vertexDataSize);
+
+        std::vector<std::uint8_t> bytes(indexDataOffset + (meshBuffer.indexCount * indexSize));
+
+        std::copy(MAGIC, MAGIC + 4, bytes.begin());
+        BinaryFormat::writeUInt16(&bytes[4], VERSION);
+        bytes[6] = static_cast<std::uint8_t>(attributeCount);
+        bytes[7] = indexSize;
+        BinaryFormat::writeUInt32(&bytes[8], meshBuffer.vertexCount);
+        BinaryFormat::writeUInt32(&bytes[12], meshBuffer.vertexStride);
+        BinaryFormat::writeUInt32(&bytes[16], meshBuffer.indexCount);
+        BinaryFormat::writeUInt32(&bytes[20], vertexDataOffset);
+        BinaryFormat::writeUInt32(&bytes[24], indexDataOffset);
+
+        std::uint32_t offset = HEADER_SIZE;
+
+        for (const auto& attribute: meshBuffer.attributes)
+        {
+            bytes[offset] = attribute.location;
+            bytes[offset + 1] = attribute.componentType;
+            bytes[offset + 2] = attribute.componentCount;
+            bytes[offset + 3] = attribute.normalized ? 1 : 0;
+            BinaryFormat::writeUInt32(&bytes[offset + 4], attribute.offset);
+            offset += ATTRIBUTE_SIZE;
+        }
+
+        std::copy(meshBuffer.vertexData, meshBuffer.vertexData + vertexDataSize, bytes.begin() + vertexDataOffset);
+
+        for (std::uint32_t i = 0; i < meshBuffer.indexCount; ++i)
+        {
+            const std::uint32_t index = meshBuffer.indexSize == 2
+                                        ? BinaryFormat::readUInt16(meshBuffer.indexData + (i * 2))
+                                        : BinaryFormat::readUInt32(meshBuffer.indexData + (i * 4));
+
+            if (indexSize == 2)
+            {
+                BinaryFormat::writeUInt16(&bytes[indexDataOffset + (i * 2)], static_cast<std::uint16_t>(index));
+            }
+            else
+            {
+                BinaryFormat::writeUInt32(&bytes[indexDataOffset + (i * 4)], index);
+            }
+        }
+
+        return bytes;
+    }
+
+    /**
+     * \brief Creates a mesh buffer over the given engine standard vertices, 3 position, 3 normal, and 2 UV
+     * floats each, and 32 bit indices.  The buffer views the given vectors, which must outlive it.
+     *
+     * \param vertices The vertex floats.
+     * \param indices  The vertex indices, stored in host order, so only valid to encode on little-endian hosts.
+     *
+     * \return The mesh buffer viewing the given data.
+     */
+    inline MeshBuffer standardMeshBuffer(const std::vector<float>& vertices, const std::vector<std::uint32_t>& indices)
+    {
+        MeshBuffer meshBuffer{};
+        meshBuffer.attributes = {
+                {0, FLOAT32, 3, false, 0},                  // Position
+                {1, FLOAT32, 3, false, 3 * sizeof(float)},  // Normal
+                {2, FLOAT32, 2, false, 6 * sizeof(float)}   // UV
+        };
+        meshBuffer.vertexStride = 8 * sizeof(float);
+        meshBuffer.vertexCount = static_cast<std::uint32_t>(vertices.size() / 8);
+        meshBuffer.vertexData = reinterpret_cast<const std::uint8_t*>(vertices.data());
+        meshBuffer.indexCount = static_cast<std::uint32_t>(indices.size());
+        meshBuffer.indexSize = 4;
+        meshBuffer.indexData = reinterpret_cast<const std::uint8_t*>(indices.data());
+
+        return meshBuffer;
+    }
+
+    /**
+     * \brief Checks if the given mesh buffer has the engine standard vertex layout, the one created by
+     * {\link MeshFormat::standardMeshBuffer}.
+     *
+     * \param meshBuffer The mesh buffer to check.
+     *
+     * \return True if the mesh buffer has the standard vertex layout, False otherwise.
+     */
+    inline bool isStandardLayout(const MeshBuffer& meshBuffer)
+    {
+        static const VertexAttribute STANDARD_ATTRIBUTES[] = {
+                {0, FLOAT32, 3, false, 0},
+                {1, FLOAT32, 3, false, 3 * sizeof(float)},
+                {2, FLOAT32, 2, false, 6 * sizeof(float)}
+        };
+
+        if (meshBuffer.vertexStride != 8 * sizeof(float) || meshBuffer.attributes.size() != 3)
+        {
+            return false;
+        }
+
+        for (std::uint32_t i = 0; i < 3; ++i)
+        {
+            const VertexAttribute& attribute = meshBuffer.attributes[i];
+            const VertexAttribute& standard = STANDARD_ATTRIBUTES[i];
+
+            if (attribute.location != standard.location
+                || attribute.componentType != standard.componentType
+                || attribute.componentCount != standard.componentCount
+                || attribute.normalized != standard.normalized
+                || attribute.offset != standard.offset)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
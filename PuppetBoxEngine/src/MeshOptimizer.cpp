@@ -0,0 +1,492 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "BinaryFormat.h"
+
+namespace PB::MeshOptimizer
+{
+    namespace
+    {
+        constexpr std::uint32_t NO_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        // Scoring constants from Forsyth's "Linear-Speed Vertex Cache Optimisation"
+        constexpr float CACHE_DECAY_POWER = 1.5f;
+        constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+        constexpr float VALENCE_BOOST_SCALE = 2.0f;
+        constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+        /**
+         * \brief Epsilon welding hashes positions into cells this many epsilons wide, so that most
+         * positions are far enough from a cell border to only need their own cell searched.
+         */
+        constexpr float CELLS_PER_EPSILON = 4.0f;
+
+        std::uint64_t hashBits(const float* values, std::uint32_t count)
+        {
+            std::uint64_t hash = BinaryFormat::FNV_OFFSET_BASIS;
+
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                std::uint32_t bits;
+                std::memcpy(&bits, &values[i], sizeof(float));
+                hash = BinaryFormat::hashWord(bits, hash);
+            }
+
+            return hash;
+        }
+
+        std::uint64_t hashCell(const std::int64_t cell[3])
+        {
+            std::uint64_t hash = BinaryFormat::FNV_OFFSET_BASIS;
+
+            for (std::uint32_t axis = 0; axis < 3; ++axis)
+            {
+                hash = BinaryFormat::hashWord(static_cast<std::uint64_t>(cell[axis]), hash);
+            }
+
+            return hash;
+        }
+
+        bool verticesEqual(const float* v1, const float* v2, std::uint32_t floatsPerVertex, float epsilon)
+        {
+            if (epsilon <= 0.0f)
+            {
+                return std::memcmp(v1, v2, floatsPerVertex * sizeof(float)) == 0;
+            }
+
+            for (std::uint32_t i = 0; i < floatsPerVertex; ++i)
+            {
+                if (!(std::abs(v1[i] - v2[i]) < epsilon))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * \brief Open addressed hash table of unique vertex indices, entries with equal hashes are
+         * told apart by comparing the vertices themselves.
+         */
+        class VertexTable
+        {
+        public:
+            explicit VertexTable(std::uint32_t vertexCount)
+            {
+                std::size_t capacity = 16;
+
+                while (capacity < static_cast<std::size_t>(vertexCount) * 2)
+                {
+                    capacity *= 2;
+                }
+
+                mask_ = capacity - 1;
+                hashes_.resize(capacity, 0);
+                indices_.resize(capacity, NO_INDEX);
+            }
+
+            template<typename Matches>
+            std::uint32_t find(std::uint64_t hash, Matches matches) const
+            {
+                for (std::size_t slot = hash & mask_; indices_[slot] != NO_INDEX; slot = (slot + 1) & mask_)
+                {
+                    if (hashes_[slot] == hash && matches(indices_[slot]))
+                    {
+                        return indices_[slot];
+                    }
+                }
+
+                return NO_INDEX;
+            }
+
+            void insert(std::uint64_t hash, std::uint32_t index)
+            {
+                std::size_t slot = hash & mask_;
+
+                while (indices_[slot] != NO_INDEX)
+                {
+                    slot = (slot + 1) & mask_;
+                }
+
+                hashes_[slot] = hash;
+                indices_[slot] = index;
+            }
+
+        private:
+            std::size_t mask_ = 0;
+            std::vector<std::uint64_t> hashes_{};
+            std::vector<std::uint32_t> indices_{};
+        };
+
+        float vertexScore(std::int32_t cachePosition, std::uint32_t remainingValence, std::uint32_t cacheSize)
+        {
+            if (remainingValence == 0)
+            {
+                return -1.0f;
+            }
+
+            float score = 0.0f;
+
+            if (cachePosition >= 0)
+            {
+                if (cachePosition < 3)
+                {
+                    // The most recent triangle's vertices get a fixed score, so the next triangle
+                    // doesn't just reuse its edge in a strip
+                    score = LAST_TRIANGLE_SCORE;
+                }
+                else
+                {
+                    const float scale = 1.0f / static_cast<float>(cacheSize - 3);
+                    score = std::pow(1.0f - (static_cast<float>(cachePosition - 3) * scale), CACHE_DECAY_POWER);
+                }
+            }
+
+            // Favour vertices with few triangles left, so lone triangles don't get stranded
+            score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingValence), -VALENCE_BOOST_POWER);
+
+            return score;
+        }
+    }
+
+    void weldVertices(
+            const float* vertices,
+            std::uint32_t vertexCount,
+            std::uint32_t floatsPerVertex,
+            float epsilon,
+            std::vector<float>& uniqueVertices,
+            std::vector<std::uint32_t>& indices)
+    {
+        uniqueVertices.clear();
+        indices.clear();
+        indices.reserve(vertexCount);
+
+        VertexTable table{vertexCount};
+        std::uint32_t uniqueCount = 0;
+
+        const float cellSize = epsilon * CELLS_PER_EPSILON;
+
+        for (std::uint32_t i = 0; i < vertexCount; ++i)
+        {
+            const float* vertex = vertices + (static_cast<std::size_t>(i) * floatsPerVertex);
+
+            auto matches = [&](std::uint32_t index) {
+                return verticesEqual(
+                        vertex,
+                        &uniqueVertices[static_cast<std::size_t>(index) * floatsPerVertex],
+                        floatsPerVertex,
+                        epsilon);
+            };
+
+            std::uint64_t hash;
+            std::uint32_t index;
+
+            if (epsilon <= 0.0f)
+            {
+                hash = hashBits(vertex, floatsPerVertex);
+                index = table.find(hash, matches);
+            }
+            else
+            {
+                std::int64_t cell[3];
+                // Per axis, -1 or 1 if the position is within epsilon of the lower or upper neighbouring cell
+                std::int32_t neighbour[3];
+
+                for (std::uint32_t axis = 0; axis < 3; ++axis)
+                {
+                    const double scaled = std::floor(static_cast<double>(vertex[axis]) / cellSize);
+                    const bool inRange = std::isfinite(scaled) && std::abs(scaled) < 1e18;
+
+                    cell[axis] = inRange ? static_cast<std::int64_t>(scaled) : 0;
+                    neighbour[axis] = 0;
+
+                    if (inRange)
+                    {
+                        const double lower = scaled * cellSize;
+
+                        if (vertex[axis] - lower < epsilon)
+                        {
+                            neighbour[axis] = -1;
+                        }
+                        else if (lower + cellSize - vertex[axis] < epsilon)
+                        {
+                            neighbour[axis] = 1;
+                        }
+                    }
+                }
+
+                hash = hashCell(cell);
+                index = table.find(hash, matches);
+
+                // Only search neighbouring cells the position is close enough to for a match to be in
+                for (std::uint32_t combination = 1; index == NO_INDEX && combination < 8; ++combination)
+                {
+                    std::int64_t neighbourCell[3] = {cell[0], cell[1], cell[2]};
+                    bool valid = true;
+
+                    for (std::uint32_t axis = 0; axis < 3 && valid; ++axis)
+                    {
+                        if (combination & (1 << axis))
+                        {
+                            valid = neighbour[axis] != 0;
+                            neighbourCell[axis] += neighbour[axis];
+                        }
+                    }
+
+                    if (valid)
+                    {
+                        index = table.find(hashCell(neighbourCell), matches);
+                    }
+                }
+            }
+
+            if (index == NO_INDEX)
+            {
+                index = uniqueCount++;
+                uniqueVertices.insert(uniqueVertices.end(), vertex, vertex + floatsPerVertex);
+                table.insert(hash, index);
+            }
+
+            indices.push_back(index);
+        }
+    }
+
+    void optimizeVertexCache(
+            std::vector<std::uint32_t>& indices,
+            std::uint32_t vertexCount,
+            std::uint32_t cacheSize)
+    {
+        const auto triangleCount = static_cast<std::uint32_t>(indices.size() / 3);
+
+        if (triangleCount == 0 || cacheSize <= 3)
+        {
+            return;
+        }
+
+        // Triangles adjacent to each vertex, the first remainingValence entries of each range are
+        // the triangles not yet emitted
+        std::vector<std::uint32_t> remainingValence(vertexCount, 0);
+        std::vector<std::uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+
+        for (std::uint32_t i = 0; i < triangleCount * 3; ++i)
+        {
+            ++remainingValence[indices[i]];
+        }
+
+        for (std::uint32_t v = 0; v < vertexCount; ++v)
+        {
+            adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remainingValence[v];
+        }
+
+        std::vector<std::uint32_t> adjacency(triangleCount * 3);
+        std::vector<std::uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+        for (std::uint32_t t = 0; t < triangleCount; ++t)
+        {
+            for (std::uint32_t corner = 0; corner < 3; ++corner)
+            {
+                adjacency[fill[indices[(t * 3) + corner]]++] = t;
+            }
+        }
+
+        std::vector<std::int32_t> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+
+        for (std::uint32_t v = 0; v < vertexCount; ++v)
+        {
+            vertexScores[v] = vertexScore(-1, remainingValence[v], cacheSize);
+        }
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<bool> emitted(triangleCount, false);
+        std::uint32_t bestTriangle = 0;
+
+        for (std::uint32_t t = 0; t < triangleCount; ++t)
+        {
+            triangleScores[t] = vertexScores[indices[t * 3]]
+                                + vertexScores[indices[(t * 3) + 1]]
+                                + vertexScores[indices[(t * 3) + 2]];
+
+            if (triangleScores[t] > triangleScores[bestTriangle])
+            {
+                bestTriangle = t;
+            }
+        }
+
+        // The cache holds 3 extra entries, the vertices pushed out of the simulated cache by the
+        // last triangle, so their scores get updated
+        std::vector<std::uint32_t> cache{};
+        std::vector<std::uint32_t> nextCache{};
+        cache.reserve(cacheSize + 3);
+        nextCache.reserve(cacheSize + 3);
+
+        std::vector<std::uint32_t> optimized(triangleCount * 3);
+        std::uint32_t nextUnemitted = 0;
+
+        for (std::uint32_t i = 0; i < triangleCount; ++i)
+        {
+            if (bestTriangle == NO_INDEX)
+            {
+                // Nothing in the cache has triangles left, continue from the next unemitted triangle
+                while (emitted[nextUnemitted])
+                {
+                    ++nextUnemitted;
+                }
+
+                bestTriangle = nextUnemitted;
+            }
+
+            const std::uint32_t* triangle = &indices[bestTriangle * 3];
+            emitted[bestTriangle] = true;
+            std::copy(triangle, triangle + 3, &optimized[i * 3]);
+
+            nextCache.clear();
+
+            for (std::uint32_t corner = 0; corner < 3; ++corner)
+            {
+                const std::uint32_t v = triangle[corner];
+
+                // Move the emitted triangle out of the vertex's remaining range
+                std::uint32_t* remaining = &adjacency[adjacencyOffsets[v]];
+                std::uint32_t& valence = remainingValence[v];
+
+                for (std::uint32_t a = 0; a < valence; ++a)
+                {
+                    if (remaining[a] == bestTriangle)
+                    {
+                        std::swap(remaining[a], remaining[valence - 1]);
+                        --valence;
+                        break;
+                    }
+                }
+
+                if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end())
+                {
+                    nextCache.push_back(v);
+                }
+            }
+
+            const std::size_t triangleVertices = nextCache.size();
+
+            auto inTriangle = [&](std::uint32_t v) {
+                const auto end = nextCache.begin() + static_cast<std::ptrdiff_t>(triangleVertices);
+                return std::find(nextCache.begin(), end, v) != end;
+            };
+
+            // Entries dropped here were already past the simulated cache, and scored as such, last time
+            for (std::uint32_t v: cache)
+            {
+                if (nextCache.size() < cacheSize + 3 && !inTriangle(v))
+                {
+                    nextCache.push_back(v);
+                }
+            }
+
+            std::swap(cache, nextCache);
+
+            bestTriangle = NO_INDEX;
+            float bestScore = -1.0f;
+
+            for (std::uint32_t position = 0; position < cache.size(); ++position)
+            {
+                const std::uint32_t v = cache[position];
+
+                cachePositions[v] = position < cacheSize ? static_cast<std::int32_t>(position) : -1;
+
+                const float score = vertexScore(cachePositions[v], remainingValence[v], cacheSize);
+                const float delta = score - vertexScores[v];
+                vertexScores[v] = score;
+
+                for (std::uint32_t a = 0; a < remainingValence[v]; ++a)
+                {
+                    const std::uint32_t t = adjacency[adjacencyOffsets[v] + a];
+                    triangleScores[t] += delta;
+
+                    if (triangleScores[t] > bestScore)
+                    {
+                        bestScore = triangleScores[t];
+                        bestTriangle = t;
+                    }
+                }
+            }
+        }
+
+        indices.swap(optimized);
+    }
+
+    void optimizeVertexFetch(
+            std::vector<float>& vertices,
+            std::uint32_t floatsPerVertex,
+            std::vector<std::uint32_t>& indices)
+    {
+        const auto vertexCount = static_cast<std::uint32_t>(vertices.size() / floatsPerVertex);
+
+        std::vector<std::uint32_t> remap(vertexCount, NO_INDEX);
+        std::uint32_t nextIndex = 0;
+
+        for (auto& index: indices)
+        {
+            if (remap[index] == NO_INDEX)
+            {
+                remap[index] = nextIndex++;
+            }
+
+            index = remap[index];
+        }
+
+        for (auto& index: remap)
+        {
+            if (index == NO_INDEX)
+            {
+                index = nextIndex++;
+            }
+        }
+
+        std::vector<float> reordered(vertices.size());
+
+        for (std::uint32_t v = 0; v < vertexCount; ++v)
+        {
+            std::copy(
+                    vertices.begin() + (static_cast<std::size_t>(v) * floatsPerVertex),
+                    vertices.begin() + (static_cast<std::size_t>(v + 1) * floatsPerVertex),
+                    reordered.begin() + (static_cast<std::size_t>(remap[v]) * floatsPerVertex));
+        }
+
+        vertices.swap(reordered);
+    }
+
+    float averageCacheMissRatio(
+            const std::vector<std::uint32_t>& indices,
+            std::uint32_t vertexCount,
+            std::uint32_t cacheSize)
+    {
+        const auto triangleCount = static_cast<std::uint32_t>(indices.size() / 3);
+
+        if (triangleCount == 0)
+        {
+            return 0.0f;
+        }
+
+        // A vertex is in the FIFO cache if fewer than cacheSize misses happened since it was added
+        std::vector<std::uint64_t> addedAt(vertexCount, 0);
+        std::uint64_t misses = 0;
+
+        for (std::uint32_t i = 0; i < triangleCount * 3; ++i)
+        {
+            const std::uint32_t v = indices[i];
+
+            if (addedAt[v] == 0 || misses - addedAt[v] >= cacheSize)
+            {
+                ++misses;
+                addedAt[v] = misses;
+            }
+        }
+
+        return static_cast<float>(misses) / static_cast<float>(triangleCount);
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Mesh indexing and reordering passes, shared between the engine's runtime mesh loading and the
+ * mesh-converter tool, so it must not depend on anything outside the standard library.
+ *
+ * <p>Vertices are given as tightly packed floats, floatsPerVertex values per vertex, with the first
+ * three values of each vertex being its position.</p>
+ */
+namespace PB::MeshOptimizer
+{
+    /**
+     * \brief Default number of entries of the simulated post-transform vertex cache.
+     */
+    constexpr std::uint32_t DEFAULT_CACHE_SIZE = 32;
+
+    /**
+     * \brief Welds equal vertices of a triangle soup together, producing unique vertices and the
+     * indices into them.
+     *
+     * <p>Vertices are hashed by position, then fully compared against the vertices in matching
+     * buckets, so welding runs in roughly linear time.  With an epsilon of 0 vertices must match
+     * bitwise.</p>
+     *
+     * \param vertices        The vertices to weld.
+     * \param vertexCount     The number of vertices.
+     * \param floatsPerVertex The number of floats per vertex, at least 3.
+     * \param epsilon         The largest difference per value for two vertices to be considered equal.
+     * \param uniqueVertices  Set to the welded vertices, in order of first appearance.
+     * \param indices         Set to one index into uniqueVertices per input vertex.
+     */
+    void weldVertices(
+            const float* vertices,
+            std::uint32_t vertexCount,
+            std::uint32_t floatsPerVertex,
+            float epsilon,
+            std::vector<float>& uniqueVertices,
+            std::vector<std::uint32_t>& indices);
+
+    /**
+     * \brief Reorders triangles to improve post-transform vertex cache hits, using Tom Forsyth's
+     * linear-speed vertex cache optimisation.
+     *
+     * \param indices     The triangle list indices to reorder in place.
+     * \param vertexCount The number of vertices the indices refer to.
+     * \param cacheSize   The number of entries of the simulated vertex cache.
+     */
+    void optimizeVertexCache(
+            std::vector<std::uint32_t>& indices,
+            std::uint32_t vertexCount,
+            std::uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+    /**
+     * \brief Reorders vertices into the order the indices first reference them, improving vertex fetch
+     * locality, and remaps the indices to match.  Unreferenced vertices are moved to the end.
+     *
+     * \param vertices        The vertices to reorder in place.
+     * \param floatsPerVertex The number of floats per vertex.
+     * \param indices         The indices to remap in place.
+     */
+    void optimizeVertexFetch(
+            std::vector<float>& vertices,
+            std::uint32_t floatsPerVertex,
+            std::vector<std::uint32_t>& indices);
+
+    /**
+     * \brief Simulates a FIFO vertex cache to get the average number of vertex shader invocations per
+     * triangle (ACMR), from 0.5 for an ideal mesh up to 3 for no reuse at all.
+     *
+     * \param indices     The triangle list indices to simulate.
+     * \param vertexCount The number of vertices the indices refer to.
+     * \param cacheSize   The number of entries of the simulated vertex cache.
+     *
+     * \return The average cache miss ratio.
+     */
+    float averageCacheMissRatio(
+            const std::vector<std::uint32_t>& indices,
+            std::uint32_t vertexCount,
+            std::uint32_t cacheSize);
+}
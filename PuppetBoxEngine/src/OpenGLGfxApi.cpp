@@ -1,40 +1,202 @@
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include <glad/glad.h>
 
 #include "puppetbox/DataStructures.h"
 
-#include "GfxMath.h"
 #include "Logger.h"
+#include "MeshOptimizer.h"
 #include "OpenGLGfxApi.h"
+#include "Shader.h"
 
 namespace PB
 {
     namespace
     {
         /**
-        * \brief Searches for the provided vertex in the provided vector.  Two ertices are considered equal if each of
-        * their matching attributes fall within a certain defined tolerance.
+        * \brief Largest difference per vertex attribute value for two vertices to be welded together, matching
+        * the tolerance of {\link GfxMath::BasicallyEqual}.
+        */
+        constexpr float VERTEX_WELD_EPSILON = 0.0000001f;
+
+        /**
+        * \brief Bytes of the stream buffer available to each frame, for the transforms and instance data.
+        */
+        constexpr std::uint32_t STREAM_REGION_SIZE = 8 * 1024 * 1024;
+
+        /**
+        * \brief Vertices and indices the mesh arena starts with room for, it grows as needed.
+        */
+        constexpr std::uint32_t ARENA_VERTEX_CAPACITY = 64 * 1024;
+        constexpr std::uint32_t ARENA_INDEX_CAPACITY = 256 * 1024;
+
+        /**
+        * \brief Maps a {\link MeshFormat::ComponentType} to the matching OpenGL type.
         *
-        * \param vertex The vertex to search for
-        * \param vector The vector to search in
+        * \param componentType The component type to map.
         *
-        * \return The index of the matching vertex in the vector, or -1 if not found.
+        * \return The matching OpenGL type.
         */
-        std::int32_t findVertexInVector(Vertex& vertex, std::vector<Vertex>& vector)
+        GLenum componentTypeToGLType(MeshFormat::ComponentType componentType)
         {
-            for (std::int32_t i = 0; i < vector.size() && i < INT32_MAX; ++i)
+            switch (componentType)
             {
-                Vertex v = vector.at(i);
+                case MeshFormat::INT8:
+                    return GL_BYTE;
+                case MeshFormat::UINT8:
+                    return GL_UNSIGNED_BYTE;
+                case MeshFormat::INT16:
+                    return GL_SHORT;
+                case MeshFormat::UINT16:
+                    return GL_UNSIGNED_SHORT;
+                case MeshFormat::FLOAT32:
+                default:
+                    return GL_FLOAT;
+            }
+        }
 
-                if (GfxMath::BasicallyEqual(vertex, v))
+        /**
+        * \brief Sets the uniform of a SET_UNIFORM command on the program in use.
+        *
+        * \param command The SET_UNIFORM command.
+        * \param data    The values recorded with the command.
+        */
+        void setUniform(const RenderCommand& command, const std::uint8_t* data)
+        {
+            const std::int32_t location = command.setUniform.location;
+            const auto count = static_cast<std::int32_t>(command.setUniform.count);
+
+            switch (command.setUniform.uniformType)
+            {
+                case UniformType::INT:
+                    glUniform1iv(location, count, reinterpret_cast<const GLint*>(data));
+                    break;
+                case UniformType::UINT:
+                    glUniform1uiv(location, count, reinterpret_cast<const GLuint*>(data));
+                    break;
+                case UniformType::FLOAT:
+                    glUniform1fv(location, count, reinterpret_cast<const GLfloat*>(data));
+                    break;
+                case UniformType::VEC2:
+                    glUniform2fv(location, count, reinterpret_cast<const GLfloat*>(data));
+                    break;
+                case UniformType::VEC3:
+                    glUniform3fv(location, count, reinterpret_cast<const GLfloat*>(data));
+                    break;
+                case UniformType::VEC4:
+                    glUniform4fv(location, count, reinterpret_cast<const GLfloat*>(data));
+                    break;
+                case UniformType::MAT4:
+                    glUniformMatrix4fv(location, count, GL_FALSE, reinterpret_cast<const GLfloat*>(data));
+                    break;
+            }
+        }
+
+        /**
+        * \brief Issues the draw call of a DRAW command.
+        *
+        * \param command The DRAW command.
+        */
+        void draw(const RenderCommand& command)
+        {
+            const auto count = static_cast<std::int32_t>(command.draw.count);
+            const auto instanceCount = static_cast<std::int32_t>(command.draw.instanceCount);
+
+            if (command.draw.indexSize != 0)
+            {
+                const GLenum indexType = command.draw.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+                const auto* indices = (void*) static_cast<std::uintptr_t>(
+                        command.draw.firstIndex * command.draw.indexSize);
+
+                if (instanceCount > 0)
+                {
+                    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, count, indexType, indices, instanceCount,
+                                                      command.draw.baseVertex);
+                }
+                else
                 {
-                    return i;
+                    glDrawElementsBaseVertex(GL_TRIANGLES, count, indexType, indices, command.draw.baseVertex);
+                }
+            }
+            else if (instanceCount > 0)
+            {
+                glDrawArraysInstanced(GL_TRIANGLES, 0, count, instanceCount);
+            }
+            else
+            {
+                glDrawArrays(GL_TRIANGLES, 0, count);
+            }
+        }
+
+        /**
+        * \brief Signature of glMaxShaderCompilerThreadsKHR, loaded by hand as not every glad build includes
+        * the parallel shader compile extensions.
+        */
+        typedef void (APIENTRY* MaxShaderCompilerThreadsFunction)(GLuint count);
+
+        /**
+        * \brief Checks if the current context supports the given extension.
+        *
+        * \param name The name of the extension.
+        *
+        * \return True if the extension is supported, False otherwise.
+        */
+        bool hasExtension(const char* name)
+        {
+            std::int32_t count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+            for (std::int32_t i = 0; i < count; ++i)
+            {
+                const char* extension = (const char*) glGetStringi(GL_EXTENSIONS, i);
+
+                if (extension != nullptr && std::strcmp(extension, name) == 0)
+                {
+                    return true;
                 }
             }
 
-            return -1;
+            return false;
+        }
+
+        /**
+        * \brief Lets the driver compile shader programs on its own threads, if it supports doing so, so
+        * {\link Shader::isReady} can poll compiles without blocking.
+        *
+        * \param procAddress Reference to the ProcAddress function for loading gfx function pointers.
+        */
+        void initParallelShaderCompile(const PB::ProcAddress procAddress)
+        {
+            const char* functionName = nullptr;
+
+            if (hasExtension("GL_KHR_parallel_shader_compile"))
+            {
+                functionName = "glMaxShaderCompilerThreadsKHR";
+            }
+            else if (hasExtension("GL_ARB_parallel_shader_compile"))
+            {
+                functionName = "glMaxShaderCompilerThreadsARB";
+            }
+
+            if (functionName != nullptr)
+            {
+                auto maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsFunction>(
+                        procAddress(functionName));
+
+                if (maxShaderCompilerThreads != nullptr)
+                {
+                    // 0xFFFFFFFF leaves the number of threads up to the driver
+                    maxShaderCompilerThreads(0xFFFFFFFF);
+                }
+
+                LOGGER_INFO("Shaders will be compiled in parallel");
+            }
+
+            Shader::setParallelCompile(functionName != nullptr);
         }
 
         /**
@@ -148,13 +310,43 @@ namespace PB
             }
 #endif
 
-            glEnable(GL_DEPTH_TEST);
+            stateCache_.setDepthTest(true);
             glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
             // Store the card's minimum UBO offset value for later.
             std::int32_t value;
             glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &value);
             minimumUBOOffset_ = static_cast<std::uint32_t>(value);
+
+            driverId_ = std::string((char*) glGetString(GL_VENDOR)) + "|" + (char*) glGetString(GL_RENDERER) + "|"
+                        + (char*) glGetString(GL_VERSION);
+
+            initParallelShaderCompile(procAddress);
+
+            glGenQueries(TIMER_QUERY_FRAMES * PASS_COUNT, &timerQueries_[0][0]);
+
+            streamBuffer_ = std::make_shared<StreamBuffer>(stateCache_);
+
+            if (!streamBuffer_->init(STREAM_REGION_SIZE))
+            {
+                error = true;
+                streamBuffer_ = nullptr;
+            }
+
+            meshArena_ = std::make_shared<MeshArena>(stateCache_);
+
+            if (!meshArena_->init(ARENA_VERTEX_CAPACITY, ARENA_INDEX_CAPACITY))
+            {
+                LOGGER_WARN("Mesh arena unavailable, every mesh gets its own buffers");
+                meshArena_ = nullptr;
+            }
+
+            multiDrawIndirect_ = GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_multi_draw_indirect;
+
+            if (!multiDrawIndirect_)
+            {
+                LOGGER_INFO("Multi draw indirect unsupported, indirect draws are made one at a time");
+            }
         }
         else
         {
@@ -165,11 +357,59 @@ namespace PB
         return !error;
     }
 
-    void OpenGLGfxApi::preLoopCommands() const
+    void OpenGLGfxApi::shutdown()
     {
-        glViewport(0, 0, static_cast<std::int32_t>(width_), static_cast<std::int32_t>(height_));
+        // Released here rather than with the API, which outlives the context
+        streamBuffer_ = nullptr;
+        meshArena_ = nullptr;
+    }
+
+    void OpenGLGfxApi::preLoopCommands(std::uint32_t width, std::uint32_t height) const
+    {
+        glViewport(0, 0, static_cast<std::int32_t>(width), static_cast<std::int32_t>(height));
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // Every frame starts from a known state, whatever may have changed it outside the cache since the last
+        stateCache_.invalidate();
+        stateCache_.resetElidedCalls();
+
+        if (streamBuffer_ != nullptr)
+        {
+            streamBuffer_->beginFrame();
+        }
+
+        readTimerQueries();
+        frameStats_ = RenderStats{};
+    }
+
+    void OpenGLGfxApi::postLoopCommands() const
+    {
+        if (streamBuffer_ != nullptr)
+        {
+            streamBuffer_->endFrame();
+        }
+
+        if (timedPass_ >= 0)
+        {
+            // A pass left open is timed up to the end of the frame
+            glEndQuery(GL_TIME_ELAPSED);
+            timerIssued_[timerFrame_ % TIMER_QUERY_FRAMES][timedPass_] = true;
+            timedPass_ = -1;
+        }
+
+        frameStats_.elidedCalls = stateCache_.elidedCalls();
+        frameStats_.resourceUploadedBytes = resourceUploadedBytes_.exchange(0);
+        frameStats_.gpuTimed = gpuTimesRead_;
+        std::copy(std::begin(passMilliseconds_), std::end(passMilliseconds_),
+                  std::begin(frameStats_.passMilliseconds));
+
+        {
+            std::unique_lock<std::mutex> mlock(statsMutex_);
+            lastFrameStats_ = frameStats_;
+        }
+
+        ++timerFrame_;
     }
 
     void OpenGLGfxApi::setRenderDimensions(std::uint32_t width, std::uint32_t height)
@@ -201,7 +441,7 @@ namespace PB
             std::uint32_t openGLId;
 
             glGenTextures(1, &openGLId);
-            glBindTexture(GL_TEXTURE_2D, openGLId);
+            stateCache_.bindTexture(0, openGLId);
 
             if (options.repeatMode == ImageOptions::Mode::CLAMP_TO_BORDER)
             {
@@ -224,14 +464,40 @@ namespace PB
 
             // Support alpha enabled images (PNGs)
             std::int32_t format = imageData.numChannels == 4 ? GL_RGBA : GL_RGB;
-            // Generate texture from previously bound image
-            glTexImage2D(GL_TEXTURE_2D, 0, format, imageData.width, imageData.height, 0, format, GL_UNSIGNED_BYTE,
-                         imageData.bufferData);
-            // Attaches texture images to texture object currently bound
-            glGenerateMipmap(GL_TEXTURE_2D);
+
+            if (imageData.mipLevels > 1)
+            {
+                // Cooked images carry their whole mip chain, smaller levels have rows that aren't 4 byte aligned
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, imageData.mipLevels - 1);
+
+                std::uint8_t* levelData = imageData.bufferData;
+                std::int32_t levelWidth = imageData.width;
+                std::int32_t levelHeight = imageData.height;
+
+                for (std::int32_t level = 0; level < imageData.mipLevels; ++level)
+                {
+                    glTexImage2D(GL_TEXTURE_2D, level, format, levelWidth, levelHeight, 0, format, GL_UNSIGNED_BYTE,
+                                 levelData);
+
+                    levelData += static_cast<std::size_t>(levelWidth) * levelHeight * imageData.numChannels;
+                    levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+                    levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+                }
+            }
+            else
+            {
+                // Generate texture from previously bound image
+                glTexImage2D(GL_TEXTURE_2D, 0, format, imageData.width, imageData.height, 0, format, GL_UNSIGNED_BYTE,
+                             imageData.bufferData);
+                // Attaches texture images to texture object currently bound
+                glGenerateMipmap(GL_TEXTURE_2D);
+            }
 
             // Free up binding after we create it
-            glBindTexture(GL_TEXTURE_2D, 0);
+            stateCache_.bindTexture(0, 0);
+
+            countResourceUpload(imageData.byteSize());
 
             imageReference = ImageReference{openGLId};
         }
@@ -239,6 +505,18 @@ namespace PB
         return imageReference;
     }
 
+    void OpenGLGfxApi::freeImage(ImageReference& image) const
+    {
+        if (image.id() != 0)
+        {
+            const std::uint32_t textureId = image.id();
+            glDeleteTextures(1, &textureId);
+            stateCache_.forgetTexture(textureId);
+
+            image = ImageReference{0};
+        }
+    }
+
     bool OpenGLGfxApi::buildCharacterMap(
             FT_Face face,
             std::unordered_map<std::int8_t, TypeCharacter>& loadedCharacters) const
@@ -346,7 +624,7 @@ namespace PB
         // Create the OpenGL resource of the glyph atlas data
         std::uint32_t texture;
         glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        stateCache_.bindTexture(0, texture);
         glTexImage2D(
                 GL_TEXTURE_2D,
                 0,
@@ -366,6 +644,8 @@ namespace PB
 
         delete[] atlasData;
 
+        countResourceUpload(static_cast<std::uint64_t>(atlasRows.size()) * MAX_ATLAS_COLUMNS);
+
         ImageReference imageReference{texture};
         imageReference.width = MAX_ATLAS_COLUMNS;
         imageReference.height = atlasRows.size();
@@ -390,42 +670,32 @@ namespace PB
         // 3 axis position, +3 axis normal, +2 axis UV coord
         mesh.stride = 3 + 3 + 2;
 
-        std::vector<Vertex> uniqueVertices{};
-        std::vector<std::uint32_t> indices{};
+        std::vector<float> vertices{};
+        vertices.reserve(static_cast<std::size_t>(vertexCount) * mesh.stride);
 
-        std::uint32_t indexCounter = 0;
-
-        // Filter out duplicate vertices, create EBO indices
         for (std::uint32_t i = 0; i < vertexCount; ++i)
         {
-            std::int32_t index = findVertexInVector(vertexData[i], uniqueVertices);
-
-            if (index < 0)
-            {
-                uniqueVertices.push_back(vertexData[i]);
-                indices.push_back(indexCounter++);
-            }
-            else
-            {
-                indices.push_back(static_cast<std::uint32_t>(index));
-            }
+            const Vertex& v = vertexData[i];
+            vertices.insert(vertices.end(), {
+                    v.position.x, v.position.y, v.position.z,
+                    v.normal.x, v.normal.y, v.normal.z,
+                    v.uv.x, v.uv.y
+            });
         }
 
+        // Filter out duplicate vertices, create EBO indices, then order both for the vertex cache and fetching
         std::vector<float> vboData{};
+        std::vector<std::uint32_t> indices{};
+        MeshOptimizer::weldVertices(&vertices[0], vertexCount, mesh.stride, VERTEX_WELD_EPSILON, vboData, indices);
+        MeshOptimizer::optimizeVertexCache(indices, static_cast<std::uint32_t>(vboData.size() / mesh.stride));
+        MeshOptimizer::optimizeVertexFetch(vboData, mesh.stride, indices);
 
-        // Convert unique vertex vector to float array
-        for (auto& v: uniqueVertices)
-        {
-            vboData.push_back(v.position.x);
-            vboData.push_back(v.position.y);
-            vboData.push_back(v.position.z);
-
-            vboData.push_back(v.normal.x);
-            vboData.push_back(v.normal.y);
-            vboData.push_back(v.normal.z);
+        const MeshFormat::MeshBuffer meshBuffer = MeshFormat::standardMeshBuffer(vboData, indices);
 
-            vboData.push_back(v.uv.x);
-            vboData.push_back(v.uv.y);
+        if (meshArena_ != nullptr && MeshArena::accepts(meshBuffer) && meshArena_->add(meshBuffer, mesh))
+        {
+            countResourceUpload(mesh.byteSize);
+            return mesh;
         }
 
         // Create buffers
@@ -433,13 +703,13 @@ namespace PB
         glGenBuffers(1, &mesh.VBO);
         glGenBuffers(1, &mesh.EBO);
 
-        glBindVertexArray(mesh.VAO);
+        stateCache_.bindVertexArray(mesh.VAO);
 
-        glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+        stateCache_.bindArrayBuffer(mesh.VBO);
         glBufferData(GL_ARRAY_BUFFER, static_cast<std::intmax_t>(sizeof(vboData[0]) * vboData.size()), &vboData[0],
                      GL_STATIC_DRAW);
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+        stateCache_.bindElementArrayBuffer(mesh.EBO);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<std::intmax_t>(sizeof(indices[0]) * indices.size()),
                      &indices[0], GL_STATIC_DRAW);
 
@@ -459,19 +729,169 @@ namespace PB
         glEnableVertexAttribArray(2);
 
         // These could be unbound now, because glVertexAttribPointer registers the buffers already
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        stateCache_.bindArrayBuffer(0);
+        stateCache_.bindVertexArray(0);
 
         // TODO: Hardcoded to only support EBO, revisit this? reason?
         mesh.drawCount = static_cast<std::int32_t>(indices.size());
+        mesh.byteSize = (sizeof(vboData[0]) * vboData.size()) + (sizeof(indices[0]) * indices.size());
+        countResourceUpload(mesh.byteSize);
+
+        return mesh;
+    }
+
+    Mesh OpenGLGfxApi::loadMesh(const MeshFormat::MeshBuffer& meshBuffer) const
+    {
+        Mesh mesh{};
+
+        if (meshArena_ != nullptr && MeshArena::accepts(meshBuffer) && meshArena_->add(meshBuffer, mesh))
+        {
+            countResourceUpload(mesh.byteSize);
+            return mesh;
+        }
+
+        mesh.stride = meshBuffer.vertexStride / sizeof(float);
+        mesh.byteSize = (static_cast<std::uint64_t>(meshBuffer.vertexCount) * meshBuffer.vertexStride)
+                        + (static_cast<std::uint64_t>(meshBuffer.indexCount) * meshBuffer.indexSize);
+
+        glGenVertexArrays(1, &(mesh.VAO));
+        glGenBuffers(1, &mesh.VBO);
+
+        stateCache_.bindVertexArray(mesh.VAO);
+
+        // Vertex and index data are already laid out for the GPU, so they go straight from the archive
+        stateCache_.bindArrayBuffer(mesh.VBO);
+        glBufferData(GL_ARRAY_BUFFER,
+                     static_cast<std::intmax_t>(meshBuffer.vertexCount) * meshBuffer.vertexStride,
+                     meshBuffer.vertexData,
+                     GL_STATIC_DRAW);
+
+        if (meshBuffer.indexCount > 0)
+        {
+            glGenBuffers(1, &mesh.EBO);
+            stateCache_.bindElementArrayBuffer(mesh.EBO);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                         static_cast<std::intmax_t>(meshBuffer.indexCount) * meshBuffer.indexSize,
+                         meshBuffer.indexData,
+                         GL_STATIC_DRAW);
+
+            mesh.indexSize = meshBuffer.indexSize;
+            mesh.drawCount = static_cast<std::int32_t>(meshBuffer.indexCount);
+        }
+        else
+        {
+            mesh.drawCount = static_cast<std::int32_t>(meshBuffer.vertexCount);
+        }
+
+        for (const auto& attribute: meshBuffer.attributes)
+        {
+            glVertexAttribPointer(attribute.location,
+                                  attribute.componentCount,
+                                  componentTypeToGLType(attribute.componentType),
+                                  attribute.normalized ? GL_TRUE : GL_FALSE,
+                                  static_cast<std::int32_t>(meshBuffer.vertexStride),
+                                  (void*) static_cast<std::uintptr_t>(attribute.offset));
+            glEnableVertexAttribArray(attribute.location);
+        }
+
+        stateCache_.bindArrayBuffer(0);
+        stateCache_.bindVertexArray(0);
+
+        countResourceUpload(mesh.byteSize);
 
         return mesh;
     }
 
+    void OpenGLGfxApi::freeMesh(Mesh& mesh) const
+    {
+        if (mesh.inArena)
+        {
+            // The VAO and buffers are shared, only the mesh's ranges are given back, if the arena is still there
+            if (meshArena_ != nullptr)
+            {
+                meshArena_->remove(mesh);
+            }
+
+            mesh.inArena = false;
+            mesh.baseVertex = 0;
+            mesh.firstIndex = 0;
+            mesh.vertexCount = 0;
+        }
+        else
+        {
+            glDeleteVertexArrays(1, &mesh.VAO);
+            glDeleteBuffers(1, &mesh.VBO);
+            stateCache_.forgetVertexArray(mesh.VAO);
+            stateCache_.forgetBuffer(mesh.VBO);
+
+            if (mesh.EBO != 0)
+            {
+                glDeleteBuffers(1, &mesh.EBO);
+                stateCache_.forgetBuffer(mesh.EBO);
+            }
+        }
+
+        mesh.VAO = 0;
+        mesh.VBO = 0;
+        mesh.EBO = 0;
+        mesh.drawCount = 0;
+        mesh.byteSize = 0;
+    }
+
+    bool OpenGLGfxApi::beginShader(
+            Shader& shader,
+            const std::string& vertexCode,
+            const std::string& geometryCode,
+            const std::string& fragmentCode) const
+    {
+        bool loaded;
+        loaded = shader.loadVertexShader(vertexCode);
+        loaded = loaded && shader.loadGeometryShader(geometryCode);
+        loaded = loaded && shader.loadFragmentShader(fragmentCode);
+
+        return loaded && shader.beginInit();
+    }
+
+    bool OpenGLGfxApi::isShaderReady(const Shader& shader) const
+    {
+        return shader.isReady();
+    }
+
+    bool OpenGLGfxApi::finishShader(Shader& shader) const
+    {
+        return shader.finishInit();
+    }
+
+    bool OpenGLGfxApi::supportsShaderBinaries() const
+    {
+        return Shader::supportsBinaries();
+    }
+
+    bool OpenGLGfxApi::loadShaderBinary(Shader& shader, const ShaderBinary& binary) const
+    {
+        return shader.loadBinary(binary);
+    }
+
+    bool OpenGLGfxApi::getShaderBinary(const Shader& shader, ShaderBinary* binary) const
+    {
+        return shader.binary(binary);
+    }
+
+    void OpenGLGfxApi::freeShader(Shader& shader) const
+    {
+        stateCache_.forgetProgram(shader.id());
+        shader.destroy();
+    }
+
+    void OpenGLGfxApi::invalidateState() const
+    {
+        stateCache_.invalidate();
+    }
+
     void OpenGLGfxApi::initializeUBORanges()
     {
         glGenBuffers(1, &UBO_);
-        glBindBuffer(GL_UNIFORM_BUFFER, UBO_);
+        stateCache_.bindUniformBuffer(UBO_);
 
         constexpr std::uint32_t sizeOfTransforms = 3 * static_cast<std::uint32_t>(sizeof(mat4));
         // Pad to next offset if needed
@@ -484,33 +904,200 @@ namespace PB
         // Create buffer of adequate size
         glBufferData(GL_UNIFORM_BUFFER, bufferSize, nullptr, GL_STATIC_DRAW);
 
-        glBindBufferRange(GL_UNIFORM_BUFFER, 0, UBO_, 0, lightCountOffset);
-        glBindBufferRange(GL_UNIFORM_BUFFER, 1, UBO_, lightCountOffset, sizeOfLightCount);
-        glBindBufferRange(GL_UNIFORM_BUFFER, 2, UBO_, firstLightOffset, sizeOfLights);
+        // Rebound to the stream buffer every frame by the transforms uploaded through submit()
+        stateCache_.bindUniformRange(0, UBO_, 0, lightCountOffset);
+        stateCache_.bindUniformRange(1, UBO_, lightCountOffset, sizeOfLightCount);
+        stateCache_.bindUniformRange(2, UBO_, firstLightOffset, sizeOfLights);
 
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        stateCache_.bindUniformBuffer(0);
     }
 
-    void OpenGLGfxApi::setTransformUBOData(mat4 view, mat4 projection, mat4 uiProjection) const
+    void OpenGLGfxApi::submit(const CommandList& commandList) const
     {
-        glBindBuffer(GL_UNIFORM_BUFFER, UBO_);
-
-        constexpr std::uint32_t sizeOfMat4 = sizeof(mat4);
-        //TODO: Used when lights are implemented
-//		constexpr std::uint32_t sizeOfTransforms = 3 * sizeOfMat4;
-//		std::uint32_t lightCountOffset = std::max(sizeOfTransforms, minimumUBOOffset_);
-//		std::uint32_t sizeOfLightCount = std::max(static_cast<std::uint32_t>(sizeof(std::uint32_t)), minimumUBOOffset_);
-//		std::uint32_t firstLightOffset = std::max(sizeOfTransforms + sizeOfLightCount, 2 * minimumUBOOffset_);
-//		constexpr std::uint32_t sizeOfLight = 4 * sizeof(vec4);
-//		constexpr std::uint32_t sizeOfLights = 10 * sizeOfLight;
-//		std::uint32_t bufferSize = firstLightOffset + sizeOfLights;
-        //                                    v-- Size of data
-        //              v-- Type           v-- Offset (bytes)    v-- Data
-        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeOfMat4, &uiProjection[0][0]);
-        glBufferSubData(GL_UNIFORM_BUFFER, sizeOfMat4, sizeOfMat4, &projection[0][0]);
-        glBufferSubData(GL_UNIFORM_BUFFER, sizeOfMat4 * 2, sizeOfMat4, &view[0][0]);
-
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        commandList.addStats(frameStats_);
+
+        // Offset of the last upload in the stream buffer, which later commands are relative to
+        std::uint32_t uploadOffset = 0;
+        // Without a stream buffer nothing can be uploaded, so nothing reading uploads is drawn
+        bool uploadFailed = streamBuffer_ == nullptr;
+
+        for (const RenderCommand& command: commandList.commands())
+        {
+            switch (command.type)
+            {
+                case RenderCommandType::USE_PROGRAM:
+                    stateCache_.useProgram(command.useProgram.programId);
+                    break;
+                case RenderCommandType::BIND_TEXTURE:
+                    stateCache_.bindTexture(command.bindTexture.slot, command.bindTexture.textureId);
+                    break;
+                case RenderCommandType::BIND_VERTEX_ARRAY:
+                    stateCache_.bindVertexArray(command.bindVertexArray.vertexArrayId);
+                    break;
+                case RenderCommandType::SET_BLENDING:
+                    stateCache_.setBlending(command.setBlending.enabled);
+                    break;
+                case RenderCommandType::SET_UNIFORM:
+                    setUniform(command, commandList.data(command.setUniform.dataOffset));
+                    break;
+                case RenderCommandType::UPLOAD:
+                {
+                    const std::uint32_t alignment = command.upload.usage == UploadUsage::UNIFORM_BLOCK
+                                                    ? minimumUBOOffset_
+                                                    : static_cast<std::uint32_t>(sizeof(vec4));
+                    StreamAllocation allocation = streamBuffer_ != nullptr
+                                                  ? streamBuffer_->allocate(command.upload.size, alignment)
+                                                  : StreamAllocation{};
+
+                    // Anything drawing from a failed upload is skipped until the next one
+                    uploadFailed = allocation.data == nullptr;
+
+                    if (!uploadFailed)
+                    {
+                        std::memcpy(allocation.data, commandList.data(command.upload.dataOffset),
+                                    command.upload.size);
+                        uploadOffset = allocation.offset;
+                    }
+                    break;
+                }
+                case RenderCommandType::BIND_UNIFORM_RANGE:
+                    if (!uploadFailed)
+                    {
+                        stateCache_.bindUniformRange(command.bindUniformRange.binding, streamBuffer_->id(),
+                                                     uploadOffset + command.bindUniformRange.offset,
+                                                     command.bindUniformRange.size);
+                    }
+                    break;
+                case RenderCommandType::SET_INSTANCE_ATTRIBUTE:
+                {
+                    if (uploadFailed)
+                    {
+                        break;
+                    }
+
+                    const std::uint32_t location = command.setInstanceAttribute.location;
+
+                    // Attribute pointers capture the buffer bound at the time they are set
+                    stateCache_.bindArrayBuffer(streamBuffer_->id());
+                    glVertexAttribPointer(location, static_cast<std::int32_t>(command.setInstanceAttribute.components),
+                                          GL_FLOAT, GL_FALSE,
+                                          static_cast<std::int32_t>(command.setInstanceAttribute.stride),
+                                          (void*) static_cast<std::size_t>(
+                                                  uploadOffset + command.setInstanceAttribute.offset));
+                    glVertexAttribDivisor(location, 1);
+                    glEnableVertexAttribArray(location);
+                    break;
+                }
+                case RenderCommandType::CLEAR_INSTANCE_ATTRIBUTE:
+                    glVertexAttribDivisor(command.clearInstanceAttribute.location, 0);
+                    glDisableVertexAttribArray(command.clearInstanceAttribute.location);
+                    break;
+                case RenderCommandType::DRAW:
+                    if (command.draw.instanceCount > 0 && uploadFailed)
+                    {
+                        break;
+                    }
+
+                    draw(command);
+                    break;
+                case RenderCommandType::MULTI_DRAW_INDIRECT:
+                {
+                    if (uploadFailed)
+                    {
+                        break;
+                    }
+
+                    const GLenum indexType = command.multiDrawIndirect.indexSize == 2
+                                             ? GL_UNSIGNED_SHORT
+                                             : GL_UNSIGNED_INT;
+
+                    if (multiDrawIndirect_)
+                    {
+                        // The draws were uploaded to the frame's region of the stream buffer just before
+                        stateCache_.bindDrawIndirectBuffer(streamBuffer_->id());
+                        glMultiDrawElementsIndirect(GL_TRIANGLES, indexType,
+                                                    (void*) static_cast<std::uintptr_t>(uploadOffset),
+                                                    static_cast<std::int32_t>(command.multiDrawIndirect.drawCount),
+                                                    0);
+                    }
+                    else
+                    {
+                        const auto* draws = reinterpret_cast<const DrawIndirectCommand*>(
+                                commandList.data(command.multiDrawIndirect.dataOffset));
+
+                        for (std::uint32_t i = 0; i < command.multiDrawIndirect.drawCount; ++i)
+                        {
+                            glDrawElementsInstancedBaseVertexBaseInstance(
+                                    GL_TRIANGLES,
+                                    static_cast<std::int32_t>(draws[i].count),
+                                    indexType,
+                                    (void*) static_cast<std::uintptr_t>(
+                                            draws[i].firstIndex * command.multiDrawIndirect.indexSize),
+                                    static_cast<std::int32_t>(draws[i].instanceCount),
+                                    draws[i].baseVertex,
+                                    draws[i].baseInstance);
+                        }
+                    }
+                    break;
+                }
+                case RenderCommandType::BEGIN_PASS:
+                {
+                    const auto pass = static_cast<std::int32_t>(command.beginPass.pass);
+                    const std::uint32_t slot = timerFrame_ % TIMER_QUERY_FRAMES;
+
+                    // GL_TIME_ELAPSED queries can't overlap, and each pass has one query per frame
+                    if (timedPass_ < 0 && !timerIssued_[slot][pass] && timerQueries_[slot][pass] != 0)
+                    {
+                        glBeginQuery(GL_TIME_ELAPSED, timerQueries_[slot][pass]);
+                        timedPass_ = pass;
+                    }
+                    break;
+                }
+                case RenderCommandType::END_PASS:
+                    if (timedPass_ >= 0)
+                    {
+                        glEndQuery(GL_TIME_ELAPSED);
+                        timerIssued_[timerFrame_ % TIMER_QUERY_FRAMES][timedPass_] = true;
+                        timedPass_ = -1;
+                    }
+                    break;
+            }
+        }
+    }
+
+    void OpenGLGfxApi::readTimerQueries() const
+    {
+        const std::uint32_t slot = timerFrame_ % TIMER_QUERY_FRAMES;
+
+        for (std::uint32_t pass = 0; pass < PASS_COUNT; ++pass)
+        {
+            if (timerIssued_[slot][pass])
+            {
+                std::uint32_t available = 0;
+                glGetQueryObjectuiv(timerQueries_[slot][pass], GL_QUERY_RESULT_AVAILABLE, &available);
+
+                // Still in flight after all these frames, the last time read is kept rather than waiting on it
+                if (available)
+                {
+                    std::uint64_t nanoseconds = 0;
+                    glGetQueryObjectui64v(timerQueries_[slot][pass], GL_QUERY_RESULT, &nanoseconds);
+                    passMilliseconds_[pass] = static_cast<float>(nanoseconds) / 1000000.0f;
+                    gpuTimesRead_ = true;
+                }
+
+                timerIssued_[slot][pass] = false;
+            }
+            else
+            {
+                // The pass drew nothing in that frame
+                passMilliseconds_[pass] = 0.0f;
+            }
+        }
+    }
+
+    void OpenGLGfxApi::countResourceUpload(std::uint64_t bytes) const
+    {
+        resourceUploadedBytes_.fetch_add(bytes, std::memory_order_relaxed);
     }
 
     bool OpenGLGfxApi::initGfxDebug() const
@@ -533,4 +1120,16 @@ namespace PB
 
         return false;
     }
+
+    std::string OpenGLGfxApi::driverId() const
+    {
+        return driverId_;
+    }
+
+    RenderStats OpenGLGfxApi::lastFrameStats() const
+    {
+        std::unique_lock<std::mutex> mlock(statsMutex_);
+
+        return lastFrameStats_;
+    }
 }
\ No newline at end of file
@@ -1,14 +1,21 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
 
 #include "puppetbox/DataStructures.h"
 #include "puppetbox/RenderWindow.h"
 
+#include "GLStateCache.h"
 #include "IGfxApi.h"
 #include "ImageOptions.h"
 #include "ImageReference.h"
 #include "Mesh.h"
+#include "MeshArena.h"
+#include "StreamBuffer.h"
 #include "TypeDef.h"
 
 namespace PB
@@ -28,10 +35,25 @@ namespace PB
         */
         bool init(PB::ProcAddress procAddress) override;
 
+        /**
+        * \brief Unmaps and deletes the stream buffer, and deletes the mesh arena, while the context they were
+        * created in is still current.
+        */
+        void shutdown() override;
+
         /**
         * \brief Used to define OpenGL API specific commands that must execute before each rendering loop.
+        *
+        * \param width	The width of the viewport to draw the frame to.
+        * \param height	The height of the viewport to draw the frame to.
+        */
+        void preLoopCommands(std::uint32_t width, std::uint32_t height) const override;
+
+        /**
+        * \brief Used to define OpenGL API specific commands that must execute after everything for a frame is
+        * drawn, fencing the frame's region of the stream buffer.
         */
-        void preLoopCommands() const override;
+        void postLoopCommands() const override;
 
         /**
         * \brief Used to execute OpenGL API specific command to set renderer dimensions.
@@ -65,6 +87,13 @@ namespace PB
         */
         ImageReference loadImage(ImageData imageData, ImageOptions options) const override;
 
+        /**
+        * \brief Deletes the image's texture, forgetting it in the GL state cache.
+        *
+        * \param image The image to release, its reference is cleared.
+        */
+        void freeImage(ImageReference& image) const override;
+
         /**
          * \brief Generates textures for each glyph of the given font face, adding references to them
          * within the loaded characters {\link unordered_map}.
@@ -80,39 +109,136 @@ namespace PB
                 std::unordered_map<std::int8_t, TypeCharacter>& loadedCharacters) const override;
 
         /**
-        * \brief Used to execute the OpenGL API specific commands to load vertex data into GFX memory.
+        * \brief Used to execute the OpenGL API specific commands to load vertex data into GFX memory.  The
+        * mesh is added to the mesh arena if it has few enough vertices once welded.
         *
         * \param vertexData		The vertex data to load into memory.
         * \param vertexCount	The number of entries in the vertexData array.
         */
         Mesh loadMesh(Vertex* vertexData, std::uint32_t vertexCount) const override;
 
+        /**
+        * \brief Used to execute the OpenGL API specific commands to load an already laid out mesh buffer
+        * into GFX memory.  Mesh buffers the mesh arena accepts are added to it, any others get their own buffers,
+        * handing their vertex and index data to glBufferData as is.
+        *
+        * \param meshBuffer	The mesh buffer to load into memory.
+        */
+        Mesh loadMesh(const MeshFormat::MeshBuffer& meshBuffer) const override;
+
+        /**
+        * \brief Used to execute the OpenGL API specific commands to delete the vertex array and buffers of
+        * a loaded mesh.
+        *
+        * \param mesh	The mesh to release, its references are cleared.
+        */
+        void freeMesh(Mesh& mesh) const override;
+
+        bool beginShader(
+                Shader& shader,
+                const std::string& vertexCode,
+                const std::string& geometryCode,
+                const std::string& fragmentCode) const override;
+
+        bool isShaderReady(const Shader& shader) const override;
+
+        bool finishShader(Shader& shader) const override;
+
+        bool supportsShaderBinaries() const override;
+
+        bool loadShaderBinary(Shader& shader, const ShaderBinary& binary) const override;
+
+        bool getShaderBinary(const Shader& shader, ShaderBinary* binary) const override;
+
+        /**
+        * \brief Deletes the shader program and its shaders, forgetting it in the GL state cache.
+        *
+        * \param shader The shader program to release, its references are cleared.
+        */
+        void freeShader(Shader& shader) const override;
+
         /**
         * \brief Initializes the UBO buffer, defining the data ranges.  This is needed before use.
         */
         void initializeUBORanges() override;
 
         /**
-        * \brief Sets view/projection matrices in the UBO.  Must initializeUBORanges() before use.
-        *
-        * \param view		     The View Matrix to set.
-        * \param projection	     The Projection Matrix to set.
-        * \param uiProjection    The UI orthographic projection matrix to set.
+        * \brief Invalidates the GL state cache, as OpenGL calls made while another thread held the context
+        * may not have gone through it.
         */
-        void setTransformUBOData(mat4 view, mat4 projection, mat4 uiProjection) const override;
+        void invalidateState() const override;
 
         /**
-        * \brief Enables the OpenGL API debugger.
+        * \brief Executes the commands of the given list, placing uploads in the frame's region of the stream
+        * buffer.  Binds and state changes to what is already set are skipped.
         *
-        * \return True if the debugger was enabled, False otherwise.
+        * \param commandList The commands to execute.
         */
+        void submit(const CommandList& commandList) const override;
+
         bool initGfxDebug() const override;
 
+        /**
+        * \brief Identifies the OpenGL driver, as its vendor, renderer, and version strings.
+        *
+        * \return The vendor, renderer and version of the driver.
+        */
+        std::string driverId() const override;
+
+        /**
+        * \brief Gets the stats of the last finished frame.  GPU times are read back from timer queries a few
+        * frames after they are issued, so reading them never waits on the GPU, and lag the counts by as much.
+        *
+        * \return The stats of the last finished frame.
+        */
+        RenderStats lastFrameStats() const override;
+
+    private:
+        /** Frames a timer query is left before its result is read back */
+        static constexpr std::uint32_t TIMER_QUERY_FRAMES = 3;
+        static constexpr std::uint32_t PASS_COUNT = static_cast<std::uint32_t>(RenderPass::COUNT);
+
+    private:
+        /**
+        * \brief Reads back the GPU times of the passes timed the last time the current frame's timer queries
+        * were used, if the GPU is done with them.
+        */
+        void readTimerQueries() const;
+
+        /**
+        * \brief Counts bytes of a mesh or image loaded into GFX memory, to report with the next finished frame.
+        *
+        * \param bytes The number of bytes uploaded.
+        */
+        void countResourceUpload(std::uint64_t bytes) const;
+
     private:
         std::uint32_t width_ = 0;
         std::uint32_t height_ = 0;
         std::uint32_t distance_ = 0;
         std::uint32_t UBO_ = 0;
         std::uint32_t minimumUBOOffset_ = 0;
+        std::string driverId_{};
+        /** Every bind and enable made while loading and drawing goes through here */
+        mutable GLStateCache stateCache_{};
+        std::shared_ptr<StreamBuffer> streamBuffer_{};
+        /** Holds the meshes with the standard vertex layout, or nullptr if it couldn't be created */
+        std::shared_ptr<MeshArena> meshArena_{};
+        /** Whether glMultiDrawElementsIndirect is available, if not indirect draws are made one at a time */
+        bool multiDrawIndirect_ = false;
+        std::uint32_t timerQueries_[TIMER_QUERY_FRAMES][PASS_COUNT] = {};
+        mutable bool timerIssued_[TIMER_QUERY_FRAMES][PASS_COUNT] = {};
+        mutable std::uint32_t timerFrame_ = 0;
+        /** The pass being timed, or -1 if none */
+        mutable std::int32_t timedPass_ = -1;
+        mutable float passMilliseconds_[PASS_COUNT] = {};
+        /** Set once the first pass time is read back, before which there are no times to report */
+        mutable bool gpuTimesRead_ = false;
+        mutable RenderStats frameStats_{};
+        /** Bytes of meshes and images loaded since the last finished frame, as loads happen between frames */
+        mutable std::atomic<std::uint64_t> resourceUploadedBytes_{0};
+        mutable RenderStats lastFrameStats_{};
+        /** Guards lastFrameStats_, which is read from outside the render thread */
+        mutable std::mutex statsMutex_{};
     };
 }
@@ -1,8 +1,10 @@
 #include "OpenGLModel.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "GfxMath.h"
+#include "PoseMath.h"
 
 namespace PB
 {
@@ -14,28 +16,104 @@ namespace PB
             animationCatalogue_(animationCatalogue),
             renderedMeshes_(std::move(renderedMeshes))
     {
+        skeleton_ = PoseMath::BuildSkeletonLayout(bones_);
+        PoseMath::LoadBindPose(skeleton_, bindPose_);
+        pose_ = bindPose_;
+        overrides_.resize(skeleton_.boneCount());
+        PoseMath::ComposePose(skeleton_, pose_, overrides_, palette_);
+    }
 
+    OpenGLModel::~OpenGLModel()
+    {
+        for (auto& renderedMesh: renderedMeshes_)
+        {
+            delete renderedMesh.second;
+        }
     }
 
     void OpenGLModel::playAnimation(const std::string& animationPath, std::uint32_t startFrame)
     {
-        animator_ = std::move(animationCatalogue_->get(animationPath));
+        playAnimation(animationPath, startFrame, 0);
+    }
+
+    void OpenGLModel::playAnimation(const std::string& animationPath, std::uint32_t startFrame, float transitionTime)
+    {
+        detachSharedPalette();
+
+        std::unique_ptr<IAnimator> animator = animationCatalogue_->get(animationPath);
+
+        if (animator != nullptr)
+        {
+            animator->setCurrentFrame(startFrame);
+        }
+
+        if (transitionTime > 0)
+        {
+            if (fadeDuration_ == 0)
+            {
+                // Whatever is currently playing becomes the source of the crossfade, or the T-Pose if nothing is
+                fadingAnimator_ = std::move(animator_);
+                fadeSourcePose_ = bindPose_;
+            }
+            else if (fadeElapsed_ > 0)
+            {
+                // Interrupting a crossfade fades from the blend it had reached, rather than jumping to either clip
+                fadingAnimator_ = nullptr;
+                fadeSourcePose_ = fadePose_;
+            }
+
+            fadeDuration_ = transitionTime;
+            fadeElapsed_ = 0;
+        }
+        else
+        {
+            fadingAnimator_ = nullptr;
+            fadeDuration_ = 0;
+        }
+
+        animator_ = std::move(animator);
+    }
+
+    void OpenGLModel::addAnimationLayer(const std::string& animationPath, float weight)
+    {
+        std::unique_ptr<IAnimator> animator = animationCatalogue_->get(animationPath);
 
-        if (animator_ != nullptr)
+        if (animator != nullptr)
         {
-            animator_->setCurrentFrame(startFrame);
+            animator->setCurrentFrame(0);
+
+            // The layer's first frame is the reference the additive difference is measured from
+            AnimationPose referencePose = animator->samplePose(0, skeleton_);
+
+            layers_.push_back(AnimationLayer{std::move(animator), std::move(referencePose), weight});
         }
     }
 
+    void OpenGLModel::removeAnimationLayer(const std::string& animationPath)
+    {
+        layers_.erase(
+                std::remove_if(layers_.begin(), layers_.end(), [&animationPath](const AnimationLayer& layer) {
+                    return layer.animator->getAnimationName() == animationPath;
+                }),
+                layers_.end()
+        );
+    }
+
     void OpenGLModel::stopAnimation()
     {
+        detachSharedPalette();
+
         animator_ = nullptr;
+        fadingAnimator_ = nullptr;
+        fadeDuration_ = 0;
     }
 
     void OpenGLModel::stopAnimation(const std::string& animationPath)
     {
         if (animator_ && animator_->getAnimationName() == animationPath)
         {
+            detachSharedPalette();
+
             animator_ = nullptr;
         }
     }
@@ -47,91 +125,93 @@ namespace PB
 
     mat4 OpenGLModel::getAbsolutePositionForBone(std::uint32_t boneId) const
     {
-        return boneTransformations_.at(boneId);
+        return activePalette()[skeleton_.boneIndexes.at(boneId)];
     }
 
     void OpenGLModel::update(float deltaTime)
     {
-        boneTransformations_.clear();
+        // Plain playback shares one palette per (animation, skeleton, quantized time) across every instance
+        if (animator_ != nullptr && fadeDuration_ == 0 && layers_.empty() && overrides_.empty())
+        {
+            sharedPalette_ = &animator_->sampleSharedPalette(deltaTime, skeleton_);
+            sharedGeneration_ = sharedPalette_->generation;
+            return;
+        }
 
-        if (animator_ != nullptr)
+        if (fadeDuration_ > 0)
         {
-            // Update bone transformation matrices for current frame
-            animator_->update(deltaTime, bones_, boneTransformationOverrides_);
+            fadeElapsed_ += deltaTime;
 
-            // Get bone transformation matrices
-            auto& keyValues = animator_->getBoneTransformations();
+            // Crossfade from whatever was playing before, or a frozen pose, towards the current animation
+            fadePose_ = fadingAnimator_ != nullptr
+                        ? fadingAnimator_->samplePose(deltaTime, skeleton_)
+                        : fadeSourcePose_;
 
-            boneTransformations_.insert(keyValues.begin(), keyValues.end());
-        }
-        else
-        {
-            //TODO: not supporting mix animations atm
+            PoseMath::BlendPose(
+                    fadePose_,
+                    animator_ != nullptr ? animator_->samplePose(deltaTime, skeleton_) : bindPose_,
+                    std::min(fadeElapsed_ / fadeDuration_, 1.0f));
 
-            // Update T-Pose local bone transforms
-            for (auto& itr : bones_.getAllBones())
-            {
-                auto override = boneTransformationOverrides_.find(itr.first);
-
-                if (override != boneTransformationOverrides_.end())
-                {
-                    itr.second.bone.transform = override->second;
-                }
-                else
-                {
-                    itr.second.bone.transform = GfxMath::CreateTransformation(
-                            itr.second.bone.rotation.vec3(),
-                            itr.second.bone.scale.vec3(),
-                            itr.second.bone.position.vec3()
-                    );
-                }
-            }
+            // Kept apart from the layered pose, in case the crossfade is interrupted
+            pose_ = fadePose_;
 
-            // Calculate T-Pose final bone transforms
-            for (auto& itr : bones_.getAllBones())
+            if (fadeElapsed_ >= fadeDuration_)
             {
-                mat4 transform = itr.second.bone.transform;
+                fadingAnimator_ = nullptr;
+                fadeDuration_ = 0;
+            }
+        }
+        else
+        {
+            pose_ = animator_ != nullptr ? animator_->samplePose(deltaTime, skeleton_) : bindPose_;
+        }
 
-                std::uint32_t parentId = itr.second.parentId;
+        for (auto& layer: layers_)
+        {
+            PoseMath::AddPose(
+                    pose_,
+                    layer.animator->samplePose(deltaTime, skeleton_),
+                    layer.referencePose,
+                    layer.weight);
+        }
 
-                while (parentId > 0)
-                {
-                    transform = bones_.getBone(parentId).result->bone.transform * transform;
-                    parentId = bones_.getBone(parentId).result->parentId;
-                }
+        PoseMath::ComposePose(skeleton_, pose_, overrides_, palette_);
 
-                boneTransformations_.insert(
-                        std::pair<std::uint32_t, mat4>(itr.first, transform)
-                );
-            }
-        }
+        sharedPalette_ = nullptr;
     }
 
     void OpenGLModel::render(mat4 transform) const
     {
         for (auto itr = renderedMeshes_.begin(); itr != renderedMeshes_.end(); ++itr)
         {
-            Bone* bones = new Bone[1];
-            bones[0].transform = boneTransformations_.at(itr->first);
+            Bone bone{};
+            bone.transform = activePalette()[skeleton_.boneIndexes.at(itr->first)];
 
-            itr->second->render(transform, bones, 1);
-
-            delete[] bones;
+            itr->second->render(transform, &bone, 1);
         }
     }
 
     void OpenGLModel::overrideBoneRotation(std::uint32_t boneId, vec3 rotation)
     {
-        //TODO: Need to translate over the scaling values from the animation frame
-        boneTransformationOverrides_[boneId] = GfxMath::CreateTransformation(
-                rotation,
-                {1, 1, 1},
-                bones_.getBone(boneId).result->bone.position.vec3());
+        auto boneIndex = skeleton_.boneIndexes.find(boneId);
+
+        if (boneIndex != skeleton_.boneIndexes.end())
+        {
+            //TODO: Need to translate over the scaling values from the animation frame
+            overrides_.set(
+                    boneIndex->second,
+                    GfxMath::CreateTransformation(rotation, {1, 1, 1}, skeleton_.bindPositions[boneIndex->second]));
+        }
     }
 
     void OpenGLModel::clearBoneOverrides(std::uint32_t boneId)
     {
-        boneTransformationOverrides_.erase(boneId);
+        auto boneIndex = skeleton_.boneIndexes.find(boneId);
+
+        if (boneIndex != skeleton_.boneIndexes.end())
+        {
+            overrides_.clear(boneIndex->second);
+        }
     }
 
     const std::uint32_t OpenGLModel::getBoneId(const std::string& boneName) const
@@ -143,4 +223,25 @@ namespace PB
     {
         return bones_;
     }
+
+    void OpenGLModel::detachSharedPalette()
+    {
+        if (sharedPalette_ != nullptr && sharedPalette_->generation == sharedGeneration_)
+        {
+            palette_ = sharedPalette_->transforms;
+        }
+
+        sharedPalette_ = nullptr;
+    }
+
+    const std::vector<mat4>& OpenGLModel::activePalette() const
+    {
+        // A model that stopped updating keeps its own last pose, rather than whatever its palette was reused for
+        if (sharedPalette_ != nullptr && sharedPalette_->generation == sharedGeneration_)
+        {
+            return sharedPalette_->transforms;
+        }
+
+        return palette_;
+    }
 }
\ No newline at end of file
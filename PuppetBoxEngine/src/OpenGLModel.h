@@ -35,6 +35,15 @@ namespace PB
                 std::unordered_map<std::uint32_t, RenderedMesh*> renderedMeshes,
                 IAnimationCatalogue* animationCatalogue);
 
+        OpenGLModel(const OpenGLModel&) = delete;
+
+        OpenGLModel& operator=(const OpenGLModel&) = delete;
+
+        /**
+        * \brief Deletes the model's {\link RenderedMesh} objects, releasing their hold on the assets they use.
+        */
+        ~OpenGLModel() override;
+
         /**
          * \brief Sets the animation of the Model.
          *
@@ -43,6 +52,34 @@ namespace PB
          */
         void playAnimation(const std::string& animationPath, std::uint32_t startFrame) override;
 
+        /**
+         * \brief Sets the animation of the Model, crossfading from the current animation over the
+         * given transition time.
+         *
+         * <p>Starting a crossfade while another is running fades from the pose the running one had reached.</p>
+         *
+         * \param animationPath  Path to the animation to start playing
+         * \param startFrame     The frame that the animation will start playing from.
+         * \param transitionTime The time, in seconds, to blend from the current animation to the new one.
+         */
+        void playAnimation(const std::string& animationPath, std::uint32_t startFrame, float transitionTime) override;
+
+        /**
+         * \brief Adds an additive animation layer, applied on top of the current animation relative
+         * to the layer animation's first frame.
+         *
+         * \param animationPath Path to the animation to layer.
+         * \param weight        The weight to apply the layer with.
+         */
+        void addAnimationLayer(const std::string& animationPath, float weight) override;
+
+        /**
+         * \brief Removes any additive animation layers that reference the given animation path.
+         *
+         * \param animationPath The path reference that dictates which layers will be removed.
+         */
+        void removeAnimationLayer(const std::string& animationPath) override;
+
         /**
          * \brief Removes any currently attached {\link Animator}s from the object.
          */
@@ -114,11 +151,49 @@ namespace PB
          */
         const BoneMap& getBones() const override;
 
+    private:
+        struct AnimationLayer
+        {
+            std::unique_ptr<IAnimator> animator;
+            AnimationPose referencePose;
+            float weight;
+        };
+
+    private:
+        /**
+         * \brief Copies the shared palette taken by the last update into the model's own, if it hasn't been
+         * reused since, so the model keeps its pose once the animator it came from is dropped.
+         */
+        void detachSharedPalette();
+
+        /**
+         * \brief Gets the palette the model was last posed with.
+         *
+         * \return The shared palette taken by the last update if it hasn't been reused since, otherwise the
+         * model's own.
+         */
+        const std::vector<mat4>& activePalette() const;
+
     private:
         BoneMap bones_{};
-        std::unordered_map<std::uint32_t, mat4> boneTransformations_{};
-        std::unordered_map<std::uint32_t, mat4> boneTransformationOverrides_{};
+        SkeletonLayout skeleton_{};
+        AnimationPose bindPose_{};
+        AnimationPose pose_{};
+        std::vector<mat4> palette_{};
+        /** The shared palette taken by the last update, or nullptr if the model composed its own */
+        const SharedPalette* sharedPalette_ = nullptr;
+        /** The generation of the shared palette when it was taken, once it changes the palette isn't ours */
+        std::uint32_t sharedGeneration_ = 0;
+        PoseOverrides overrides_{};
         std::unique_ptr<IAnimator> animator_{nullptr};
+        std::unique_ptr<IAnimator> fadingAnimator_{nullptr};
+        /** Source of the crossfade when there is no fading animator, the T-Pose or an interrupted blend */
+        AnimationPose fadeSourcePose_{};
+        /** The crossfade's blended pose, before layers are applied */
+        AnimationPose fadePose_{};
+        float fadeDuration_ = 0;
+        float fadeElapsed_ = 0;
+        std::vector<AnimationLayer> layers_{};
         std::unordered_map<std::uint32_t, RenderedMesh*> renderedMeshes_{};
         IAnimationCatalogue* animationCatalogue_ = nullptr;
     };
@@ -0,0 +1,188 @@
+#include "ParsedAssetCache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "BinaryFormat.h"
+#include "CookedFormat.h"
+#include "Logger.h"
+#include "Utilities.h"
+
+namespace PB
+{
+    ParsedAssetCache::ParsedAssetCache(std::string cachePath, std::shared_ptr<ArchiveReader> archive)
+            : cachePath_(std::move(cachePath)), archive_(std::move(archive)), archiveHash_(archive_->contentHash())
+    {
+
+    }
+
+    ParsedAssetCache::~ParsedAssetCache()
+    {
+        save();
+
+        if (stats_.cachedAssets > 0)
+        {
+            LOGGER_INFO("Read " + std::to_string(stats_.cachedAssets) + " parsed assets from '" + cachePath_
+                        + "' in " + StringUtils::formatMilliseconds(stats_.cachedMilliseconds)
+                        + " (warm start), parsing them took "
+                        + StringUtils::formatMilliseconds(stats_.coldMilliseconds) + " (cold start)");
+        }
+
+        if (stats_.parsedAssets > 0)
+        {
+            LOGGER_INFO("Parsed " + std::to_string(stats_.parsedAssets) + " assets missing from '" + cachePath_
+                        + "' in " + StringUtils::formatMilliseconds(stats_.parsedMilliseconds) + " (cold start)");
+        }
+    }
+
+    bool ParsedAssetCache::load()
+    {
+        std::unique_lock<std::mutex> mlock(mutex_);
+
+        bool archiveMatches = false;
+        std::uint32_t staleCount = 0;
+
+        const auto status = CookedFormat::readCacheFile(
+                cachePath_,
+                CookedFormat::CACHE_MAGIC,
+                "parsed asset cache",
+                [this, &archiveMatches, &staleCount](
+                        BinaryFormat::Reader& reader,
+                        const std::shared_ptr<std::uint8_t[]>& buffer) {
+                    archiveMatches = reader.readUInt32() == archiveHash_;
+                    const std::uint32_t count = reader.readUInt32();
+
+                    for (std::uint32_t i = 0; i < count && !reader.overrun(); ++i)
+                    {
+                        std::string fileName = reader.readString();
+                        const std::uint32_t crc32 = reader.readUInt32();
+                        const std::uint32_t parseMicros = reader.readUInt32();
+                        const std::uint32_t entrySize = reader.readUInt32();
+                        const std::uint8_t* bytes = reader.readBytes(entrySize);
+
+                        if (bytes != nullptr)
+                        {
+                            const ArchiveEntry* source = archiveMatches ? nullptr : archive_->findEntry(fileName);
+
+                            if (archiveMatches || (source != nullptr && source->crc32 == crc32))
+                            {
+                                entries_[fileName] = {crc32, parseMicros, {bytes, entrySize, buffer}};
+                            }
+                            else
+                            {
+                                ++staleCount;
+                            }
+                        }
+                    }
+
+                    return true;
+                });
+
+        if (status != CookedFormat::CacheFileStatus::READ)
+        {
+            entries_.clear();
+            dirty_ = dirty_ || status == CookedFormat::CacheFileStatus::DISCARDED;
+            return false;
+        }
+
+        if (!archiveMatches)
+        {
+            LOGGER_INFO("Archive changed since '" + cachePath_ + "' was written, " + std::to_string(staleCount)
+                        + " changed assets will be parsed again");
+            dirty_ = true;
+        }
+
+        return archiveMatches;
+    }
+
+    ArchiveEntryData ParsedAssetCache::find(const std::string& fileName) const
+    {
+        std::unique_lock<std::mutex> mlock(mutex_);
+
+        auto itr = entries_.find(fileName);
+
+        return itr != entries_.end() ? itr->second.data : ArchiveEntryData{};
+    }
+
+    void ParsedAssetCache::recordHit(const std::string& fileName, double milliseconds)
+    {
+        std::unique_lock<std::mutex> mlock(mutex_);
+
+        auto itr = entries_.find(fileName);
+
+        if (itr != entries_.end())
+        {
+            ++stats_.cachedAssets;
+            stats_.cachedMilliseconds += milliseconds;
+            stats_.coldMilliseconds += static_cast<double>(itr->second.parseMicros) / 1000.0;
+        }
+    }
+
+    void ParsedAssetCache::store(
+            const std::string& fileName,
+            const std::vector<std::uint8_t>& bytes,
+            double parseMilliseconds)
+    {
+        const ArchiveEntry* source = archive_->findEntry(fileName);
+
+        if (source == nullptr)
+        {
+            return;
+        }
+
+        std::shared_ptr<std::uint8_t[]> buffer{new std::uint8_t[bytes.size()]};
+        std::copy(bytes.begin(), bytes.end(), buffer.get());
+
+        const auto parseMicros = static_cast<std::uint32_t>(
+                std::min(parseMilliseconds * 1000.0, static_cast<double>(UINT32_MAX)));
+
+        std::unique_lock<std::mutex> mlock(mutex_);
+
+        entries_[fileName] = {source->crc32, parseMicros, {buffer.get(), bytes.size(), buffer}};
+        dirty_ = true;
+
+        ++stats_.parsedAssets;
+        stats_.parsedMilliseconds += parseMilliseconds;
+    }
+
+    bool ParsedAssetCache::save()
+    {
+        std::unique_lock<std::mutex> mlock(mutex_);
+
+        if (!dirty_)
+        {
+            return true;
+        }
+
+        const auto sortedEntries = CookedFormat::sortedEntries(entries_);
+
+        const bool written = CookedFormat::writeCacheFile(
+                cachePath_,
+                CookedFormat::CACHE_MAGIC,
+                "parsed asset cache",
+                [this, &sortedEntries](BinaryFormat::Writer& writer) {
+                    writer.writeUInt32(archiveHash_);
+                    writer.writeUInt32(static_cast<std::uint32_t>(sortedEntries.size()));
+
+                    for (const auto* entry: sortedEntries)
+                    {
+                        writer.writeString(entry->first);
+                        writer.writeUInt32(entry->second.crc32);
+                        writer.writeUInt32(entry->second.parseMicros);
+                        writer.writeUInt32(static_cast<std::uint32_t>(entry->second.data.size));
+                        writer.writeBytes(entry->second.data.data, entry->second.data.size);
+                    }
+                });
+
+        if (!written)
+        {
+            return false;
+        }
+
+        dirty_ = false;
+
+        LOGGER_DEBUG("Wrote " + std::to_string(sortedEntries.size()) + " parsed assets to '" + cachePath_ + "'");
+
+        return true;
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ArchiveReader.h"
+
+namespace PB
+{
+    /**
+    * \brief Load times of the assets read through a {\link ParsedAssetCache}, comparing the warm start, where
+    * assets are read back from the cache, with the cold start, where they were parsed from their source text.
+    */
+    struct ParsedAssetStats
+    {
+        std::uint32_t cachedAssets = 0;
+        /** Time spent reading the cached assets from the cache */
+        double cachedMilliseconds = 0;
+        /** Time it took to parse the cached assets when they were cached */
+        double coldMilliseconds = 0;
+        std::uint32_t parsedAssets = 0;
+        double parsedMilliseconds = 0;
+    };
+
+    /**
+    * \brief An on-disk cache of the assets parsed from a source archive's text files, stored in their cooked
+    * forms (see {\link CookedFormat.h}) in a single file next to the archive.
+    *
+    * <p>The cache is keyed by the content hash of the archive and the CRC of each source file.  While the
+    * archive is unchanged every cached asset is used as is, once it changes only the assets whose source
+    * files changed are dropped, to be parsed again.  The cache file is read with a single read, and cached
+    * assets are served from that buffer without copying.  Newly parsed assets are written back when the
+    * cache is destroyed.  Lookups and stores may be made from multiple threads at once.</p>
+    */
+    class ParsedAssetCache
+    {
+    public:
+        /**
+        * \brief Creates an empty cache for the given archive.
+        *
+        * \param cachePath The path of the cache file.
+        * \param archive   The open source archive the cached assets are parsed from.
+        */
+        ParsedAssetCache(std::string cachePath, std::shared_ptr<ArchiveReader> archive);
+
+        ParsedAssetCache(const ParsedAssetCache&) = delete;
+
+        ParsedAssetCache& operator=(const ParsedAssetCache&) = delete;
+
+        /**
+        * \brief Saves any newly parsed assets, and reports the warm and cold load times.
+        */
+        ~ParsedAssetCache();
+
+        /**
+        * \brief Reads the cache file, keeping the cached assets that are still current.
+        *
+        * \return True if the cache was read and the archive is unchanged since it was written, False otherwise.
+        */
+        bool load();
+
+        /**
+        * \brief Finds the cached, parsed form of the given source file.
+        *
+        * \param fileName The name of the source file within the archive.
+        * \return The cooked form of the parsed asset, or empty data if it isn't cached.
+        */
+        ArchiveEntryData find(const std::string& fileName) const;
+
+        /**
+        * \brief Records that the given cached asset was used, and how long it took to read it.
+        *
+        * \param fileName     The name of the source file within the archive.
+        * \param milliseconds The time it took to read the cached asset.
+        */
+        void recordHit(const std::string& fileName, double milliseconds);
+
+        /**
+        * \brief Caches the parsed form of the given source file, to be written when the cache is saved.
+        *
+        * \param fileName          The name of the source file within the archive.
+        * \param bytes             The cooked form of the parsed asset.
+        * \param parseMilliseconds The time it took to parse the source file.
+        */
+        void store(const std::string& fileName, const std::vector<std::uint8_t>& bytes, double parseMilliseconds);
+
+        /**
+        * \brief Writes the cache file, if any assets were cached since it was read.
+        *
+        * \return True if the cache file is up to date, False if it could not be written.
+        */
+        bool save();
+
+    private:
+        struct CacheEntry
+        {
+            std::uint32_t crc32 = 0;
+            std::uint32_t parseMicros = 0;
+            ArchiveEntryData data{};
+        };
+
+    private:
+        std::string cachePath_;
+        std::shared_ptr<ArchiveReader> archive_;
+        std::uint32_t archiveHash_;
+        mutable std::mutex mutex_;
+        std::unordered_map<std::string, CacheEntry> entries_{};
+        bool dirty_ = false;
+        ParsedAssetStats stats_{};
+    };
+}
@@ -0,0 +1,414 @@
+#include "PoseMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "GfxMath.h"
+
+namespace PB::PoseMath
+{
+    namespace
+    {
+        /**
+         * \brief Counts the number of ancestors of the given bone.
+         *
+         * \param bones  The skeletal data the bone belongs to.
+         * \param boneId The ID of the bone to count ancestors for.
+         *
+         * \return The number of ancestors of the bone.
+         */
+        std::uint32_t boneDepth(BoneMap& bones, std::uint32_t boneId)
+        {
+            std::uint32_t depth = 0;
+
+            auto bone = bones.getBone(boneId);
+            auto parent = bones.getBone(bone.result->parentId);
+
+            while (parent.hasResult && depth < bones.getAllBones().size())
+            {
+                ++depth;
+                parent = bones.getBone(parent.result->parentId);
+            }
+
+            return depth;
+        }
+
+        /**
+         * \brief Mixes the given values into the hash seed.
+         *
+         * \param seed  The hash seed to mix into.
+         * \param value The vector to mix into the seed.
+         */
+        inline void hashCombine(std::size_t& seed, const vec3& value)
+        {
+            for (std::uint32_t i = 0; i < 3; ++i)
+            {
+                seed ^= std::hash<float>()(value[i]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            }
+        }
+
+        /**
+         * \brief Gets the signed difference between two angles along the shortest arc.
+         *
+         * \param from The angle to measure from, in radians.
+         * \param to   The angle to measure to, in radians.
+         *
+         * \return The shortest signed difference between the angles, in radians.
+         */
+        inline float shortestArc(float from, float to)
+        {
+            float delta = std::fmod(to - from, TWO_PI);
+
+            if (delta > PI)
+            {
+                delta -= TWO_PI;
+            }
+            else if (delta < -PI)
+            {
+                delta += TWO_PI;
+            }
+
+            return delta;
+        }
+
+        /**
+         * \brief Wraps the given angle to [0, 2PI).
+         *
+         * \param angle The angle to wrap, in radians.
+         *
+         * \return The wrapped angle, in radians.
+         */
+        inline float wrapAngle(float angle)
+        {
+            return std::fmod(std::fmod(angle, TWO_PI) + TWO_PI, TWO_PI);
+        }
+
+        /**
+         * \brief Rotation differences below this, in radians, are treated as no difference.
+         */
+        const float ANGLE_EPSILON = 0.000001f;
+
+        /**
+         * \brief Past this dot product two rotations are close enough to interpolate linearly.
+         */
+        const float SLERP_LINEAR_THRESHOLD = 0.9995f;
+
+        /**
+         * \brief Unit quaternion, used to interpolate rotations about more than one axis.
+         */
+        struct Quaternion
+        {
+            float w, x, y, z;
+        };
+
+        inline Quaternion multiply(const Quaternion& a, const Quaternion& b)
+        {
+            return {
+                    (a.w * b.w) - (a.x * b.x) - (a.y * b.y) - (a.z * b.z),
+                    (a.w * b.x) + (a.x * b.w) + (a.y * b.z) - (a.z * b.y),
+                    (a.w * b.y) - (a.x * b.z) + (a.y * b.w) + (a.z * b.x),
+                    (a.w * b.z) + (a.x * b.y) - (a.y * b.x) + (a.z * b.w)
+            };
+        }
+
+        inline Quaternion conjugate(const Quaternion& q)
+        {
+            return {q.w, -q.x, -q.y, -q.z};
+        }
+
+        /**
+         * \brief Converts Euler angles to a quaternion, in the same order as {\link GfxMath::Rotate}, x then y
+         * then z.
+         *
+         * \param angles The rotation about each axis, in radians.
+         *
+         * \return The quaternion for the same rotation.
+         */
+        inline Quaternion toQuaternion(const vec3& angles)
+        {
+            const Quaternion qx{std::cos(angles.x * 0.5f), std::sin(angles.x * 0.5f), 0, 0};
+            const Quaternion qy{std::cos(angles.y * 0.5f), 0, std::sin(angles.y * 0.5f), 0};
+            const Quaternion qz{std::cos(angles.z * 0.5f), 0, 0, std::sin(angles.z * 0.5f)};
+
+            return multiply(multiply(qx, qy), qz);
+        }
+
+        /**
+         * \brief Converts a quaternion back to Euler angles in the order {\link GfxMath::Rotate} applies them,
+         * each wrapped to [0, 2PI).
+         *
+         * \param q The quaternion to convert.
+         *
+         * \return The rotation about each axis, in radians.
+         */
+        inline vec3 toEulerAngles(const Quaternion& q)
+        {
+            // The entries of the rotation matrix Rx * Ry * Rz needed to recover the angles
+            const float r00 = 1 - 2 * ((q.y * q.y) + (q.z * q.z));
+            const float r01 = 2 * ((q.x * q.y) - (q.w * q.z));
+            const float r02 = 2 * ((q.x * q.z) + (q.w * q.y));
+            const float r10 = 2 * ((q.x * q.y) + (q.w * q.z));
+            const float r11 = 1 - 2 * ((q.x * q.x) + (q.z * q.z));
+            const float r12 = 2 * ((q.y * q.z) - (q.w * q.x));
+            const float r20 = 2 * ((q.x * q.z) - (q.w * q.y));
+            const float r21 = 2 * ((q.y * q.z) + (q.w * q.x));
+            const float r22 = 1 - 2 * ((q.x * q.x) + (q.y * q.y));
+
+            vec3 angles{};
+            angles.x = std::atan2(-r12, r22);
+            // atan2 keeps y accurate close to +-PI/2, where asin loses precision
+            angles.y = std::atan2(r02, std::sqrt((r00 * r00) + (r01 * r01)));
+
+            // z is solved against the x actually chosen, so near gimbal lock, where x is poorly determined,
+            // the three angles still make up the same rotation
+            const float cosX = std::cos(angles.x);
+            const float sinX = std::sin(angles.x);
+            angles.z = std::atan2((cosX * r10) + (sinX * r20), (cosX * r11) + (sinX * r21));
+
+            return {wrapAngle(angles.x), wrapAngle(angles.y), wrapAngle(angles.z)};
+        }
+
+        /**
+         * \brief Spherically interpolates between two rotations along the shortest arc.
+         *
+         * \param from  The rotation to interpolate from.
+         * \param to    The rotation to interpolate to.
+         * \param blend The blend factor, 0 being from and 1 being to.
+         *
+         * \return The interpolated rotation.
+         */
+        inline Quaternion slerp(const Quaternion& from, Quaternion to, float blend)
+        {
+            float dot = (from.w * to.w) + (from.x * to.x) + (from.y * to.y) + (from.z * to.z);
+
+            // q and -q are the same rotation, flipping to the nearer one takes the short way round
+            if (dot < 0)
+            {
+                to = {-to.w, -to.x, -to.y, -to.z};
+                dot = -dot;
+            }
+
+            float fromWeight = 1 - blend;
+            float toWeight = blend;
+
+            if (dot < SLERP_LINEAR_THRESHOLD)
+            {
+                const float theta = std::acos(dot);
+                const float sinTheta = std::sin(theta);
+
+                fromWeight = std::sin((1 - blend) * theta) / sinTheta;
+                toWeight = std::sin(blend * theta) / sinTheta;
+            }
+
+            Quaternion result{
+                    (from.w * fromWeight) + (to.w * toWeight),
+                    (from.x * fromWeight) + (to.x * toWeight),
+                    (from.y * fromWeight) + (to.y * toWeight),
+                    (from.z * fromWeight) + (to.z * toWeight)
+            };
+
+            const float length = std::sqrt(
+                    (result.w * result.w) + (result.x * result.x) + (result.y * result.y) + (result.z * result.z));
+
+            return {result.w / length, result.x / length, result.y / length, result.z / length};
+        }
+
+        /**
+         * \brief Counts the axes the two rotations differ on.
+         *
+         * \param from The first rotation, in radians.
+         * \param to   The second rotation, in radians.
+         *
+         * \return The number of axes with a difference.
+         */
+        inline std::uint32_t axesChanged(const vec3& from, const vec3& to)
+        {
+            std::uint32_t count = 0;
+
+            for (std::uint32_t axis = 0; axis < 3; ++axis)
+            {
+                count += std::abs(shortestArc(from[axis], to[axis])) > ANGLE_EPSILON ? 1 : 0;
+            }
+
+            return count;
+        }
+    }
+
+    SkeletonLayout BuildSkeletonLayout(BoneMap& bones)
+    {
+        SkeletonLayout skeleton{};
+
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> depthOrder{};
+        depthOrder.reserve(bones.getAllBones().size());
+
+        for (auto& entry: bones.getAllBones())
+        {
+            depthOrder.emplace_back(boneDepth(bones, entry.first), entry.first);
+        }
+
+        // Sorting by depth guarantees parents come before children, sorting by ID keeps it deterministic
+        std::sort(depthOrder.begin(), depthOrder.end());
+
+        for (auto& entry: depthOrder)
+        {
+            const BoneNode* boneNode = bones.getBone(entry.second).result;
+
+            auto parentIndex = skeleton.boneIndexes.find(boneNode->parentId);
+
+            skeleton.boneIndexes.insert(
+                    std::pair<std::uint32_t, std::uint32_t>{
+                            boneNode->id,
+                            static_cast<std::uint32_t>(skeleton.boneIds.size())}
+            );
+
+            skeleton.boneIds.push_back(boneNode->id);
+            skeleton.boneNames.push_back(boneNode->name);
+            skeleton.parentIndexes.push_back(
+                    parentIndex != skeleton.boneIndexes.end() ? static_cast<std::int32_t>(parentIndex->second) : -1
+            );
+            skeleton.bindPositions.push_back(boneNode->bone.position.vec3());
+            skeleton.bindRotations.push_back(boneNode->bone.rotation.vec3());
+            skeleton.bindScales.push_back(boneNode->bone.scale.vec3());
+
+            // Bind data is part of the signature, models sharing bone names may still differ in shape
+            skeleton.signature ^= std::hash<std::uint32_t>()(boneNode->id)
+                                  + 0x9e3779b9 + (skeleton.signature << 6) + (skeleton.signature >> 2);
+            hashCombine(skeleton.signature, skeleton.bindPositions.back());
+            hashCombine(skeleton.signature, skeleton.bindRotations.back());
+            hashCombine(skeleton.signature, skeleton.bindScales.back());
+        }
+
+        return skeleton;
+    }
+
+    float TweenAngle(float from, float to, float blend)
+    {
+        return wrapAngle(from + (shortestArc(from, to) * blend));
+    }
+
+    void Interpolate(
+            const vec3* fromRotations,
+            const vec3* fromScales,
+            const vec3* toRotations,
+            const vec3* toScales,
+            float blend,
+            std::size_t count,
+            vec3* outRotations,
+            vec3* outScales)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            outScales[i].x = fromScales[i].x + ((toScales[i].x - fromScales[i].x) * blend);
+            outScales[i].y = fromScales[i].y + ((toScales[i].y - fromScales[i].y) * blend);
+            outScales[i].z = fromScales[i].z + ((toScales[i].z - fromScales[i].z) * blend);
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // About a single axis the per axis arc is the shortest arc, and much cheaper
+            if (axesChanged(fromRotations[i], toRotations[i]) <= 1)
+            {
+                outRotations[i].x = TweenAngle(fromRotations[i].x, toRotations[i].x, blend);
+                outRotations[i].y = TweenAngle(fromRotations[i].y, toRotations[i].y, blend);
+                outRotations[i].z = TweenAngle(fromRotations[i].z, toRotations[i].z, blend);
+            }
+            else
+            {
+                outRotations[i] = toEulerAngles(
+                        slerp(toQuaternion(fromRotations[i]), toQuaternion(toRotations[i]), blend));
+            }
+        }
+    }
+
+    void LoadBindPose(const SkeletonLayout& skeleton, AnimationPose& pose)
+    {
+        pose.rotations.assign(skeleton.bindRotations.begin(), skeleton.bindRotations.end());
+        pose.scales.assign(skeleton.bindScales.begin(), skeleton.bindScales.end());
+    }
+
+    void BlendPose(AnimationPose& pose, const AnimationPose& target, float weight)
+    {
+        const std::size_t count = std::min(pose.rotations.size(), target.rotations.size());
+
+        Interpolate(
+                pose.rotations.data(),
+                pose.scales.data(),
+                target.rotations.data(),
+                target.scales.data(),
+                weight,
+                count,
+                pose.rotations.data(),
+                pose.scales.data());
+    }
+
+    void AddPose(AnimationPose& pose, const AnimationPose& additive, const AnimationPose& reference, float weight)
+    {
+        const std::size_t count = std::min(
+                pose.rotations.size(),
+                std::min(additive.rotations.size(), reference.rotations.size()));
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            pose.scales[i] += (additive.scales[i] - reference.scales[i]) * weight;
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const vec3& referenceRotation = reference.rotations[i];
+            const vec3& additiveRotation = additive.rotations[i];
+
+            // z is applied last, so a delta about z alone adds to the pose's z exactly
+            if (std::abs(shortestArc(referenceRotation.x, additiveRotation.x)) <= ANGLE_EPSILON
+                && std::abs(shortestArc(referenceRotation.y, additiveRotation.y)) <= ANGLE_EPSILON)
+            {
+                const float delta = shortestArc(referenceRotation.z, additiveRotation.z);
+
+                pose.rotations[i].z = wrapAngle(pose.rotations[i].z + (delta * weight));
+            }
+            else
+            {
+                // The delta is taken and applied in the bone's local space, scaled along its shortest arc
+                const Quaternion delta = multiply(
+                        conjugate(toQuaternion(referenceRotation)),
+                        toQuaternion(additiveRotation));
+
+                pose.rotations[i] = toEulerAngles(multiply(
+                        toQuaternion(pose.rotations[i]),
+                        slerp(Quaternion{1, 0, 0, 0}, delta, weight)));
+            }
+        }
+    }
+
+    void ComposePose(
+            const SkeletonLayout& skeleton,
+            const AnimationPose& pose,
+            const PoseOverrides& overrides,
+            std::vector<mat4>& palette)
+    {
+        const std::size_t count = skeleton.boneCount();
+
+        palette.resize(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (overrides.has(i))
+            {
+                palette[i] = overrides.transforms[i];
+            }
+            else
+            {
+                palette[i] = GfxMath::CreateTransformation(
+                        pose.rotations[i],
+                        pose.scales[i],
+                        skeleton.bindPositions[i]);
+            }
+
+            // Parents always precede children, so the parent's final transformation is already complete
+            if (skeleton.parentIndexes[i] >= 0)
+            {
+                palette[i] = palette[skeleton.parentIndexes[i]] * palette[i];
+            }
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vector>
+
+#include "puppetbox/DataStructures.h"
+#include "puppetbox/IAnimationCatalogue.h"
+
+namespace PB::PoseMath
+{
+    /**
+     * \brief Builds a flattened, parent first layout of the given skeleton.
+     *
+     * \param bones The skeletal data to build the layout from.
+     *
+     * \return The {\link SkeletonLayout} for the given skeleton.
+     */
+    SkeletonLayout BuildSkeletonLayout(BoneMap& bones);
+
+    /**
+     * \brief Interpolates between two angles about one axis along the shortest arc, wrapping the result to
+     * [0, 2PI).
+     *
+     * <p>Tweening each Euler axis on its own is only the shortest arc of the whole rotation when the
+     * rotations differ about a single axis, {\link Interpolate} handles the general case.</p>
+     *
+     * \param from  The angle to interpolate from, in radians.
+     * \param to    The angle to interpolate to, in radians.
+     * \param blend The blend factor between the two angles, 0 being from and 1 being to.
+     *
+     * \return The interpolated angle, in radians.
+     */
+    float TweenAngle(float from, float to, float blend);
+
+    /**
+     * \brief Interpolates a contiguous range of bone rotations and scales in one pass, using
+     * shortest arc interpolation for rotations and linear interpolation for scales.
+     *
+     * <p>Rotations differing about a single axis are tweened per axis, any others are slerped as
+     * quaternions and converted back to Euler angles, so the result may use a different but equivalent
+     * set of angles.</p>
+     *
+     * \param fromRotations The rotations to interpolate from.
+     * \param fromScales    The scales to interpolate from.
+     * \param toRotations   The rotations to interpolate to.
+     * \param toScales      The scales to interpolate to.
+     * \param blend         The blend factor, 0 being from and 1 being to.
+     * \param count         The number of bones in each range.
+     * \param outRotations  The range to write the interpolated rotations to.
+     * \param outScales     The range to write the interpolated scales to.
+     */
+    void Interpolate(
+            const vec3* fromRotations,
+            const vec3* fromScales,
+            const vec3* toRotations,
+            const vec3* toScales,
+            float blend,
+            std::size_t count,
+            vec3* outRotations,
+            vec3* outScales);
+
+    /**
+     * \brief Resizes the given pose to match the skeleton and fills it with the skeleton's bind pose.
+     *
+     * \param skeleton The skeleton to pull the bind pose from.
+     * \param pose     The pose to fill.
+     */
+    void LoadBindPose(const SkeletonLayout& skeleton, AnimationPose& pose);
+
+    /**
+     * \brief Blends the target pose into the given pose by the given weight.
+     *
+     * \param pose   The pose to blend into, holding the result.
+     * \param target The pose to blend towards.
+     * \param weight The blend weight, 0 keeping the pose as is, and 1 replacing it with the target.
+     */
+    void BlendPose(AnimationPose& pose, const AnimationPose& target, float weight);
+
+    /**
+     * \brief Applies the difference between an additive pose and its reference pose on top of
+     * the given pose.
+     *
+     * <p>The rotation difference is measured and applied in each bone's local space, and scaled by the
+     * weight along its shortest arc.</p>
+     *
+     * \param pose      The pose to apply the additive layer to, holding the result.
+     * \param additive  The sampled pose of the additive layer.
+     * \param reference The reference pose the additive layer is relative to.
+     * \param weight    The weight to apply the additive difference with.
+     */
+    void AddPose(AnimationPose& pose, const AnimationPose& additive, const AnimationPose& reference, float weight);
+
+    /**
+     * \brief Builds the final bone transformation matrices for the given local pose, compounding each
+     * bone with its parent.
+     *
+     * \param skeleton  The layout of the skeleton the pose belongs to.
+     * \param pose      The local pose to compose.
+     * \param overrides Local transformation overrides for bones that replace the pose.
+     * \param palette   The vector to write the final transformations to, indexed by {\link SkeletonLayout} order.
+     */
+    void ComposePose(
+            const SkeletonLayout& skeleton,
+            const AnimationPose& pose,
+            const PoseOverrides& overrides,
+            std::vector<mat4>& palette);
+}
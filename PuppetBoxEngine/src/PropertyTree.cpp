@@ -3,83 +3,234 @@
 #include <utility>
 
 #include "Logger.h"
+#include "Utilities.h"
 
 namespace PB
 {
-    PropertyTree::PropertyTree() : parent_(nullptr)
+    namespace
     {
+        /**
+        * \brief Helper function to count the indentation level of the given line.
+        *
+        * \param line	The line to calculate the indentation level for.
+        *
+        * \return The number of indentations prefixed on the given line.
+        */
+        std::uint32_t countIndents(std::string_view line)
+        {
+            std::uint32_t indentCount = 0;
 
-    }
+            while (indentCount < line.size() && line[indentCount] == ' ')
+            {
+                indentCount++;
+            }
 
-    PropertyTree::PropertyTree(std::string name, PropertyTree* parent) : name_(std::move(name)), parent_(parent)
-    {
+            return indentCount;
+        }
 
+        std::string lineError(const std::string& message, std::string_view line, std::uint32_t lineNumber)
+        {
+            return message + " '" + std::string(line) + "' on line " + std::to_string(lineNumber);
+        }
     }
 
-    Result<PropertyTree*> PropertyTree::get(const std::string& parameterName)
+    Result<PropertyTree*> PropertyTree::get(std::string_view parameterName) const
     {
-        if (children_.find(parameterName) != children_.end())
+        for (PropertyTree* child = firstChild_; child != nullptr; child = child->nextSibling_)
         {
-            return {&(*children_.at(parameterName)), true};
+            if (child->name_ == parameterName)
+            {
+                return {child, true};
+            }
         }
 
         return {nullptr, false};
     }
 
-    std::string PropertyTree::name()
+    std::string_view PropertyTree::name() const
     {
         return name_;
     }
 
-    std::string PropertyTree::value()
+    std::string_view PropertyTree::value() const
     {
-        if (children_.size() == 1 && children_.begin()->second->isLeaf())
+        if (childCount_ == 1 && firstChild_->isLeaf())
         {
-            return children_.begin()->second->name_;
+            return firstChild_->name_;
         }
 
         LOGGER_ERROR("Node does not have a singular child leaf node, no value to retrieve");
-        return "";
+        return {};
+    }
+
+    bool PropertyTree::has(std::string_view parameterName) const
+    {
+        return get(parameterName).hasResult;
     }
 
-    bool PropertyTree::has(const std::string& parameterName)
+    bool PropertyTree::isLeaf() const
     {
-        return children_.find(parameterName) != children_.end();
+        return firstChild_ == nullptr;
     }
 
-    bool PropertyTree::add(const std::string& parameterName)
+    std::uint32_t PropertyTree::childCount() const
     {
-        bool exists = has(parameterName);
+        return childCount_;
+    }
 
-        children_[parameterName] = std::make_shared<PropertyTree>(parameterName, this);
+    PropertyTree* PropertyTree::firstChild() const
+    {
+        return firstChild_;
+    }
+
+    PropertyTree* PropertyTree::nextSibling() const
+    {
+        return nextSibling_;
+    }
 
-        return !exists;
+    PropertyTree* PropertyTree::parent() const
+    {
+        return parent_;
     }
 
-    bool PropertyTree::remove(const std::string& parameterName)
+    PropertyDocument::PropertyDocument(std::string rootName) : rootName_(std::move(rootName))
     {
-        return children_.erase(parameterName) > 0;
+        root_.name_ = rootName_;
     }
 
-    bool PropertyTree::isLeaf()
+    PropertyTree& PropertyDocument::root()
     {
-        return children_.empty();
+        return root_;
     }
 
-    std::vector<std::string> PropertyTree::children()
+    PropertyTree* PropertyDocument::add(PropertyTree* parent, std::string_view name)
     {
-        std::vector<std::string> children{};
+        if (blockUsed_ == NODES_PER_BLOCK)
+        {
+            blocks_.push_back(std::make_unique<PropertyTree[]>(NODES_PER_BLOCK));
+            blockUsed_ = 0;
+        }
+
+        PropertyTree* node = &blocks_.back()[blockUsed_++];
+        node->name_ = name;
+        node->parent_ = parent;
 
-        for (auto itr = children_.begin(); itr != children_.end(); ++itr)
+        if (parent->lastChild_ != nullptr)
+        {
+            parent->lastChild_->nextSibling_ = node;
+        }
+        else
         {
-            children.push_back(itr->first);
+            parent->firstChild_ = node;
         }
 
-        return children;
+        parent->lastChild_ = node;
+        ++parent->childCount_;
+
+        return node;
     }
 
-    PropertyTree* PropertyTree::parent()
+    bool PropertyDocument::parse(std::string_view text)
     {
-        return parent_;
+        std::uint32_t lineNumber = 0;
+        PropertyTree* currentNode = &root_;
+        std::uint32_t minIndents = 0;
+        std::uint32_t maxIndents = 0;
+
+        while (!text.empty())
+        {
+            std::string_view line = StringUtils::nextLine(&text);
+            lineNumber++;
+
+            std::uint32_t indentLevel = countIndents(line);
+            line = StringUtils::trimView(line);
+
+            if (line.empty())
+            {
+                continue;
+            }
+
+            if (indentLevel % 2 != 0)
+            {
+                LOGGER_ERROR(lineError("Invalid indentation (odd spaces)", line, lineNumber));
+                return false;
+            }
+
+            if (indentLevel < minIndents || indentLevel > maxIndents)
+            {
+                LOGGER_ERROR(lineError("Unexpected indentation", line, lineNumber));
+                return false;
+            }
+
+            bool isList = line.front() == '-';
+
+            if (isList)
+            {
+                line = StringUtils::trimView(line.substr(1));
+            }
+
+            if (indentLevel < maxIndents)
+            {
+                if (isList)
+                {
+                    LOGGER_ERROR(lineError("Unexpected list item", line, lineNumber));
+                    return false;
+                }
+
+                for (std::uint32_t i = maxIndents; i > indentLevel; i -= 2)
+                {
+                    currentNode = currentNode->parent();
+                }
+            }
+
+            if (isList)
+            {
+                if (!currentNode->has(line))
+                {
+                    add(currentNode, line);
+                }
+
+                minIndents = 0;
+                maxIndents = indentLevel;
+            }
+            else
+            {
+                std::size_t separator = line.find(':');
+
+                if (separator == std::string_view::npos)
+                {
+                    LOGGER_ERROR(lineError("Invalid data", line, lineNumber));
+                    return false;
+                }
+
+                std::string_view name = StringUtils::trimView(line.substr(0, separator));
+                std::string_view value = StringUtils::trimView(line.substr(separator + 1));
+                Result<PropertyTree*> existing = currentNode->get(name);
+
+                if (value.empty())
+                {
+                    // A redefined parent property continues the existing one
+                    currentNode = existing.hasResult ? existing.result : add(currentNode, name);
+                    minIndents = indentLevel + 2;
+                    maxIndents = minIndents;
+                }
+                else
+                {
+                    minIndents = 0;
+                    maxIndents = indentLevel;
+
+                    if (!existing.hasResult)
+                    {
+                        add(add(currentNode, name), value);
+                    }
+                    else
+                    {
+                        LOGGER_WARN(lineError("Property redefinition, ignoring", line, lineNumber));
+                    }
+                }
+            }
+        }
+
+        return true;
     }
-}
\ No newline at end of file
+}
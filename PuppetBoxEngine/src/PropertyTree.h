@@ -1,42 +1,118 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 #include "puppetbox/DataStructures.h"
 
 namespace PB
 {
-    //TODO: Fix the way node values are stored/retrieved
+    /**
+    * \brief A node of a parsed {\link PropertyDocument}, either a named property with child nodes, or a leaf
+    * holding a value.  Nodes belong to their document, and their names are views into the document's source
+    * text, so neither may be used once the document or the text is gone.
+    */
     class PropertyTree
     {
     public:
-        PropertyTree();
+        /**
+        * \brief Gets the child node with the given name.
+        *
+        * \param parameterName The name of the child node.
+        *
+        * \return A {\link Result} holding the child node, or an empty {\link Result} if there is no such child.
+        */
+        Result<PropertyTree*> get(std::string_view parameterName) const;
 
-        explicit PropertyTree(std::string name, PropertyTree* parent = nullptr);
+        std::string_view name() const;
 
-        Result<PropertyTree*> get(const std::string& parameterName);
+        /**
+        * \brief Gets the value of a property, which is the name of its single leaf child.
+        *
+        * \return The value of the property, or an empty view if the node doesn't have a single leaf child.
+        */
+        std::string_view value() const;
 
-        std::string name();
+        bool has(std::string_view parameterName) const;
 
-        std::string value();
+        bool isLeaf() const;
 
-        bool has(const std::string& parameterName);
+        std::uint32_t childCount() const;
 
-        bool add(const std::string& parameterName);
+        /**
+        * \brief Gets the first child node, the rest are reached through {\link PropertyTree::nextSibling},
+        * in the order they appeared in the source text.
+        *
+        * \return The first child node, or nullptr if the node is a leaf.
+        */
+        PropertyTree* firstChild() const;
 
-        bool remove(const std::string& parameterName);
+        PropertyTree* nextSibling() const;
 
-        bool isLeaf();
+        PropertyTree* parent() const;
 
-        std::vector<std::string> children();
+    private:
+        friend class PropertyDocument;
+
+        std::string_view name_{};
+        PropertyTree* parent_ = nullptr;
+        PropertyTree* firstChild_ = nullptr;
+        PropertyTree* lastChild_ = nullptr;
+        PropertyTree* nextSibling_ = nullptr;
+        std::uint32_t childCount_ = 0;
+    };
+
+    /**
+    * \brief A property tree parsed from indented "name: value" text, with "- value" list items.
+    *
+    * <p>The text is tokenized in place, node names are views into it rather than copies, and the nodes are
+    * allocated in blocks from the document's own arena and released all at once with the document.  The
+    * source text must outlive the document.</p>
+    */
+    class PropertyDocument
+    {
+    public:
+        /**
+        * \brief Creates an empty document.
+        *
+        * \param rootName The name of the document's root node.
+        */
+        explicit PropertyDocument(std::string rootName);
 
-        PropertyTree* parent();
+        PropertyDocument(const PropertyDocument&) = delete;
+
+        PropertyDocument& operator=(const PropertyDocument&) = delete;
+
+        /**
+        * \brief Parses the given text into the document, adding to the nodes already under the root.
+        *
+        * \param text The text to parse, which must outlive the document.
+        *
+        * \return True if the text was successfully parsed, False otherwise.
+        */
+        bool parse(std::string_view text);
+
+        PropertyTree& root();
+
+        /**
+        * \brief Adds a new child node with the given name under the given parent node.
+        *
+        * \param parent The node to add the child to.
+        * \param name   The name of the child, which must outlive the document.
+        *
+        * \return The added child node.
+        */
+        PropertyTree* add(PropertyTree* parent, std::string_view name);
 
     private:
-        std::string name_;
-        std::unordered_map<std::string, std::shared_ptr<PropertyTree>> children_{};
-        PropertyTree* parent_;
+        static constexpr std::uint32_t NODES_PER_BLOCK = 256;
+
+        std::string rootName_;
+        PropertyTree root_{};
+        std::vector<std::unique_ptr<PropertyTree[]>> blocks_{};
+        std::uint32_t blockUsed_ = NODES_PER_BLOCK;
     };
-}
\ No newline at end of file
+}
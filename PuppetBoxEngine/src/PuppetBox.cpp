@@ -5,15 +5,19 @@
 #include "puppetbox/KeyCode.h"
 
 #include "AnimationCatalogue.h"
+#include "AssetCooker.h"
 #include "AssetLibrary.h"
+#include "AssetStreamer.h"
 #include "Engine.h"
 #include "EventDef.h"
 #include "FontLoader.h"
 #include "MessageBroker.h"
 #include "OpenGLGfxApi.h"
+#include "RecordingGfxApi.h"
 #include "Sdl2Initializer.h"
 #include "Sdl2InputReader.h"
 #include "UIComponents.h"
+#include "WorkerPool.h"
 
 namespace PB
 {
@@ -26,8 +30,14 @@ namespace PB
         FontLoader fontLoader{nullptr};
         AnimationCatalogue animationCatalogue{nullptr};
         std::shared_ptr<AssetLibrary> assetLibrary{nullptr};
+        std::shared_ptr<WorkerPool> workerPool{nullptr};
+        std::shared_ptr<AssetStreamer> assetStreamer{nullptr};
         bool pbInitialized = false;
         bool engineInitialized = false;
+        bool renderThreadEnabled = false;
+        bool recordedRendering = false;
+        /** The engine while it's running, to take the GFX API context for synchronous loads */
+        Engine* runningEngine = nullptr;
 
         /**
         * \brief Used to map scan codes to the actual ascii characters
@@ -59,15 +69,52 @@ namespace PB
         }
 
         /**
-        * \brief Helper function that provides a default IGfxApi implementation.
+        * \brief Helper function that provides a default IGfxApi implementation, the recording one if frames
+        * are to be recorded.
         *
         * \return A IGfxApi implementation.
         */
         std::shared_ptr<IGfxApi> defaultGfxApi()
         {
+            if (recordedRendering)
+            {
+                return std::make_shared<RecordingGfxApi>();
+            }
+
             return std::make_shared<OpenGLGfxApi>();
         }
 
+        /**
+        * \brief Makes the GFX API context current for a synchronous load, taking it from the render thread if
+        * frames are drawn on one, which stalls the render thread until {\link ReleaseLoadContext}.
+        *
+        * \param caller The public function loading, named in the error logged if the context can't be taken.
+        *
+        * \return True if the load can go ahead, in which case ReleaseLoadContext must be called after it.
+        */
+        bool AcquireLoadContext(const std::string& caller)
+        {
+            if (runningEngine == nullptr || runningEngine->acquireContext())
+            {
+                return true;
+            }
+
+            LOGGER_ERROR(caller + " must be called from the main thread");
+
+            return false;
+        }
+
+        /**
+        * \brief Gives back the GFX API context taken by {\link AcquireLoadContext}.
+        */
+        void ReleaseLoadContext()
+        {
+            if (runningEngine != nullptr)
+            {
+                runningEngine->releaseContext();
+            }
+        }
+
         /**
         * \brief Initializes the char map with the desired mappings of arbitrary key codes to specific ascii characters.
         */
@@ -232,12 +279,16 @@ namespace PB
 
             pbInitialized = true;
 
+            workerPool = std::make_shared<WorkerPool>();
+            workerPool->start();
+
             //TODO: Using globally instanced font loader?
             assetLibrary = std::make_shared<AssetLibrary>("../", gfxApi, &fontLoader);
 
             if (assetLibrary->init())
             {
-                animationCatalogue = AnimationCatalogue(assetLibrary);
+                animationCatalogue = AnimationCatalogue(assetLibrary, workerPool);
+                assetStreamer = std::make_shared<AssetStreamer>(assetLibrary, workerPool);
 
                 fontLoader = FontLoader{gfxApi};
                 LOGGER_DEBUG("FontLoader initialized");
@@ -283,10 +334,24 @@ namespace PB
         return assetLibrary->loadArchive(archiveName);
     }
 
+    bool CookAssetPack(const std::string& archiveRoot, const std::string& archiveName)
+    {
+        AssetCooker cooker{archiveName, archiveRoot};
+        return cooker.cook();
+    }
+
     bool LoadFontAsset(const std::string& fontPath, std::uint8_t fontSize)
     {
+        if (!AcquireLoadContext("LoadFontAsset"))
+        {
+            return false;
+        }
+
         bool error = false;
         assetLibrary->loadFontAsset(fontPath, fontSize, &error);
+
+        ReleaseLoadContext();
+
         return !error;
     }
 
@@ -304,14 +369,102 @@ namespace PB
             success = false;
             LOGGER_ERROR("SceneObject must be instantiated prior to invoking CreateSceneObject");
         }
+        else if (!AcquireLoadContext("CreateSceneObject"))
+        {
+            success = false;
+        }
         else
         {
             success = assetLibrary->loadSceneObject(assetPath, sceneObject, uuid, &animationCatalogue);
+            ReleaseLoadContext();
         }
 
         return success;
     }
 
+    PreloadHandle CreateSceneObjectAsync(const std::string& assetPath, SceneObject* sceneObject)
+    {
+        return CreateSceneObjectAsync(assetPath, sceneObject, RandomUtils::uuid());
+    }
+
+    PreloadHandle CreateSceneObjectAsync(const std::string& assetPath, SceneObject* sceneObject, UUID uuid)
+    {
+        return assetStreamer->loadSceneObject(assetPath, sceneObject, uuid, &animationCatalogue);
+    }
+
+    void SetAssetUploadBudget(float milliseconds, std::uint64_t bytes)
+    {
+        assetStreamer->setUploadBudget(milliseconds, bytes);
+    }
+
+    void SetAssetMemoryBudget(std::uint64_t cpuBytes, std::uint64_t gpuBytes)
+    {
+        assetLibrary->setMemoryBudget(cpuBytes, gpuBytes);
+    }
+
+    void SetRecordedRendering(bool enabled)
+    {
+        recordedRendering = enabled;
+    }
+
+    void SetRenderThreadEnabled(bool enabled)
+    {
+        renderThreadEnabled = enabled;
+    }
+
+    std::vector<ResidentAsset> GetResidentAssets()
+    {
+        return assetLibrary->residentAssets();
+    }
+
+    RenderStats GetRenderStats()
+    {
+        return gfxApi->lastFrameStats();
+    }
+
+    bool ShowRenderStatsOverlay(const std::string& fontPath, std::uint32_t fontSize)
+    {
+        if (!engineInitialized)
+        {
+            LOGGER_ERROR("The render stats overlay can't be shown until after the engine is running");
+            return false;
+        }
+
+        std::unique_ptr<UIComponentAttributes> attributes = UIComponent::createUIComponentAttributes();
+        attributes->setUIntAttribute(UI::ORIGIN, UI::Origin::TOP_LEFT);
+        attributes->setUIntAttribute(UI::POS_X, 10);
+        attributes->setUIntAttribute(UI::POS_Y, *gfxApi->getRenderWindow().height - 10);
+        // In front of any scene UI
+        attributes->setUIntAttribute(UI::POS_Z, 100);
+        // Wide enough for the longest line, and tall enough for all five
+        attributes->setUIntAttribute(UI::WIDTH, fontSize * 30);
+        attributes->setUIntAttribute(UI::HEIGHT, fontSize * 6);
+        attributes->setUIntAttribute(UI::FONT_SIZE, fontSize);
+        attributes->setStringAttribute(UI::FONT_TYPE, fontPath);
+
+        bool error = false;
+        std::shared_ptr<UIComponent> overlay{CreateUIComponent(UI::TEXT_AREA, std::move(attributes), &error)};
+
+        if (!error)
+        {
+            auto event = std::make_shared<EngineStatsOverlayEvent>();
+            event->overlay = overlay;
+            MessageBroker::instance().publish(Event::Topic::ENGINE_STATS_OVERLAY_TOPIC, event);
+        }
+
+        return !error;
+    }
+
+    void HideRenderStatsOverlay()
+    {
+        if (engineInitialized)
+        {
+            MessageBroker::instance().publish(
+                    Event::Topic::ENGINE_STATS_OVERLAY_TOPIC,
+                    std::make_shared<EngineStatsOverlayEvent>());
+        }
+    }
+
     bool LoadAnimationsPack(const std::string& assetPath)
     {
         return animationCatalogue.load(assetPath);
@@ -322,19 +475,35 @@ namespace PB
         return animationCatalogue.preloadAnimation(boneMap, animationPath);
     }
 
+    PreloadHandle PreloadAnimationFramesAsync(const std::string& animationPath, BoneMap& boneMap)
+    {
+        return animationCatalogue.preloadAnimationAsync(boneMap, animationPath);
+    }
+
+    void SetAnimationSamplingSteps(std::uint32_t stepsPerFrame)
+    {
+        animationCatalogue.setStepsPerFrame(stepsPerFrame);
+    }
+
     void Run(std::function<bool()> onReady)
     {
         if (pbInitialized)
         {
-            Engine engine{gfxApi, hardwareInitializer, inputReader};
+            Engine engine{gfxApi, hardwareInitializer, inputReader, assetStreamer, assetLibrary, &animationCatalogue};
 
             engine.init();
+            engine.setRenderThreadEnabled(renderThreadEnabled);
 
             engineInitialized = true;
+            runningEngine = &engine;
 
             engine.run(onReady);
 
+            runningEngine = nullptr;
+
             engine.shutdown();
+
+            workerPool->stop();
         }
         else
         {
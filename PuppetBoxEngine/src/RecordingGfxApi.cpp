@@ -0,0 +1,541 @@
+#include "RecordingGfxApi.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include "BinaryFormat.h"
+#include "Logger.h"
+#include "MeshArena.h"
+#include "MeshOptimizer.h"
+
+namespace PB
+{
+    namespace
+    {
+        /**
+        * \brief Matches the OpenGL backend, so welded meshes get the same draw counts.
+        */
+        constexpr float VERTEX_WELD_EPSILON = 0.0000001f;
+
+        /**
+        * \brief Matches the OpenGL backend, so glyph atlases get the same layout.
+        */
+        constexpr std::uint32_t MAX_ATLAS_COLUMNS = 512;
+
+        /**
+        * \brief Hashes data recorded with a command, so serialized frames show when it changes without
+        * holding all of it.
+        *
+        * \param bytes  The data to hash.
+        * \param length The number of bytes to hash.
+        *
+        * \return The hash, as 16 hex digits.
+        */
+        std::string hexHash(const std::uint8_t* bytes, std::size_t length)
+        {
+            static const char* HEX_DIGITS = "0123456789abcdef";
+
+            std::uint64_t hash = BinaryFormat::hashBytes(bytes, length);
+
+            std::string hex(16, '0');
+
+            for (std::int32_t i = 15; i >= 0; --i)
+            {
+                hex[i] = HEX_DIGITS[hash & 0xF];
+                hash >>= 4;
+            }
+
+            return hex;
+        }
+
+        /**
+        * \brief Reads the vertex attribute locations declared with "layout (location = N) in type name;" in
+        * the given vertex shader source, the only way the engine's shaders place their attributes.
+        *
+        * \param vertexCode The vertex shader source.
+        * \param uniforms   The table to add the attribute locations to.
+        */
+        void readAttributeLocations(const std::string& vertexCode, UniformTable& uniforms)
+        {
+            std::istringstream lines{vertexCode};
+            std::string line;
+
+            while (std::getline(lines, line))
+            {
+                const std::size_t layout = line.find("layout");
+                const std::size_t location = line.find("location", layout);
+                const std::size_t close = line.find(')', location);
+
+                if (layout == std::string::npos || location == std::string::npos || close == std::string::npos)
+                {
+                    continue;
+                }
+
+                const std::size_t equals = line.find('=', location);
+                std::istringstream declaration{line.substr(close + 1)};
+                std::string qualifier;
+                std::string type;
+                std::string name;
+
+                if (equals < close && declaration >> qualifier >> type >> name && qualifier == "in")
+                {
+                    name = name.substr(0, name.find(';'));
+                    uniforms.attributeLocations[name] = std::stoi(line.substr(equals + 1, close - equals - 1));
+                }
+            }
+        }
+
+        /**
+        * \brief Gets the size of the values of a SET_UNIFORM command.
+        *
+        * \param command The SET_UNIFORM command.
+        *
+        * \return The number of bytes of the command's values.
+        */
+        std::uint32_t uniformSize(const RenderCommand& command)
+        {
+            std::uint32_t components;
+
+            switch (command.setUniform.uniformType)
+            {
+                case UniformType::VEC2:
+                    components = 2;
+                    break;
+                case UniformType::VEC3:
+                    components = 3;
+                    break;
+                case UniformType::VEC4:
+                    components = 4;
+                    break;
+                case UniformType::MAT4:
+                    components = 16;
+                    break;
+                default:
+                    components = 1;
+                    break;
+            }
+
+            return components * command.setUniform.count * 4;
+        }
+
+        /**
+        * \brief Serializes a single command as one line of text.
+        *
+        * \param command     The command to serialize.
+        * \param commandList The list the command was recorded into.
+        *
+        * \return The serialized command, ending in a new line.
+        */
+        std::string serialize(const RenderCommand& command, const CommandList& commandList)
+        {
+            static const char* UNIFORM_TYPES[] = {"INT", "UINT", "FLOAT", "VEC2", "VEC3", "VEC4", "MAT4"};
+            static const char* UPLOAD_USAGES[] = {"INSTANCE_DATA", "UNIFORM_BLOCK", "INDIRECT_COMMANDS"};
+
+            switch (command.type)
+            {
+                case RenderCommandType::USE_PROGRAM:
+                    return "USE_PROGRAM " + std::to_string(command.useProgram.programId) + "\n";
+                case RenderCommandType::BIND_TEXTURE:
+                    return "BIND_TEXTURE " + std::to_string(command.bindTexture.slot) + " "
+                           + std::to_string(command.bindTexture.textureId) + "\n";
+                case RenderCommandType::BIND_VERTEX_ARRAY:
+                    return "BIND_VERTEX_ARRAY " + std::to_string(command.bindVertexArray.vertexArrayId) + "\n";
+                case RenderCommandType::SET_BLENDING:
+                    return std::string("SET_BLENDING ") + (command.setBlending.enabled ? "1" : "0") + "\n";
+                case RenderCommandType::SET_UNIFORM:
+                    return "SET_UNIFORM " + std::to_string(command.setUniform.location) + " "
+                           + UNIFORM_TYPES[static_cast<std::uint8_t>(command.setUniform.uniformType)] + " "
+                           + std::to_string(command.setUniform.count) + " "
+                           + hexHash(commandList.data(command.setUniform.dataOffset), uniformSize(command)) + "\n";
+                case RenderCommandType::UPLOAD:
+                    return std::string("UPLOAD ")
+                           + UPLOAD_USAGES[static_cast<std::uint8_t>(command.upload.usage)] + " "
+                           + std::to_string(command.upload.size) + " "
+                           + hexHash(commandList.data(command.upload.dataOffset), command.upload.size) + "\n";
+                case RenderCommandType::BIND_UNIFORM_RANGE:
+                    return "BIND_UNIFORM_RANGE " + std::to_string(command.bindUniformRange.binding) + " "
+                           + std::to_string(command.bindUniformRange.offset) + " "
+                           + std::to_string(command.bindUniformRange.size) + "\n";
+                case RenderCommandType::SET_INSTANCE_ATTRIBUTE:
+                    return "SET_INSTANCE_ATTRIBUTE " + std::to_string(command.setInstanceAttribute.location) + " "
+                           + std::to_string(command.setInstanceAttribute.components) + " "
+                           + std::to_string(command.setInstanceAttribute.stride) + " "
+                           + std::to_string(command.setInstanceAttribute.offset) + "\n";
+                case RenderCommandType::CLEAR_INSTANCE_ATTRIBUTE:
+                    return "CLEAR_INSTANCE_ATTRIBUTE " + std::to_string(command.clearInstanceAttribute.location) + "\n";
+                case RenderCommandType::DRAW:
+                    return "DRAW " + std::to_string(command.draw.count) + " "
+                           + std::to_string(command.draw.indexSize) + " "
+                           + std::to_string(command.draw.instanceCount) + " "
+                           + std::to_string(command.draw.firstIndex) + " "
+                           + std::to_string(command.draw.baseVertex) + "\n";
+                case RenderCommandType::MULTI_DRAW_INDIRECT:
+                    return "MULTI_DRAW_INDIRECT " + std::to_string(command.multiDrawIndirect.drawCount) + " "
+                           + std::to_string(command.multiDrawIndirect.indexSize) + "\n";
+                case RenderCommandType::BEGIN_PASS:
+                    return "BEGIN_PASS " + std::to_string(static_cast<std::uint32_t>(command.beginPass.pass)) + "\n";
+                case RenderCommandType::END_PASS:
+                    return "END_PASS\n";
+            }
+
+            return "UNKNOWN\n";
+        }
+    }
+
+    bool RecordingGfxApi::init(const PB::ProcAddress procAddress)
+    {
+        LOGGER_INFO("Recording gfx API initialized, frames will be counted but not drawn");
+
+        return true;
+    }
+
+    void RecordingGfxApi::preLoopCommands(std::uint32_t width, std::uint32_t height) const
+    {
+        frameStats_ = RenderStats{};
+        frame_.clear();
+    }
+
+    void RecordingGfxApi::postLoopCommands() const
+    {
+        frameStats_.resourceUploadedBytes = resourceUploadedBytes_.exchange(0);
+
+        {
+            std::unique_lock<std::mutex> mlock(statsMutex_);
+            lastFrameStats_ = frameStats_;
+        }
+
+        lastFrame_.swap(frame_);
+    }
+
+    void RecordingGfxApi::setRenderDimensions(std::uint32_t width, std::uint32_t height)
+    {
+        width_ = width;
+        height_ = height;
+    }
+
+    void RecordingGfxApi::setRenderDistance(std::uint32_t distance)
+    {
+        distance_ = distance;
+    }
+
+    const RenderWindow RecordingGfxApi::getRenderWindow()
+    {
+        return RenderWindow{
+                &width_,
+                &height_,
+                &distance_
+        };
+    }
+
+    ImageReference RecordingGfxApi::loadImage(ImageData imageData, ImageOptions options) const
+    {
+        ImageReference imageReference{0};
+
+        if (imageData.bufferData)
+        {
+            imageReference = ImageReference{nextId()};
+            countResourceUpload(imageData.byteSize());
+        }
+
+        return imageReference;
+    }
+
+    void RecordingGfxApi::freeImage(ImageReference& image) const
+    {
+        image = ImageReference{0};
+    }
+
+    bool RecordingGfxApi::buildCharacterMap(
+            FT_Face face,
+            std::unordered_map<std::int8_t, TypeCharacter>& loadedCharacters) const
+    {
+        const std::uint32_t MAX_CHARACTERS = 128;
+
+        uivec2 nextAtlasPosition{};
+        std::uint32_t atlasHeight = 0;
+        TypeCharacter typeCharacters[MAX_CHARACTERS];
+
+        bool success = true;
+
+        for (std::uint8_t c = 0; success && c < MAX_CHARACTERS; ++c)
+        {
+            if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+            {
+                success = false;
+                LOGGER_ERROR("Failed to load glyph for '" + std::to_string(static_cast<char>(c)) + "'");
+            }
+            else
+            {
+                std::uint32_t bitmapWidth = face->glyph->bitmap.width;
+                std::uint32_t bitmapHeight = face->glyph->bitmap.rows;
+
+                // Check if we're overrunning the atlas row width
+                if (nextAtlasPosition.x + bitmapWidth > MAX_ATLAS_COLUMNS)
+                {
+                    nextAtlasPosition.y = atlasHeight;
+                    nextAtlasPosition.x = 0;
+                }
+
+                atlasHeight = std::max(atlasHeight, nextAtlasPosition.y + bitmapHeight);
+
+                typeCharacters[c] = TypeCharacter{
+                        c,
+                        ImageReference{0},
+                        {bitmapWidth, bitmapHeight},
+                        nextAtlasPosition,
+                        {face->glyph->bitmap_left, face->glyph->bitmap_top},
+                        static_cast<std::uint32_t>(face->glyph->advance.x)
+                };
+
+                nextAtlasPosition.x += bitmapWidth;
+            }
+        }
+
+        countResourceUpload(static_cast<std::uint64_t>(atlasHeight) * MAX_ATLAS_COLUMNS);
+
+        ImageReference imageReference{nextId()};
+        imageReference.width = MAX_ATLAS_COLUMNS;
+        imageReference.height = atlasHeight;
+        imageReference.requiresAlphaBlending = true;
+
+        for (auto tChar: typeCharacters)
+        {
+            tChar.image = imageReference;
+            loadedCharacters.insert(
+                    std::pair<std::int8_t, TypeCharacter>{tChar.character, tChar}
+            );
+        }
+
+        return success;
+    }
+
+    Mesh RecordingGfxApi::loadMesh(Vertex* vertexData, std::uint32_t vertexCount) const
+    {
+        Mesh mesh{};
+
+        // 3 axis position, +3 axis normal, +2 axis UV coord
+        mesh.stride = 3 + 3 + 2;
+
+        std::vector<float> vertices{};
+        vertices.reserve(static_cast<std::size_t>(vertexCount) * mesh.stride);
+
+        for (std::uint32_t i = 0; i < vertexCount; ++i)
+        {
+            const Vertex& v = vertexData[i];
+            vertices.insert(vertices.end(), {
+                    v.position.x, v.position.y, v.position.z,
+                    v.normal.x, v.normal.y, v.normal.z,
+                    v.uv.x, v.uv.y
+            });
+        }
+
+        std::vector<float> vboData{};
+        std::vector<std::uint32_t> indices{};
+        MeshOptimizer::weldVertices(&vertices[0], vertexCount, mesh.stride, VERTEX_WELD_EPSILON, vboData, indices);
+
+        if (addToArena(MeshFormat::standardMeshBuffer(vboData, indices), mesh))
+        {
+            return mesh;
+        }
+
+        mesh.VAO = nextId();
+        mesh.VBO = nextId();
+        mesh.EBO = nextId();
+        mesh.drawCount = static_cast<std::int32_t>(indices.size());
+        mesh.indexSize = sizeof(std::uint32_t);
+        mesh.byteSize = (sizeof(vboData[0]) * vboData.size()) + (sizeof(indices[0]) * indices.size());
+        countResourceUpload(mesh.byteSize);
+
+        return mesh;
+    }
+
+    Mesh RecordingGfxApi::loadMesh(const MeshFormat::MeshBuffer& meshBuffer) const
+    {
+        Mesh mesh{};
+
+        if (addToArena(meshBuffer, mesh))
+        {
+            return mesh;
+        }
+
+        mesh.stride = meshBuffer.vertexStride / sizeof(float);
+        mesh.byteSize = (static_cast<std::uint64_t>(meshBuffer.vertexCount) * meshBuffer.vertexStride)
+                        + (static_cast<std::uint64_t>(meshBuffer.indexCount) * meshBuffer.indexSize);
+        mesh.VAO = nextId();
+        mesh.VBO = nextId();
+
+        if (meshBuffer.indexCount > 0)
+        {
+            mesh.EBO = nextId();
+            mesh.indexSize = meshBuffer.indexSize;
+            mesh.drawCount = static_cast<std::int32_t>(meshBuffer.indexCount);
+        }
+        else
+        {
+            mesh.drawCount = static_cast<std::int32_t>(meshBuffer.vertexCount);
+        }
+
+        countResourceUpload(mesh.byteSize);
+
+        return mesh;
+    }
+
+    void RecordingGfxApi::freeMesh(Mesh& mesh) const
+    {
+        mesh.inArena = false;
+        mesh.baseVertex = 0;
+        mesh.firstIndex = 0;
+        mesh.vertexCount = 0;
+        mesh.VAO = 0;
+        mesh.VBO = 0;
+        mesh.EBO = 0;
+        mesh.drawCount = 0;
+        mesh.byteSize = 0;
+    }
+
+    bool RecordingGfxApi::beginShader(
+            Shader& shader,
+            const std::string& vertexCode,
+            const std::string& geometryCode,
+            const std::string& fragmentCode) const
+    {
+        auto uniforms = std::make_shared<UniformTable>();
+        readAttributeLocations(vertexCode, *uniforms);
+        shader.initHeadless(nextId(), uniforms);
+
+        return true;
+    }
+
+    bool RecordingGfxApi::isShaderReady(const Shader& shader) const
+    {
+        return true;
+    }
+
+    bool RecordingGfxApi::finishShader(Shader& shader) const
+    {
+        return shader.id() != 0;
+    }
+
+    bool RecordingGfxApi::supportsShaderBinaries() const
+    {
+        return false;
+    }
+
+    bool RecordingGfxApi::loadShaderBinary(Shader& shader, const ShaderBinary& binary) const
+    {
+        return false;
+    }
+
+    bool RecordingGfxApi::getShaderBinary(const Shader& shader, ShaderBinary* binary) const
+    {
+        return false;
+    }
+
+    void RecordingGfxApi::freeShader(Shader& shader) const
+    {
+        shader.destroy();
+    }
+
+    void RecordingGfxApi::initializeUBORanges()
+    {
+
+    }
+
+    void RecordingGfxApi::invalidateState() const
+    {
+
+    }
+
+    void RecordingGfxApi::submit(const CommandList& commandList) const
+    {
+        commandList.addStats(frameStats_);
+
+        if (captureFrames_)
+        {
+            for (const RenderCommand& command: commandList.commands())
+            {
+                frame_ += serialize(command, commandList);
+            }
+        }
+    }
+
+    bool RecordingGfxApi::initGfxDebug() const
+    {
+        return false;
+    }
+
+    std::string RecordingGfxApi::driverId() const
+    {
+        return "PuppetBox|Recording";
+    }
+
+    RenderStats RecordingGfxApi::lastFrameStats() const
+    {
+        std::unique_lock<std::mutex> mlock(statsMutex_);
+
+        return lastFrameStats_;
+    }
+
+    void RecordingGfxApi::shutdown()
+    {
+
+    }
+
+    void RecordingGfxApi::setCaptureFrames(bool capture)
+    {
+        captureFrames_ = capture;
+    }
+
+    const std::string& RecordingGfxApi::lastFrame() const
+    {
+        return lastFrame_;
+    }
+
+    bool RecordingGfxApi::addToArena(const MeshFormat::MeshBuffer& meshBuffer, Mesh& mesh) const
+    {
+        if (!MeshArena::accepts(meshBuffer))
+        {
+            return false;
+        }
+
+        if (arenaVertexArrayId_ == 0)
+        {
+            arenaVertexArrayId_ = nextId();
+            arenaVertexBufferId_ = nextId();
+            arenaIndexBufferId_ = nextId();
+        }
+
+        const std::uint32_t indexCount = meshBuffer.indexCount > 0 ? meshBuffer.indexCount : meshBuffer.vertexCount;
+
+        mesh.VAO = arenaVertexArrayId_;
+        mesh.VBO = arenaVertexBufferId_;
+        mesh.EBO = arenaIndexBufferId_;
+        mesh.inArena = true;
+        mesh.stride = meshBuffer.vertexStride / sizeof(float);
+        mesh.indexSize = sizeof(std::uint16_t);
+        mesh.baseVertex = static_cast<std::int32_t>(arenaVertices_);
+        mesh.vertexCount = meshBuffer.vertexCount;
+        mesh.firstIndex = arenaIndices_;
+        mesh.drawCount = static_cast<std::int32_t>(indexCount);
+        mesh.byteSize = (static_cast<std::uint64_t>(meshBuffer.vertexCount) * meshBuffer.vertexStride)
+                        + (static_cast<std::uint64_t>(indexCount) * sizeof(std::uint16_t));
+
+        arenaVertices_ += meshBuffer.vertexCount;
+        arenaIndices_ += indexCount;
+
+        countResourceUpload(mesh.byteSize);
+
+        return true;
+    }
+
+    void RecordingGfxApi::countResourceUpload(std::uint64_t bytes) const
+    {
+        resourceUploadedBytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    std::uint32_t RecordingGfxApi::nextId() const
+    {
+        return ++lastId_;
+    }
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "puppetbox/DataStructures.h"
+#include "puppetbox/RenderWindow.h"
+
+#include "CommandList.h"
+#include "IGfxApi.h"
+#include "ImageOptions.h"
+#include "ImageReference.h"
+#include "Mesh.h"
+#include "TypeDef.h"
+
+namespace PB
+{
+    /**
+    * \brief Headless {\link IGfxApi} implementation that draws nothing, but counts the commands submitted to it
+    * each frame and can serialize them, so rendering cost can be measured and regressions checked without a GPU.
+    *
+    * <p>Loaded resources are given IDs and sizes as the OpenGL backend would, without any gfx memory behind
+    * them.  Meshes the OpenGL backend would put in its mesh arena share one set of IDs, with ranges handed out one
+    * after the other and never reused.</p>
+    *
+    * <p>Shader programs are given IDs without being compiled, and serve uniform lookups headlessly, with the
+    * vertex attribute locations declared in their vertex shader source.</p>
+    */
+    class RecordingGfxApi : public IGfxApi
+    {
+    public:
+        /**
+        * \brief Initializes the backend, which needs no gfx API function pointers.
+        *
+        * \param procAddress Ignored.
+        *
+        * \return Always True.
+        */
+        bool init(PB::ProcAddress procAddress) override;
+
+        /**
+        * \brief Starts counting the commands of a new frame.
+        *
+        * \param width  Ignored.
+        * \param height Ignored.
+        */
+        void preLoopCommands(std::uint32_t width, std::uint32_t height) const override;
+
+        /**
+        * \brief Finishes the frame, making its counts and serialized commands available.
+        */
+        void postLoopCommands() const override;
+
+        void setRenderDimensions(std::uint32_t width, std::uint32_t height) override;
+
+        void setRenderDistance(std::uint32_t distance) override;
+
+        const RenderWindow getRenderWindow() override;
+
+        /**
+        * \brief Gives the image an ID, without loading it anywhere.
+        *
+        * \param imageData The image data to give an ID.
+        * \param options   Ignored.
+        *
+        * \return Reference to the image, with an ID of 0 if there was no image data.
+        */
+        ImageReference loadImage(ImageData imageData, ImageOptions options) const override;
+
+        void freeImage(ImageReference& image) const override;
+
+        /**
+        * \brief Lays out the glyphs of the given font face in an atlas, as the OpenGL backend would, without
+        * creating the atlas image.
+        *
+        * \param face             The font face to lay out the glyphs of.
+        * \param loadedCharacters The map to store the laid out glyphs in.
+        *
+        * \return True if every glyph was loaded, False otherwise.
+        */
+        bool buildCharacterMap(
+                FT_Face face,
+                std::unordered_map<std::int8_t, TypeCharacter>& loadedCharacters) const override;
+
+        /**
+        * \brief Welds the vertices of the mesh, as the OpenGL backend would, to give the mesh the same draw
+        * count, without loading it anywhere.
+        *
+        * \param vertexData  The vertex data of the mesh.
+        * \param vertexCount The number of entries in the vertexData array.
+        *
+        * \return The mesh, with IDs but no gfx memory behind them.
+        */
+        Mesh loadMesh(Vertex* vertexData, std::uint32_t vertexCount) const override;
+
+        Mesh loadMesh(const MeshFormat::MeshBuffer& meshBuffer) const override;
+
+        void freeMesh(Mesh& mesh) const override;
+
+        /**
+        * \brief Gives the shader program an ID and a headless uniform table, reading its vertex attribute
+        * locations from the layout qualifiers of the vertex shader source, without compiling anything.
+        *
+        * \param shader       The shader program to set up.
+        * \param vertexCode   The vertex shader source, read for its attribute locations.
+        * \param geometryCode Ignored.
+        * \param fragmentCode Ignored.
+        *
+        * \return Always True.
+        */
+        bool beginShader(
+                Shader& shader,
+                const std::string& vertexCode,
+                const std::string& geometryCode,
+                const std::string& fragmentCode) const override;
+
+        bool isShaderReady(const Shader& shader) const override;
+
+        bool finishShader(Shader& shader) const override;
+
+        /**
+        * \brief Headless shader programs have no binaries to cache.
+        *
+        * \return Always False.
+        */
+        bool supportsShaderBinaries() const override;
+
+        bool loadShaderBinary(Shader& shader, const ShaderBinary& binary) const override;
+
+        bool getShaderBinary(const Shader& shader, ShaderBinary* binary) const override;
+
+        void freeShader(Shader& shader) const override;
+
+        void initializeUBORanges() override;
+
+        void invalidateState() const override;
+
+        /**
+        * \brief Counts the commands of the given list towards the current frame, serializing them if frame
+        * capturing is enabled.
+        *
+        * \param commandList The commands to count.
+        */
+        void submit(const CommandList& commandList) const override;
+
+        bool initGfxDebug() const override;
+
+        std::string driverId() const override;
+
+        /**
+        * \brief Gets the counts of the last finished frame.  No GPU time is measured, and no calls are elided.
+        *
+        * \return The counts of the last finished frame.
+        */
+        RenderStats lastFrameStats() const override;
+
+        void shutdown() override;
+
+        /**
+        * \brief Enables serializing the commands of each frame, one command per line, with any uniform values
+        * or uploaded data they carry replaced by a hash.
+        *
+        * \param capture True to serialize frames, False otherwise.
+        */
+        void setCaptureFrames(bool capture);
+
+
+        /**
+        * \brief Gets the serialized commands of the last finished frame.
+        *
+        * \return The commands of the last finished frame, empty if frames aren't being captured.
+        */
+        const std::string& lastFrame() const;
+
+    private:
+        /**
+        * \brief Hands out the next resource ID, starting at 1 so no resource gets the "none" ID of 0.
+        *
+        * \return The next resource ID.
+        */
+        std::uint32_t nextId() const;
+
+        /**
+        * \brief Gives the mesh the arena's IDs and the next ranges of it, if the OpenGL backend would put it in
+        * its mesh arena.
+        *
+        * \param meshBuffer The mesh buffer of the mesh.
+        * \param mesh       The mesh to set the arena's IDs and ranges on.
+        *
+        * \return True if the mesh was put in the arena, False otherwise.
+        */
+        bool addToArena(const MeshFormat::MeshBuffer& meshBuffer, Mesh& mesh) const;
+
+        /**
+        * \brief Counts bytes of a mesh or image the OpenGL backend would upload, to report with the next
+        * finished frame.
+        *
+        * \param bytes The number of bytes uploaded.
+        */
+        void countResourceUpload(std::uint64_t bytes) const;
+
+    private:
+        std::uint32_t width_ = 0;
+        std::uint32_t height_ = 0;
+        std::uint32_t distance_ = 0;
+        bool captureFrames_ = false;
+        mutable std::uint32_t lastId_ = 0;
+        mutable std::uint32_t arenaVertexArrayId_ = 0;
+        mutable std::uint32_t arenaVertexBufferId_ = 0;
+        mutable std::uint32_t arenaIndexBufferId_ = 0;
+        mutable std::uint32_t arenaVertices_ = 0;
+        mutable std::uint32_t arenaIndices_ = 0;
+        mutable RenderStats frameStats_{};
+        /** Bytes of meshes and images loaded since the last finished frame, as loads happen between frames */
+        mutable std::atomic<std::uint64_t> resourceUploadedBytes_{0};
+        mutable RenderStats lastFrameStats_{};
+        /** Guards lastFrameStats_, which is read from outside the thread submitting frames */
+        mutable std::mutex statsMutex_{};
+        mutable std::string frame_{};
+        mutable std::string lastFrame_{};
+    };
+}
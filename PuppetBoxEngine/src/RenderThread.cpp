@@ -0,0 +1,218 @@
+#include "RenderThread.h"
+
+#include <utility>
+
+#include "Logger.h"
+
+namespace PB
+{
+    RenderThread::RenderThread(std::shared_ptr<IGfxApi> gfxApi, Sdl2Initializer* hardwareInitializer)
+            : gfxApi_(std::move(gfxApi)), hardwareInitializer_(hardwareInitializer)
+    {
+
+    }
+
+    RenderThread::~RenderThread()
+    {
+        stop();
+    }
+
+    bool RenderThread::start()
+    {
+        if (running_.load(std::memory_order_acquire))
+        {
+            return true;
+        }
+
+        // Left as RELEASED until the render thread has tried to take the context
+        contextState_.store(RELEASED, std::memory_order_release);
+        hardwareInitializer_->releaseContext();
+
+        running_.store(true, std::memory_order_release);
+        thread_ = std::thread{&RenderThread::run, this};
+
+        waitUntil([this]() {
+            return contextState_.load(std::memory_order_acquire) != RELEASED;
+        });
+
+        if (contextState_.load(std::memory_order_acquire) == RETURNED)
+        {
+            thread_.join();
+
+            running_.store(false, std::memory_order_release);
+            contextState_.store(RENDER_THREAD, std::memory_order_release);
+            hardwareInitializer_->makeContextCurrent();
+
+            LOGGER_ERROR("Render thread failed to take the context, rendering on the main thread instead");
+
+            return false;
+        }
+
+        LOGGER_INFO("Render thread started");
+
+        return true;
+    }
+
+    void RenderThread::stop()
+    {
+        if (!running_.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        running_.store(false, std::memory_order_release);
+        signal();
+        thread_.join();
+
+        hardwareInitializer_->makeContextCurrent();
+
+        LOGGER_INFO("Render thread stopped");
+    }
+
+    FramePacket& RenderThread::beginFrame()
+    {
+        const std::uint64_t frame = published_.load(std::memory_order_relaxed);
+
+        // The packet is free once the render thread is done with the frame recorded into it PACKET_COUNT ago
+        waitUntil([this, frame]() {
+            return consumed_.load(std::memory_order_acquire) + PACKET_COUNT > frame;
+        });
+
+        FramePacket& packet = packets_[frame % PACKET_COUNT];
+        packet.frameCommands.reset();
+        packet.commands.reset();
+        packet.releases.clear();
+
+        return packet;
+    }
+
+    void RenderThread::publishFrame()
+    {
+        published_.store(published_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        signal();
+    }
+
+    bool RenderThread::acquireContext()
+    {
+        contextState_.store(REQUESTED, std::memory_order_release);
+        signal();
+
+        waitUntil([this]() {
+            return contextState_.load(std::memory_order_acquire) == RELEASED;
+        });
+
+        if (!hardwareInitializer_->makeContextCurrent())
+        {
+            return false;
+        }
+
+        // Nothing the render thread shadowed is relied on by the main thread, nor the other way around
+        gfxApi_->invalidateState();
+
+        return true;
+    }
+
+    void RenderThread::releaseContext()
+    {
+        gfxApi_->invalidateState();
+        hardwareInitializer_->releaseContext();
+        contextState_.store(RETURNED, std::memory_order_release);
+        signal();
+
+        // Waiting for the render thread to take it back, so the next request can't be mistaken for this one
+        waitUntil([this]() {
+            return contextState_.load(std::memory_order_acquire) == RENDER_THREAD;
+        });
+    }
+
+    void RenderThread::run()
+    {
+        if (!hardwareInitializer_->makeContextCurrent())
+        {
+            contextState_.store(RETURNED, std::memory_order_release);
+            signal();
+            return;
+        }
+
+        contextState_.store(RENDER_THREAD, std::memory_order_release);
+        signal();
+
+        bool running = true;
+
+        while (running)
+        {
+            const std::uint64_t consumed = consumed_.load(std::memory_order_relaxed);
+
+            if (published_.load(std::memory_order_acquire) > consumed)
+            {
+                render(packets_[consumed % PACKET_COUNT]);
+
+                consumed_.store(consumed + 1, std::memory_order_release);
+                signal();
+            }
+            else if (contextState_.load(std::memory_order_acquire) == REQUESTED)
+            {
+                // Every published frame is drawn by now, the main thread publishes nothing while it waits
+                hardwareInitializer_->releaseContext();
+                contextState_.store(RELEASED, std::memory_order_release);
+                signal();
+
+                waitUntil([this]() {
+                    return contextState_.load(std::memory_order_acquire) == RETURNED;
+                });
+
+                hardwareInitializer_->makeContextCurrent();
+                contextState_.store(RENDER_THREAD, std::memory_order_release);
+                signal();
+            }
+            else if (!running_.load(std::memory_order_acquire))
+            {
+                // A frame may have been published just before stopping, it's drawn before the thread ends
+                running = published_.load(std::memory_order_acquire) > consumed;
+            }
+            else
+            {
+                waitUntil([this, consumed]() {
+                    return published_.load(std::memory_order_acquire) > consumed
+                           || contextState_.load(std::memory_order_acquire) == REQUESTED
+                           || !running_.load(std::memory_order_acquire);
+                });
+            }
+        }
+
+        hardwareInitializer_->releaseContext();
+    }
+
+    void RenderThread::signal()
+    {
+        // Pairs with the fence in waitUntil
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (sleepers_.load(std::memory_order_relaxed) > 0)
+        {
+            {
+                // Taken so the change can't land between a sleeper checking its condition and going to sleep
+                std::lock_guard<std::mutex> lock{wakeMutex_};
+            }
+
+            wake_.notify_all();
+        }
+    }
+
+    void RenderThread::render(FramePacket& packet)
+    {
+        gfxApi_->preLoopCommands(packet.width, packet.height);
+
+        gfxApi_->submit(packet.frameCommands);
+        gfxApi_->submit(packet.commands);
+
+        gfxApi_->postLoopCommands();
+        hardwareInitializer_->postLoopCommands();
+
+        // Every frame that could draw the evicted assets has been submitted by now
+        for (const auto& release: packet.releases)
+        {
+            release();
+        }
+    }
+}
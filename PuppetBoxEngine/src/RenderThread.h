@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CommandList.h"
+#include "IGfxApi.h"
+#include "Sdl2Initializer.h"
+
+namespace PB
+{
+    /**
+    * \brief Everything the render thread needs to draw a frame, recorded by the main thread while the render
+    * thread draws the frame before it.
+    *
+    * <p>Once published, a packet is only read by the render thread until it is done with it.  Transforms,
+    * bone palettes, and UI draw data are all copied into the command lists as they are recorded, so nothing
+    * in a packet refers back to scene state the main thread goes on to change.</p>
+    */
+    struct FramePacket
+    {
+        /** Size of the rendering area when the frame was recorded, resizes after it are left to the next frame */
+        std::uint32_t width = 0;
+        std::uint32_t height = 0;
+        /** Commands set up once per frame, ahead of anything drawn */
+        CommandList frameCommands{};
+        /** Commands drawing the scene, the sprite batches, and the glyph batches */
+        CommandList commands{};
+        /** Releases of evicted assets' GFX API objects, run once the frame is submitted */
+        std::vector<std::function<void()>> releases{};
+    };
+
+    /**
+    * \brief Owns the GFX API context on a dedicated thread, submitting the {\link FramePacket}s the main thread
+    * publishes and swapping the window's buffers, so the main thread can update the next frame while the
+    * driver works on the last one.
+    *
+    * <p>Two packets are handed between the threads without locks, the main thread records into one while the
+    * render thread submits the other, and waits only when it gets two frames ahead.  Either thread waiting spins
+    * briefly on the atomics, then sleeps until the other thread signals a change, so neither burns a core while
+    * idle.</p>
+    *
+    * <p>GFX API resources are still created on the main thread.  It takes the context back with
+    * {\link RenderThread::acquireContext} for that, which waits for every published frame to be drawn first,
+    * so those frames lose their overlap.</p>
+    */
+    class RenderThread
+    {
+    public:
+        /**
+        * \brief Creates a render thread submitting to the given GFX API.
+        *
+        * \param gfxApi              The GFX API to submit frames to.
+        * \param hardwareInitializer The hardware library implementation holding the window and its context.
+        */
+        RenderThread(std::shared_ptr<IGfxApi> gfxApi, Sdl2Initializer* hardwareInitializer);
+
+        ~RenderThread();
+
+        /**
+        * \brief Moves the GFX API context from the calling thread to a newly started render thread.
+        *
+        * \return True if the render thread started, False if it couldn't take the context, in which case the
+        * context is left on the calling thread.
+        */
+        bool start();
+
+        /**
+        * \brief Waits for every published frame to be drawn, then stops the render thread and moves the GFX API
+        * context back to the calling thread.  Does nothing if the render thread isn't running.
+        */
+        void stop();
+
+        /**
+        * \brief Gets the next packet to record a frame into, waiting for the render thread to be done with it if
+        * it is still drawing from it.  The packet is emptied before it's returned.
+        *
+        * \return The packet to record the next frame into.
+        */
+        FramePacket& beginFrame();
+
+        /**
+        * \brief Publishes the packet returned by the last call to {\link RenderThread::beginFrame} to the render
+        * thread.  The packet must not be touched again until it's returned by another call to beginFrame.
+        */
+        void publishFrame();
+
+        /**
+        * \brief Waits for every published frame to be drawn, then moves the GFX API context to the calling
+        * thread, until {\link RenderThread::releaseContext} is called.
+        *
+        * \return True if the context was made current on the calling thread, False otherwise.
+        */
+        bool acquireContext();
+
+        /**
+        * \brief Gives the GFX API context taken by {\link RenderThread::acquireContext} back to the render thread.
+        */
+        void releaseContext();
+
+    private:
+        /**
+        * \brief Which thread the GFX API context is on, or moving to.
+        */
+        enum ContextState : std::uint8_t
+        {
+            RENDER_THREAD,
+            REQUESTED,
+            RELEASED,
+            RETURNED,
+        };
+
+        static constexpr std::uint32_t PACKET_COUNT = 2;
+        /** Checks made of a condition before sleeping on it, long enough to catch a frame handed straight over */
+        static constexpr std::uint32_t SPIN_COUNT = 64;
+
+    private:
+        /**
+        * \brief The render thread's loop, submitting packets as they are published and handing the context over
+        * when it is requested.
+        */
+        void run();
+
+        /**
+        * \brief Submits the given packet and swaps the window's buffers, run on the render thread.
+        *
+        * \param packet The packet to submit.
+        */
+        void render(FramePacket& packet);
+
+        /**
+        * \brief Waits for the given condition, yielding between checks for a bounded number of them, then
+        * sleeping until the other thread signals a change with {\link RenderThread::signal}.
+        *
+        * \param condition The condition to wait for, which must only change along with a call to signal.
+        */
+        template<typename Condition>
+        void waitUntil(Condition condition)
+        {
+            for (std::uint32_t i = 0; i < SPIN_COUNT; ++i)
+            {
+                if (condition())
+                {
+                    return;
+                }
+
+                std::this_thread::yield();
+            }
+
+            sleepers_.fetch_add(1);
+            // Pairs with the fence in signal, so either the condition's change is seen or the sleeper is
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            {
+                std::unique_lock<std::mutex> lock{wakeMutex_};
+                wake_.wait(lock, condition);
+            }
+
+            sleepers_.fetch_sub(1);
+        }
+
+        /**
+        * \brief Wakes the other thread if it's sleeping in {\link RenderThread::waitUntil}, called after every change
+        * to the state either thread waits on.
+        */
+        void signal();
+
+    private:
+        std::shared_ptr<IGfxApi> gfxApi_;
+        Sdl2Initializer* hardwareInitializer_;
+        std::array<FramePacket, PACKET_COUNT> packets_{};
+        /** Number of packets the main thread has published */
+        std::atomic<std::uint64_t> published_{0};
+        /** Number of packets the render thread is done with */
+        std::atomic<std::uint64_t> consumed_{0};
+        std::atomic<std::uint8_t> contextState_{RENDER_THREAD};
+        std::atomic<bool> running_{false};
+        /** Number of threads sleeping on wake_, so signalling skips the lock when neither is */
+        std::atomic<std::uint32_t> sleepers_{0};
+        std::mutex wakeMutex_{};
+        std::condition_variable wake_{};
+        std::thread thread_{};
+    };
+}
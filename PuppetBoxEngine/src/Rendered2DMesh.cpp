@@ -1,25 +1,38 @@
 #include "Rendered2DMesh.h"
 
+#include <utility>
+
 #include "GfxMath.h"
 
 namespace PB
 {
-    Rendered2DMesh::Rendered2DMesh(Mesh mesh, Material material) : mesh_(mesh), material_(material)
+    Rendered2DMesh::Rendered2DMesh(
+            Mesh mesh,
+            Material material,
+            std::vector<AssetHandle> assets,
+            std::shared_ptr<SpriteBatch> spriteBatch,
+            std::shared_ptr<CommandList> commandList)
+            : mesh_(mesh), material_(material), assets_(std::move(assets))
     {
+        if (spriteBatch != nullptr && SpriteBatch::isInstanced(material_.shader))
+        {
+            // Instanced shaders take all of these per instance instead
+            spriteBatch_ = std::move(spriteBatch);
+            return;
+        }
+
+        commandList_ = std::move(commandList);
 
+        // Resolved once here so rendering doesn't look the uniforms up by name on every draw
+        diffuseMapUniform_ = material_.shader.uniform<std::int32_t>("material.diffuseMap");
+        diffuseUvAdjustUniform_ = material_.shader.uniform<vec4>("diffuseUvAdjust");
+        boneTransformUniform_ = material_.shader.uniform<mat4>("boneTransform");
+        meshTransformUniform_ = material_.shader.uniform<mat4>("meshTransform");
+        modelUniform_ = material_.shader.uniform<mat4>("model");
     }
 
     void Rendered2DMesh::render(mat4 transform, Bone* bones, std::uint32_t boneCount) const
     {
-        if (material_.requiresAlphaBlending)
-        {
-            glEnable(GL_BLEND);
-        }
-
-        material_.shader.use();
-        material_.diffuseMap.use(0);
-        material_.shader.setInt("material.diffuseMap", 0);
-
         vec4 diffuseUvAdjust{
                 static_cast<float>(material_.diffuseData.width) / static_cast<float>(material_.diffuseMap.width),
                 static_cast<float>(material_.diffuseData.height) / static_cast<float>(material_.diffuseMap.height),
@@ -27,29 +40,35 @@ namespace PB
                 static_cast<float>(material_.diffuseData.yOffset) / static_cast<float>(material_.diffuseMap.height)
         };
 
-        material_.shader.setVec4("diffuseUvAdjust", diffuseUvAdjust);
-        material_.shader.setMat4("boneTransform", bones[0].transform);
-        material_.shader.setMat4("meshTransform", mesh_.transform);
-        material_.shader.setMat4("model", transform);
+        if (spriteBatch_ != nullptr)
+        {
+            SpriteInstance instance{};
+            instance.transform = transform * bones[0].transform * mesh_.transform;
+            instance.uvAdjust = diffuseUvAdjust;
 
-        glBindVertexArray(mesh_.VAO);
+            spriteBatch_->submit(
+                    material_.shader,
+                    material_.diffuseMap,
+                    mesh_,
+                    material_.requiresAlphaBlending,
+                    instance);
 
-        if (mesh_.EBO != 0)
-        {
-            //                           v-- number of indices to draw
-            glDrawElements(GL_TRIANGLES, mesh_.drawCount, GL_UNSIGNED_INT, 0); // NOLINT(modernize-use-nullptr)
-        }
-        else
-        {
-            //                            v-- number of vertices to draw
-            glDrawArrays(GL_TRIANGLES, 0, mesh_.drawCount);
+            return;
         }
 
-        // Unset VAO for next render
-        glBindVertexArray(0);
+        // Everything this draw depends on is set, rather than unset after it, so the GFX API can skip
+        // whatever is already set by the draw before
+        commandList_->setBlending(material_.requiresAlphaBlending || material_.diffuseMap.requiresAlphaBlending);
+        commandList_->useProgram(material_.shader.id());
+        commandList_->bindTexture(0, material_.diffuseMap.id());
+        commandList_->setUniform(diffuseMapUniform_, 0);
+
+        commandList_->setUniform(diffuseUvAdjustUniform_, diffuseUvAdjust);
+        commandList_->setUniform(boneTransformUniform_, bones[0].transform);
+        commandList_->setUniform(meshTransformUniform_, mesh_.transform);
+        commandList_->setUniform(modelUniform_, transform);
 
-        material_.diffuseMap.unuse(0);
-        material_.shader.unuse();
-        glDisable(GL_BLEND);
+        commandList_->bindVertexArray(mesh_.VAO);
+        commandList_->draw(mesh_);
     }
-}
\ No newline at end of file
+}
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
+#include "AssetResidency.h"
+#include "CommandList.h"
 #include "Material.h"
 #include "Mesh.h"
 #include "RenderedMesh.h"
+#include "SpriteBatch.h"
 
 namespace PB
 {
@@ -17,16 +23,36 @@ namespace PB
         *
         * \param mesh		The OpenGL specific mesh data to use for rendering calls.
         * \param material	The OpenGL specific material data to use for rendering calls.
+        * \param assets     Handles to the mesh, material, and shader assets, keeping them resident while
+        * this mesh exists.
+        * \param spriteBatch The batch to submit draws to if the material's shader is instanced.
+        * \param commandList The list to record draws into if the material's shader isn't instanced.
         */
-        Rendered2DMesh(Mesh mesh, Material material);
+        Rendered2DMesh(
+                Mesh mesh,
+                Material material,
+                std::vector<AssetHandle> assets,
+                std::shared_ptr<SpriteBatch> spriteBatch,
+                std::shared_ptr<CommandList> commandList);
 
         /**
-        * \brief Renders the object with OpenGL specific invocations.
+        * \brief Records the draw of the object into the command list, or adds it to the sprite batch to be
+        * drawn along with other sprites sharing its shader, texture, and mesh.
         */
         void render(mat4 transform, Bone* bones, std::uint32_t boneCount) const;
 
     private:
         Mesh mesh_;
         Material material_;
+        std::vector<AssetHandle> assets_;
+        /** Only set if the material's shader is instanced */
+        std::shared_ptr<SpriteBatch> spriteBatch_;
+        /** Only set if the material's shader isn't instanced */
+        std::shared_ptr<CommandList> commandList_;
+        UniformHandle<std::int32_t> diffuseMapUniform_;
+        UniformHandle<vec4> diffuseUvAdjustUniform_;
+        UniformHandle<mat4> boneTransformUniform_;
+        UniformHandle<mat4> meshTransformUniform_;
+        UniformHandle<mat4> modelUniform_;
     };
 }
\ No newline at end of file
@@ -10,6 +10,8 @@ namespace PB
     class RenderedMesh
     {
     public:
+        virtual ~RenderedMesh() = default;
+
         /**
         * \brief Renders the object with OpenGL specific invocations.
         */
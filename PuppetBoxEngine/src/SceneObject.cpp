@@ -143,6 +143,21 @@ namespace PB
         model_->playAnimation(animationPath, startFrame);
     }
 
+    void SceneObject::playAnimation(const std::string& animationPath, std::uint32_t startFrame, float transitionTime)
+    {
+        model_->playAnimation(animationPath, startFrame, transitionTime);
+    }
+
+    void SceneObject::addAnimationLayer(const std::string& animationPath, float weight)
+    {
+        model_->addAnimationLayer(animationPath, weight);
+    }
+
+    void SceneObject::removeAnimationLayer(const std::string& animationPath)
+    {
+        model_->removeAnimationLayer(animationPath);
+    }
+
     void SceneObject::stopAnimation()
     {
         model_->stopAnimation();
@@ -96,10 +96,10 @@ namespace PB
                                            windowWidth, windowHeight, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
                 if (window_ != nullptr)
                 {
-                    SDL_GLContext glContext = SDL_GL_CreateContext(window_);
-                    if (glContext != nullptr)
+                    glContext_ = SDL_GL_CreateContext(window_);
+                    if (glContext_ != nullptr)
                     {
-                        SDL_GL_MakeCurrent(window_, glContext);
+                        SDL_GL_MakeCurrent(window_, glContext_);
                         SDL_GL_SetSwapInterval(0);
                     }
                     else
@@ -145,6 +145,7 @@ namespace PB
                 }
                 else
                 {
+                    error = true;
                     LOGGER_ERROR("Failed to initialize GFX API");
                 }
             }
@@ -200,6 +201,32 @@ namespace PB
             SDL_GL_SwapWindow(window_);
         };
 
+        /**
+        * \brief Makes the GFX API context current on the calling thread.  A context can only be current on one
+        * thread at a time, so it must be released by the thread holding it first.
+        *
+        * \return True if the context was made current, False otherwise.
+        */
+        bool makeContextCurrent() const
+        {
+            bool success = SDL_GL_MakeCurrent(window_, glContext_) == 0;
+
+            if (!success)
+            {
+                LOGGER_ERROR("Failed to make context current: " + std::string(SDL_GetError()));
+            }
+
+            return success;
+        };
+
+        /**
+        * \brief Releases the GFX API context from the calling thread, so another thread can make it current.
+        */
+        void releaseContext() const
+        {
+            SDL_GL_MakeCurrent(window_, nullptr);
+        };
+
         /**
         * \brief Initialize the game time for later tracking time deltas between frames.
         */
@@ -236,6 +263,7 @@ namespace PB
         std::uint64_t lastFrameTime_ = 0;
         std::shared_ptr<IGfxApi> gfxApi_;
         SDL_Window* window_ = nullptr;
+        SDL_GLContext glContext_ = nullptr;
         bool useDebugger_ = false;
     };
 }
@@ -1,22 +1,32 @@
-#include <unordered_map>
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 #include <glad/glad.h>
 
 #include "Logger.h"
 #include "Shader.h"
 
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 namespace PB
 {
     namespace
     {
-        bool compileShaderProgram(
+        /**
+        * \brief Whether the driver compiles shader programs in parallel (GL_KHR_parallel_shader_compile), so
+        * GL_COMPLETION_STATUS_KHR can be polled without blocking.
+        */
+        bool parallelCompile = false;
+
+        bool createShaderProgram(
                 std::uint32_t* programId,
                 const std::uint32_t* vShaderId,
                 const std::uint32_t* gShaderId,
                 const std::uint32_t* fShaderId)
         {
-            int success;
-            char infoLog[512];
             // shader Program
             *programId = glCreateProgram();
 
@@ -35,12 +45,24 @@ namespace PB
                 glAttachShader(*programId, *fShaderId);
             }
 
+            // Has to be set before linking for the driver to keep the binary around for Shader#binary()
+            glProgramParameteri(*programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+            // Status isn't checked until Shader#finishInit(), so parallel compiles aren't waited on here
             glLinkProgram(*programId);
+
+            return *programId != 0;
+        }
+
+        bool checkForProgramLinkError(const std::uint32_t programId)
+        {
+            int success;
+            char infoLog[512];
             // print linking errors if any
-            glGetProgramiv(*programId, GL_LINK_STATUS, &success);
+            glGetProgramiv(programId, GL_LINK_STATUS, &success);
             if (!success)
             {
-                glGetProgramInfoLog(*programId, 512, nullptr, infoLog);
+                glGetProgramInfoLog(programId, 512, nullptr, infoLog);
                 LOGGER_ERROR("Failed to link program'\n" + std::string(infoLog));
             }
 
@@ -52,6 +74,12 @@ namespace PB
             int success;
             const int BUFF_SIZE = 1024;
             char infoLog[BUFF_SIZE];
+
+            if (shaderId == 0)
+            {
+                return;
+            }
+
             glGetShaderiv(shaderId, GL_COMPILE_STATUS, &success);
 
             if (!success)
@@ -63,14 +91,113 @@ namespace PB
         }
 
         bool
-        compileShader(std::uint32_t* shaderId, const int shaderType, const char* shaderSource, const char* shaderName)
+        compileShader(std::uint32_t* shaderId, const int shaderType, const char* shaderSource)
         {
-            bool error = false;
             *shaderId = glCreateShader(shaderType);
             glShaderSource(*shaderId, 1, &shaderSource, nullptr);
+            // Status isn't checked until Shader#finishInit(), so parallel compiles aren't waited on here
             glCompileShader(*shaderId);
-            checkForShaderCompileError(*shaderId, shaderName, &error);
-            return !error;
+            return *shaderId != 0;
+        }
+
+        std::shared_ptr<UniformTable> reflectUniforms(std::uint32_t programId)
+        {
+            auto uniforms = std::make_shared<UniformTable>();
+            std::int32_t count = 0;
+            std::int32_t maxLength = 0;
+
+            glGetProgramiv(programId, GL_ACTIVE_UNIFORMS, &count);
+            glGetProgramiv(programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+            std::vector<char> name(static_cast<std::size_t>(std::max(maxLength, 1)));
+
+            for (std::int32_t i = 0; i < count; ++i)
+            {
+                GLsizei length = 0;
+                GLint size = 0;
+                GLenum type = 0;
+                glGetActiveUniform(programId, i, maxLength, &length, &size, &type, name.data());
+
+                std::string uniformName{name.data(), static_cast<std::size_t>(length)};
+                const std::int32_t location = glGetUniformLocation(programId, uniformName.c_str());
+
+                // Members of uniform blocks have no location of their own
+                if (location == -1)
+                {
+                    continue;
+                }
+
+                // Arrays are reported as "name[0]", but are just as often set by their bare name
+                const std::size_t arrayIndex = uniformName.rfind("[0]");
+
+                if (arrayIndex != std::string::npos && arrayIndex + 3 == uniformName.size())
+                {
+                    uniforms->locations[uniformName.substr(0, arrayIndex)] = location;
+                }
+
+                uniforms->locations[std::move(uniformName)] = location;
+            }
+
+            glGetProgramiv(programId, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+            glGetProgramiv(programId, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+
+            name.resize(static_cast<std::size_t>(std::max(maxLength, 1)));
+
+            for (std::int32_t i = 0; i < count; ++i)
+            {
+                GLsizei length = 0;
+                glGetActiveUniformBlockName(programId, i, maxLength, &length, name.data());
+
+                uniforms->blockIndices[std::string{name.data(), static_cast<std::size_t>(length)}] = i;
+            }
+
+            glGetProgramiv(programId, GL_ACTIVE_ATTRIBUTES, &count);
+            glGetProgramiv(programId, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+
+            name.resize(static_cast<std::size_t>(std::max(maxLength, 1)));
+
+            for (std::int32_t i = 0; i < count; ++i)
+            {
+                GLsizei length = 0;
+                GLint size = 0;
+                GLenum type = 0;
+                glGetActiveAttrib(programId, i, maxLength, &length, &size, &type, name.data());
+
+                std::string attributeName{name.data(), static_cast<std::size_t>(length)};
+                const std::int32_t location = glGetAttribLocation(programId, attributeName.c_str());
+
+                // Built in inputs, such as gl_VertexID, have no location
+                if (location != -1)
+                {
+                    uniforms->attributeLocations[std::move(attributeName)] = location;
+                }
+            }
+
+            return uniforms;
+        }
+
+        void bindUniformBlock(std::uint32_t programId, const UniformTable& uniforms, const char* name,
+                              std::uint32_t binding)
+        {
+            auto itr = uniforms.blockIndices.find(name);
+
+            if (itr != uniforms.blockIndices.end())
+            {
+                glUniformBlockBinding(programId, itr->second, binding);
+            }
+        }
+
+        bool isHeadless(const std::shared_ptr<UniformTable>& uniforms)
+        {
+            return uniforms != nullptr && uniforms->headless;
+        }
+
+        void bindUniformBlocks(std::uint32_t programId, const UniformTable& uniforms)
+        {
+            // Initialize UBO locations for later use.
+            bindUniformBlock(programId, uniforms, "Transforms", 0);
+            bindUniformBlock(programId, uniforms, "LightCounter", 1);
+            bindUniformBlock(programId, uniforms, "LightData", 2);
         }
     }
 
@@ -79,6 +206,24 @@ namespace PB
         return programId_;
     }
 
+    bool Shader::isSameProgram(const Shader& other) const
+    {
+        // Each built program gets a uniform table of its own, shared by its copies
+        return programId_ == other.programId_ && uniforms_ == other.uniforms_;
+    }
+
+    std::uint32_t Shader::binarySize() const
+    {
+        std::int32_t length = 0;
+
+        if (programId_ != 0 && !isHeadless(uniforms_))
+        {
+            glGetProgramiv(programId_, GL_PROGRAM_BINARY_LENGTH, &length);
+        }
+
+        return static_cast<std::uint32_t>(length);
+    }
+
     std::string Shader::name() const
     {
         return shaderName_;
@@ -90,7 +235,7 @@ namespace PB
         {
             if (!shaderCode.empty())
             {
-                return compileShader(&vertexShaderId_, GL_VERTEX_SHADER, shaderCode.c_str(), "VERTEX");
+                return compileShader(&vertexShaderId_, GL_VERTEX_SHADER, shaderCode.c_str());
             }
         }
         else
@@ -107,7 +252,7 @@ namespace PB
         {
             if (!shaderCode.empty())
             {
-                return compileShader(&geometryShaderId_, GL_GEOMETRY_SHADER, shaderCode.c_str(), "GEOMETRY");
+                return compileShader(&geometryShaderId_, GL_GEOMETRY_SHADER, shaderCode.c_str());
             }
         }
         else
@@ -124,7 +269,7 @@ namespace PB
         {
             if (!shaderCode.empty())
             {
-                return compileShader(&fragmentShaderId_, GL_FRAGMENT_SHADER, shaderCode.c_str(), "FRAGMENT");
+                return compileShader(&fragmentShaderId_, GL_FRAGMENT_SHADER, shaderCode.c_str());
             }
         }
         else
@@ -136,127 +281,301 @@ namespace PB
     }
 
     bool Shader::init()
+    {
+        return beginInit() && finishInit();
+    }
+
+    bool Shader::beginInit()
     {
         if (programId_ == 0)
         {
-            if (compileShaderProgram(&programId_, &vertexShaderId_, &geometryShaderId_, &fragmentShaderId_))
-            {
-                // Initialize UBO locations for later use.
-                std::uint32_t loc = glGetUniformBlockIndex(programId_, "Transforms");
+            return createShaderProgram(&programId_, &vertexShaderId_, &geometryShaderId_, &fragmentShaderId_);
+        }
+        else
+        {
+            LOGGER_WARN("Shader '" + shaderName_ + "' has already been initialized");
+        }
 
-                if (loc != GL_INVALID_INDEX)
-                {
-                    glUniformBlockBinding(programId_, loc, 0);
-                }
+        return false;
+    }
 
-                loc = glGetUniformBlockIndex(programId_, "LightCounter");
+    bool Shader::isReady() const
+    {
+        std::int32_t completed = GL_TRUE;
 
-                if (loc != GL_INVALID_INDEX)
-                {
-                    glUniformBlockBinding(programId_, loc, 1);
-                }
+        if (parallelCompile && programId_ != 0)
+        {
+            glGetProgramiv(programId_, GL_COMPLETION_STATUS_KHR, &completed);
+        }
 
-                loc = glGetUniformBlockIndex(programId_, "LightData");
+        return completed == GL_TRUE;
+    }
 
-                if (loc != GL_INVALID_INDEX)
-                {
-                    glUniformBlockBinding(programId_, loc, 2);
-                }
+    bool Shader::finishInit()
+    {
+        bool error = false;
 
-                return true;
-            }
+        if (programId_ == 0)
+        {
+            LOGGER_WARN("Shader '" + shaderName_ + "' was never started");
+            return false;
         }
-        else
+
+        checkForShaderCompileError(vertexShaderId_, "VERTEX", &error);
+        checkForShaderCompileError(geometryShaderId_, "GEOMETRY", &error);
+        checkForShaderCompileError(fragmentShaderId_, "FRAGMENT", &error);
+
+        if (!error && checkForProgramLinkError(programId_))
         {
-            LOGGER_WARN("Shader '" + shaderName_ + "' has already been initialized");
+            uniforms_ = reflectUniforms(programId_);
+            bindUniformBlocks(programId_, *uniforms_);
+
+            return true;
         }
 
         return false;
     }
 
-    void Shader::use() const
+    bool Shader::loadBinary(const ShaderBinary& binary)
+    {
+        if (programId_ != 0)
+        {
+            LOGGER_WARN("Shader '" + shaderName_ + "' has already been initialized");
+            return false;
+        }
+
+        programId_ = glCreateProgram();
+        glProgramBinary(programId_, binary.format, binary.bytes.data(), static_cast<GLsizei>(binary.bytes.size()));
+
+        std::int32_t success = GL_FALSE;
+        glGetProgramiv(programId_, GL_LINK_STATUS, &success);
+
+        if (!success)
+        {
+            // Expected whenever the driver changes, so the caller compiles from source instead
+            LOGGER_DEBUG("Program binary rejected for shader '" + shaderName_ + "'");
+            glDeleteProgram(programId_);
+            programId_ = 0;
+            return false;
+        }
+
+        // Uniform block bindings aren't part of the binary on every driver
+        uniforms_ = reflectUniforms(programId_);
+        bindUniformBlocks(programId_, *uniforms_);
+
+        return true;
+    }
+
+    bool Shader::binary(ShaderBinary* binary) const
+    {
+        const std::uint32_t length = binarySize();
+
+        if (length == 0)
+        {
+            return false;
+        }
+
+        GLenum format = 0;
+        GLsizei written = 0;
+        binary->bytes.resize(length);
+        glGetProgramBinary(programId_, static_cast<GLsizei>(length), &written, &format, binary->bytes.data());
+        binary->bytes.resize(static_cast<std::size_t>(written));
+        binary->format = format;
+
+        return written > 0;
+    }
+
+    void Shader::initHeadless(std::uint32_t programId, std::shared_ptr<UniformTable> uniforms)
+    {
+        programId_ = programId;
+        uniforms_ = std::move(uniforms);
+        uniforms_->headless = true;
+    }
+
+    void Shader::setParallelCompile(bool enabled)
+    {
+        parallelCompile = enabled;
+    }
+
+    bool Shader::supportsBinaries()
+    {
+        std::int32_t formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+
+        return formatCount > 0;
+    }
+
+    std::int32_t Shader::location(const std::string& name) const
+    {
+        if (uniforms_ == nullptr)
+        {
+            LOGGER_WARN("Uniform '" + name + "' set before shader '" + shaderName_ + "' was linked");
+            return -1;
+        }
+
+        auto itr = uniforms_->locations.find(name);
+
+        if (itr != uniforms_->locations.end())
+        {
+            return itr->second;
+        }
+
+        if (uniforms_->headless)
+        {
+            const auto location = static_cast<std::int32_t>(uniforms_->locations.size());
+            uniforms_->locations[name] = location;
+            return location;
+        }
+
+        // Elements past the first of an array aren't reflected, only unknown names end up as -1
+        const std::int32_t location = glGetUniformLocation(programId_, name.c_str());
+
+        if (location == -1)
+        {
+            LOGGER_WARN("Shader '" + shaderName_ + "' has no active uniform '" + name + "'");
+        }
+
+        uniforms_->locations[name] = location;
+
+        return location;
+    }
+
+    std::int32_t Shader::attributeLocation(const std::string& name) const
     {
-        glUseProgram(programId_);
+        if (uniforms_ == nullptr)
+        {
+            return -1;
+        }
+
+        auto itr = uniforms_->attributeLocations.find(name);
+
+        return itr != uniforms_->attributeLocations.end() ? itr->second : -1;
     }
 
-    // Keeping this non static for consistency with Shader#use()
-    void Shader::unuse() const // NOLINT(readability-convert-member-functions-to-static)
+    void Shader::set(UniformHandle<bool> uniform, bool value) const
     {
-        glUseProgram(0);
+        glUniform1i(uniform.location, (int) value);
+    }
+
+    void Shader::set(UniformHandle<std::int32_t> uniform, std::int32_t value) const
+    {
+        glUniform1i(uniform.location, value);
+    }
+
+    void Shader::set(UniformHandle<std::uint32_t> uniform, std::uint32_t value) const
+    {
+        glUniform1ui(uniform.location, value);
+    }
+
+    void Shader::set(UniformHandle<float> uniform, float value) const
+    {
+        glUniform1f(uniform.location, value);
+    }
+
+    void Shader::set(UniformHandle<float> uniform, std::uint32_t count, const float* values) const
+    {
+        glUniform1fv(uniform.location, count, values);
+    }
+
+    void Shader::set(UniformHandle<vec2> uniform, const vec2& value) const
+    {
+        glUniform2fv(uniform.location, 1, &value[0]);
+    }
+
+    void Shader::set(UniformHandle<vec3> uniform, const vec3& value) const
+    {
+        glUniform3fv(uniform.location, 1, &value[0]);
+    }
+
+    void Shader::set(UniformHandle<vec4> uniform, const vec4& value) const
+    {
+        glUniform4fv(uniform.location, 1, &value[0]);
+    }
+
+    void Shader::set(UniformHandle<mat4> uniform, const mat4& mat) const
+    {
+        glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
     }
 
     void Shader::setBool(const std::string& name, bool value) const
     {
-        glUniform1i(glGetUniformLocation(programId_, name.c_str()), (int) value);
+        glUniform1i(location(name), (int) value);
     }
 
     void Shader::setInt(const std::string& name, int value) const
     {
-        glUniform1i(glGetUniformLocation(programId_, name.c_str()), value);
+        glUniform1i(location(name), value);
     }
 
     void Shader::setUInt(const std::string& name, std::uint32_t value) const
     {
-        glUniform1ui(glGetUniformLocation(programId_, name.c_str()), value);
+        glUniform1ui(location(name), value);
     }
 
     void Shader::setFloat(const std::string& name, float value) const
     {
-        glUniform1f(glGetUniformLocation(programId_, name.c_str()), value);
+        glUniform1f(location(name), value);
     }
 
     void Shader::setFloatArray(const std::string& name, std::uint32_t count, float* values) const
     {
-        glUniform1fv(glGetUniformLocation(programId_, name.c_str()), count, values);
+        glUniform1fv(location(name), count, values);
     }
 
     void Shader::setVec2(const std::string& name, const vec2& value) const
     {
-        glUniform2fv(glGetUniformLocation(programId_, name.c_str()), 1, &value[0]);
+        glUniform2fv(location(name), 1, &value[0]);
     }
 
     void Shader::setVec2(const std::string& name, float x, float y) const
     {
-        glUniform2f(glGetUniformLocation(programId_, name.c_str()), x, y);
+        glUniform2f(location(name), x, y);
     }
 
     void Shader::setVec3(const std::string& name, const vec3& value) const
     {
-        glUniform3fv(glGetUniformLocation(programId_, name.c_str()), 1, &value[0]);
+        glUniform3fv(location(name), 1, &value[0]);
     }
 
     void Shader::setVec3(const std::string& name, float x, float y, float z) const
     {
-        glUniform3f(glGetUniformLocation(programId_, name.c_str()), x, y, z);
+        glUniform3f(location(name), x, y, z);
     }
 
     void Shader::setVec4(const std::string& name, const vec4& value) const
     {
-        glUniform4fv(glGetUniformLocation(programId_, name.c_str()), 1, &value[0]);
+        glUniform4fv(location(name), 1, &value[0]);
     }
 
     void Shader::setVec4(const std::string& name, float x, float y, float z, float w) const
     {
-        glUniform4f(glGetUniformLocation(programId_, name.c_str()), x, y, z, w);
+        glUniform4f(location(name), x, y, z, w);
     }
 
     void Shader::setMat2(const std::string& name, const mat2& mat) const
     {
-        //glUniformMatrix2fv(glGetUniformLocation(programId_, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        //glUniformMatrix2fv(location(name), 1, GL_FALSE, &mat[0][0]);
     }
 
     void Shader::setMat3(const std::string& name, const mat3& mat) const
     {
-        //glUniformMatrix3fv(glGetUniformLocation(programId_, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        //glUniformMatrix3fv(location(name), 1, GL_FALSE, &mat[0][0]);
     }
 
     void Shader::setMat4(const std::string& name, const mat4& mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(programId_, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix4fv(location(name), 1, GL_FALSE, &mat[0][0]);
     }
 
     void Shader::destroy()
     {
+        if (isHeadless(uniforms_))
+        {
+            programId_ = 0;
+            uniforms_ = nullptr;
+            return;
+        }
+
         glDetachShader(programId_, vertexShaderId_);
         glDeleteShader(vertexShaderId_);
         glDetachShader(programId_, geometryShaderId_);
@@ -269,5 +588,6 @@ namespace PB
         vertexShaderId_ = 0;
         geometryShaderId_ = 0;
         fragmentShaderId_ = 0;
+        uniforms_ = nullptr;
     }
 }
\ No newline at end of file
@@ -1,12 +1,66 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "puppetbox/DataStructures.h"
 
 namespace PB
 {
+    /**
+    * \brief A linked shader program in the driver's own binary format, as retrieved from the gfx API.
+    */
+    struct ShaderBinary
+    {
+        std::uint32_t format = 0;
+        std::vector<std::uint8_t> bytes{};
+    };
+
+    /**
+    * \brief A pre-resolved reference to a uniform variable of a single shader program, typed by the value
+    * it holds, so setting it with {\link Shader::set} skips looking up the uniform by name.
+    *
+    * <p>Handles are resolved with {\link Shader::uniform} once the shader program is linked, and stay valid
+    * for as long as the shader program does.  A handle to a uniform the shader program doesn't have is
+    * still safe to set, the value is ignored.</p>
+    */
+    template<typename T>
+    struct UniformHandle
+    {
+        std::int32_t location = -1;
+
+        /**
+        * \brief Checks if the handle references a uniform of the shader program.
+        *
+        * \return True if the uniform was found in the shader program, False otherwise.
+        */
+        bool isValid() const
+        {
+            return location != -1;
+        }
+    };
+
+    /**
+    * \brief The active uniforms, uniform blocks, and vertex attributes of a linked shader program, as reflected
+    * from the gfx API.
+    */
+    struct UniformTable
+    {
+        /** Uniform locations by name, including names that were looked up but not found, as -1 */
+        std::unordered_map<std::string, std::int32_t> locations{};
+        std::unordered_map<std::string, std::uint32_t> blockIndices{};
+        std::unordered_map<std::string, std::int32_t> attributeLocations{};
+        /**
+        * Set for shader programs without a gfx API behind them, which take every uniform name as active and
+        * hand out locations in the order the names are first looked up
+        */
+        bool headless = false;
+    };
+
     /**
     * \brief Class used to build and reference a single shader program.
     */
@@ -17,6 +71,10 @@ namespace PB
         * \brief Creates a reference to a single shader program, referencing the given shaders.  The
         * shader must first have required shaders compiled with loadXXShader() invocations, and program
         * compiled with `init()` before it can be used in a rendering process.
+        *
+        * <p>`init()` waits on the driver, to compile without blocking use `beginInit()` instead, then poll
+        * `isReady()` and call `finishInit()` once it returns True.  A program can also be created from
+        * a previously linked program binary with `loadBinary()`, skipping compilation.</p>
         * 
         * \param shaderName     The virtual asset path of the shader program asset.
         * \param vertexPath     The virtual asset path of the vertex shader asset.
@@ -41,6 +99,15 @@ namespace PB
         */
         std::uint32_t id() const;
 
+        /**
+        * \brief Checks if the given shader is a copy of this one, rather than a program given the same ID after
+        * this one was released.
+        *
+        * \param other The shader to compare with.
+        * \return True if both reference the same shader program, False otherwise.
+        */
+        bool isSameProgram(const Shader& other) const;
+
         /**
         * \brief Gets the name for the shader program.
         *
@@ -48,12 +115,20 @@ namespace PB
         */
         std::string name() const;
 
+        /**
+        * \brief Gets the size of the linked shader program, as reported by the gfx API.
+        *
+        * \return The size of the program binary in bytes, or 0 if the program isn't linked.
+        */
+        std::uint32_t binarySize() const;
+
         /**
         * \brief Builds a vertex shader with the given shader code to be used in the shader program.
         * 
         * \param shaderCode The respective code for the shader to be compiled.
         * 
-        * \return True if the shader compiled successfully, False otherwise.
+        * \return True if the shader was submitted for compiling, False otherwise.  Compile errors are
+        * reported once the shader program is linked.
         */
         bool loadVertexShader(const std::string& shaderCode);
 
@@ -62,7 +137,8 @@ namespace PB
         *
         * \param shaderCode The respective code for the shader to be compiled.
         *
-        * \return True if the shader compiled successfully, False otherwise.
+        * \return True if the shader was submitted for compiling, False otherwise.  Compile errors are
+        * reported once the shader program is linked.
         */
         bool loadGeometryShader(const std::string& shaderCode);
 
@@ -71,7 +147,8 @@ namespace PB
         *
         * \param shaderCode The respective code for the shader to be compiled.
         *
-        * \return True if the shader compiled successfully, False otherwise.
+        * \return True if the shader was submitted for compiling, False otherwise.  Compile errors are
+        * reported once the shader program is linked.
         */
         bool loadFragmentShader(const std::string& shaderCode);
 
@@ -83,14 +160,177 @@ namespace PB
         bool init();
 
         /**
-        * \brief Actives the shader program to be used for subsequent render calls.
+        * \brief Starts linking the shader program using the previously submitted shaders, without waiting
+        * on the driver to finish compiling and linking.
+        *
+        * \return True if linking was started, False otherwise.
+        */
+        bool beginInit();
+
+        /**
+        * \brief Checks if the driver finished compiling and linking the shader program started by
+        * `beginInit()`.  This never blocks when the driver compiles in parallel, otherwise it is always True.
+        *
+        * \return True if `finishInit()` can be called without blocking, False otherwise.
+        */
+        bool isReady() const;
+
+        /**
+        * \brief Checks the result of compiling and linking the shader program started by `beginInit()`,
+        * blocking until the driver is done if `isReady()` isn't True yet.
+        *
+        * \return True if the shader program compiled successfully, False otherwise.
+        */
+        bool finishInit();
+
+        /**
+        * \brief Creates the shader program from a program binary previously retrieved with `binary()`.
+        * Drivers may reject binaries, such as after an update, in which case the program must be compiled
+        * from source instead.
+        *
+        * \param binary The program binary to create the shader program from.
+        *
+        * \return True if the driver accepted the program binary, False otherwise.
+        */
+        bool loadBinary(const ShaderBinary& binary);
+
+        /**
+        * \brief Retrieves the linked shader program in the driver's binary format, to be given to
+        * `loadBinary()` on later runs.
+        *
+        * \param binary The program binary to fill.
+        *
+        * \return True if the driver provided a program binary, False otherwise.
+        */
+        bool binary(ShaderBinary* binary) const;
+
+        /**
+        * \brief Creates the shader program without a gfx API behind it, for backends that only record what
+        * would be drawn.  Uniform and attribute lookups are served from the given table alone.
+        *
+        * \param programId The ID to give the shader program.
+        * \param uniforms  The table to serve lookups from, holding the shader program's vertex attributes.
+        */
+        void initHeadless(std::uint32_t programId, std::shared_ptr<UniformTable> uniforms);
+
+        /**
+        * \brief Sets whether the driver compiles shader programs in parallel, letting `isReady()` poll
+        * without blocking.  Set by the gfx API once it detects driver support.
+        *
+        * \param enabled True if the driver compiles in parallel, False otherwise.
         */
-        void use() const;
+        static void setParallelCompile(bool enabled);
 
         /**
-        * \brief Disables the shader program from being used for subsequent render calls.
+        * \brief Checks if the driver supports retrieving and loading program binaries.
+        *
+        * \return True if program binaries are supported, False otherwise.
+        */
+        static bool supportsBinaries();
+
+        /**
+        * \brief Gets the location of a uniform variable in the shader, from the uniforms reflected when the
+        * shader program was linked.  Names the shader program doesn't have are warned about once.
+        *
+        * \param name The name of the uniform variable in the shader.
+        * \return The location of the uniform variable, or -1 if the shader program doesn't have it.
+        */
+        std::int32_t location(const std::string& name) const;
+
+        /**
+        * \brief Gets the location of an active vertex attribute in the shader, from the attributes reflected
+        * when the shader program was linked.
+        *
+        * \param name The name of the vertex attribute in the shader.
+        * \return The location of the vertex attribute, or -1 if the shader program doesn't use it.
+        */
+        std::int32_t attributeLocation(const std::string& name) const;
+
+        /**
+        * \brief Resolves a typed handle to a uniform variable in the shader, to be set with
+        * {\link Shader::set} without looking the uniform up by name each time.
+        *
+        * \param name The name of the uniform variable in the shader.
+        * \return The handle to the uniform variable, which is invalid if the shader program doesn't have it.
+        */
+        template<typename T>
+        UniformHandle<T> uniform(const std::string& name) const
+        {
+            return UniformHandle<T>{location(name)};
+        }
+
+        /**
+        * \brief Sets a Boolean uniform value in the shader.
+        *
+        * \param uniform    The handle of the uniform variable in the shader.
+        * \param value      The desired value for the uniform variable in the shader.
+        */
+        void set(UniformHandle<bool> uniform, bool value) const;
+
+        /**
+        * \brief Sets a Signed Integer uniform value in the shader.
+        *
+        * \param uniform    The handle of the uniform variable in the shader.
+        * \param value      The desired value for the uniform variable in the shader.
+        */
+        void set(UniformHandle<std::int32_t> uniform, std::int32_t value) const;
+
+        /**
+        * \brief Sets a Unsigned Integer uniform value in the shader.
+        *
+        * \param uniform    The handle of the uniform variable in the shader.
+        * \param value      The desired value for the uniform variable in the shader.
+        */
+        void set(UniformHandle<std::uint32_t> uniform, std::uint32_t value) const;
+
+        /**
+        * \brief Sets a Float uniform value in the shader.
+        *
+        * \param uniform    The handle of the uniform variable in the shader.
+        * \param value      The desired value for the uniform variable in the shader.
+        */
+        void set(UniformHandle<float> uniform, float value) const;
+
+        /**
+        * \brief Sets an array of Float uniform values in the shader.
+        *
+        * \param uniform    The handle of the uniform array in the shader.
+        * \param size       The size of the float array.
+        * \param values     Pointer to the float array.
+        */
+        void set(UniformHandle<float> uniform, std::uint32_t size, const float* values) const;
+
+        /**
+        * \brief Sets a Vec2 uniform value in the shader.
+        *
+        * \param uniform    The handle of the uniform variable in the shader.
+        * \param value      The desired value for the uniform variable in the shader.
+        */
+        void set(UniformHandle<vec2> uniform, const vec2& value) const;
+
+        /**
+        * \brief Sets a Vec3 uniform value in the shader.
+        *
+        * \param uniform    The handle of the uniform variable in the shader.
+        * \param value      The desired value for the uniform variable in the shader.
+        */
+        void set(UniformHandle<vec3> uniform, const vec3& value) const;
+
+        /**
+        * \brief Sets a Vec4 uniform value in the shader.
+        *
+        * \param uniform    The handle of the uniform variable in the shader.
+        * \param value      The desired value for the uniform variable in the shader.
+        */
+        void set(UniformHandle<vec4> uniform, const vec4& value) const;
+
+        /**
+        * \brief Sets a Mat4 uniform value in the shader.
+        *
+        * \param uniform    The handle of the uniform variable in the shader.
+        * \param mat        The desired value for the uniform variable in the shader.
         */
-        void unuse() const;
+        void set(UniformHandle<mat4> uniform, const mat4& mat) const;
 
         /**
         * \brief Sets a Boolean uniform value in the shader.
@@ -225,5 +465,7 @@ namespace PB
         std::uint32_t vertexShaderId_ = 0;
         std::uint32_t geometryShaderId_ = 0;
         std::uint32_t fragmentShaderId_ = 0;
+        /** Shared by copies of the shader, so names looked up through one copy are known to all */
+        std::shared_ptr<UniformTable> uniforms_{};
     };
 }
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "ShaderBinaryCache.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "BinaryFormat.h"
+#include "CookedFormat.h"
+#include "Logger.h"
+
+namespace PB
+{
+    namespace
+    {
+        std::uint64_t hashStage(std::uint64_t hash, const std::string& code)
+        {
+            // The length keeps code moving between stages from hashing the same
+            const auto length = static_cast<std::uint64_t>(code.size());
+            hash = BinaryFormat::hashBytes(&length, sizeof(length), hash);
+
+            return BinaryFormat::hashBytes(code.data(), code.size(), hash);
+        }
+    }
+
+    ShaderBinaryCache::ShaderBinaryCache(std::string cachePath, std::string driverId)
+            : cachePath_(std::move(cachePath)), driverId_(std::move(driverId))
+    {
+
+    }
+
+    ShaderBinaryCache::~ShaderBinaryCache()
+    {
+        save();
+
+        if (hits_ + misses_ > 0)
+        {
+            LOGGER_INFO("Loaded " + std::to_string(hits_) + " shader programs from '" + cachePath_ + "', compiled "
+                        + std::to_string(misses_));
+        }
+    }
+
+    bool ShaderBinaryCache::load()
+    {
+        const auto status = CookedFormat::readCacheFile(
+                cachePath_,
+                CookedFormat::SHADER_CACHE_MAGIC,
+                "shader cache",
+                [this](BinaryFormat::Reader& reader, const std::shared_ptr<std::uint8_t[]>&) {
+                    if (reader.readString() != driverId_)
+                    {
+                        LOGGER_INFO("Driver changed since '" + cachePath_
+                                    + "' was written, shaders will be compiled again");
+                        return false;
+                    }
+
+                    const std::uint32_t count = reader.readUInt32();
+
+                    for (std::uint32_t i = 0; i < count && !reader.overrun(); ++i)
+                    {
+                        const std::uint64_t keyLow = reader.readUInt32();
+                        const std::uint64_t key = keyLow | (static_cast<std::uint64_t>(reader.readUInt32()) << 32);
+                        const std::uint32_t format = reader.readUInt32();
+                        const std::uint32_t size = reader.readUInt32();
+                        const std::uint8_t* bytes = reader.readBytes(size);
+
+                        if (bytes != nullptr)
+                        {
+                            entries_[key] = {format, std::vector<std::uint8_t>(bytes, bytes + size)};
+                        }
+                    }
+
+                    return true;
+                });
+
+        if (status != CookedFormat::CacheFileStatus::READ)
+        {
+            entries_.clear();
+            dirty_ = dirty_ || status == CookedFormat::CacheFileStatus::DISCARDED;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ShaderBinaryCache::find(std::uint64_t key, ShaderBinary* binary)
+    {
+        auto itr = entries_.find(key);
+
+        if (itr == entries_.end())
+        {
+            ++misses_;
+            return false;
+        }
+
+        ++hits_;
+        *binary = itr->second;
+
+        return true;
+    }
+
+    void ShaderBinaryCache::store(std::uint64_t key, ShaderBinary binary)
+    {
+        entries_[key] = std::move(binary);
+        dirty_ = true;
+    }
+
+    void ShaderBinaryCache::remove(std::uint64_t key)
+    {
+        if (entries_.erase(key) > 0)
+        {
+            // Counted as a hit by find(), but it ends up compiled
+            --hits_;
+            ++misses_;
+            dirty_ = true;
+        }
+    }
+
+    bool ShaderBinaryCache::save()
+    {
+        if (!dirty_)
+        {
+            return true;
+        }
+
+        const auto sortedEntries = CookedFormat::sortedEntries(entries_);
+
+        const bool written = CookedFormat::writeCacheFile(
+                cachePath_,
+                CookedFormat::SHADER_CACHE_MAGIC,
+                "shader cache",
+                [this, &sortedEntries](BinaryFormat::Writer& writer) {
+                    writer.writeString(driverId_);
+                    writer.writeUInt32(static_cast<std::uint32_t>(sortedEntries.size()));
+
+                    for (const auto* entry: sortedEntries)
+                    {
+                        writer.writeUInt32(static_cast<std::uint32_t>(entry->first));
+                        writer.writeUInt32(static_cast<std::uint32_t>(entry->first >> 32));
+                        writer.writeUInt32(entry->second.format);
+                        writer.writeUInt32(static_cast<std::uint32_t>(entry->second.bytes.size()));
+                        writer.writeBytes(entry->second.bytes.data(), entry->second.bytes.size());
+                    }
+                });
+
+        if (!written)
+        {
+            return false;
+        }
+
+        dirty_ = false;
+
+        LOGGER_DEBUG("Wrote " + std::to_string(sortedEntries.size()) + " shader programs to '" + cachePath_ + "'");
+
+        return true;
+    }
+
+    std::uint64_t ShaderBinaryCache::sourceKey(
+            const std::string& vertexCode,
+            const std::string& geometryCode,
+            const std::string& fragmentCode)
+    {
+        std::uint64_t hash = BinaryFormat::FNV_OFFSET_BASIS;
+        hash = hashStage(hash, vertexCode);
+        hash = hashStage(hash, geometryCode);
+        hash = hashStage(hash, fragmentCode);
+
+        return hash;
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "Shader.h"
+
+namespace PB
+{
+    /**
+    * \brief An on-disk cache of linked shader program binaries (see {\link CookedFormat.h}), so shader
+    * programs seen on an earlier run are loaded with a single driver call instead of being compiled again.
+    *
+    * <p>Binaries are keyed by a hash of the shader program's stage sources, and the whole cache is tied
+    * to the driver that linked them, so a driver update or a different GPU discards it.  Binaries the driver
+    * rejects anyway are dropped with {\link ShaderBinaryCache::remove}.  New binaries are written back when
+    * the cache is destroyed.  Only used from the main thread, alongside the gfx API calls.</p>
+    */
+    class ShaderBinaryCache
+    {
+    public:
+        /**
+        * \brief Creates an empty cache for the given driver.
+        *
+        * \param cachePath The path of the cache file.
+        * \param driverId  Identifies the driver the cached binaries are linked by.
+        */
+        ShaderBinaryCache(std::string cachePath, std::string driverId);
+
+        ShaderBinaryCache(const ShaderBinaryCache&) = delete;
+
+        ShaderBinaryCache& operator=(const ShaderBinaryCache&) = delete;
+
+        /**
+        * \brief Saves any newly cached binaries, and reports the cache hits and misses.
+        */
+        ~ShaderBinaryCache();
+
+        /**
+        * \brief Reads the cache file, keeping its binaries if they were linked by the same driver.
+        *
+        * \return True if the cache was read and its binaries kept, False otherwise.
+        */
+        bool load();
+
+        /**
+        * \brief Finds the cached binary of the shader program with the given source key.
+        *
+        * \param key    The source key of the shader program, from {\link ShaderBinaryCache::sourceKey}.
+        * \param binary The program binary to fill.
+        * \return True if a binary is cached for the key, False otherwise.
+        */
+        bool find(std::uint64_t key, ShaderBinary* binary);
+
+        /**
+        * \brief Caches the binary of the shader program with the given source key, to be written when the
+        * cache is saved.
+        *
+        * \param key    The source key of the shader program.
+        * \param binary The linked program binary.
+        */
+        void store(std::uint64_t key, ShaderBinary binary);
+
+        /**
+        * \brief Drops the cached binary with the given source key, used when the driver rejects it.
+        *
+        * \param key The source key of the shader program.
+        */
+        void remove(std::uint64_t key);
+
+        /**
+        * \brief Writes the cache file, if any binaries changed since it was read.
+        *
+        * \return True if the cache file is up to date, False if it could not be written.
+        */
+        bool save();
+
+        /**
+        * \brief Hashes the stage sources of a shader program into the key its binary is cached under.
+        *
+        * \param vertexCode   The vertex shader source.
+        * \param geometryCode The geometry shader source.
+        * \param fragmentCode The fragment shader source.
+        * \return The 64-bit FNV-1a hash of the stage sources.
+        */
+        static std::uint64_t sourceKey(
+                const std::string& vertexCode,
+                const std::string& geometryCode,
+                const std::string& fragmentCode);
+
+    private:
+        std::string cachePath_;
+        std::string driverId_;
+        std::unordered_map<std::uint64_t, ShaderBinary> entries_{};
+        bool dirty_ = false;
+        std::uint32_t hits_ = 0;
+        std::uint32_t misses_ = 0;
+    };
+}
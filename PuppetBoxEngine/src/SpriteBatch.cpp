@@ -0,0 +1,203 @@
+#include "SpriteBatch.h"
+
+#include <cstddef>
+
+namespace PB
+{
+    namespace
+    {
+        constexpr std::uint32_t INSTANCE_STRIDE = sizeof(SpriteInstance);
+    }
+
+    static_assert(sizeof(SpriteInstance) == 24 * sizeof(float), "SpriteInstance must be tightly packed floats");
+
+    bool SpriteBatch::isInstanced(const Shader& shader)
+    {
+        return shader.attributeLocation("instanceTransform") == static_cast<std::int32_t>(TRANSFORM_LOCATION);
+    }
+
+    void SpriteBatch::submit(
+            const Shader& shader,
+            const ImageReference& texture,
+            const Mesh& mesh,
+            bool alphaBlending,
+            const SpriteInstance& instance)
+    {
+        const BatchKey key{shader.id(), texture.id(), mesh.VAO, alphaBlending};
+        auto itr = batchIndexes_.find(key);
+
+        if (itr == batchIndexes_.end())
+        {
+            if (batchCount_ == batches_.size())
+            {
+                batches_.emplace_back();
+            }
+
+            Batch& batch = batches_[batchCount_];
+
+            // Slots usually get the same batch frame to frame, so the lookup is only made when the shader changes
+            if (!batch.shader.isSameProgram(shader))
+            {
+                batch.diffuseMapUniform = shader.uniform<std::int32_t>("material.diffuseMap");
+            }
+
+            batch.shader = shader;
+            batch.texture = texture;
+            batch.alphaBlending = alphaBlending;
+
+            itr = batchIndexes_.emplace(key, batchCount_++).first;
+        }
+
+        Batch& batch = batches_[itr->second];
+
+        // Arena meshes are told apart by their ranges, any other mesh is alone in its batch
+        std::uint32_t meshIndex = 0;
+
+        while (meshIndex < batch.meshCount
+               && (batch.meshes[meshIndex].mesh.firstIndex != mesh.firstIndex
+                   || batch.meshes[meshIndex].mesh.baseVertex != mesh.baseVertex))
+        {
+            ++meshIndex;
+        }
+
+        if (meshIndex == batch.meshCount)
+        {
+            if (batch.meshCount == batch.meshes.size())
+            {
+                batch.meshes.emplace_back();
+            }
+
+            batch.meshes[batch.meshCount++].mesh = mesh;
+        }
+
+        batch.meshes[meshIndex].instances.push_back(instance);
+    }
+
+    void SpriteBatch::flush(CommandList& commandList)
+    {
+        drawCalls_ = 0;
+        instanceCount_ = 0;
+
+        if (batchCount_ == 0)
+        {
+            return;
+        }
+
+        commandList.beginPass(RenderPass::SPRITES);
+
+        for (std::uint32_t i = 0; i < batchCount_; ++i)
+        {
+            Batch& batch = batches_[i];
+            MeshInstances& first = batch.meshes[0];
+
+            // Left set for the next batch, the GFX API skips whatever the batches share
+            commandList.setBlending(batch.alphaBlending || batch.texture.requiresAlphaBlending);
+            commandList.useProgram(batch.shader.id());
+            commandList.bindTexture(0, batch.texture.id());
+            commandList.setUniform(batch.diffuseMapUniform, 0);
+
+            commandList.bindVertexArray(first.mesh.VAO);
+
+            if (batch.meshCount == 1)
+            {
+                const auto count = static_cast<std::uint32_t>(first.instances.size());
+
+                commandList.upload(
+                        UploadUsage::INSTANCE_DATA,
+                        first.instances.data(),
+                        count * static_cast<std::uint32_t>(sizeof(SpriteInstance)));
+                setInstanceAttributes(commandList);
+
+                commandList.draw(first.mesh, count);
+            }
+            else
+            {
+                drawArenaMeshes(batch, commandList);
+            }
+
+            // The mesh's vertex array is also drawn without instancing
+            clearInstanceAttributes(commandList);
+
+            for (std::uint32_t m = 0; m < batch.meshCount; ++m)
+            {
+                instanceCount_ += static_cast<std::uint32_t>(batch.meshes[m].instances.size());
+                batch.meshes[m].instances.clear();
+            }
+
+            batch.meshCount = 0;
+            ++drawCalls_;
+        }
+
+        commandList.endPass();
+
+        batchIndexes_.clear();
+        batchCount_ = 0;
+    }
+
+    std::uint32_t SpriteBatch::drawCalls() const
+    {
+        return drawCalls_;
+    }
+
+    std::uint32_t SpriteBatch::instanceCount() const
+    {
+        return instanceCount_;
+    }
+
+    void SpriteBatch::drawArenaMeshes(const Batch& batch, CommandList& commandList)
+    {
+        arenaInstances_.clear();
+        arenaDraws_.clear();
+
+        for (std::uint32_t m = 0; m < batch.meshCount; ++m)
+        {
+            const MeshInstances& meshInstances = batch.meshes[m];
+
+            DrawIndirectCommand draw{};
+            draw.count = static_cast<std::uint32_t>(meshInstances.mesh.drawCount);
+            draw.instanceCount = static_cast<std::uint32_t>(meshInstances.instances.size());
+            draw.firstIndex = meshInstances.mesh.firstIndex;
+            draw.baseVertex = meshInstances.mesh.baseVertex;
+            draw.baseInstance = static_cast<std::uint32_t>(arenaInstances_.size());
+            arenaDraws_.push_back(draw);
+
+            arenaInstances_.insert(arenaInstances_.end(), meshInstances.instances.begin(),
+                                   meshInstances.instances.end());
+        }
+
+        commandList.upload(
+                UploadUsage::INSTANCE_DATA,
+                arenaInstances_.data(),
+                static_cast<std::uint32_t>(arenaInstances_.size() * sizeof(SpriteInstance)));
+        setInstanceAttributes(commandList);
+
+        commandList.multiDrawIndirect(
+                arenaDraws_.data(),
+                static_cast<std::uint32_t>(arenaDraws_.size()),
+                batch.meshes[0].mesh.indexSize);
+    }
+
+    void SpriteBatch::setInstanceAttributes(CommandList& commandList)
+    {
+        // A mat4 attribute takes up 4 consecutive locations, one per column
+        for (std::uint32_t column = 0; column < 4; ++column)
+        {
+            commandList.setInstanceAttribute(TRANSFORM_LOCATION + column, 4, INSTANCE_STRIDE,
+                                             offsetof(SpriteInstance, transform) + column * 4 * sizeof(float));
+        }
+
+        commandList.setInstanceAttribute(UV_ADJUST_LOCATION, 4, INSTANCE_STRIDE, offsetof(SpriteInstance, uvAdjust));
+        commandList.setInstanceAttribute(TINT_LOCATION, 4, INSTANCE_STRIDE, offsetof(SpriteInstance, tint));
+    }
+
+    void SpriteBatch::clearInstanceAttributes(CommandList& commandList)
+    {
+        for (std::uint32_t column = 0; column < 4; ++column)
+        {
+            commandList.clearInstanceAttribute(TRANSFORM_LOCATION + column);
+        }
+
+        commandList.clearInstanceAttribute(UV_ADJUST_LOCATION);
+        commandList.clearInstanceAttribute(TINT_LOCATION);
+    }
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "puppetbox/DataStructures.h"
+
+#include "CommandList.h"
+#include "ImageReference.h"
+#include "Mesh.h"
+#include "Shader.h"
+
+namespace PB
+{
+    /**
+    * \brief The per-instance data of a single batched sprite, streamed to the vertex attributes declared by
+    * instanced shaders (see {\link SpriteBatch}).
+    */
+    struct SpriteInstance
+    {
+        /** The model, bone, and mesh transforms combined */
+        mat4 transform{};
+        /** Scale (xy) and offset (zw) of the sprite's UV rect within its texture */
+        vec4 uvAdjust{};
+        vec4 tint{1.0f, 1.0f, 1.0f, 1.0f};
+    };
+
+    /**
+    * \brief Collects sprite draws over a frame and renders all of those sharing a shader, texture, and vertex array
+    * with a single draw call, uploading their {\link SpriteInstance} data through a {\link CommandList}.
+    *
+    * <p>Every mesh in the mesh arena shares its vertex array, so sprites of different arena meshes are drawn
+    * together with one multi draw, each mesh reading its own range of the instance data.  Other meshes have a
+    * vertex array of their own, and are drawn with an instanced draw per mesh.</p>
+    *
+    * <p>Only shaders that declare the instance attributes are batched, with the following layout:</p>
+    * <pre>
+    * layout (location = 3) in mat4 instanceTransform;
+    * layout (location = 7) in vec4 instanceUvAdjust;
+    * layout (location = 8) in vec4 instanceTint;
+    * </pre>
+    * <p>Batches are drawn in the order they were first submitted to, when {\link SpriteBatch::flush} is
+    * called.</p>
+    */
+    class SpriteBatch
+    {
+    public:
+        static constexpr std::uint32_t TRANSFORM_LOCATION = 3;
+        static constexpr std::uint32_t UV_ADJUST_LOCATION = 7;
+        static constexpr std::uint32_t TINT_LOCATION = 8;
+
+    public:
+        SpriteBatch() = default;
+
+        SpriteBatch(const SpriteBatch&) = delete;
+
+        SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+        /**
+        * \brief Checks if the given shader declares the instance attributes, so sprites using it can be batched.
+        *
+        * \param shader The linked shader program to check.
+        * \return True if the shader reads its transform from the instance attributes, False otherwise.
+        */
+        static bool isInstanced(const Shader& shader);
+
+        /**
+        * \brief Adds a sprite to the batch of its shader, texture, and mesh's vertex array, to be drawn on the next
+        * flush.
+        *
+        * \param shader        The instanced shader program to draw the sprite with.
+        * \param texture       The texture to draw the sprite with.
+        * \param mesh          The mesh to draw for the sprite.
+        * \param alphaBlending Whether the sprite needs to be drawn with alpha blending.
+        * \param instance      The per-instance data of the sprite.
+        */
+        void submit(
+                const Shader& shader,
+                const ImageReference& texture,
+                const Mesh& mesh,
+                bool alphaBlending,
+                const SpriteInstance& instance);
+
+        /**
+        * \brief Records the draws of all sprites submitted since the last flush, one draw call per batch.
+        *
+        * \param commandList The list to record the draws into.
+        */
+        void flush(CommandList& commandList);
+
+        /**
+        * \brief Gets the number of draw calls made by the last flush.
+        *
+        * \return The number of draw calls made by the last flush.
+        */
+        std::uint32_t drawCalls() const;
+
+        /**
+        * \brief Gets the number of sprites drawn by the last flush.
+        *
+        * \return The number of sprites drawn by the last flush.
+        */
+        std::uint32_t instanceCount() const;
+
+    private:
+        struct MeshInstances
+        {
+            Mesh mesh{};
+            std::vector<SpriteInstance> instances{};
+        };
+
+        struct Batch
+        {
+            Shader shader{""};
+            /** Resolved when the batch is created, unless the slot's last batch had the same shader program */
+            UniformHandle<std::int32_t> diffuseMapUniform{};
+            ImageReference texture{0};
+            bool alphaBlending = false;
+            /** Reused from frame to frame, only the first meshCount are in use */
+            std::vector<MeshInstances> meshes{};
+            std::uint32_t meshCount = 0;
+        };
+
+        /** Shader program, texture, mesh VAO, and alpha blending */
+        using BatchKey = std::tuple<std::uint32_t, std::uint32_t, std::uint32_t, bool>;
+
+    private:
+        /**
+        * \brief Points the instance attributes of the bound VAO at the instances of the last upload.
+        *
+        * \param commandList The list to record the attribute changes into.
+        */
+        static void setInstanceAttributes(CommandList& commandList);
+
+        /**
+        * \brief Disables the instance attributes of the bound VAO again, leaving the mesh as it was.
+        *
+        * \param commandList The list to record the attribute changes into.
+        */
+        static void clearInstanceAttributes(CommandList& commandList);
+
+        /**
+        * \brief Records the draw of a batch whose meshes share the mesh arena's vertex array, drawing every mesh
+        * with a single multi draw.
+        *
+        * \param batch       The batch to draw.
+        * \param commandList The list to record the draw into.
+        */
+        void drawArenaMeshes(const Batch& batch, CommandList& commandList);
+
+    private:
+        /** Reused from frame to frame, only the first batchCount_ are in use */
+        std::vector<Batch> batches_{};
+        std::uint32_t batchCount_ = 0;
+        std::map<BatchKey, std::uint32_t> batchIndexes_{};
+        /** The instances of all meshes of an arena batch, in the order of their draws */
+        std::vector<SpriteInstance> arenaInstances_{};
+        std::vector<DrawIndirectCommand> arenaDraws_{};
+        std::uint32_t drawCalls_ = 0;
+        std::uint32_t instanceCount_ = 0;
+    };
+}
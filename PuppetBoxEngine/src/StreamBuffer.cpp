@@ -0,0 +1,160 @@
+#include "StreamBuffer.h"
+
+#include "Logger.h"
+
+namespace PB
+{
+    namespace
+    {
+        /**
+        * \brief How long to wait on a fence before checking it again, in nanoseconds.
+        */
+        constexpr GLuint64 FENCE_TIMEOUT = 1000000000;
+
+        /**
+        * \brief The largest GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT allowed by the spec.
+        */
+        constexpr std::uint32_t REGION_ALIGNMENT = 256;
+    }
+
+    StreamBuffer::StreamBuffer(GLStateCache& stateCache) : stateCache_(stateCache)
+    {
+
+    }
+
+    StreamBuffer::~StreamBuffer()
+    {
+        for (auto& fence: fences_)
+        {
+            if (fence != nullptr)
+            {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+
+        if (bufferId_ != 0)
+        {
+            stateCache_.bindArrayBuffer(bufferId_);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            stateCache_.bindArrayBuffer(0);
+            glDeleteBuffers(1, &bufferId_);
+            stateCache_.forgetBuffer(bufferId_);
+        }
+    }
+
+    bool StreamBuffer::init(std::uint32_t regionSize)
+    {
+        if (!GLAD_GL_VERSION_4_4 && !GLAD_GL_ARB_buffer_storage)
+        {
+            LOGGER_ERROR("Persistently mapped buffers require OpenGL 4.4 or ARB_buffer_storage");
+            return false;
+        }
+
+        // Keeps every region starting on an offset any binding alignment divides
+        regionSize = ((regionSize + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT) * REGION_ALIGNMENT;
+
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        const GLsizeiptr bufferSize = static_cast<GLsizeiptr>(regionSize) * FRAME_COUNT;
+
+        glGenBuffers(1, &bufferId_);
+        stateCache_.bindArrayBuffer(bufferId_);
+        glBufferStorage(GL_ARRAY_BUFFER, bufferSize, nullptr, flags);
+        mapping_ = static_cast<std::uint8_t*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bufferSize, flags));
+        stateCache_.bindArrayBuffer(0);
+
+        if (mapping_ == nullptr)
+        {
+            LOGGER_ERROR("Failed to map stream buffer of " + std::to_string(bufferSize) + " bytes");
+            glDeleteBuffers(1, &bufferId_);
+            bufferId_ = 0;
+            return false;
+        }
+
+        regionSize_ = regionSize;
+        region_ = FRAME_COUNT - 1;
+
+        return true;
+    }
+
+    void StreamBuffer::beginFrame()
+    {
+        region_ = (region_ + 1) % FRAME_COUNT;
+        regionOffset_ = 0;
+
+        GLsync& fence = fences_[region_];
+
+        if (fence == nullptr)
+        {
+            return;
+        }
+
+        GLenum result = glClientWaitSync(fence, 0, 0);
+
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            ++stalledFrames_;
+
+            // Flushing makes sure the fence is actually submitted, or the wait could never end
+            do
+            {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+            } while (result == GL_TIMEOUT_EXPIRED);
+        }
+
+        if (result == GL_WAIT_FAILED)
+        {
+            LOGGER_ERROR("Failed waiting on stream buffer region " + std::to_string(region_));
+        }
+
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    void StreamBuffer::endFrame()
+    {
+        GLsync& fence = fences_[region_];
+
+        if (fence != nullptr)
+        {
+            glDeleteSync(fence);
+        }
+
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    StreamAllocation StreamBuffer::allocate(std::uint32_t size, std::uint32_t alignment)
+    {
+        const std::uint32_t offset = alignment > 1
+                                     ? ((regionOffset_ + alignment - 1) / alignment) * alignment
+                                     : regionOffset_;
+
+        if (mapping_ == nullptr || offset + size > regionSize_)
+        {
+            if (!warnedFull_)
+            {
+                LOGGER_WARN("Stream buffer region of " + std::to_string(regionSize_) + " bytes is full, "
+                            + std::to_string(size) + " bytes could not be allocated");
+                warnedFull_ = true;
+            }
+
+            return {};
+        }
+
+        regionOffset_ = offset + size;
+
+        const std::uint32_t bufferOffset = region_ * regionSize_ + offset;
+
+        return {mapping_ + bufferOffset, bufferOffset, size};
+    }
+
+    std::uint32_t StreamBuffer::id() const
+    {
+        return bufferId_;
+    }
+
+    std::uint32_t StreamBuffer::stalledFrames() const
+    {
+        return stalledFrames_;
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+#include "GLStateCache.h"
+
+namespace PB
+{
+    /**
+    * \brief A range of a {\link StreamBuffer} handed out for the current frame.
+    */
+    struct StreamAllocation
+    {
+        /** Where to write the data, or nullptr if the frame's region is out of space */
+        void* data = nullptr;
+        /** Offset of the range from the start of the buffer, for binding it to the gfx API */
+        std::uint32_t offset = 0;
+        std::uint32_t size = 0;
+    };
+
+    /**
+    * \brief A buffer for data written by the CPU every frame, such as uniform blocks and instance data, that
+    * is mapped once for the lifetime of the buffer so writes go straight to memory the GPU reads from.
+    *
+    * <p>The buffer is split into one region per frame in flight.  Each frame hands out ranges of its region
+    * front to back with {\link StreamBuffer::allocate}, and a fence placed by {\link StreamBuffer::endFrame}
+    * keeps the region from being written again until the GPU is done drawing that frame.  This removes the
+    * copies and implicit synchronization of re-specifying buffer data every frame.</p>
+    */
+    class StreamBuffer
+    {
+    public:
+        /** Frames the CPU can get ahead of the GPU before waiting on it */
+        static constexpr std::uint32_t FRAME_COUNT = 3;
+
+    public:
+        /**
+        * \brief Creates a stream buffer binding its buffer through the given state cache.
+        *
+        * \param stateCache The state cache of the gfx API owning the buffer.
+        */
+        explicit StreamBuffer(GLStateCache& stateCache);
+
+        StreamBuffer(const StreamBuffer&) = delete;
+
+        StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+        /**
+        * \brief Unmaps and deletes the buffer, along with any pending fences.
+        */
+        ~StreamBuffer();
+
+        /**
+        * \brief Creates and persistently maps the buffer, requires GL 4.4 or ARB_buffer_storage.
+        *
+        * \param regionSize The bytes available to each frame.
+        * \return True if the buffer was created and mapped, False otherwise.
+        */
+        bool init(std::uint32_t regionSize);
+
+        /**
+        * \brief Moves on to the next frame's region, waiting for the GPU to finish the frame that last used
+        * it if it hasn't already.
+        */
+        void beginFrame();
+
+        /**
+        * \brief Fences the current frame's region, to be waited on before the region is written again.  Must be
+        * called after the last draw call reading from it.
+        */
+        void endFrame();
+
+        /**
+        * \brief Hands out a range of the current frame's region, valid until the end of the frame.
+        *
+        * \param size      The bytes to allocate.
+        * \param alignment The alignment of the range's offset, such as GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+        * \return The allocated range, with no data pointer if the region doesn't have enough space left.
+        */
+        StreamAllocation allocate(std::uint32_t size, std::uint32_t alignment);
+
+        /**
+        * \brief Gets the gfx API specific ID of the buffer.
+        *
+        * \return The ID of the buffer.
+        */
+        std::uint32_t id() const;
+
+        /**
+        * \brief Gets the number of frames that had to wait on the GPU before their region could be written.
+        *
+        * \return The number of frames that waited on the GPU.
+        */
+        std::uint32_t stalledFrames() const;
+
+    private:
+        GLStateCache& stateCache_;
+        std::uint32_t bufferId_ = 0;
+        std::uint8_t* mapping_ = nullptr;
+        std::uint32_t regionSize_ = 0;
+        std::uint32_t region_ = 0;
+        /** Bytes of the current region already handed out */
+        std::uint32_t regionOffset_ = 0;
+        std::array<GLsync, FRAME_COUNT> fences_{};
+        std::uint32_t stalledFrames_ = 0;
+        bool warnedFull_ = false;
+    };
+}
@@ -153,6 +153,11 @@ namespace PB
         return false;
     }
 
+    void UIComponent::attributeChanged(UI::Attribute attributeName)
+    {
+
+    }
+
     void UIComponent::setAttributes(std::unique_ptr<UIComponentAttributes> attributes)
     {
         attributes_ = std::move(attributes);
@@ -161,6 +166,7 @@ namespace PB
     void UIComponent::setUIntAttribute(UI::Attribute attributeName, std::uint32_t value)
     {
         attributes_->setUIntAttribute(attributeName, value);
+        attributeChanged(attributeName);
     }
 
     Result<std::uint32_t> UIComponent::getUIntAttribute(UI::Attribute attributeName) const
@@ -171,6 +177,7 @@ namespace PB
     void UIComponent::setIntAttribute(UI::Attribute attributeName, std::int32_t value)
     {
         attributes_->setIntAttribute(attributeName, value);
+        attributeChanged(attributeName);
     }
 
     Result<std::int32_t> UIComponent::getIntAttribute(UI::Attribute attributeName) const
@@ -181,6 +188,7 @@ namespace PB
     void UIComponent::setFloatAttribute(UI::Attribute attributeName, float value)
     {
         attributes_->setFloatAttribute(attributeName, value);
+        attributeChanged(attributeName);
     }
 
     Result<float> UIComponent::getFloatAttribute(UI::Attribute attributeName) const
@@ -191,6 +199,7 @@ namespace PB
     void UIComponent::setStringAttribute(UI::Attribute attributeName, const std::string& value)
     {
         attributes_->setStringAttribute(attributeName, value);
+        attributeChanged(attributeName);
     }
 
     Result<std::string> UIComponent::getStringAttribute(UI::Attribute attributeName) const
@@ -201,6 +210,7 @@ namespace PB
     void UIComponent::setBoolAttribute(UI::Attribute attributeName, bool value)
     {
         attributes_->setBoolAttribute(attributeName, value);
+        attributeChanged(attributeName);
     }
 
     Result<bool> UIComponent::getBoolAttribute(UI::Attribute attributeName) const
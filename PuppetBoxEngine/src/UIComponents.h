@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "puppetbox/DataStructures.h"
@@ -20,7 +21,6 @@ namespace PB
      */
     struct Glyph
     {
-        ImageReference image{0};
         vec3 position{};
         uivec2 atlasPosition{};
         uivec2 originalDimensions{};
@@ -56,12 +56,71 @@ namespace PB
 
         void render() const override;
 
+    protected:
+        void attributeChanged(UI::Attribute attributeName) override;
+
+    private:
+        /**
+         * A line of the text content, with its glyphs positioned relative to the paragraph's top left
+         * once laid out.
+         */
+        struct Paragraph
+        {
+            std::string text{};
+            std::vector<Glyph> glyphs{};
+            /** Offset of the paragraph's last line from its first, zero or negative */
+            float lastLineY = 0;
+            bool laidOut = false;
+        };
+
+    private:
+        /**
+         * \brief Loads the font named by the FONT_TYPE attribute, keeping it resident for as long as the
+         * component uses it.
+         *
+         * \return True if the font was loaded, False otherwise.
+         */
+        bool loadFont();
+
+        /**
+         * \brief Splits the new text content into paragraphs.  If the text was only appended to, paragraphs
+         * before the last existing one keep their layout.
+         */
+        void updateText();
+
+        /**
+         * \brief Positions the glyphs of the given paragraph, wrapping words that overflow the component's
+         * width if word wrap is enabled.
+         *
+         * \param paragraph The paragraph to lay out.
+         */
+        void layoutParagraph(Paragraph& paragraph) const;
+
+        /**
+         * \brief Stacks the paragraphs from the bottom up until the component's height is filled, laying out
+         * any that aren't yet, and builds the glyph instances rendered each frame.
+         */
+        void placeGlyphs();
+
     private:
-        Shader shader_{""};
-        std::uint32_t VAO_;
-        std::uint32_t VBO_;
-        std::vector<Glyph> glyphs{};
         Font font_{};
+        AssetHandle fontHandle_{};
+        std::string text_{};
+        std::vector<Paragraph> paragraphs_{};
+        std::vector<GlyphInstance> instances_{};
+        /** Attributes the paragraph layouts depend on, read when any of them change */
+        struct
+        {
+            std::uint32_t fontSize = 0;
+            std::uint32_t width = 0;
+            float letterSpacing = 1.0f;
+            float wordSpacing = 1.0f;
+            bool wordWrapEnabled = true;
+        } layout_;
+        bool fontDirty_ = true;
+        bool textDirty_ = true;
+        bool layoutDirty_ = true;
+        bool placementDirty_ = true;
     };
 
     class GroupComponent : public GfxUIComponent
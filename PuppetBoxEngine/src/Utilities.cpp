@@ -1,4 +1,5 @@
 #include <cctype>
+#include <iomanip>
 #include <random>
 #include <streambuf>
 #include <utility>
@@ -349,6 +350,13 @@ namespace PB
 
             return lowercaseString;
         }
+
+        std::string formatMilliseconds(double milliseconds)
+        {
+            std::ostringstream stream{};
+            stream << std::fixed << std::setprecision(2) << milliseconds << " ms";
+            return stream.str();
+        }
     }
 
     namespace RandomUtils
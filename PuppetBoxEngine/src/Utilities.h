@@ -1,12 +1,18 @@
 #pragma once
 
+#include <cctype>
+#include <charconv>
 #include <chrono>
 #include <ctime>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 
+#include "puppetbox/DataStructures.h"
+
 #include "Logger.h"
 
 namespace PB
@@ -129,6 +135,83 @@ namespace PB
         */
         bool startsWith(const std::string& str, const std::string& prefix);
 
+        /**
+        * \brief Trims all whitespace from the beginning and the end of the given view, without copying.
+        *
+        * \param str	The view to trim.
+        *
+        * \return A view of the trimmed characters.
+        */
+        inline std::string_view trimView(std::string_view str)
+        {
+            std::size_t start = 0;
+            std::size_t end = str.size();
+
+            while (start < end && std::isspace(static_cast<unsigned char>(str[start])))
+            {
+                ++start;
+            }
+
+            while (end > start && std::isspace(static_cast<unsigned char>(str[end - 1])))
+            {
+                --end;
+            }
+
+            return str.substr(start, end - start);
+        }
+
+        /**
+        * \brief Takes the next line off the front of the given text, without copying.  Both "\n" and "\r\n"
+        * line breaks are recognized, and neither is included in the line.
+        *
+        * \param text	Pointer to the remaining text, advanced past the taken line.
+        *
+        * \return A view of the taken line.
+        */
+        inline std::string_view nextLine(std::string_view* text)
+        {
+            std::size_t lineEnd = text->find('\n');
+            std::string_view line = text->substr(0, lineEnd);
+
+            text->remove_prefix(lineEnd == std::string_view::npos ? text->size() : lineEnd + 1);
+
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+
+            return line;
+        }
+
+        /**
+        * \brief Takes the next whitespace delimited token off the front of the given text, without copying.
+        *
+        * \param text	Pointer to the remaining text, advanced past the taken token.
+        *
+        * \return A view of the taken token, or an empty view if only whitespace remained.
+        */
+        inline std::string_view nextToken(std::string_view* text)
+        {
+            std::size_t start = 0;
+
+            while (start < text->size() && std::isspace(static_cast<unsigned char>((*text)[start])))
+            {
+                ++start;
+            }
+
+            std::size_t end = start;
+
+            while (end < text->size() && !std::isspace(static_cast<unsigned char>((*text)[end])))
+            {
+                ++end;
+            }
+
+            std::string_view token = text->substr(start, end - start);
+            text->remove_prefix(end);
+
+            return token;
+        }
+
         /**
         * \brief Splits the given string by whitespace values, with an option to allow or disallow null values
         * in the array due to repeating whitespace characters in the original string.
@@ -197,6 +280,14 @@ namespace PB
          * \return The new string with all characters transformed to lower case equivalents.
          */
         std::string toLowerCase(const std::string& original);
+
+        /**
+         * \brief Formats a duration for logging, to two decimal places with its unit.
+         *
+         * \param milliseconds The duration to format, in milliseconds.
+         * \return The formatted duration, such as "12.50 ms".
+         */
+        std::string formatMilliseconds(double milliseconds);
     }
 
     /**
@@ -238,6 +329,49 @@ namespace PB
 
             return value;
         }
+
+        /**
+        * \brief Parses a string value into an instance of the specified type, without copying or allocating.
+        *
+        * \param numberAsString	The string representation of the value to parse.
+        * \param defaultValue	The default value to use if the number cannot be parsed.
+        * \param error			Flag indicating an error occurred if set to True.
+        *
+        * \return The value parsed from the string, or the default value if it could not be parsed.
+        */
+        template<typename T>
+        T parseValue(std::string_view numberAsString, T defaultValue, bool* error)
+        {
+            T value = defaultValue;
+            const char* begin = numberAsString.data();
+            const char* end = begin + numberAsString.size();
+
+            // from_chars doesn't take an explicit sign, where stream parsing did
+            if (begin != end && *begin == '+')
+            {
+                ++begin;
+            }
+
+            std::from_chars_result result{};
+
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                result = std::from_chars(begin, end, value, std::chars_format::general);
+            }
+            else
+            {
+                result = std::from_chars(begin, end, value);
+            }
+
+            if (result.ec != std::errc() || result.ptr == begin)
+            {
+                *error = true;
+                value = defaultValue;
+                LOGGER_WARN("Could not parse value '" + std::string(numberAsString) + "'");
+            }
+
+            return value;
+        }
     }
 
     /**
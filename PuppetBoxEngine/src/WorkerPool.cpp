@@ -0,0 +1,78 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+namespace PB
+{
+    WorkerPool::WorkerPool(std::uint32_t threadCount)
+            : threadCount_(threadCount)
+    {
+        if (threadCount_ == 0)
+        {
+            // Leave a core for the main thread
+            threadCount_ = std::max<std::uint32_t>(std::thread::hardware_concurrency(), 2) - 1;
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        stop();
+    }
+
+    void WorkerPool::start()
+    {
+        if (threads_.empty())
+        {
+            for (std::uint32_t i = 0; i < threadCount_; ++i)
+            {
+                threads_.emplace_back([this]() {
+                    std::function<void()> job = jobs_.pop();
+
+                    // An empty job is the signal to shut down
+                    while (job)
+                    {
+                        job();
+                        job = jobs_.pop();
+                    }
+                });
+            }
+        }
+    }
+
+    void WorkerPool::stop()
+    {
+        for (std::uint32_t i = 0; i < threads_.size(); ++i)
+        {
+            jobs_.push(nullptr);
+        }
+
+        for (auto& thread: threads_)
+        {
+            thread.join();
+        }
+
+        threads_.clear();
+    }
+
+    void WorkerPool::submit(std::function<void()> job)
+    {
+        if (threads_.empty())
+        {
+            job();
+        }
+        else
+        {
+            jobs_.push(job);
+        }
+    }
+
+    std::uint32_t WorkerPool::threadCount() const
+    {
+        return threadCount_;
+    }
+
+    bool WorkerPool::isRunning() const
+    {
+        return !threads_.empty();
+    }
+}
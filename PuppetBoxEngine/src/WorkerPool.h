@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "puppetbox/DataStructures.h"
+
+namespace PB
+{
+    /**
+     * \brief A fixed set of worker threads that execute submitted jobs in order of submission.
+     *
+     * <p>Jobs submitted while the pool is not running are executed immediately on the calling thread.</p>
+     */
+    class WorkerPool
+    {
+    public:
+        /**
+         * \brief Creates a worker pool, threads are not created until {\link WorkerPool::start} is called.
+         *
+         * \param threadCount The number of worker threads to use, 0 to pick one based on the hardware.
+         */
+        explicit WorkerPool(std::uint32_t threadCount = 0);
+
+        ~WorkerPool();
+
+        /**
+         * \brief Starts the worker threads.
+         */
+        void start();
+
+        /**
+         * \brief Stops the worker threads after they finish the jobs already submitted.
+         */
+        void stop();
+
+        /**
+         * \brief Submits a job to be executed by the next available worker.
+         *
+         * \param job The job to execute.
+         */
+        void submit(std::function<void()> job);
+
+        /**
+         * \brief Gets the number of worker threads the pool runs with.
+         *
+         * \return The number of worker threads the pool runs with.
+         */
+        std::uint32_t threadCount() const;
+
+        /**
+         * \brief Checks if the pool's worker threads are running.
+         *
+         * \return True if the worker threads are running, False otherwise.
+         */
+        bool isRunning() const;
+
+    private:
+        std::uint32_t threadCount_;
+        std::vector<std::thread> threads_{};
+        Concurrent::Blocking::Queue<std::function<void()>> jobs_{};
+    };
+}
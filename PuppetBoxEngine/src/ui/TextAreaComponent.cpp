@@ -12,64 +12,156 @@ namespace PB
 
     bool TextAreaComponent::init()
     {
-        bool error = false;
-        shader_ = library()->loadShaderAsset("Default/Shader/UI/Glyph", &error);
+        if (library()->glyphBatch() == nullptr)
+        {
+            LOGGER_ERROR("Text areas require the asset library's glyph batch to be initialized");
+            return false;
+        }
+
+        fontDirty_ = false;
+
+        return loadFont();
+    }
+
+    void TextAreaComponent::update(float deltaTime)
+    {
+        //TODO: Still need to handle word breaks and vertical align on text.
 
-        if (error)
+        if (fontDirty_)
         {
-            LOGGER_ERROR("Failed to load shader asset 'Default/Shader/UI/Glyph'");
+            fontDirty_ = false;
+            loadFont();
         }
 
-        // Setting both Vertex and UV origin to 0 to make shader calculations simpler
-        //TODO: This may need to be revisited, offset origin could get weird later
-        //TODO: Utilize the default sprite asset
-        float vertices[] = {
-                // Vertex                           // UV
-                0.0f, 1.0f, 0.0f,       0.0f, 1.0f, // Top left
-                0.0f, 0.0f, 0.0f,       0.0f, 0.0f, // Bot left
-                1.0f, 0.0f, 0.0f,       1.0f, 0.0f, // Bot right
+        if (textDirty_)
+        {
+            textDirty_ = false;
+            updateText();
+        }
 
-                0.0f, 1.0f, 0.0f,       0.0f, 1.0f, // Top left
-                1.0f, 0.0f, 0.0f,       1.0f, 0.0f, // Bot right
-                1.0f, 1.0f, 0.0f,       1.0f, 1.0f  // Top right
-        };
+        if (layoutDirty_)
+        {
+            layoutDirty_ = false;
 
-        glGenVertexArrays(1, &VAO_);
-        glGenBuffers(1, &VBO_);
+            layout_.fontSize = UIComponent::getUIntAttribute(UI::FONT_SIZE).orElse(0);
+            layout_.width = UIComponent::getUIntAttribute(UI::WIDTH).orElse(0);
+            layout_.letterSpacing = UIComponent::getFloatAttribute(UI::LETTER_SPACE).orElse(1.0f);
+            layout_.wordSpacing = UIComponent::getFloatAttribute(UI::WORD_SPACE).orElse(1.0f);
+            layout_.wordWrapEnabled = UIComponent::getBoolAttribute(UI::WORD_WRAP).orElse(true);
 
-        glBindVertexArray(VAO_);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+            for (auto& paragraph: paragraphs_)
+            {
+                paragraph.laidOut = false;
+            }
 
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+            placementDirty_ = true;
+        }
 
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+        if (placementDirty_)
+        {
+            placementDirty_ = false;
+            placeGlyphs();
+        }
+    }
 
-        glBindVertexArray(0);
+    void TextAreaComponent::render() const
+    {
+        // Glyphs are drawn with those of every other text area sharing the font atlas once the frame is flushed
+        if (!instances_.empty())
+        {
+            library()->glyphBatch()->submit(font_.atlas(), instances_);
+        }
+    }
 
-        return !error;
+    void TextAreaComponent::attributeChanged(UI::Attribute attributeName)
+    {
+        switch (attributeName)
+        {
+            case UI::TEXT_CONTENT:
+                textDirty_ = true;
+                break;
+            case UI::FONT_TYPE:
+                fontDirty_ = true;
+                break;
+            case UI::FONT_SIZE:
+            case UI::LETTER_SPACE:
+            case UI::WIDTH:
+            case UI::WORD_SPACE:
+            case UI::WORD_WRAP:
+                layoutDirty_ = true;
+                break;
+            case UI::HEIGHT:
+            case UI::ORIGIN:
+            case UI::POS_X:
+            case UI::POS_Y:
+            case UI::POS_Z:
+                placementDirty_ = true;
+                break;
+            default:
+                break;
+        }
     }
 
-    void TextAreaComponent::update(float deltaTime)
+    bool TextAreaComponent::loadFont()
     {
-        //TODO: Still need to handle word breaks and vertical align on text.
         bool error = false;
 
-        glyphs.clear();
+        // Layouts from a previous font are no longer valid, even if the new one fails to load
+        layoutDirty_ = true;
+
+        Result<std::string> fontName = UIComponent::getStringAttribute(UI::FONT_TYPE);
+
+        //TODO: Load default font if this fails
+        if (fontName.hasResult)
+        {
+            font_ = library()->loadFontAsset(fontName.result, 0, &error);
+            fontHandle_ = library()->acquireAsset(fontName.result);
+
+            if (error)
+            {
+                LOGGER_ERROR("Failed to load font '" + fontName.result + "' for text area");
+                font_ = Font{};
+            }
+        }
 
+        return !error;
+    }
+
+    void TextAreaComponent::updateText()
+    {
         std::string text = UIComponent::getStringAttribute(UI::TEXT_CONTENT).orElse("");
 
-        std::vector<std::string> paragraphs{};
+        if (text == text_)
+        {
+            return;
+        }
+
         std::uint32_t lineStart = 0;
-        std::uint32_t lineEnd = 0;
+
+        if (text.size() > text_.size() && text.compare(0, text_.size(), text_) == 0)
+        {
+            // Appending can only extend the last paragraph, any before it keep their layout
+            std::size_t lastLineBreak = text_.rfind('\n');
+            lineStart = lastLineBreak == std::string::npos ? 0 : lastLineBreak + 1;
+
+            if (lineStart < text_.size())
+            {
+                paragraphs_.pop_back();
+            }
+        }
+        else
+        {
+            paragraphs_.clear();
+        }
+
+        std::uint32_t lineEnd = lineStart;
 
         while (lineEnd < text.size())
         {
             if (text.c_str()[lineEnd] == '\n')
             {
-                paragraphs.push_back(text.substr(lineStart, lineEnd - lineStart));
+                paragraphs_.emplace_back();
+                paragraphs_.back().text = text.substr(lineStart, lineEnd - lineStart);
                 lineStart = lineEnd + 1;
             }
 
@@ -78,186 +170,130 @@ namespace PB
 
         if (lineStart != lineEnd)
         {
-            paragraphs.push_back(text.substr(lineStart, lineEnd - lineStart));
+            paragraphs_.emplace_back();
+            paragraphs_.back().text = text.substr(lineStart, lineEnd - lineStart);
         }
 
-        if (!text.empty())
-        {
-            Result<std::string> fontName = UIComponent::getStringAttribute(UI::FONT_TYPE);
+        text_ = std::move(text);
+        placementDirty_ = true;
+    }
 
-            //TODO: Load default font if this fails
-            if (fontName.hasResult)
-            {
-                font_ = library()->loadFontAsset(fontName.result, 0, &error);
+    void TextAreaComponent::layoutParagraph(Paragraph& paragraph) const
+    {
+        std::vector<Glyph>& glyphs = paragraph.glyphs;
+        glyphs.clear();
 
-                struct
-                {
-                    uivec3 position;
-                    uivec2 dimensions;
-                    std::string fontPath;
-                    std::uint32_t fontSize;
-                    bool wordWrapEnabled;
-                    float letterSpacing;
-                    float wordSpacing;
-                } component;
-
-                component.position.x = UIComponent::getUIntAttribute(UI::POS_X).orElse(0);
-                component.position.y = UIComponent::getUIntAttribute(UI::POS_Y).orElse(0);
-                component.position.z = UIComponent::getUIntAttribute(UI::POS_Z).orElse(0);
-                component.dimensions.x = UIComponent::getUIntAttribute(UI::WIDTH).orElse(0);
-                component.dimensions.y = UIComponent::getUIntAttribute(UI::HEIGHT).orElse(0);
-                component.fontSize = UIComponent::getUIntAttribute(UI::FONT_SIZE).orElse(0);
-                component.fontPath = UIComponent::getStringAttribute(UI::FONT_TYPE).orElse("");
-                component.letterSpacing = UIComponent::getFloatAttribute(UI::LETTER_SPACE).orElse(1.0f);
-                component.wordSpacing = UIComponent::getFloatAttribute(UI::WORD_SPACE).orElse(1.0f);
-                component.wordWrapEnabled = UIComponent::getBoolAttribute(UI::WORD_WRAP).orElse(true);
-
-                float scale = (float) component.fontSize / font_.fontSize();
-
-                std::string::const_iterator c;
-                vec3 localPosition{};
-                vec3 paragraphPosition{};
-
-                float deltaY = component.fontSize + 2;
-
-                float wordFirstLetterOffset = 0;
-
-                std::uint32_t firstCharOfWordIndex = 0;
-                std::uint32_t firstCharOfParagraphIndex = 0;
-
-                std::int32_t paragraphIndex = paragraphs.size();
-
-                // For each paragraph
-                while (-(localPosition.y - deltaY) < component.dimensions.y && --paragraphIndex >= 0)
-                {
-                    c = paragraphs.at(paragraphIndex).begin();
-                    firstCharOfParagraphIndex = glyphs.size();
-                    paragraphPosition.y = 0;
-
-                    // For each character in a paragraph
-                    // localPosition.y represents the "top", so we decrement it as we go.
-                    while (
-                            -(localPosition.y - deltaY) <= component.dimensions.y
-                            && c != paragraphs.at(paragraphIndex).end())
-                    {
-                        // TODO: Add a default character to load for unrecognized ones
-                        TypeCharacter tchar = font_.getCharacter(*c).result;
+        paragraph.laidOut = true;
+        paragraph.lastLineY = 0;
 
-                        Glyph glyph;
+        float scale = (float) layout_.fontSize / font_.fontSize();
 
-                        glyph.charOffsets.x = tchar.bearing.x * scale;
-                        glyph.charOffsets.y = -((tchar.size.y - tchar.bearing.y) * scale);
+        vec3 localPosition{};
+        vec3 paragraphPosition{};
 
-                        glyph.position.x = localPosition.x + glyph.charOffsets.x;
-                        glyph.position.y = paragraphPosition.y + glyph.charOffsets.y;
-                        glyph.position.z = localPosition.z;
+        float deltaY = layout_.fontSize + 2;
 
-                        glyph.originalDimensions = tchar.size;
+        float wordFirstLetterOffset = 0;
 
-                        glyph.scaledDimensions.x = tchar.size.x * scale;
-                        glyph.scaledDimensions.y = tchar.size.y * scale;
+        std::uint32_t firstCharOfWordIndex = 0;
 
-                        glyph.atlasPosition = tchar.atlasPosition;
-                        glyph.image = tchar.image;
+        // For each character in the paragraph
+        for (const char c: paragraph.text)
+        {
+            // TODO: Add a default character to load for unrecognized ones
+            const TypeCharacter* tchar = font_.findCharacter(c);
 
-                        glyph.advance = tchar.advance;
+            if (tchar == nullptr)
+            {
+                continue;
+            }
 
-                        glyph.character = *c;
+            Glyph glyph;
 
-                        // Check for space sto identify the start of a new word
-                        if (*c == ' ')
-                        {
-                            //TODO: Word spacing isn't quite working
-                            glyph.advance = tchar.advance * component.wordSpacing;
-                            // First character of next word will be the next one after this character, so
-                            // size + 1 for next index + 1
-                            firstCharOfWordIndex = glyphs.size() + 1;
-                        }
+            glyph.charOffsets.x = tchar->bearing.x * scale;
+            glyph.charOffsets.y = -((tchar->size.y - tchar->bearing.y) * scale);
 
-                        // Check for horizontal clipping
-                        if ((localPosition.x + glyph.scaledDimensions.x) > component.dimensions.x
-                            && firstCharOfWordIndex < glyphs.size())
-                        {
-                            // If the letter is clipped (and not a space), move the whole word down a line
-                            // if wordwrap is enabled, otherwise it gets thrown out
-                            if (component.wordWrapEnabled)
-                            {
-                                Glyph firstCharOfWordGlyph = glyphs.at(firstCharOfWordIndex);
-                                // Remove character offset to get true x coord of first char in word
-                                wordFirstLetterOffset = firstCharOfWordGlyph.position.x
-                                                        - firstCharOfWordGlyph.charOffsets.x;
-
-                                //TODO: Is this threshold too high?
-                                if (wordFirstLetterOffset > 0.01)
-                                {
-                                    localPosition.x = 0;
-                                    paragraphPosition.y -= deltaY;
-
-                                    // Move every character of the word down
-                                    while (firstCharOfWordIndex < glyphs.size())
-                                    {
-                                        Glyph& storedGlyph = glyphs.at(firstCharOfWordIndex++);
-                                        storedGlyph.position.x = localPosition.x + storedGlyph.charOffsets.x;
-                                        storedGlyph.position.y = paragraphPosition.y + storedGlyph.charOffsets.y;
-                                        localPosition.x += ((storedGlyph.advance >> 6) * component.letterSpacing *
-                                                            scale);
-                                    }
-
-                                    // Update current character as well
-                                    glyph.position.x = localPosition.x + glyph.charOffsets.x;
-                                    glyph.position.y = paragraphPosition.y + glyph.charOffsets.y;
-                                    glyphs.push_back(glyph);
-                                }
-                            }
-                        }
-                        else
-                        {
-                            glyphs.push_back(glyph);
-                        }
+            glyph.position.x = localPosition.x + glyph.charOffsets.x;
+            glyph.position.y = paragraphPosition.y + glyph.charOffsets.y;
+            glyph.position.z = localPosition.z;
 
-                        // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
-                        // bitshift by 6 to get value in pixels (2^6 = 64)
-                        localPosition.x +=
-                                (tchar.advance >> 6) * component.letterSpacing * scale;
+            glyph.originalDimensions = tchar->size;
 
-                        ++c;
-                    }
+            glyph.scaledDimensions.x = tchar->size.x * scale;
+            glyph.scaledDimensions.y = tchar->size.y * scale;
+
+            glyph.atlasPosition = tchar->atlasPosition;
+
+            glyph.advance = tchar->advance;
 
-                    std::uint32_t paragraphToTopDelta;
-                    std::uint32_t paragraphShift;
+            glyph.character = c;
+
+            // Check for space sto identify the start of a new word
+            if (c == ' ')
+            {
+                //TODO: Word spacing isn't quite working
+                glyph.advance = tchar->advance * layout_.wordSpacing;
+                // First character of next word will be the next one after this character, so
+                // size + 1 for next index + 1
+                firstCharOfWordIndex = glyphs.size() + 1;
+            }
+
+            // Check for horizontal clipping
+            if ((localPosition.x + glyph.scaledDimensions.x) > layout_.width
+                && firstCharOfWordIndex < glyphs.size())
+            {
+                // If the letter is clipped (and not a space), move the whole word down a line
+                // if wordwrap is enabled, otherwise it gets thrown out
+                if (layout_.wordWrapEnabled)
+                {
+                    const Glyph& firstCharOfWordGlyph = glyphs.at(firstCharOfWordIndex);
+                    // Remove character offset to get true x coord of first char in word
+                    wordFirstLetterOffset = firstCharOfWordGlyph.position.x
+                                            - firstCharOfWordGlyph.charOffsets.x;
 
-                    // Move current paragraph above previous paragraph
-                    for (std::uint32_t i = firstCharOfParagraphIndex; i < glyphs.size(); ++i)
+                    //TODO: Is this threshold too high?
+                    if (wordFirstLetterOffset > 0.01)
                     {
-                        auto& glyph = glyphs.at(i);
-                        // Difference between top of frame and top of previous paragraph
-                        // This is likely a negative value since y = 0 is the top of the frame
-                        // Because localPosition.y is decremented, the sum gives the delta
-                        // As localPosition.y becomes more negative, this delta gets smaller
-                        paragraphToTopDelta = component.dimensions.y + localPosition.y;
-                        // Distance of the top of the current glyph to the bottom of the paragraph
-                        // This creates a positive value, shifting [0, -1, -2, ...] to [..., 2, 1, 0]
-                        // The calculation is based on the top of the glyph, so shift everything up one extra line,
-                        // making the "bottom" of the glyphs in the last line of the paragraph the origin.
-                        paragraphShift = (-paragraphPosition.y) + deltaY;
-                        // Shift the paragraph "up" so the bottom of the paragraph is at y = 0
-                        glyph.position.y += paragraphShift;
-                        // Shift the paragraph "down" so the bottom of the paragraph is at y = top of previous paragraph
-                        glyph.position.y -= paragraphToTopDelta;
-                    }
+                        localPosition.x = 0;
+                        paragraphPosition.y -= deltaY;
+
+                        // Move every character of the word down
+                        while (firstCharOfWordIndex < glyphs.size())
+                        {
+                            Glyph& storedGlyph = glyphs.at(firstCharOfWordIndex++);
+                            storedGlyph.position.x = localPosition.x + storedGlyph.charOffsets.x;
+                            storedGlyph.position.y = paragraphPosition.y + storedGlyph.charOffsets.y;
+                            localPosition.x += ((storedGlyph.advance >> 6) * layout_.letterSpacing * scale);
+                        }
 
-                    localPosition.x = 0;
-                    // New localPosition.y to track previous paragraph position
-                    localPosition.y += paragraphPosition.y - deltaY;
-                    paragraphPosition.y = 0;
+                        // Update current character as well
+                        glyph.position.x = localPosition.x + glyph.charOffsets.x;
+                        glyph.position.y = paragraphPosition.y + glyph.charOffsets.y;
+                        glyphs.push_back(glyph);
+                    }
                 }
             }
+            else
+            {
+                glyphs.push_back(glyph);
+            }
+
+            // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
+            // bitshift by 6 to get value in pixels (2^6 = 64)
+            localPosition.x += (tchar->advance >> 6) * layout_.letterSpacing * scale;
         }
+
+        paragraph.lastLineY = paragraphPosition.y;
     }
 
-    void TextAreaComponent::render() const
+    void TextAreaComponent::placeGlyphs()
     {
-        //TODO: Abstract the OpenGL calls/logic away
+        instances_.clear();
+
+        if (!font_.isInitialized())
+        {
+            return;
+        }
 
         struct
         {
@@ -272,84 +308,74 @@ namespace PB
         component.position.y = UIComponent::getUIntAttribute(UI::POS_Y).orElse(0);
         component.position.z = UIComponent::getUIntAttribute(UI::POS_Z).orElse(0);
 
-        component.dimension.x = UIComponent::getUIntAttribute(UI::WIDTH).orElse(0);
+        component.dimension.x = layout_.width;
         component.dimension.y = UIComponent::getUIntAttribute(UI::HEIGHT).orElse(0);
 
-        std::int32_t fontHeight = UIComponent::getUIntAttribute(UI::FONT_SIZE).orElse(0);
+        std::int32_t fontHeight = layout_.fontSize;
 
-        shader_.use();
-        shader_.setVec3("textColour", vec3{1.0f, 1.0f, 1.0f});
+        bool originTop = component.origin == UI::TOP_LEFT || component.origin == UI::TOP_RIGHT;
+        //TODO: Still need to implement this
+        bool originRight = component.origin == UI::TOP_RIGHT || component.origin == UI::BOTTOM_RIGHT;
 
-        glBindVertexArray(VAO_);
+        vec3 containerOffset{};
+        containerOffset.x = component.position.x - (component.dimension.x * originRight);
+        containerOffset.y = component.position.y
+                            // Raises up if origin is bottom
+                            // NOTE: Glyph vertices are drawn with origin in bottom left, so adjust for font height
+                            // when raising up.
+                            + (component.dimension.y - fontHeight)
+                            // Brings back down if origin is top
+                            - (component.dimension.y * originTop);
 
-        const std::uint32_t MAX_INSTANCE_COUNT = 25;
-        const std::uint32_t MAX_INSTANCE_SIZE = MAX_INSTANCE_COUNT * 9;
+        const ImageReference atlas = font_.atlas();
 
-        auto itr = glyphs.begin();
-        float instanceData[MAX_INSTANCE_SIZE];
-        std::uint32_t instanceCount = 0;
+        float deltaY = layout_.fontSize + 2;
 
-        TypeCharacter c = font_.getCharacter(' ').result;
-        c.image.use(0);
+        // Tracks the top of the previously placed paragraph, decremented as paragraphs are stacked
+        float previousParagraphY = 0;
 
-        std::uint32_t instanceDataIndex = 0;
+        std::int32_t paragraphIndex = paragraphs_.size();
 
-        // Build sets of 100 glyphs, then render them as an instance group
-        while (itr != glyphs.end())
+        // Paragraphs are stacked from the last one up, until they no longer fit
+        while (-(previousParagraphY - deltaY) < component.dimension.y && --paragraphIndex >= 0)
         {
-            if (instanceCount >= MAX_INSTANCE_COUNT)
-            {
-                shader_.setFloatArray("instanceData", instanceDataIndex, instanceData);
+            Paragraph& paragraph = paragraphs_.at(paragraphIndex);
 
-                glDrawArraysInstanced(GL_TRIANGLES, 0, 6, instanceCount);
-
-                instanceCount = 0;
-                instanceDataIndex = 0;
+            if (!paragraph.laidOut)
+            {
+                layoutParagraph(paragraph);
             }
 
-            bool originTop = component.origin == UI::TOP_LEFT || component.origin == UI::TOP_RIGHT;
-            //TODO: Still need to implement this
-            bool originRight = component.origin == UI::TOP_RIGHT || component.origin == UI::BOTTOM_RIGHT;
-
-            vec3 containerOffset{};
-            containerOffset.x = component.position.x - (component.dimension.x * originRight);
-            containerOffset.y = component.position.y
-                                // Raises up if origin is bottom
-                                // NOTE: Glyph vertices are drawn with origin in bottom left, so adjust for font height
-                                // when raising up.
-                                + (component.dimension.y - fontHeight)
-                                // Brings back down if origin is top
-                                - (component.dimension.y * originTop);
-
-            instanceData[instanceDataIndex++] = itr->position.x + containerOffset.x;
-            instanceData[instanceDataIndex++] = itr->position.y + containerOffset.y;// + itr->scaledDimensions.y;
-            instanceData[instanceDataIndex++] = itr->position.z;
-            instanceData[instanceDataIndex++] = itr->scaledDimensions.x;
-            instanceData[instanceDataIndex++] = itr->scaledDimensions.y;
-            instanceData[instanceDataIndex++] = static_cast<float>(itr->atlasPosition.x) / itr->image.width;
-            instanceData[instanceDataIndex++] = static_cast<float>(itr->atlasPosition.y) / itr->image.height;
-            instanceData[instanceDataIndex++] = static_cast<float>(itr->originalDimensions.x) / itr->image.width;
-            instanceData[instanceDataIndex++] = static_cast<float>(itr->originalDimensions.y) / itr->image.height;
-
-            ++itr;
-            ++instanceCount;
-        }
-
-        // Render any remaining glyphs
-        if (instanceCount > 0)
-        {
-            shader_.setFloatArray("instanceData", instanceDataIndex, instanceData);
-
-            glDrawArraysInstanced(GL_TRIANGLES, 0, 6, instanceCount);
+            // Difference between top of frame and top of previous paragraph
+            // This is likely a negative value since y = 0 is the top of the frame
+            // Because previousParagraphY is decremented, the sum gives the delta
+            // As previousParagraphY becomes more negative, this delta gets smaller
+            std::uint32_t paragraphToTopDelta = component.dimension.y + previousParagraphY;
+            // Distance of the top of the current glyph to the bottom of the paragraph
+            // This creates a positive value, shifting [0, -1, -2, ...] to [..., 2, 1, 0]
+            // The calculation is based on the top of the glyph, so shift everything up one extra line,
+            // making the "bottom" of the glyphs in the last line of the paragraph the origin.
+            std::uint32_t paragraphShift = (-paragraph.lastLineY) + deltaY;
+
+            for (const auto& glyph: paragraph.glyphs)
+            {
+                GlyphInstance instance{};
+                instance.position.x = glyph.position.x + containerOffset.x;
+                // Shift the paragraph "up" so the bottom of the paragraph is at y = 0, then "down" so
+                // the bottom of the paragraph is at y = top of previous paragraph
+                instance.position.y = glyph.position.y + paragraphShift - paragraphToTopDelta + containerOffset.y;
+                instance.position.z = glyph.position.z;
+                instance.dimensions = glyph.scaledDimensions;
+                instance.uvRect.x = static_cast<float>(glyph.atlasPosition.x) / atlas.width;
+                instance.uvRect.y = static_cast<float>(glyph.atlasPosition.y) / atlas.height;
+                instance.uvRect.z = static_cast<float>(glyph.originalDimensions.x) / atlas.width;
+                instance.uvRect.w = static_cast<float>(glyph.originalDimensions.y) / atlas.height;
+
+                instances_.push_back(instance);
+            }
 
-            instanceCount = 0;
-            instanceDataIndex = 0;
+            // New previousParagraphY to track previous paragraph position
+            previousParagraphY += paragraph.lastLineY - deltaY;
         }
-
-        glBindVertexArray(0);
-
-        c.image.unuse(0);
-
-        shader_.unuse();
     }
-}
\ No newline at end of file
+}
@@ -4,6 +4,7 @@ out vec4 FragColor;
 in VS_OUT
 {
 	vec2 uvCoord;
+	vec4 tint;
 } vs_out;
 
 struct Material
@@ -24,5 +25,5 @@ void main()
 	
 	if (_diffuseTexel.a < 0.1) discard;
 	
-	FragColor = _diffuseTexel;
+	FragColor = _diffuseTexel * vs_out.tint;
 }
\ No newline at end of file
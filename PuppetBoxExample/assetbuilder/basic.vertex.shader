@@ -2,10 +2,14 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aUv;
+layout (location = 3) in mat4 instanceTransform;
+layout (location = 7) in vec4 instanceUvAdjust;
+layout (location = 8) in vec4 instanceTint;
 
 out VS_OUT
 {
 	vec2 uvCoord;
+	vec4 tint;
 } vs_out;
 
 layout(std140) uniform Transforms
@@ -14,15 +18,13 @@ layout(std140) uniform Transforms
 	mat4 projection;
 	mat4 view;
 };
-uniform mat4 model;
-uniform mat4 boneTransform;
-uniform mat4 meshTransform;
 
 void main()
 {
 	vec4 local = vec4(aPos, 1.0);
 	
-	gl_Position = projection * view * model * boneTransform * meshTransform * local;
+	gl_Position = projection * view * instanceTransform * local;
 	
-	vs_out.uvCoord = aUv;
+	vs_out.uvCoord = (aUv * instanceUvAdjust.xy) + instanceUvAdjust.zw;
+	vs_out.tint = instanceTint;
 }
\ No newline at end of file
@@ -4,15 +4,20 @@ import zipfile
 
 args = sys.argv
 
+# Already compressed (or binary) formats are stored as is, so the engine can read them without inflating
+STORED_EXTENSIONS = {'.png', '.pbanim', '.pbmesh'}
+
 
 def zip_dir(path, ziph):
     for root, dirs, files in os.walk(path):
         for file in files:
             if file != os.path.basename(__file__) and file != 'Assets1.zip':
                 filename = os.path.join(root, file)
+                compression = zipfile.ZIP_STORED if os.path.splitext(file)[1] in STORED_EXTENSIONS else zipfile.ZIP_DEFLATED
                 ziph.write(
                     filename,
-                    os.path.relpath(filename, os.path.join(path, '.'))
+                    os.path.relpath(filename, os.path.join(path, '.')),
+                    compression
                 )
 
 
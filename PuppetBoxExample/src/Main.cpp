@@ -6,6 +6,9 @@
 // Required signature, Entry point is in SDL2
 int main(int argc, char** argv)
 {
+    // Scenes load their assets in setUps, and create objects for network events on the main thread, so the
+    // next frame can be updated while the last one is drawn
+    PB::SetRenderThreadEnabled(true);
     PB::Init("PuppetBox - My Window", 800, 600, 1000);
 
     PB::Run([]() {
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <unordered_set>
@@ -185,6 +187,8 @@ protected:
 
     void preLoopUpdates(float deltaTime) override
     {
+        runMainThreadUpdates();
+
         if (playerToControl_ != PB::UUID::nullUUID())
         {
             //TODO: Super hacky logic
@@ -276,8 +280,41 @@ private:
     float timeSinceLastLocationUpdate_ = 0.0f;
     ScreenTranslator screenTranslator_{};
     std::queue<PB::UUID> subscriptions_{};
+    std::mutex mainThreadMutex_{};
+    std::queue<std::function<void()>> mainThreadUpdates_{};
 
 private:
+    /**
+     * \brief Queues an update to run on the main thread at the start of the next scene update, for event handlers
+     * that create GFX API resources, which can't be done from the network thread publishing their events.
+     *
+     * \param update The update to run.
+     */
+    void onMainThread(std::function<void()> update)
+    {
+        std::unique_lock<std::mutex> mlock(mainThreadMutex_);
+        mainThreadUpdates_.push(std::move(update));
+    }
+
+    /**
+     * \brief Runs the updates queued by {\link onMainThread}, in the order they were queued.
+     */
+    void runMainThreadUpdates()
+    {
+        std::queue<std::function<void()>> updates{};
+
+        {
+            std::unique_lock<std::mutex> mlock(mainThreadMutex_);
+            std::swap(updates, mainThreadUpdates_);
+        }
+
+        while (!updates.empty())
+        {
+            updates.front()();
+            updates.pop();
+        }
+    }
+
     /**
      * \brief Sets up all the required events for the scene.  Events are permanent once they are registered,
      * and can be shared between scenes.
@@ -327,75 +364,81 @@ private:
 
         Event::Topic::ADD_TO_INVENTORY_TOPIC = PB::RegisterTopic(PBEX_EVENT_ADD_TO_INVENTORY);
         uuid = PB::SubscribeEvent(PBEX_EVENT_ADD_TO_INVENTORY, [this](std::shared_ptr<void> data) {
-            auto addToInvEvent = std::static_pointer_cast<AddToInventoryEvent>(data);
+            // Published on the network thread, scene objects are created on the main thread
+            onMainThread([this, data]() {
+                auto addToInvEvent = std::static_pointer_cast<AddToInventoryEvent>(data);
 
-            Entity* entity = (Entity*) getSceneObject(addToInvEvent->mobUUID);
+                Entity* entity = (Entity*) getSceneObject(addToInvEvent->mobUUID);
 
-            if (entity != nullptr)
-            {
-                auto itr = entity->inventory.find(addToInvEvent->equipSlot);
-
-                if (itr != entity->inventory.end())
+                if (entity != nullptr)
                 {
-                    // If this slot already has an item
+                    auto itr = entity->inventory.find(addToInvEvent->equipSlot);
 
-                    if (entity->equippedItem == itr->second)
+                    if (itr != entity->inventory.end())
                     {
-                        // If it's currently equipped, remove it from the scene, then destroy
-                        removeFromScene(itr->second);
+                        // If this slot already has an item
+
+                        if (entity->equippedItem == itr->second)
+                        {
+                            // If it's currently equipped, remove it from the scene, then destroy
+                            removeFromScene(itr->second);
+                        }
+
+                        destroySceneObject(itr->second);
+                        entity->inventory.erase(itr);
                     }
 
-                    destroySceneObject(itr->second);
-                    entity->inventory.erase(itr);
-                }
+                    auto item = new Entity{};
 
-                auto item = new Entity{};
+                    if (PB::CreateSceneObject(addToInvEvent->itemType, item, addToInvEvent->itemUUID))
+                    {
+                        item->name = "Some Equipment Item";
+                        item->position = {0, 0, 0};
+                        addSceneObject(item);
+                        attachToObject(item->getId(), entity->getId(), entity->getBoneId("weapon_attach_right"));
+                    }
 
-                if (PB::CreateSceneObject(addToInvEvent->itemType, item, addToInvEvent->itemUUID))
-                {
-                    item->name = "Some Equipment Item";
-                    item->position = {0, 0, 0};
-                    addSceneObject(item);
-                    attachToObject(item->getId(), entity->getId(), entity->getBoneId("weapon_attach_right"));
+                    entity->equippedItem = addToInvEvent->itemUUID;
+                    entity->inventory.insert(
+                            std::pair<std::uint8_t, PB::UUID>{addToInvEvent->equipSlot, addToInvEvent->itemUUID}
+                    );
                 }
-
-                entity->equippedItem = addToInvEvent->itemUUID;
-                entity->inventory.insert(
-                        std::pair<std::uint8_t, PB::UUID>{addToInvEvent->equipSlot, addToInvEvent->itemUUID}
-                );
-            }
+            });
         });
 
         subscriptions_.push(uuid);
 
         Event::Topic::EQUIP_ITEM_TOPIC = PB::RegisterTopic(PBEX_EVENT_EQUIP_ITEM);
         uuid = PB::SubscribeEvent(PBEX_EVENT_EQUIP_ITEM, [this](std::shared_ptr<void> data) {
-            auto equipEvent = std::static_pointer_cast<EquipItemEvent>(data);
+            // Published on the network thread, scene objects are created on the main thread
+            onMainThread([this, data]() {
+                auto equipEvent = std::static_pointer_cast<EquipItemEvent>(data);
 
-            Entity* entity = (Entity*) getSceneObject(equipEvent->mobUUID);
+                Entity* entity = (Entity*) getSceneObject(equipEvent->mobUUID);
 
-            if (entity != nullptr && entity->equippedItem != equipEvent->itemUUID)
-            {
-                // Destroy previous item
-                if (entity->equippedItem != PB::UUID::nullUUID())
+                if (entity != nullptr && entity->equippedItem != equipEvent->itemUUID)
                 {
-                    removeFromScene(entity->equippedItem);
-                    destroySceneObject(entity->equippedItem);
-                    entity->equippedItem = PB::UUID::nullUUID();
-                }
+                    // Destroy previous item
+                    if (entity->equippedItem != PB::UUID::nullUUID())
+                    {
+                        removeFromScene(entity->equippedItem);
+                        destroySceneObject(entity->equippedItem);
+                        entity->equippedItem = PB::UUID::nullUUID();
+                    }
 
-                auto item = new Entity{};
+                    auto item = new Entity{};
 
-                if (PB::CreateSceneObject(equipEvent->itemType, item, equipEvent->itemUUID))
-                {
-                    item->name = "Some Item";
-                    item->position = {0, 0, 0};
-                    addSceneObject(item);
-                    attachToObject(item->getId(), entity->getId(), entity->getBoneId("weapon_attach_right"));
-                    moveToScene(item->getId());
-                    entity->equippedItem = equipEvent->itemUUID;
+                    if (PB::CreateSceneObject(equipEvent->itemType, item, equipEvent->itemUUID))
+                    {
+                        item->name = "Some Item";
+                        item->position = {0, 0, 0};
+                        addSceneObject(item);
+                        attachToObject(item->getId(), entity->getId(), entity->getBoneId("weapon_attach_right"));
+                        moveToScene(item->getId());
+                        entity->equippedItem = equipEvent->itemUUID;
+                    }
                 }
-            }
+            });
         });
 
         subscriptions_.push(uuid);
@@ -505,17 +548,20 @@ private:
 
         Event::Topic::CREATE_ENTITY_TOPIC = PB::RegisterTopic(PBEX_EVENT_CREATE_ENTITY);
         uuid = PB::SubscribeEvent(PBEX_EVENT_CREATE_ENTITY, [this](std::shared_ptr<void> data) {
-            auto createEntityEvent = std::static_pointer_cast<CreateEntityEvent>(data);
+            // Published on the network thread, scene objects are created on the main thread
+            onMainThread([this, data]() {
+                auto createEntityEvent = std::static_pointer_cast<CreateEntityEvent>(data);
 
-            auto entity = new Entity{};
+                auto entity = new Entity{};
 
-            if (PB::CreateSceneObject(createEntityEvent->type, entity, createEntityEvent->uuid))
-            {
-                entity->name = "Fred";
-                entity->position = createEntityEvent->position;
-                addSceneObject(entity);
-                moveToScene(entity->getId());
-            }
+                if (PB::CreateSceneObject(createEntityEvent->type, entity, createEntityEvent->uuid))
+                {
+                    entity->name = "Fred";
+                    entity->position = createEntityEvent->position;
+                    addSceneObject(entity);
+                    moveToScene(entity->getId());
+                }
+            });
         });
 
         subscriptions_.push(uuid);
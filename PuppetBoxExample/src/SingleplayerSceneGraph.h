@@ -212,7 +212,7 @@ namespace Singleplayer
             {
                 auto event = std::make_shared<UpdateEntityEvent>();
                 event->action = [](Entity* entity) {
-                    entity->playAnimation(Constants::Animation::kWalk, 0);
+                    entity->playAnimation(Constants::Animation::kWalk, 0, 0.25f);
                 };
 
                 PB::PublishEvent(Event::Topic::UPDATE_ENTITY_TOPIC, event);
@@ -221,7 +221,7 @@ namespace Singleplayer
             {
                 auto event = std::make_shared<UpdateEntityEvent>();
                 event->action = [](Entity* entity) {
-                    entity->playAnimation(Constants::Animation::kIdle0, 0);
+                    entity->playAnimation(Constants::Animation::kIdle0, 0, 0.25f);
                 };
 
                 PB::PublishEvent(Event::Topic::UPDATE_ENTITY_TOPIC, event);
@@ -470,6 +470,7 @@ private:
     AbstractInputProcessor* inputProcessor_ = nullptr;
     ScreenTranslator screenTranslator_{};
     std::queue<PB::UUID> subscriptions_{};
+    std::vector<PB::PreloadHandle> animationPreloads_{};
 
 private:
     /**
@@ -685,9 +686,9 @@ private:
 
         PB::BoneMap boneMap = entity->getBones();
 
-        //TODO: These load times are long, separate thread and maybe some optimizations
-        PB::PreloadAnimationFrames(Constants::Animation::kIdle0, boneMap);
-        PB::PreloadAnimationFrames(Constants::Animation::kWalk, boneMap);
+        // Animations can play while these finish in the background
+        animationPreloads_.push_back(PB::PreloadAnimationFramesAsync(Constants::Animation::kIdle0, boneMap));
+        animationPreloads_.push_back(PB::PreloadAnimationFramesAsync(Constants::Animation::kWalk, boneMap));
 
         auto entity1 = new Entity{};
 
@@ -4,10 +4,12 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "puppetbox/AbstractSceneGraph.h"
 #include "puppetbox/Constants.h"
 #include "puppetbox/Event.h"
+#include "puppetbox/IAnimationCatalogue.h"
 #include "puppetbox/SceneObject.h"
 #include "puppetbox/TypeDef.h"
 #include "puppetbox/UIComponent.h"
@@ -50,6 +52,18 @@ namespace PB
      */
     extern PUPPET_BOX_API bool LoadAssetPack(const std::string& archiveName);
 
+    /**
+     * \brief Cooks an asset package into a load-ready asset pack, written next to it.  Once cooked,
+     * {\link PB::LoadAssetPack} loads the cooked pack instead, skipping all parsing of its assets.
+     *
+     * <p>Does not need the engine to be initialized, so it can be run from offline tools.</p>
+     *
+     * \param archiveRoot The directory containing the asset package, with a trailing separator.
+     * \param archiveName The name of the asset package to cook.
+     * \return True if the asset pack was cooked successfully, False otherwise.
+     */
+    extern PUPPET_BOX_API bool CookAssetPack(const std::string& archiveRoot, const std::string& archiveName);
+
     /**
      * \brief Loads a font asset from the given fully qualified asset path.
      *
@@ -82,6 +96,112 @@ namespace PB
      */
     extern PUPPET_BOX_API bool CreateSceneObject(const std::string& assetPath, SceneObject* sceneObject, UUID uuid);
 
+    /**
+     * \brief Streams the base assets into the given {\link PB::SceneObject} in the background.
+     *
+     * <p>Assets are read and decoded on worker threads, then uploaded on the main thread between frames
+     * within the budget set by {\link PB::SetAssetUploadBudget}.  The {\link PB::SceneObject} must stay alive
+     * until the returned handle is done, and the handle must not be waited on from the main thread.</p>
+     *
+     * \param assetPath     The path to the asset to inject
+     * \param sceneObject   The SceneObject to inject assets into, must not be a nullptr.
+     *
+     * \return A {\link PreloadHandle} for tracking progress and completion of the load.
+     */
+    extern PUPPET_BOX_API PreloadHandle CreateSceneObjectAsync(const std::string& assetPath, SceneObject* sceneObject);
+
+    /**
+     * \brief Streams the base assets into the given {\link PB::SceneObject} in the background, with the given
+     * UUID.
+     *
+     * \param assetPath     The path to the asset to inject
+     * \param sceneObject   The SceneObject to inject assets into, must not be a nullptr.
+     * \param uuid          The {\link PB::UUID} to use for the {\link PB::SceneObject}.
+     *
+     * \return A {\link PreloadHandle} for tracking progress and completion of the load.
+     */
+    extern PUPPET_BOX_API PreloadHandle CreateSceneObjectAsync(
+            const std::string& assetPath,
+            SceneObject* sceneObject,
+            UUID uuid);
+
+    /**
+     * \brief Sets how much streamed asset data may be uploaded per frame, whichever limit is reached first
+     * ends the frame's uploads.
+     *
+     * \param milliseconds The time budget per frame, in milliseconds.
+     * \param bytes        The byte budget per frame.
+     */
+    extern PUPPET_BOX_API void SetAssetUploadBudget(float milliseconds, std::uint64_t bytes);
+
+    /**
+     * \brief Sets the memory budgets for loaded assets.  At the end of each frame, assets that aren't used by
+     * any {\link PB::SceneObject} or {\link UIComponent} are evicted least recently used first, until both
+     * budgets are met.  Both budgets are unlimited by default.
+     *
+     * \param cpuBytes The main memory budget, in bytes.
+     * \param gpuBytes The GPU memory budget, in bytes.
+     */
+    extern PUPPET_BOX_API void SetAssetMemoryBudget(std::uint64_t cpuBytes, std::uint64_t gpuBytes);
+
+    /**
+     * \brief Sets whether frames are recorded instead of drawn, so scenes can be run and their rendering
+     * checked without a GPU.  Disabled by default, must be set before {\link PB::Init}.
+     *
+     * <p>Recorded frames issue no GFX API calls, resources and shader programs are given IDs without being
+     * uploaded or compiled.  {\link PB::GetRenderStats} still counts the commands of each frame.</p>
+     *
+     * \param enabled True to record frames, False to draw them with OpenGL.
+     */
+    extern PUPPET_BOX_API void SetRecordedRendering(bool enabled);
+
+    /**
+     * \brief Sets whether frames are drawn from a dedicated render thread, so the next frame is updated while
+     * the driver works on the last one.  Disabled by default, must be set before {\link PB::Run}.
+     *
+     * <p>Assets are still loaded on the main thread, taking the GFX API context back from the render thread
+     * while they do, so scene set up, streamed uploads, and synchronous loads like {\link PB::CreateSceneObject}
+     * stall the render thread.  Assets are best loaded in the {\link PB::Run} ready callback,
+     * {\link AbstractSceneGraph::setUps}, or with the async functions.  Synchronous loads from any thread other
+     * than the main thread fail, with or without the render thread.</p>
+     *
+     * \param enabled True to draw frames on a dedicated render thread, False to draw them on the main thread.
+     */
+    extern PUPPET_BOX_API void SetRenderThreadEnabled(bool enabled);
+
+    /**
+     * \brief Lists the currently loaded assets, and the memory each of them holds.
+     *
+     * \return The loaded assets, largest first by combined CPU and GPU bytes.
+     */
+    extern PUPPET_BOX_API std::vector<ResidentAsset> GetResidentAssets();
+
+    /**
+     * \brief Gets the render stats of the last frame the GPU finished, counted from the commands submitted for it.
+     *
+     * <p>GPU times are read back a few frames after they're measured so the CPU never waits on them, and are
+     * left unset until the first ones arrive, or if the driver can't measure them.</p>
+     *
+     * \return The render stats of the last finished frame.
+     */
+    extern PUPPET_BOX_API RenderStats GetRenderStats();
+
+    /**
+     * \brief Shows the render stats of the last finished frame in the top left corner of the window, refreshed
+     * a few times a second.  Must be called after {\link PB::Run} has started.
+     *
+     * \param fontPath The path of the font to show the stats in, which must already be loaded with
+     * {\link PB::LoadFontAsset}.
+     * \param fontSize The size of the font to show the stats in.
+     * \return True if the overlay was shown, False otherwise.
+     */
+    extern PUPPET_BOX_API bool ShowRenderStatsOverlay(const std::string& fontPath, std::uint32_t fontSize);
+
+    /**
+     * \brief Hides the render stats overlay shown by {\link PB::ShowRenderStatsOverlay}, if it's shown.
+     */
+    extern PUPPET_BOX_API void HideRenderStatsOverlay();
+
     /**
      * \brief Loads the animations associated with the given asset path.
      *
@@ -100,6 +220,31 @@ namespace PB
      */
     extern PUPPET_BOX_API bool PreloadAnimationFrames(const std::string& animationPath, BoneMap& boneMap);
 
+    /**
+     * \brief Preloads the animation keyframes into memory on worker threads.
+     *
+     * <p>The animation can be played before the preload completes, frames that are not loaded yet
+     * are evaluated on demand.</p>
+     *
+     * \param animationPath The path to the desired animation to preload.
+     * \param boneMap       The skeletal data to use when preloading the keyframes.
+     *
+     * \return A {\link PreloadHandle} for tracking progress and completion of the preload.
+     */
+    extern PUPPET_BOX_API PreloadHandle PreloadAnimationFramesAsync(const std::string& animationPath, BoneMap& boneMap);
+
+    /**
+     * \brief Sets the number of steps each animation frame is split into when sampling, for animations
+     * played afterwards.  Must be called after {\link Init}.
+     *
+     * <p>Instances at the same step of an animation share one evaluated pose, so fewer steps are cheaper
+     * for large crowds but move less smoothly.  The same steps are used whether or not an instance is
+     * blending, so instances don't pop when overrides or layers are toggled.</p>
+     *
+     * \param stepsPerFrame The number of steps per animation frame, or 0 to sample in continuous time.
+     */
+    extern PUPPET_BOX_API void SetAnimationSamplingSteps(std::uint32_t stepsPerFrame);
+
     /**
      * \brief Initiates start of core engine, input processors, and render loops.
      */
@@ -975,6 +975,82 @@ namespace PB
         std::uint32_t length = 0;
     };
 
+    /**
+     * \brief The kinds of assets that are tracked while resident in memory.
+     */
+    enum class AssetType
+    {
+        MESH,
+        IMAGE,
+        SHADER,
+        FONT,
+        MATERIAL
+    };
+
+    /**
+     * \brief Describes an asset that is currently loaded, and the memory it is holding.
+     */
+    struct ResidentAsset
+    {
+        std::string assetPath;
+        AssetType type = AssetType::MESH;
+        /** Bytes held in main memory */
+        std::uint64_t cpuBytes = 0;
+        /** Bytes held by the GFX API, estimated where the API doesn't report them */
+        std::uint64_t gpuBytes = 0;
+        /** Number of live references, only unreferenced assets can be evicted */
+        std::uint32_t references = 0;
+        /** Pinned assets are never evicted, such as the engine's default assets */
+        bool pinned = false;
+    };
+
+    /**
+     * \brief The passes a frame is drawn in, each timed on the GPU separately.
+     */
+    enum class RenderPass : std::uint8_t
+    {
+        /** Meshes drawn one at a time by the scene */
+        SCENE,
+        /** Batched sprites */
+        SPRITES,
+        /** Batched text */
+        TEXT,
+        COUNT
+    };
+
+    /**
+     * \brief Counts of the rendering work submitted for a frame, and the GPU time it took.
+     */
+    struct RenderStats
+    {
+        std::uint32_t commands = 0;
+        std::uint32_t drawCalls = 0;
+        /** Instances drawn by instanced draw calls */
+        std::uint32_t instances = 0;
+        std::uint64_t triangles = 0;
+        std::uint32_t programBinds = 0;
+        std::uint32_t textureBinds = 0;
+        std::uint32_t vertexArrayBinds = 0;
+        /** Uniform values set */
+        std::uint32_t uniformSets = 0;
+        /** Uniform block ranges bound */
+        std::uint32_t uniformRangeBinds = 0;
+        /** Instance attributes pointed at instance data, or cleared back to a constant value */
+        std::uint32_t instanceAttributeSets = 0;
+        /** Blending changes and other fixed function state set */
+        std::uint32_t stateChanges = 0;
+        /** Bytes of uniform block and instance data uploaded */
+        std::uint64_t uploadedBytes = 0;
+        /** Bytes of meshes and images loaded since the frame before, which are uploaded outside the commands */
+        std::uint64_t resourceUploadedBytes = 0;
+        /** Binds and state changes the GFX API skipped, as they were already set */
+        std::uint32_t elidedCalls = 0;
+        /** Whether the GFX API measured the GPU time of the passes */
+        bool gpuTimed = false;
+        /** GPU time of each {\link RenderPass}, in milliseconds, measured a few frames earlier to avoid stalls */
+        float passMilliseconds[static_cast<std::size_t>(RenderPass::COUNT)] = {};
+    };
+
     namespace Concurrent
     {
         namespace NonBlocking
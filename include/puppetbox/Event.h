@@ -10,6 +10,7 @@
 #define PB_EVENT_NETWORK_STATUS     "pb_network_status"
 #define PB_EVENT_SCENE_ADD          "pb_engine_add_scene"
 #define PB_EVENT_SCENE_SET          "pb_engine_set_scene"
+#define PB_EVENT_STATS_OVERLAY      "pb_engine_stats_overlay"
 
 typedef std::function<void(std::shared_ptr<void>, std::uint8_t**, std::uint32_t*)> pb_NetworkEventWriter;
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -43,6 +46,156 @@ namespace PB
         }
     };
 
+    /**
+     * \brief Flattened view of a skeleton used for batch pose evaluation.
+     *
+     * <p>Bones are ordered so that every parent precedes its children, allowing a pose to be
+     * composed in a single forward pass over the arrays.</p>
+     */
+    struct SkeletonLayout
+    {
+        std::vector<std::uint32_t> boneIds{};
+        std::vector<std::string> boneNames{};
+        std::vector<std::int32_t> parentIndexes{};
+        std::vector<vec3> bindPositions{};
+        std::vector<vec3> bindRotations{};
+        std::vector<vec3> bindScales{};
+        std::unordered_map<std::uint32_t, std::uint32_t> boneIndexes{};
+        std::size_t signature = 0;
+
+        std::size_t boneCount() const
+        {
+            return boneIds.size();
+        }
+    };
+
+    /**
+     * \brief Local bone rotations and scales for a single pose, indexed by {\link SkeletonLayout} order.
+     */
+    struct AnimationPose
+    {
+        std::vector<vec3> rotations{};
+        std::vector<vec3> scales{};
+    };
+
+    /**
+     * \brief Local transformation overrides for bones, indexed by {\link SkeletonLayout} order, that
+     * replace the animated pose of the bone.
+     *
+     * <p>Storage is sized once for the skeleton, so setting and clearing overrides never allocates.</p>
+     */
+    struct PoseOverrides
+    {
+        std::vector<mat4> transforms{};
+        std::vector<std::uint8_t> isSet{};
+        std::uint32_t count = 0;
+
+        void resize(std::size_t boneCount)
+        {
+            transforms.resize(boneCount);
+            isSet.resize(boneCount, 0);
+        };
+
+        void set(std::uint32_t boneIndex, const mat4& transform)
+        {
+            count += isSet[boneIndex] ? 0 : 1;
+            isSet[boneIndex] = 1;
+            transforms[boneIndex] = transform;
+        };
+
+        void clear(std::uint32_t boneIndex)
+        {
+            count -= isSet[boneIndex] ? 1 : 0;
+            isSet[boneIndex] = 0;
+        };
+
+        bool has(std::uint32_t boneIndex) const
+        {
+            return count > 0 && isSet[boneIndex];
+        };
+
+        bool empty() const
+        {
+            return count == 0;
+        };
+    };
+
+    /**
+     * \brief Shared state of an asynchronous preload, updated by the worker jobs performing it.
+     */
+    struct PreloadState
+    {
+        std::uint32_t totalUnits = 0;
+        std::atomic<std::uint32_t> completedUnits{0};
+        std::atomic<std::uint32_t> pendingJobs{0};
+        std::promise<bool> result{};
+    };
+
+    /**
+     * \brief Handle to an asynchronous preload, used to poll progress or wait for completion.
+     */
+    class PreloadHandle
+    {
+    public:
+        PreloadHandle() = default;
+
+        explicit PreloadHandle(std::shared_ptr<PreloadState> state)
+                : state_(state), result_(state->result.get_future().share())
+        {
+
+        };
+
+        /**
+         * \brief Gets the fraction of the preload that has completed, suitable for loading bars.
+         *
+         * \return The completed fraction, from 0 to 1.
+         */
+        float progress() const
+        {
+            if (state_ == nullptr || state_->totalUnits == 0)
+            {
+                return 1.0f;
+            }
+
+            return static_cast<float>(state_->completedUnits.load()) / state_->totalUnits;
+        };
+
+        /**
+         * \brief Checks if the preload has finished, successfully or not.
+         *
+         * \return True if the preload has finished, False otherwise.
+         */
+        bool isDone() const
+        {
+            return !result_.valid() || result_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        };
+
+        /**
+         * \brief Blocks until the preload has finished.
+         *
+         * \return True if the preload was successful, False otherwise.
+         */
+        bool wait() const
+        {
+            return result_.valid() && result_.get();
+        };
+
+    private:
+        std::shared_ptr<PreloadState> state_{nullptr};
+        std::shared_future<bool> result_{};
+    };
+
+    /**
+     * \brief Bone transformations shared by every instance at the same (skeleton, step) of an animation, see
+     * {\link IAnimation::getSharedPalette}.
+     */
+    struct SharedPalette
+    {
+        std::vector<mat4> transforms{};
+        /** Bumped each time the palette is reused for another (skeleton, step), so holders can tell it's stale */
+        std::uint32_t generation = 0;
+    };
+
     class PUPPET_BOX_API IAnimation
     {
     public:
@@ -70,6 +223,54 @@ namespace PB
                 std::uint32_t boneId,
                 const std::string& boneName) const = 0;
 
+        /**
+         * \brief Samples the local pose of every bone in the given skeleton at a continuous frame
+         * position, interpolating between the surrounding frames.
+         *
+         * \param frameTime The fractional frame position to sample at.
+         * \param skeleton  The layout of the skeleton to sample the pose for.
+         * \param pose      The pose to write the sampled bone rotations and scales to.
+         */
+        virtual void samplePose(float frameTime, const SkeletonLayout& skeleton, AnimationPose& pose) const = 0;
+
+        /**
+         * \brief Bakes the given range of frames for the given skeleton.
+         *
+         * <p>Safe to call from several threads at once with different ranges, and concurrently with
+         * playback, which evaluates frames that are not baked yet on demand.</p>
+         *
+         * \param skeleton   The layout of the skeleton to bake frames for.
+         * \param firstFrame The first frame to bake.
+         * \param lastFrame  The frame to stop baking at, exclusive.
+         */
+        virtual void bakeFrames(const SkeletonLayout& skeleton, std::uint32_t firstFrame, std::uint32_t lastFrame) const = 0;
+
+        /**
+         * \brief Gets the final bone transformations of the given skeleton at the given step, each frame
+         * being split into the given number of steps.
+         *
+         * <p>Each unique (skeleton, step) palette is evaluated once and then shared between every instance
+         * playing the animation, making it suitable for large crowds.  Palettes are kept while they are
+         * used, a palette not used for a whole frame is reused for another (skeleton, step).</p>
+         *
+         * \param step          The step to get the palette for, counted from the start of the animation.
+         * \param stepsPerFrame The number of steps each frame is split into.
+         * \param skeleton      The layout of the skeleton to get the palette for.
+         * \return The shared palette, its transformations indexed by {\link SkeletonLayout} order.  They hold
+         * until the end of the next frame, after which the palette's generation changes if it is reused.
+         */
+        virtual const SharedPalette& getSharedPalette(
+                std::uint32_t step,
+                std::uint32_t stepsPerFrame,
+                const SkeletonLayout& skeleton) const = 0;
+
+        /**
+         * \brief Starts a new frame of shared palettes, reusing the palettes not used during the last frame.
+         *
+         * \param frame The number of the frame being started.
+         */
+        virtual void beginFrame(std::uint32_t frame) = 0;
+
         /**
          * \brief Returns the path associated with the animation.
          *
@@ -105,13 +306,40 @@ namespace PB
         virtual std::string getAnimationName() const = 0;
 
         /**
-         * \brief Update the state of the current animator.
+         * \brief Update the state of the current animator, writing the bone transformations into
+         * storage owned by the animator.
          *
          * \param deltaTime The time since the last update cycle.
-         * \param bones     The bones for the target skeleton to apply the animation to.
+         * \param skeleton  The layout of the target skeleton to apply the animation to.
          * \param overrides The bone overrides to use when calculating transformations.
          */
-        virtual void update(float deltaTime, BoneMap& bones, std::unordered_map<std::uint32_t, mat4> overrides) = 0;
+        virtual void update(float deltaTime, const SkeletonLayout& skeleton, const PoseOverrides& overrides) = 0;
+
+        /**
+         * \brief Advances the animator and samples the local pose of the attached animation,
+         * without composing the bone hierarchy.
+         *
+         * <p>Used when several animators are blended together before final transformations are
+         * calculated.</p>
+         *
+         * \param deltaTime The time since the last update cycle.
+         * \param skeleton  The layout of the skeleton to sample the pose for.
+         * \return The sampled local pose, valid until the next call.
+         */
+        virtual const AnimationPose& samplePose(float deltaTime, const SkeletonLayout& skeleton) = 0;
+
+        /**
+         * \brief Advances the animator and gets the shared bone transformations for the current
+         * time, see {\link IAnimation::getSharedPalette}.
+         *
+         * <p>Only valid for instances without bone overrides, blending, or layers.  When sampling in
+         * continuous time nothing can be shared, and the animator's own transformations are returned.</p>
+         *
+         * \param deltaTime The time since the last update cycle.
+         * \param skeleton  The layout of the skeleton to get the palette for.
+         * \return The shared palette, its transformations indexed by {\link SkeletonLayout} order.
+         */
+        virtual const SharedPalette& sampleSharedPalette(float deltaTime, const SkeletonLayout& skeleton) = 0;
 
         /**
          * \brief Sets the current frame for the animation.
@@ -124,9 +352,9 @@ namespace PB
          * \brief Gets the previously calculated bone transformation matrices
          * for the attached animation.
          *
-         * \return A map of the bone transformations, keyed on each bone ID.
+         * \return The bone transformations, indexed by {\link SkeletonLayout} order.
          */
-        virtual const std::unordered_map<std::uint32_t, mat4>& getBoneTransformations() const = 0;
+        virtual const std::vector<mat4>& getBoneTransformations() const = 0;
     };
 
     class PUPPET_BOX_API IAnimationCatalogue
@@ -151,6 +379,17 @@ namespace PB
          */
         virtual bool preloadAnimation(BoneMap& boneMap, const std::string& animationPath) = 0;
 
+        /**
+         * \brief Preloads the animation into memory on worker threads, split into frame range jobs.
+         *
+         * <p>The animation can be played while the preload is in progress.</p>
+         *
+         * \param boneMap       The skeletal data to use to preload the animation.
+         * \param animationPath The path to the animation asset to preload.
+         * \return A {\link PreloadHandle} to track the preload with.
+         */
+        virtual PreloadHandle preloadAnimationAsync(BoneMap& boneMap, const std::string& animationPath) = 0;
+
         /**
          * \brief Get the animation associated to the given path reference.
          *
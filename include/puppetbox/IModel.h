@@ -13,6 +13,8 @@ namespace PB
     class IModel
     {
     public:
+        virtual ~IModel() = default;
+
         /**
          * \brief Sets the animation of the Model.
          *
@@ -21,6 +23,32 @@ namespace PB
          */
         virtual void playAnimation(const std::string& animationPath, std::uint32_t startFrame) = 0;
 
+        /**
+         * \brief Sets the animation of the Model, crossfading from the current animation over the
+         * given transition time.
+         *
+         * \param animationPath  Path to the animation to start playing
+         * \param startFrame     The frame that the animation will start playing from.
+         * \param transitionTime The time, in seconds, to blend from the current animation to the new one.
+         */
+        virtual void playAnimation(const std::string& animationPath, std::uint32_t startFrame, float transitionTime) = 0;
+
+        /**
+         * \brief Adds an additive animation layer, applied on top of the current animation relative
+         * to the layer animation's first frame.
+         *
+         * \param animationPath Path to the animation to layer.
+         * \param weight        The weight to apply the layer with.
+         */
+        virtual void addAnimationLayer(const std::string& animationPath, float weight) = 0;
+
+        /**
+         * \brief Removes any additive animation layers that reference the given animation path.
+         *
+         * \param animationPath The path reference that dictates which layers will be removed.
+         */
+        virtual void removeAnimationLayer(const std::string& animationPath) = 0;
+
         /**
          * \brief Removes any currently attached {\link Animator}s from the object.
          */
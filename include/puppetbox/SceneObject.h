@@ -173,6 +173,32 @@ namespace PB
          */
         void playAnimation(const std::string& animationPath, std::uint32_t startFrame);
 
+        /**
+         * \brief Applies the given animation to the {\link IModel} associated with this
+         * {\link SceneObject}, crossfading from the currently playing animation over the given
+         * transition time.
+         *
+         * \param animationPath  The path associated with the animation to play.
+         * \param startFrame     The frame of the animation to start playing at.
+         * \param transitionTime The time, in seconds, to blend from the current animation to the new one.
+         */
+        void playAnimation(const std::string& animationPath, std::uint32_t startFrame, float transitionTime);
+
+        /**
+         * \brief Adds an additive animation layer on top of the currently playing animation.
+         *
+         * \param animationPath The path associated with the animation to layer.
+         * \param weight        The weight to apply the layer with.
+         */
+        void addAnimationLayer(const std::string& animationPath, float weight);
+
+        /**
+         * \brief Removes any additive animation layers with the given path reference.
+         *
+         * \param animationPath The path associated with the layers to remove.
+         */
+        void removeAnimationLayer(const std::string& animationPath);
+
         /**
          * \brief Removes any currently attached {\link Animator}s from the object.
          */
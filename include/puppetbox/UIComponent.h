@@ -200,7 +200,8 @@ namespace PB
          * \brief The "Update" phase is where checks should be done to see if the component's
          * attributes have been changed, and update it's state.
          *
-         * TODO: Implement listeners for the various attributes?
+         * <p>Changes are reported as they are made through {\link UIComponent::attributeChanged}, so
+         * components can keep their state cached between updates.</p>
          *
          * \param deltaTime The amount of tie that has passed (in seconds) since the last update call.
          */
@@ -236,6 +237,15 @@ namespace PB
 
         Result<bool> getBoolAttribute(UI::Attribute attributeName) const override;
 
+    protected:
+        /**
+         * \brief Invoked after any of the component's attributes is set, so implementations only need to
+         * recalculate state depending on that attribute.  Does nothing by default.
+         *
+         * \param attributeName The attribute that was set.
+         */
+        virtual void attributeChanged(UI::Attribute attributeName);
+
     private:
         std::unique_ptr<UIComponentAttributes> attributes_;
     };
@@ -0,0 +1,15 @@
+#include "AssetLibrary.h"
+
+namespace PB
+{
+    /**
+     * The check hands out its own clips, so the archive backed catalogue never loads an animation set and the
+     * asset library it would load from isn't built into the check.
+     */
+    bool AssetLibrary::loadAnimationSetAsset(
+            const std::string& assetPath,
+            std::unordered_map<std::string, IAnimation*>& animationMap)
+    {
+        return false;
+    }
+}
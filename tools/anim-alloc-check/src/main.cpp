@@ -0,0 +1,447 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AnimationCatalogue.h"
+#include "GfxMath.h"
+#include "OpenGLModel.h"
+#include "PropertyTree.h"
+#include "Utilities.h"
+
+/**
+ * Every allocation made through the global operator new, by the engine sources compiled into the check as
+ * much as by the check itself.
+ */
+std::atomic<std::uint64_t> allocationCount{0};
+
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * Updates run before counting, covering the first samples of every new animator, which size its pose
+ * storage and bake the frames it lands on.
+ */
+constexpr std::uint32_t WARM_UP_UPDATES = 120;
+
+/**
+ * Updates counted per path, long enough to loop both clips several times.
+ */
+constexpr std::uint32_t CHECKED_UPDATES = 600;
+
+/**
+ * Instances sharing the same clip, so the shared palettes are pooled and recycled between frames.
+ */
+constexpr std::uint32_t CROWD_SIZE = 8;
+
+constexpr float DELTA_TIME = 1.0f / 60.0f;
+
+const std::string WALK_PATH = "BasicHuman/Walk";
+const std::string IDLE_PATH = "BasicHuman/Idle0";
+
+struct Config
+{
+    std::string assetDirectory = "../../PuppetBoxExample/assetbuilder";
+};
+
+bool readFile(const std::string& path, std::string& text)
+{
+    std::ifstream file{path, std::ios::binary};
+
+    if (!file)
+    {
+        std::cerr << "Could not open '" << path << "'" << std::endl;
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    text = buffer.str();
+
+    return true;
+}
+
+float numberAt(PB::PropertyTree& node, std::string_view name, float defaultValue)
+{
+    auto child = node.get(name);
+
+    if (!child.hasResult || child.result->value().empty())
+    {
+        return defaultValue;
+    }
+
+    bool error = false;
+    return PB::NumberUtils::parseValue<float>(child.result->value(), defaultValue, &error);
+}
+
+PB::vec3 vectorAt(PB::PropertyTree& node, std::string_view name, float defaultValue)
+{
+    auto child = node.get(name);
+
+    if (!child.hasResult)
+    {
+        return {defaultValue, defaultValue, defaultValue};
+    }
+
+    return {
+            numberAt(*child.result, "x", defaultValue),
+            numberAt(*child.result, "y", defaultValue),
+            numberAt(*child.result, "z", defaultValue)
+    };
+}
+
+/**
+ * Adds the bone and its children to the bone map the same way the engine does when it loads a model.
+ */
+void addBones(PB::PropertyTree& node, const std::string& parentName, PB::BoneMap& bones)
+{
+    const PB::vec3 offset = vectorAt(node, "offset", 0.0f);
+    const PB::vec3 scale = vectorAt(node, "scale", 1.0f);
+    const PB::vec3 rotation = vectorAt(node, "rotation", 0.0f) * PB::GfxMath::RADS_PER_DEGREE;
+
+    PB::Bone bone{
+            PB::vec4{offset.x, offset.y, offset.z, 1.0f},
+            PB::vec4{scale.x, scale.y, scale.z, 1.0f},
+            PB::vec4{rotation.x, rotation.y, rotation.z, 0.0f}
+    };
+
+    bone.transform = PB::GfxMath::CreateTransformation(rotation, scale, offset);
+
+    const std::string name{node.name()};
+    bones.addBone(name, parentName, bone);
+
+    auto children = node.get("children");
+
+    if (children.hasResult)
+    {
+        for (PB::PropertyTree* child = children.result->firstChild(); child != nullptr; child = child->nextSibling())
+        {
+            addBones(*child, name, bones);
+        }
+    }
+}
+
+bool loadSkeleton(const std::string& path, PB::BoneMap& bones)
+{
+    std::string text;
+    PB::PropertyDocument document{"root"};
+
+    if (!readFile(path, text) || !document.parse(text) || document.root().firstChild() == nullptr)
+    {
+        std::cerr << "Could not parse skeleton '" << path << "'" << std::endl;
+        return false;
+    }
+
+    addBones(*document.root().firstChild(), "", bones);
+
+    return true;
+}
+
+PB::Result<float> optionalNumberAt(PB::PropertyTree& node, std::string_view name, float scale)
+{
+    auto child = node.get(name);
+
+    if (!child.hasResult || child.result->value().empty())
+    {
+        return {0.0f, false};
+    }
+
+    return {numberAt(node, name, 0.0f) * scale, true};
+}
+
+/**
+ * Loads a text animation clip the same way the engine's archive does, converting rotations to radians.
+ */
+PB::Animation* loadClip(const std::string& path, const std::string& animationPath)
+{
+    std::string text;
+    PB::PropertyDocument document{"root"};
+
+    if (!readFile(path, text) || !document.parse(text) || !document.root().has("keyframes"))
+    {
+        std::cerr << "Could not parse animation '" << path << "'" << std::endl;
+        return nullptr;
+    }
+
+    PB::PropertyTree& root = document.root();
+    std::unordered_map<std::uint8_t, std::vector<PB::RawKeyframe>> keyframes{};
+
+    for (PB::PropertyTree* frame = root.get("keyframes").result->firstChild(); frame != nullptr;
+         frame = frame->nextSibling())
+    {
+        bool error = false;
+        const auto frameIndex = PB::NumberUtils::parseValue<std::uint8_t>(frame->name(), 0, &error);
+
+        for (PB::PropertyTree* boneNode = frame->firstChild(); boneNode != nullptr; boneNode = boneNode->nextSibling())
+        {
+            PB::RawKeyframe keyframe{};
+            keyframe.frameIndex = frameIndex;
+            keyframe.boneName = std::string(boneNode->name());
+
+            const std::pair<const char*, PB::Vec4*> channels[] = {
+                    {"position", &keyframe.position},
+                    {"rotation", &keyframe.rotation},
+                    {"scale",    &keyframe.scale}
+            };
+
+            for (const auto& channel: channels)
+            {
+                auto channelNode = boneNode->get(channel.first);
+
+                if (channelNode.hasResult)
+                {
+                    const float scale = channel.second == &keyframe.rotation ? PB::GfxMath::RADS_PER_DEGREE : 1.0f;
+
+                    channel.second->x = optionalNumberAt(*channelNode.result, "x", scale);
+                    channel.second->y = optionalNumberAt(*channelNode.result, "y", scale);
+                    channel.second->z = optionalNumberAt(*channelNode.result, "z", scale);
+                }
+            }
+
+            keyframes[frameIndex].push_back(keyframe);
+        }
+    }
+
+    return new PB::Animation(
+            animationPath,
+            static_cast<std::uint8_t>(numberAt(root, "fps", 30.0f)),
+            static_cast<std::uint8_t>(numberAt(root, "length", 1.0f)),
+            keyframes);
+}
+
+/**
+ * Hands out animators for the loaded clips, standing in for the archive backed catalogue.
+ */
+class ClipCatalogue : public PB::IAnimationCatalogue
+{
+public:
+    void add(PB::Animation* animation)
+    {
+        animations_[animation->getPath()] = std::unique_ptr<PB::Animation>(animation);
+    }
+
+    void setStepsPerFrame(std::uint32_t stepsPerFrame)
+    {
+        stepsPerFrame_ = stepsPerFrame;
+    }
+
+    void beginFrame()
+    {
+        ++frame_;
+
+        for (auto& animation: animations_)
+        {
+            animation.second->beginFrame(frame_);
+        }
+    }
+
+    bool load(const std::string& assetPath) override
+    {
+        return false;
+    }
+
+    bool preloadAnimation(PB::BoneMap& boneMap, const std::string& animationPath) override
+    {
+        return false;
+    }
+
+    PB::PreloadHandle preloadAnimationAsync(PB::BoneMap& boneMap, const std::string& animationPath) override
+    {
+        return {};
+    }
+
+    std::unique_ptr<PB::IAnimator> get(const std::string& animationPath) const override
+    {
+        auto itr = animations_.find(animationPath);
+
+        return itr != animations_.end() ? std::make_unique<PB::Animator>(itr->second.get(), stepsPerFrame_) : nullptr;
+    }
+
+private:
+    std::unordered_map<std::string, std::unique_ptr<PB::Animation>> animations_{};
+    std::uint32_t stepsPerFrame_ = 0;
+    std::uint32_t frame_ = 0;
+};
+
+/**
+ * A playback path to check, set up once per instance before the updates are run.
+ */
+struct PlaybackPath
+{
+    std::string name;
+    std::function<void(PB::OpenGLModel&)> setUp;
+    /** Runs before every update, for paths that are driven each frame such as bone overrides */
+    std::function<void(PB::OpenGLModel&, std::uint32_t)> perFrame;
+};
+
+std::uint64_t countSteadyStateAllocations(
+        ClipCatalogue& catalogue,
+        const PB::BoneMap& skeleton,
+        const PlaybackPath& path)
+{
+    std::vector<std::unique_ptr<PB::OpenGLModel>> crowd{};
+
+    for (std::uint32_t i = 0; i < CROWD_SIZE; ++i)
+    {
+        PB::BoneMap bones{skeleton};
+        crowd.push_back(std::make_unique<PB::OpenGLModel>(bones, std::unordered_map<std::uint32_t, PB::RenderedMesh*>{},
+                                                          &catalogue));
+        path.setUp(*crowd.back());
+    }
+
+    std::uint64_t allocationsBefore = 0;
+
+    for (std::uint32_t update = 0; update < WARM_UP_UPDATES + CHECKED_UPDATES; ++update)
+    {
+        if (update == WARM_UP_UPDATES)
+        {
+            allocationsBefore = allocationCount.load();
+        }
+
+        catalogue.beginFrame();
+
+        for (std::uint32_t i = 0; i < crowd.size(); ++i)
+        {
+            if (path.perFrame)
+            {
+                path.perFrame(*crowd[i], update);
+            }
+
+            // Instances are staggered, so the crowd covers more than one step of the clip each frame
+            crowd[i]->update(DELTA_TIME * (1.0f + static_cast<float>(i) * 0.1f));
+        }
+    }
+
+    return allocationCount.load() - allocationsBefore;
+}
+
+Config loadRunConfig(std::uint32_t count, char** params)
+{
+    Config config{};
+
+    if (count > 1)
+    {
+        config.assetDirectory = params[1];
+    }
+
+    return config;
+}
+
+int main(int argc, char* argv[])
+{
+    Config config = loadRunConfig(argc, argv);
+
+    PB::BoneMap skeleton{};
+    ClipCatalogue catalogue{};
+
+    if (!loadSkeleton(config.assetDirectory + "/GenericMob.m", skeleton))
+    {
+        return 1;
+    }
+
+    PB::Animation* walk = loadClip(config.assetDirectory + "/BasicHuman_Walk.anim", WALK_PATH);
+    PB::Animation* idle = loadClip(config.assetDirectory + "/BasicHuman_Idle0.anim", IDLE_PATH);
+
+    if (walk == nullptr || idle == nullptr)
+    {
+        return 1;
+    }
+
+    catalogue.add(walk);
+    catalogue.add(idle);
+
+    const std::uint32_t headId = skeleton.getBoneId("head");
+
+    const std::vector<PlaybackPath> paths{
+            {"plain",     [](PB::OpenGLModel& model) {
+                model.playAnimation(WALK_PATH, 0);
+            }},
+            {"crossfade", [](PB::OpenGLModel& model) {
+                model.playAnimation(IDLE_PATH, 0);
+                model.playAnimation(WALK_PATH, 0, 1000.0f);
+            }},
+            {"additive",  [](PB::OpenGLModel& model) {
+                model.playAnimation(WALK_PATH, 0);
+                model.addAnimationLayer(IDLE_PATH, 0.5f);
+            }},
+            {"override",  [](PB::OpenGLModel& model) {
+                model.playAnimation(WALK_PATH, 0);
+            }, [headId](PB::OpenGLModel& model, std::uint32_t update) {
+                model.overrideBoneRotation(headId, {0.0f, 0.0f, static_cast<float>(update % 90) * 0.01f});
+            }}
+    };
+
+    bool allocated = false;
+
+    // Both quantized sampling, where plain playback shares palettes, and continuous sampling
+    for (std::uint32_t stepsPerFrame: {4u, 0u})
+    {
+        catalogue.setStepsPerFrame(stepsPerFrame);
+
+        for (const auto& path: paths)
+        {
+            const std::uint64_t allocations = countSteadyStateAllocations(catalogue, skeleton, path);
+
+            std::cout << path.name << ", " << stepsPerFrame << " steps per frame: " << allocations
+                      << " allocations over " << CHECKED_UPDATES << " updates of " << CROWD_SIZE << " instances"
+                      << (allocations > 0 ? "  FAIL" : "") << std::endl;
+
+            allocated = allocated || allocations > 0;
+        }
+    }
+
+    return allocated ? 1 : 0;
+}
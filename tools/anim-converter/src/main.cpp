@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AnimationClipFormat.h"
+
+constexpr float RADS_PER_DEGREE = PB::AnimationClip::PI / 180.0f;
+
+/**
+ * A single node of an indentation based property file, as used by the engine's text assets.
+ */
+struct PropertyNode
+{
+    std::string name;
+    std::string value;
+    std::vector<std::unique_ptr<PropertyNode>> children{};
+
+    const PropertyNode* get(const std::string& childName) const
+    {
+        for (const auto& child : children)
+        {
+            if (child->name == childName)
+            {
+                return child.get();
+            }
+        }
+
+        return nullptr;
+    }
+};
+
+std::string trim(const std::string& str)
+{
+    const auto start = str.find_first_not_of(" \t\r");
+
+    if (start == std::string::npos)
+    {
+        return "";
+    }
+
+    const auto end = str.find_last_not_of(" \t\r");
+
+    return str.substr(start, end - start + 1);
+}
+
+bool parseProperties(std::istream& input, PropertyNode& root)
+{
+    // Each entry is the indentation level children of the node must have
+    std::vector<std::pair<std::uint32_t, PropertyNode*>> stack{{0, &root}};
+
+    std::string line;
+    std::uint32_t lineNumber = 0;
+
+    while (std::getline(input, line))
+    {
+        ++lineNumber;
+
+        const std::string content = trim(line);
+
+        if (content.empty())
+        {
+            continue;
+        }
+
+        const auto indentLevel = static_cast<std::uint32_t>(line.find_first_not_of(' '));
+
+        while (stack.size() > 1 && indentLevel < stack.back().first)
+        {
+            stack.pop_back();
+        }
+
+        auto node = std::make_unique<PropertyNode>();
+
+        if (content[0] == '-')
+        {
+            node->name = trim(content.substr(1));
+            stack.back().second->children.emplace_back(std::move(node));
+            continue;
+        }
+
+        const auto split = content.find(':');
+
+        if (split == std::string::npos)
+        {
+            std::cout << "Invalid data '" << content << "' on line " << lineNumber << std::endl;
+            return false;
+        }
+
+        node->name = trim(content.substr(0, split));
+        node->value = trim(content.substr(split + 1));
+
+        PropertyNode* added = node.get();
+        stack.back().second->children.emplace_back(std::move(node));
+
+        if (added->value.empty())
+        {
+            stack.emplace_back(indentLevel + 2, added);
+        }
+    }
+
+    return true;
+}
+
+bool mapToClip(const PropertyNode& root, PB::AnimationClip::Clip& clip)
+{
+    const PropertyNode* fps = root.get("fps");
+    const PropertyNode* length = root.get("length");
+    const PropertyNode* keyframes = root.get("keyframes");
+
+    if (fps == nullptr || length == nullptr || keyframes == nullptr)
+    {
+        std::cout << "Animation is missing fps, length, or keyframes" << std::endl;
+        return false;
+    }
+
+    clip.fps = static_cast<std::uint8_t>(std::stoul(fps->value));
+    clip.frameCount = static_cast<std::uint8_t>(std::stoul(length->value));
+
+    std::unordered_map<std::string, std::uint16_t> boneIndexes{};
+
+    const char* vectorNames[3] = {"rotation", "scale", "position"};
+    const char* axisNames[3] = {"x", "y", "z"};
+
+    for (const auto& frame : keyframes->children)
+    {
+        const auto frameIndex = static_cast<std::uint8_t>(std::stoul(frame->name));
+
+        for (const auto& bone : frame->children)
+        {
+            if (boneIndexes.find(bone->name) == boneIndexes.end())
+            {
+                boneIndexes[bone->name] = static_cast<std::uint16_t>(clip.boneNames.size());
+                clip.boneNames.push_back(bone->name);
+            }
+
+            PB::AnimationClip::Keyframe keyframe{};
+            keyframe.frameIndex = frameIndex;
+            keyframe.boneIndex = boneIndexes.at(bone->name);
+
+            for (std::uint32_t v = 0; v < 3; ++v)
+            {
+                const PropertyNode* vector = bone->get(vectorNames[v]);
+
+                if (vector != nullptr)
+                {
+                    for (std::uint32_t axis = 0; axis < 3; ++axis)
+                    {
+                        const PropertyNode* component = vector->get(axisNames[axis]);
+
+                        if (component != nullptr)
+                        {
+                            const std::uint32_t channel = (v * 3) + axis;
+                            float value = std::stof(component->value);
+
+                            if (v == 0)
+                            {
+                                // Stored as radians wrapped to [-PI, PI) to fit the quantized range
+                                value = PB::AnimationClip::wrapRotation(value * RADS_PER_DEGREE);
+                            }
+
+                            keyframe.channels |= 1 << channel;
+                            keyframe.values[channel] = value;
+                        }
+                    }
+                }
+            }
+
+            clip.keyframes.push_back(keyframe);
+        }
+    }
+
+    return true;
+}
+
+struct Config
+{
+    bool isDirectory = false;
+    std::string target;
+};
+
+Config loadRunConfig(std::uint32_t count, char** params)
+{
+    Config config{};
+
+    if (count > 1) {
+        const std::string& param = params[1];
+
+        config.target = param;
+        config.isDirectory = std::filesystem::is_directory(std::filesystem::path{param});
+    }
+
+    return config;
+}
+
+std::string convertToOutput(const std::string& fileName)
+{
+    std::filesystem::path path{fileName};
+    path.replace_extension(PB::AnimationClip::FILE_EXTENSION);
+    return path.string();
+}
+
+int main(int argc, char* argv[])
+{
+    Config config = loadRunConfig(argc, argv);
+
+    if (config.target.empty())
+    {
+        std::cout << "Usage: anim_converter <file.anim | directory>" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> files{};
+
+    if (config.isDirectory)
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(config.target))
+        {
+            if (entry.path().extension().string() == ".anim")
+            {
+                files.emplace_back(entry.path().string());
+            }
+        }
+    }
+    else
+    {
+        files.emplace_back(config.target);
+    }
+
+    bool error = false;
+
+    for (const auto& fileName : files)
+    {
+        std::ifstream input(fileName);
+
+        PropertyNode root{};
+        PB::AnimationClip::Clip clip{};
+
+        if (input.is_open() && parseProperties(input, root) && mapToClip(root, clip))
+        {
+            const std::vector<std::uint8_t> bytes = PB::AnimationClip::encode(clip);
+
+            std::ofstream out(convertToOutput(fileName), std::ios::binary | std::ios::out);
+            out.write((const char*) bytes.data(), (std::streamsize) bytes.size());
+            out.close();
+
+            std::cout << fileName << " -> " << convertToOutput(fileName) << " (" << bytes.size() << " bytes)"
+                      << std::endl;
+        }
+        else
+        {
+            error = true;
+            std::cout << "Failed to convert '" << fileName << "'" << std::endl;
+        }
+    }
+
+    return error ? 1 : 0;
+}
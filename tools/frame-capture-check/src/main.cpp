@@ -0,0 +1,265 @@
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "CommandList.h"
+#include "ImageData.h"
+#include "ImageOptions.h"
+#include "RecordingGfxApi.h"
+#include "Shader.h"
+#include "SpriteBatch.h"
+
+struct Config
+{
+    std::string assetDirectory = "../../PuppetBoxExample/assetbuilder";
+    std::string expectedFrame = "expected/frame.txt";
+    bool update = false;
+};
+
+bool readFile(const std::string& path, std::string& text)
+{
+    std::ifstream file{path, std::ios::binary};
+
+    if (!file)
+    {
+        std::cerr << "Could not open '" << path << "'" << std::endl;
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    text = buffer.str();
+
+    return true;
+}
+
+bool writeFile(const std::string& path, const std::string& text)
+{
+    std::ofstream file{path, std::ios::binary};
+
+    if (!file)
+    {
+        std::cerr << "Could not write '" << path << "'" << std::endl;
+        return false;
+    }
+
+    file << text;
+
+    return true;
+}
+
+/**
+ * A unit quad, two triangles sharing an edge, so welding leaves 4 vertices.
+ */
+std::vector<PB::Vertex> quadVertices()
+{
+    const PB::vec3 normal{0.0f, 0.0f, 1.0f};
+
+    return {
+            {{-0.5f, -0.5f, 0.0f}, normal, {0.0f, 0.0f}},
+            {{0.5f,  -0.5f, 0.0f}, normal, {1.0f, 0.0f}},
+            {{0.5f,  0.5f,  0.0f}, normal, {1.0f, 1.0f}},
+            {{0.5f,  0.5f,  0.0f}, normal, {1.0f, 1.0f}},
+            {{-0.5f, 0.5f,  0.0f}, normal, {0.0f, 1.0f}},
+            {{-0.5f, -0.5f, 0.0f}, normal, {0.0f, 0.0f}},
+    };
+}
+
+std::vector<PB::Vertex> triangleVertices()
+{
+    const PB::vec3 normal{0.0f, 0.0f, 1.0f};
+
+    return {
+            {{-0.5f, -0.5f, 0.0f}, normal, {0.0f, 0.0f}},
+            {{0.5f,  -0.5f, 0.0f}, normal, {1.0f, 0.0f}},
+            {{0.0f,  0.5f,  0.0f}, normal, {0.5f, 1.0f}},
+    };
+}
+
+PB::mat4 translation(float x, float y)
+{
+    return PB::mat4{
+            1.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 1.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 1.0f, 0.0f,
+            x, y, 0.0f, 1.0f
+    };
+}
+
+/**
+ * Records the scripted frame: a scene of opaque and alpha blended sprites over two textures and two arena
+ * meshes, batched by the {\link PB::SpriteBatch} as the renderer would.
+ */
+bool recordFrame(const Config& config, std::string& frame)
+{
+    PB::RecordingGfxApi gfxApi{};
+    gfxApi.init(nullptr);
+    gfxApi.setRenderDimensions(800, 600);
+    gfxApi.setCaptureFrames(true);
+
+    std::string vertexCode;
+
+    if (!readFile(config.assetDirectory + "/basic.vertex.shader", vertexCode))
+    {
+        return false;
+    }
+
+    PB::Shader shader{"Check/Shader/Basic"};
+
+    if (!gfxApi.beginShader(shader, vertexCode, "", "") || !gfxApi.finishShader(shader))
+    {
+        std::cerr << "Could not build the headless shader" << std::endl;
+        return false;
+    }
+
+    if (!PB::SpriteBatch::isInstanced(shader))
+    {
+        std::cerr << "The headless shader didn't read the instance attribute locations" << std::endl;
+        return false;
+    }
+
+    std::vector<PB::Vertex> quad = quadVertices();
+    std::vector<PB::Vertex> triangle = triangleVertices();
+    const PB::Mesh quadMesh = gfxApi.loadMesh(&quad[0], static_cast<std::uint32_t>(quad.size()));
+    const PB::Mesh triangleMesh = gfxApi.loadMesh(&triangle[0], static_cast<std::uint32_t>(triangle.size()));
+
+    std::vector<std::uint8_t> pixels(4 * 4 * 4, 0xFF);
+    PB::ImageData imageData{&pixels[0], 4, 4, 4};
+    const PB::ImageReference wall = gfxApi.loadImage(imageData, ImageOptions{});
+    PB::ImageReference glass = gfxApi.loadImage(imageData, ImageOptions{});
+    glass.requiresAlphaBlending = true;
+
+    PB::CommandList commandList{};
+
+    PB::SpriteBatch spriteBatch{};
+
+    for (std::uint32_t i = 0; i < 6; ++i)
+    {
+        const PB::ImageReference& texture = (i % 3 == 2) ? glass : wall;
+        const PB::Mesh& mesh = (i % 2 == 0) ? quadMesh : triangleMesh;
+
+        PB::SpriteInstance instance{};
+        instance.transform = translation(static_cast<float>(i), static_cast<float>(i % 2));
+        instance.uvAdjust = {1.0f, 1.0f, 0.0f, 0.0f};
+        instance.tint = {1.0f, 1.0f, 1.0f, texture.requiresAlphaBlending ? 0.5f : 1.0f};
+
+        spriteBatch.submit(shader, texture, mesh, texture.requiresAlphaBlending, instance);
+    }
+
+    spriteBatch.flush(commandList);
+
+    gfxApi.preLoopCommands(800, 600);
+    gfxApi.submit(commandList);
+    gfxApi.postLoopCommands();
+
+    frame = gfxApi.lastFrame();
+
+    return true;
+}
+
+/**
+ * Reports the first line the recorded frame differs from the expected one at.
+ */
+void reportDifference(const std::string& expected, const std::string& actual)
+{
+    std::istringstream expectedLines{expected};
+    std::istringstream actualLines{actual};
+    std::string expectedLine;
+    std::string actualLine;
+    std::uint32_t lineNumber = 1;
+
+    while (true)
+    {
+        const bool hasExpected = static_cast<bool>(std::getline(expectedLines, expectedLine));
+        const bool hasActual = static_cast<bool>(std::getline(actualLines, actualLine));
+
+        if (!hasExpected && !hasActual)
+        {
+            break;
+        }
+
+        if (!hasExpected || !hasActual || expectedLine != actualLine)
+        {
+            std::cerr << "Line " << lineNumber << " differs" << std::endl;
+            std::cerr << "  expected: " << (hasExpected ? expectedLine : "<end of frame>") << std::endl;
+            std::cerr << "  recorded: " << (hasActual ? actualLine : "<end of frame>") << std::endl;
+            break;
+        }
+
+        ++lineNumber;
+    }
+}
+
+Config loadRunConfig(std::uint32_t count, char** params)
+{
+    Config config{};
+
+    for (std::uint32_t i = 1; i < count; ++i)
+    {
+        const std::string param = params[i];
+
+        if (param == "--update")
+        {
+            config.update = true;
+        }
+        else if (param == "--assets" && i + 1 < count)
+        {
+            config.assetDirectory = params[++i];
+        }
+        else if (param == "--expected" && i + 1 < count)
+        {
+            config.expectedFrame = params[++i];
+        }
+    }
+
+    return config;
+}
+
+/**
+ * Records a scripted frame through the recording gfx API, and checks it against the expected frame checked in
+ * next to the check, so changes to how frames are recorded show up as a diff of the expected frame.
+ *
+ * Run from the check's directory, with --update to write the recorded frame as the expected one.
+ */
+int main(int argc, char* argv[])
+{
+    Config config = loadRunConfig(argc, argv);
+
+    std::string frame;
+
+    if (!recordFrame(config, frame))
+    {
+        return 1;
+    }
+
+    if (config.update)
+    {
+        if (!writeFile(config.expectedFrame, frame))
+        {
+            return 1;
+        }
+
+        std::cout << "Wrote the recorded frame to '" << config.expectedFrame << "'" << std::endl;
+        return 0;
+    }
+
+    std::string expected;
+
+    if (!readFile(config.expectedFrame, expected))
+    {
+        return 1;
+    }
+
+    if (frame != expected)
+    {
+        reportDifference(expected, frame);
+        return 1;
+    }
+
+    std::cout << "Recorded frame matches '" << config.expectedFrame << "'" << std::endl;
+
+    return 0;
+}
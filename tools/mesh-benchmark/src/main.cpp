@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "MeshOptimizer.h"
+
+/**
+ * Number of floats per vertex in the engine's mesh layout, 3 position, 3 normal, 2 UV.
+ */
+constexpr std::uint32_t FLOATS_PER_VERTEX = 8;
+
+/**
+ * Welding tolerance used by the engine when loading text meshes at runtime.
+ */
+constexpr float RUNTIME_WELD_EPSILON = 0.0000001f;
+
+/**
+ * The quadratic weld is only run up to this many vertices, past that it takes minutes.
+ */
+constexpr std::uint32_t MAX_LINEAR_SCAN_VERTICES = 20000;
+
+/**
+ * Builds a triangle soup of a wavy grid, with every triangle repeating its vertices as text meshes
+ * do, and the triangles shuffled so there is no vertex reuse to begin with.
+ */
+std::vector<float> buildTriangleSoup(std::uint32_t targetVertexCount)
+{
+    const auto quadsPerSide = static_cast<std::uint32_t>(std::sqrt(targetVertexCount / 6.0));
+
+    auto vertexAt = [&](std::uint32_t x, std::uint32_t y, float* out) {
+        const float u = static_cast<float>(x) / static_cast<float>(quadsPerSide);
+        const float v = static_cast<float>(y) / static_cast<float>(quadsPerSide);
+
+        out[0] = u * 100.0f;
+        out[1] = v * 100.0f;
+        out[2] = std::sin(u * 12.0f) * std::cos(v * 9.0f) * 5.0f;
+        out[3] = 0.0f;
+        out[4] = 0.0f;
+        out[5] = 1.0f;
+        out[6] = u;
+        out[7] = v;
+    };
+
+    std::vector<std::vector<float>> triangles{};
+    triangles.reserve(static_cast<std::size_t>(quadsPerSide) * quadsPerSide * 2);
+
+    for (std::uint32_t y = 0; y < quadsPerSide; ++y)
+    {
+        for (std::uint32_t x = 0; x < quadsPerSide; ++x)
+        {
+            const std::uint32_t corners[2][3][2] = {
+                    {{x, y}, {x + 1, y}, {x + 1, y + 1}},
+                    {{x, y}, {x + 1, y + 1}, {x, y + 1}}
+            };
+
+            for (const auto& corner : corners)
+            {
+                std::vector<float> triangle(3 * FLOATS_PER_VERTEX);
+
+                for (std::uint32_t i = 0; i < 3; ++i)
+                {
+                    vertexAt(corner[i][0], corner[i][1], &triangle[i * FLOATS_PER_VERTEX]);
+                }
+
+                triangles.emplace_back(std::move(triangle));
+            }
+        }
+    }
+
+    std::mt19937 random{1234};
+    std::shuffle(triangles.begin(), triangles.end(), random);
+
+    std::vector<float> soup{};
+    soup.reserve(triangles.size() * 3 * FLOATS_PER_VERTEX);
+
+    for (const auto& triangle : triangles)
+    {
+        soup.insert(soup.end(), triangle.begin(), triangle.end());
+    }
+
+    return soup;
+}
+
+/**
+ * The welding previously done by the engine, a linear scan of the unique vertices per input vertex.
+ */
+void linearScanWeld(const std::vector<float>& soup, std::vector<float>& unique, std::vector<std::uint32_t>& indices)
+{
+    const auto vertexCount = static_cast<std::uint32_t>(soup.size() / FLOATS_PER_VERTEX);
+
+    for (std::uint32_t i = 0; i < vertexCount; ++i)
+    {
+        const float* vertex = &soup[i * FLOATS_PER_VERTEX];
+        std::uint32_t found = UINT32_MAX;
+
+        for (std::uint32_t u = 0; u < unique.size() / FLOATS_PER_VERTEX && found == UINT32_MAX; ++u)
+        {
+            bool equal = true;
+
+            for (std::uint32_t f = 0; f < FLOATS_PER_VERTEX && equal; ++f)
+            {
+                equal = std::abs(vertex[f] - unique[(u * FLOATS_PER_VERTEX) + f]) < RUNTIME_WELD_EPSILON;
+            }
+
+            found = equal ? u : UINT32_MAX;
+        }
+
+        if (found == UINT32_MAX)
+        {
+            found = static_cast<std::uint32_t>(unique.size() / FLOATS_PER_VERTEX);
+            unique.insert(unique.end(), vertex, vertex + FLOATS_PER_VERTEX);
+        }
+
+        indices.push_back(found);
+    }
+}
+
+template<typename Function>
+double timeMilliseconds(Function function)
+{
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Average distance in bytes between consecutive vertex fetches, lower is better.
+ */
+double averageFetchDistance(const std::vector<std::uint32_t>& indices)
+{
+    double total = 0;
+
+    for (std::size_t i = 1; i < indices.size(); ++i)
+    {
+        total += std::abs(static_cast<double>(indices[i]) - static_cast<double>(indices[i - 1]));
+    }
+
+    return indices.size() > 1 ? (total / static_cast<double>(indices.size() - 1)) * FLOATS_PER_VERTEX * sizeof(float)
+                              : 0.0;
+}
+
+void runBenchmark(std::uint32_t targetVertexCount)
+{
+    const std::vector<float> soup = buildTriangleSoup(targetVertexCount);
+    const auto vertexCount = static_cast<std::uint32_t>(soup.size() / FLOATS_PER_VERTEX);
+
+    std::cout << "== " << vertexCount << " input vertices, " << vertexCount / 3 << " triangles ==" << std::endl;
+
+    std::vector<float> vertices{};
+    std::vector<std::uint32_t> indices{};
+
+    if (vertexCount <= MAX_LINEAR_SCAN_VERTICES)
+    {
+        const double linearScan = timeMilliseconds([&]() {
+            linearScanWeld(soup, vertices, indices);
+        });
+        std::cout << "  linear scan weld:     " << linearScan << " ms" << std::endl;
+    }
+    else
+    {
+        std::cout << "  linear scan weld:     skipped, over " << MAX_LINEAR_SCAN_VERTICES << " vertices" << std::endl;
+    }
+
+    const double exactWeld = timeMilliseconds([&]() {
+        PB::MeshOptimizer::weldVertices(soup.data(), vertexCount, FLOATS_PER_VERTEX, 0.0f, vertices, indices);
+    });
+    std::cout << "  hashed weld (exact):  " << exactWeld << " ms" << std::endl;
+
+    const double epsilonWeld = timeMilliseconds([&]() {
+        PB::MeshOptimizer::weldVertices(
+                soup.data(),
+                vertexCount,
+                FLOATS_PER_VERTEX,
+                RUNTIME_WELD_EPSILON,
+                vertices,
+                indices);
+    });
+    const auto uniqueCount = static_cast<std::uint32_t>(vertices.size() / FLOATS_PER_VERTEX);
+    std::cout << "  hashed weld (epsilon): " << epsilonWeld << " ms, " << uniqueCount << " unique vertices"
+              << std::endl;
+
+    const float acmrBefore16 = PB::MeshOptimizer::averageCacheMissRatio(indices, uniqueCount, 16);
+    const float acmrBefore32 = PB::MeshOptimizer::averageCacheMissRatio(indices, uniqueCount, 32);
+    const double fetchBefore = averageFetchDistance(indices);
+
+    const double cacheOptimize = timeMilliseconds([&]() {
+        PB::MeshOptimizer::optimizeVertexCache(indices, uniqueCount);
+    });
+    std::cout << "  vertex cache order:   " << cacheOptimize << " ms, ACMR (16) " << acmrBefore16 << " -> "
+              << PB::MeshOptimizer::averageCacheMissRatio(indices, uniqueCount, 16) << ", ACMR (32) "
+              << acmrBefore32 << " -> " << PB::MeshOptimizer::averageCacheMissRatio(indices, uniqueCount, 32)
+              << std::endl;
+
+    const double fetchOptimize = timeMilliseconds([&]() {
+        PB::MeshOptimizer::optimizeVertexFetch(vertices, FLOATS_PER_VERTEX, indices);
+    });
+    std::cout << "  vertex fetch order:   " << fetchOptimize << " ms, average fetch distance " << fetchBefore
+              << " -> " << averageFetchDistance(indices) << " bytes" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::uint32_t> sizes{10000, 100000, 1000000};
+
+    if (argc > 1)
+    {
+        sizes.clear();
+
+        for (int i = 1; i < argc; ++i)
+        {
+            sizes.push_back(static_cast<std::uint32_t>(std::stoul(argv[i])));
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (std::uint32_t size : sizes)
+    {
+        runBenchmark(size);
+    }
+
+    return 0;
+}
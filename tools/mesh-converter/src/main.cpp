@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "MeshFormat.h"
+#include "MeshOptimizer.h"
+
+/**
+ * Number of floats per vertex in the text mesh format, 3 position, 3 normal, 2 UV.
+ */
+constexpr std::uint32_t FLOATS_PER_VERTEX = 8;
+
+struct IndexedMesh
+{
+    std::vector<float> vertices{};
+    std::vector<std::uint32_t> indices{};
+
+    std::uint32_t vertexCount() const
+    {
+        return static_cast<std::uint32_t>(vertices.size() / FLOATS_PER_VERTEX);
+    }
+};
+
+bool parseTextMesh(std::istream& input, std::vector<float>& values)
+{
+    float value;
+
+    while (input >> value)
+    {
+        values.push_back(value);
+    }
+
+    if (!input.eof())
+    {
+        std::cout << "Invalid value after " << values.size() << " values" << std::endl;
+        return false;
+    }
+
+    if (values.size() % FLOATS_PER_VERTEX != 0)
+    {
+        std::cout << "Incomplete vertex, " << values.size() << " values is not a multiple of "
+                  << FLOATS_PER_VERTEX << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Welds bitwise identical vertices together, the engine compares with a tolerance at load time, but
+ * exported meshes repeat shared vertices exactly.  The result is then ordered for the post-transform
+ * vertex cache, and the vertices for fetching in that order.
+ */
+IndexedMesh indexMesh(const std::vector<float>& values)
+{
+    IndexedMesh mesh{};
+
+    PB::MeshOptimizer::weldVertices(
+            values.data(),
+            static_cast<std::uint32_t>(values.size() / FLOATS_PER_VERTEX),
+            FLOATS_PER_VERTEX,
+            0.0f,
+            mesh.vertices,
+            mesh.indices);
+
+    PB::MeshOptimizer::optimizeVertexCache(mesh.indices, mesh.vertexCount());
+    PB::MeshOptimizer::optimizeVertexFetch(mesh.vertices, FLOATS_PER_VERTEX, mesh.indices);
+
+    return mesh;
+}
+
+struct Config
+{
+    bool isDirectory = false;
+    std::string target;
+    std::string extension = ".mesh";
+};
+
+Config loadRunConfig(std::uint32_t count, char** params)
+{
+    Config config{};
+
+    if (count > 1) {
+        const std::string& param = params[1];
+
+        config.target = param;
+        config.isDirectory = std::filesystem::is_directory(std::filesystem::path{param});
+    }
+
+    if (count > 2) {
+        config.extension = params[2];
+    }
+
+    return config;
+}
+
+std::string convertToOutput(const std::string& fileName)
+{
+    std::filesystem::path path{fileName};
+    path.replace_extension(PB::MeshFormat::FILE_EXTENSION);
+    return path.string();
+}
+
+int main(int argc, char* argv[])
+{
+    Config config = loadRunConfig(argc, argv);
+
+    if (config.target.empty())
+    {
+        std::cout << "Usage: mesh_converter <file | directory> [source extension, default .mesh]" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> files{};
+
+    if (config.isDirectory)
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(config.target))
+        {
+            if (entry.path().extension().string() == config.extension)
+            {
+                files.emplace_back(entry.path().string());
+            }
+        }
+    }
+    else
+    {
+        files.emplace_back(config.target);
+    }
+
+    bool error = false;
+
+    for (const auto& fileName : files)
+    {
+        std::ifstream input(fileName);
+
+        std::vector<float> values{};
+
+        if (input.is_open() && parseTextMesh(input, values))
+        {
+            const IndexedMesh mesh = indexMesh(values);
+            const std::vector<std::uint8_t> bytes = PB::MeshFormat::encode(
+                    PB::MeshFormat::standardMeshBuffer(mesh.vertices, mesh.indices));
+
+            std::ofstream out(convertToOutput(fileName), std::ios::binary | std::ios::out);
+            out.write((const char*) bytes.data(), (std::streamsize) bytes.size());
+            out.close();
+
+            std::cout << fileName << " -> " << convertToOutput(fileName) << " (" << mesh.vertexCount()
+                      << " vertices, " << mesh.indices.size() << " indices, ACMR "
+                      << PB::MeshOptimizer::averageCacheMissRatio(
+                              mesh.indices,
+                              mesh.vertexCount(),
+                              PB::MeshOptimizer::DEFAULT_CACHE_SIZE)
+                      << ", " << bytes.size() << " bytes)" << std::endl;
+        }
+        else
+        {
+            error = true;
+            std::cout << "Failed to convert '" << fileName << "'" << std::endl;
+        }
+    }
+
+    return error ? 1 : 0;
+}
@@ -0,0 +1,462 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "PropertyTree.h"
+#include "Utilities.h"
+
+/**
+ * Each timing is the best of this many runs.
+ */
+constexpr std::uint32_t RUNS = 5;
+
+/**
+ * Keyframes are stored per frame in a byte, so an animation can't be longer than this.
+ */
+constexpr std::uint32_t MAX_FRAMES = 255;
+
+/**
+ * A copy of the property tree node the engine parsed into before the zero-copy parser, every node owning
+ * its name and holding its children in a map of shared pointers.
+ */
+class LegacyPropertyTree
+{
+public:
+    explicit LegacyPropertyTree(std::string name, LegacyPropertyTree* parent = nullptr)
+            : name_(std::move(name)), parent_(parent)
+    {
+
+    }
+
+    LegacyPropertyTree* get(const std::string& name)
+    {
+        auto itr = children_.find(name);
+        return itr != children_.end() ? itr->second.get() : nullptr;
+    }
+
+    bool add(const std::string& name)
+    {
+        bool exists = children_.find(name) != children_.end();
+        children_[name] = std::make_shared<LegacyPropertyTree>(name, this);
+        return !exists;
+    }
+
+    std::string value()
+    {
+        return children_.size() == 1 ? children_.begin()->second->name_ : "";
+    }
+
+    LegacyPropertyTree* parent()
+    {
+        return parent_;
+    }
+
+    std::uint32_t countNodes() const
+    {
+        std::uint32_t count = 1;
+
+        for (const auto& child : children_)
+        {
+            count += child.second->countNodes();
+        }
+
+        return count;
+    }
+
+    template<typename Function>
+    void forEachLeaf(Function function)
+    {
+        for (const auto& child : children_)
+        {
+            if (child.second->children_.empty())
+            {
+                function(child.second->name_);
+            }
+            else
+            {
+                child.second->forEachLeaf(function);
+            }
+        }
+    }
+
+private:
+    std::string name_;
+    std::unordered_map<std::string, std::shared_ptr<LegacyPropertyTree>> children_{};
+    LegacyPropertyTree* parent_;
+};
+
+std::string legacyTrim(std::string str)
+{
+    while (!str.empty() && std::isspace(static_cast<unsigned char>(str.front())))
+    {
+        str.erase(0, 1);
+    }
+
+    while (!str.empty() && std::isspace(static_cast<unsigned char>(str.back())))
+    {
+        str.erase(str.size() - 1, 1);
+    }
+
+    return str;
+}
+
+/**
+ * Mirrors the engine's old split on the first ':', which grew a new[] array one slice at a time.
+ */
+void legacySplit(const std::string& line, std::string** splitValues, std::uint32_t* splitCount)
+{
+    *splitCount = 1;
+    *splitValues = new std::string[1];
+    std::size_t pos = line.find(':');
+
+    if (pos != std::string::npos)
+    {
+        *splitCount = 2;
+        auto* tmpBits = new std::string[2];
+        delete[] *splitValues;
+        *splitValues = tmpBits;
+        (*splitValues)[0] = line.substr(0, pos);
+        (*splitValues)[1] = line.substr(pos + 1);
+    }
+    else
+    {
+        (*splitValues)[0] = line;
+    }
+}
+
+/**
+ * The engine's old stream parser, reading line by line with copies of every line and token.  The engine
+ * never freed the split arrays, this copy does, so the comparison is kinder to it than it was in practice.
+ */
+bool legacyParse(const std::string& text, LegacyPropertyTree* root)
+{
+    std::istringstream stream{text};
+    std::string line;
+    LegacyPropertyTree* currentNode = root;
+    std::uint32_t minIndents = 0;
+    std::uint32_t maxIndents = 0;
+
+    while (std::getline(stream, line))
+    {
+        std::uint32_t indentLevel = 0;
+
+        while (indentLevel < line.size() && line[indentLevel] == ' ')
+        {
+            ++indentLevel;
+        }
+
+        line = legacyTrim(line);
+
+        if (line.empty())
+        {
+            continue;
+        }
+
+        if (indentLevel % 2 != 0 || indentLevel < minIndents || indentLevel > maxIndents)
+        {
+            return false;
+        }
+
+        bool isList = line[0] == '-';
+
+        if (isList)
+        {
+            line = legacyTrim(line.substr(1));
+        }
+
+        for (std::uint32_t i = maxIndents; i > indentLevel; i -= 2)
+        {
+            currentNode = currentNode->parent();
+        }
+
+        if (isList)
+        {
+            currentNode->add(line);
+            minIndents = 0;
+            maxIndents = indentLevel;
+        }
+        else
+        {
+            std::string* splitValues;
+            std::uint32_t splitCount;
+
+            legacySplit(line, &splitValues, &splitCount);
+
+            if (splitCount != 2)
+            {
+                delete[] splitValues;
+                return false;
+            }
+
+            splitValues[0] = legacyTrim(splitValues[0]);
+            splitValues[1] = legacyTrim(splitValues[1]);
+
+            if (splitValues[1].empty())
+            {
+                minIndents = indentLevel + 2;
+                maxIndents = minIndents;
+
+                if (currentNode->add(splitValues[0]))
+                {
+                    currentNode = currentNode->get(splitValues[0]);
+                }
+            }
+            else
+            {
+                minIndents = 0;
+                maxIndents = indentLevel;
+
+                if (currentNode->add(splitValues[0]))
+                {
+                    currentNode->get(splitValues[0])->add(splitValues[1]);
+                }
+            }
+
+            delete[] splitValues;
+        }
+    }
+
+    return true;
+}
+
+std::uint32_t countNodes(const PB::PropertyTree& node)
+{
+    std::uint32_t count = 1;
+
+    for (PB::PropertyTree* child = node.firstChild(); child != nullptr; child = child->nextSibling())
+    {
+        count += countNodes(*child);
+    }
+
+    return count;
+}
+
+template<typename Function>
+void forEachLeaf(const PB::PropertyTree& node, Function function)
+{
+    for (PB::PropertyTree* child = node.firstChild(); child != nullptr; child = child->nextSibling())
+    {
+        if (child->isLeaf())
+        {
+            function(child->name());
+        }
+        else
+        {
+            forEachLeaf(*child, function);
+        }
+    }
+}
+
+void appendVector(std::string& text, const std::string& indent, const std::string& name, std::mt19937& random)
+{
+    std::uniform_real_distribution<float> distribution{-180.0f, 180.0f};
+
+    text += indent + name + ":\n";
+    text += indent + "  x: " + std::to_string(distribution(random)) + "\n";
+    text += indent + "  y: " + std::to_string(distribution(random)) + "\n";
+    text += indent + "  z: " + std::to_string(distribution(random)) + "\n";
+}
+
+void appendModel(
+        std::string& text,
+        const std::string& indent,
+        const std::string& name,
+        std::uint32_t depth,
+        std::uint32_t width,
+        std::mt19937& random)
+{
+    text += indent + name + ":\n";
+
+    const std::string inner = indent + "  ";
+
+    appendVector(text, inner, "offset", random);
+    appendVector(text, inner, "rotation", random);
+    text += inner + "mesh:\n";
+    text += inner + "  data: Assets1/Meshes/" + name + "\n";
+    text += inner + "  material: Assets1/Materials/" + name + "\n";
+    appendVector(text, inner + "  ", "offset", random);
+    appendVector(text, inner + "  ", "scale", random);
+
+    if (depth > 0)
+    {
+        text += inner + "children:\n";
+
+        for (std::uint32_t i = 0; i < width; ++i)
+        {
+            appendModel(text, inner + "  ", name + "_" + std::to_string(i), depth - 1, width, random);
+        }
+    }
+}
+
+/**
+ * Builds a model with a wide, deep hierarchy of nodes, until the text is at least the given size.
+ */
+std::string buildModelText(std::size_t targetBytes)
+{
+    std::mt19937 random{1234};
+    std::string text{};
+    std::uint32_t depth = 1;
+
+    while (text.size() < targetBytes)
+    {
+        text.clear();
+        appendModel(text, "", "root", depth++, 4, random);
+    }
+
+    return text;
+}
+
+/**
+ * Builds an animation with a keyframe on every frame for every bone, adding bones until the text is at
+ * least the given size.
+ */
+std::string buildAnimationText(std::size_t targetBytes)
+{
+    std::mt19937 random{1234};
+    std::string frames{};
+
+    // Each bone keyframe is two vectors of four lines, around 180 bytes
+    const auto bonesPerFrame = static_cast<std::uint32_t>(targetBytes / (MAX_FRAMES * 180)) + 1;
+
+    for (std::uint32_t frame = 0; frame < MAX_FRAMES; ++frame)
+    {
+        frames += "  " + std::to_string(frame) + ":\n";
+
+        for (std::uint32_t bone = 0; bone < bonesPerFrame; ++bone)
+        {
+            frames += "    bone_" + std::to_string(bone) + ":\n";
+            appendVector(frames, "      ", "rotation", random);
+            appendVector(frames, "      ", "position", random);
+        }
+    }
+
+    return "skeleton: Assets1/Skeletons/Humanoid\nfps: 30\nlength: " + std::to_string(MAX_FRAMES) + "\nframes:\n"
+           + frames;
+}
+
+template<typename Function>
+double timeMilliseconds(Function function)
+{
+    double best = 0;
+
+    for (std::uint32_t run = 0; run < RUNS; ++run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const double elapsed = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+        best = run == 0 ? elapsed : std::min(best, elapsed);
+    }
+
+    return best;
+}
+
+void report(const std::string& label, double milliseconds, std::size_t bytes)
+{
+    std::cout << "  " << label << milliseconds << " ms, "
+              << (static_cast<double>(bytes) / (1024.0 * 1024.0)) / (milliseconds / 1000.0) << " MB/s" << std::endl;
+}
+
+void runBenchmark(const std::string& label, const std::string& text)
+{
+    std::cout << "== " << label << ", " << static_cast<double>(text.size()) / (1024.0 * 1024.0) << " MB ==" << std::endl;
+
+    std::uint32_t legacyNodes = 0;
+    std::uint32_t documentNodes = 0;
+
+    const double legacyTime = timeMilliseconds([&]() {
+        LegacyPropertyTree root{"root"};
+        legacyParse(text, &root);
+        legacyNodes = root.countNodes();
+    });
+    report("stream parser:      ", legacyTime, text.size());
+
+    const double documentTime = timeMilliseconds([&]() {
+        PB::PropertyDocument document{"root"};
+        document.parse(text);
+        documentNodes = countNodes(document.root());
+    });
+    report("zero-copy parser:   ", documentTime, text.size());
+
+    std::cout << "  parse speedup:      " << legacyTime / documentTime << "x, " << documentNodes << " nodes";
+
+    if (legacyNodes != documentNodes)
+    {
+        std::cout << ", MISMATCH stream parser produced " << legacyNodes << " nodes";
+    }
+
+    std::cout << std::endl;
+
+    // Parse every leaf as a number, as the asset mappers do with each value they read
+    LegacyPropertyTree legacyRoot{"root"};
+    legacyParse(text, &legacyRoot);
+    PB::PropertyDocument document{"root"};
+    document.parse(text);
+
+    double legacySum = 0;
+    double documentSum = 0;
+
+    const double legacyValueTime = timeMilliseconds([&]() {
+        legacySum = 0;
+        legacyRoot.forEachLeaf([&](const std::string& value) {
+            float number;
+            std::stringstream stream(value);
+
+            if (stream >> number)
+            {
+                legacySum += number;
+            }
+        });
+    });
+
+    const double documentValueTime = timeMilliseconds([&]() {
+        documentSum = 0;
+        forEachLeaf(document.root(), [&](std::string_view value) {
+            if (!value.empty() && (std::isdigit(static_cast<unsigned char>(value.front())) || value.front() == '-'))
+            {
+                bool error = false;
+                documentSum += PB::NumberUtils::parseValue<float>(value, 0.0f, &error);
+            }
+        });
+    });
+
+    std::cout << "  stream values:      " << legacyValueTime << " ms" << std::endl;
+    std::cout << "  from_chars values:  " << documentValueTime << " ms, " << legacyValueTime / documentValueTime
+              << "x" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::size_t> sizes{1, 4, 16};
+
+    if (argc > 1)
+    {
+        sizes.clear();
+
+        for (int i = 1; i < argc; ++i)
+        {
+            sizes.push_back(static_cast<std::size_t>(std::stoul(argv[i])));
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (std::size_t size : sizes)
+    {
+        const std::size_t targetBytes = size * 1024 * 1024;
+
+        runBenchmark("model", buildModelText(targetBytes));
+        runBenchmark("animation", buildAnimationText(targetBytes));
+    }
+
+    return 0;
+}
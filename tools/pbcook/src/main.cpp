@@ -0,0 +1,64 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <PuppetBox.h>
+
+#include "AssetPackTools.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cout << "Usage: pbcook <archive root directory> <archive name> [archive name...]" << std::endl;
+        return 1;
+    }
+
+    std::string archiveRoot = argv[1];
+
+    if (!archiveRoot.empty() && archiveRoot.back() != '/' && archiveRoot.back() != '\\')
+    {
+        archiveRoot += '/';
+    }
+
+    bool error = false;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        const std::string archiveName = argv[i];
+        const auto start = std::chrono::steady_clock::now();
+
+        if (PB::CookAssetPack(archiveRoot, archiveName))
+        {
+            const double milliseconds = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+
+            std::cout << archiveRoot << archiveName << ".zip -> " << archiveRoot << archiveName << ".pbpak ("
+                      << milliseconds << " ms)" << std::endl;
+
+            // What cooking buys at startup, a full load of every asset from each
+            double sourceMilliseconds = 0;
+            double packMilliseconds = 0;
+
+            if (PB::Tools::TimeAssetPackLoad(archiveRoot, archiveName, false, &sourceMilliseconds)
+                && PB::Tools::TimeAssetPackLoad(archiveRoot, archiveName, true, &packMilliseconds))
+            {
+                std::cout << "  full load from .zip:   " << sourceMilliseconds << " ms" << std::endl;
+                std::cout << "  full load from .pbpak: " << packMilliseconds << " ms ("
+                          << sourceMilliseconds / packMilliseconds << "x)" << std::endl;
+            }
+            else
+            {
+                error = true;
+                std::cout << "Failed to time loading '" << archiveName << "'" << std::endl;
+            }
+        }
+        else
+        {
+            error = true;
+            std::cout << "Failed to cook '" << archiveName << "'" << std::endl;
+        }
+    }
+
+    return error ? 1 : 0;
+}
@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <zip/zip.h>
+
+#include "ArchivePrefetcher.h"
+#include "ArchiveReader.h"
+
+/**
+ * Budget the engine stages prefetched entries within.
+ */
+constexpr std::uint64_t PREFETCH_BUDGET_BYTES = 64 * 1024 * 1024;
+
+struct Config
+{
+    std::string archivePath = "prefetch-benchmark.zip";
+    std::string profilePath = "prefetch-benchmark.pbprofile";
+    std::uint32_t entryCount = 40;
+    std::uint32_t entryBytes = 1024 * 1024;
+    /** Time spent on each asset once it is read, standing in for parsing it */
+    double workMilliseconds = 3.0;
+    /** Sleep through the work instead, as a load waiting on something other than this core would */
+    bool sleep = false;
+};
+
+struct RunResult
+{
+    double milliseconds = 0;
+    bool contentsMatched = true;
+};
+
+Config loadRunConfig(std::uint32_t count, char** params)
+{
+    Config config{};
+
+    for (std::uint32_t i = 1; i < count; ++i)
+    {
+        const std::string param = params[i];
+
+        if (param == "--entries" && i + 1 < count)
+        {
+            config.entryCount = static_cast<std::uint32_t>(std::stoul(params[++i]));
+        }
+        else if (param == "--entry-bytes" && i + 1 < count)
+        {
+            config.entryBytes = static_cast<std::uint32_t>(std::stoul(params[++i]));
+        }
+        else if (param == "--work" && i + 1 < count)
+        {
+            config.workMilliseconds = std::stod(params[++i]);
+        }
+        else if (param == "--sleep")
+        {
+            config.sleep = true;
+        }
+    }
+
+    return config;
+}
+
+std::string entryName(std::uint32_t index)
+{
+    return "Assets/Entry" + std::to_string(index) + ".bin";
+}
+
+/**
+ * Contents of the given entry, drawn from a small alphabet so they deflate about as well as text assets do.
+ */
+std::vector<std::uint8_t> entryContents(std::uint32_t index, std::uint32_t size)
+{
+    std::mt19937 random{index + 1};
+    std::uniform_int_distribution<std::uint32_t> letter{'a', 'p'};
+    std::vector<std::uint8_t> contents(size);
+
+    for (auto& value: contents)
+    {
+        value = static_cast<std::uint8_t>(letter(random));
+    }
+
+    return contents;
+}
+
+bool writeArchive(const Config& config, const std::vector<std::vector<std::uint8_t>>& contents)
+{
+    zip_t* archive = zip_open(config.archivePath.c_str(), ZIP_DEFAULT_COMPRESSION_LEVEL, 'w');
+
+    if (archive == nullptr)
+    {
+        std::cerr << "Could not create '" << config.archivePath << "'" << std::endl;
+        return false;
+    }
+
+    bool success = true;
+
+    for (std::uint32_t i = 0; i < config.entryCount && success; ++i)
+    {
+        success = zip_entry_open(archive, entryName(i).c_str()) == 0
+                  && zip_entry_write(archive, contents[i].data(), contents[i].size()) == 0
+                  && zip_entry_close(archive) == 0;
+    }
+
+    zip_close(archive);
+
+    if (!success)
+    {
+        std::cerr << "Could not write the entries of '" << config.archivePath << "'" << std::endl;
+    }
+
+    return success;
+}
+
+/**
+ * Busy waits unless told to sleep, parsing keeps the loading thread's core busy.
+ */
+void work(double milliseconds, bool sleep)
+{
+    if (sleep)
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(milliseconds));
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    while (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() < milliseconds)
+    {
+
+    }
+}
+
+/**
+ * Reads every entry in order as a startup would, with a prefetcher that records the reads, and prefetches
+ * them if a profile was left by an earlier run.
+ */
+bool runStartup(
+        const Config& config,
+        const std::vector<std::vector<std::uint8_t>>& contents,
+        RunResult& result)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    auto prefetcher = std::make_shared<PB::ArchivePrefetcher>(config.profilePath, PREFETCH_BUDGET_BYTES);
+    prefetcher->start();
+
+    PB::ArchiveReader reader{};
+
+    if (!reader.open(config.archivePath))
+    {
+        return false;
+    }
+
+    reader.setPrefetcher(prefetcher);
+
+    for (std::uint32_t i = 0; i < config.entryCount; ++i)
+    {
+        bool error = false;
+        PB::ArchiveEntryData entryData = reader.read(entryName(i), &error);
+
+        if (error)
+        {
+            return false;
+        }
+
+        result.contentsMatched = result.contentsMatched
+                                 && entryData.size == contents[i].size()
+                                 && std::equal(contents[i].begin(), contents[i].end(), entryData.data);
+
+        work(config.workMilliseconds, config.sleep);
+    }
+
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    prefetcher->finish(result.milliseconds);
+
+    return true;
+}
+
+/**
+ * Times a startup that reads every entry of a deflated archive without a prefetch profile, then a second
+ * startup with the profile the first one recorded.  The archive is in the OS file cache for both, so the
+ * difference is inflating entries ahead of demand rather than reading them from disk.
+ */
+int main(int argc, char* argv[])
+{
+    Config config = loadRunConfig(argc, argv);
+
+    std::vector<std::vector<std::uint8_t>> contents{};
+
+    for (std::uint32_t i = 0; i < config.entryCount; ++i)
+    {
+        contents.push_back(entryContents(i, config.entryBytes));
+    }
+
+    std::remove(config.profilePath.c_str());
+
+    if (!writeArchive(config, contents))
+    {
+        return 1;
+    }
+
+    RunResult withoutProfile{};
+    RunResult withProfile{};
+
+    bool success = runStartup(config, contents, withoutProfile) && runStartup(config, contents, withProfile);
+
+    std::remove(config.archivePath.c_str());
+    std::remove(config.profilePath.c_str());
+
+    if (!success)
+    {
+        std::cerr << "Failed to read '" << config.archivePath << "'" << std::endl;
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << config.entryCount << " deflated entries of " << config.entryBytes << " bytes, "
+              << config.workMilliseconds << " ms of " << (config.sleep ? "sleep" : "work") << " per entry, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << "  without a profile: " << withoutProfile.milliseconds << " ms" << std::endl;
+    std::cout << "  with a profile:    " << withProfile.milliseconds << " ms" << std::endl;
+
+    if (!withoutProfile.contentsMatched || !withProfile.contentsMatched)
+    {
+        std::cerr << "Read contents did not match what was written" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
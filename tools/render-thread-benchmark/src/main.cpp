@@ -0,0 +1,150 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <PuppetBox.h>
+
+struct Config
+{
+    bool renderThread = false;
+    std::uint32_t sprites = 200;
+    float updateMilliseconds = 4.0f;
+    std::uint32_t warmUpFrames = 60;
+    std::uint32_t frames = 600;
+};
+
+/**
+ * A crowd of walking sprites, with a fixed amount of busy update work each frame standing in for game logic, timing
+ * every frame once warmed up and closing the window once enough are timed.
+ */
+class BenchmarkScene : public PB::AbstractSceneGraph
+{
+public:
+    BenchmarkScene(const std::string& sceneName, Config config)
+            : PB::AbstractSceneGraph(sceneName), config_(config) {};
+
+protected:
+    bool setUps() override
+    {
+        setViewMode(PB::SceneView::ORTHO);
+        camera().moveTo({0.0f, 0.0f, 3.0f});
+
+        if (!PB::LoadAssetPack("Assets1") || !PB::LoadAnimationsPack("Assets1/Animations/BasicHuman"))
+        {
+            std::cout << "Failed to load the Assets1 pack, run from the directory holding it" << std::endl;
+            return false;
+        }
+
+        const std::uint32_t columns = 20;
+
+        for (std::uint32_t i = 0; i < config_.sprites; ++i)
+        {
+            auto sprite = new PB::SceneObject{};
+
+            if (!PB::CreateSceneObject("Assets1/Sprites/GenericMob", sprite))
+            {
+                delete sprite;
+                return false;
+            }
+
+            sprite->position = PB::vec3{
+                    static_cast<float>(i % columns) * 40.0f - 380.0f,
+                    static_cast<float>(i / columns) * 60.0f - 280.0f,
+                    -50.0f};
+            addSceneObject(sprite);
+            moveToScene(sprite->getId());
+            sprite->playAnimation("Assets1/Animations/BasicHuman/Walk", i % 8);
+        }
+
+        return true;
+    }
+
+    void preLoopUpdates(const float deltaTime) override
+    {
+        if (frame_ > config_.warmUpFrames)
+        {
+            elapsedSeconds_ += deltaTime;
+        }
+
+        if (frame_ == config_.warmUpFrames + config_.frames)
+        {
+            std::cout << "Render thread " << (config_.renderThread ? "on" : "off")
+                      << ", " << config_.sprites << " sprites, "
+                      << config_.updateMilliseconds << " ms update: "
+                      << (elapsedSeconds_ * 1000.0) / config_.frames << " ms per frame" << std::endl;
+
+            input()->window.windowClose = true;
+        }
+
+        ++frame_;
+
+        // Busy rather than sleeping, as game logic would keep the main thread's core
+        const auto updateEnd = std::chrono::steady_clock::now()
+                               + std::chrono::duration<float, std::milli>(config_.updateMilliseconds);
+
+        while (std::chrono::steady_clock::now() < updateEnd);
+    }
+
+private:
+    Config config_;
+    std::uint32_t frame_ = 0;
+    double elapsedSeconds_ = 0;
+};
+
+Config loadRunConfig(std::uint32_t count, char** params)
+{
+    Config config{};
+
+    for (std::uint32_t i = 1; i < count; ++i)
+    {
+        const std::string param = params[i];
+
+        if (param == "--render-thread")
+        {
+            config.renderThread = true;
+        }
+        else if (param == "--sprites" && i + 1 < count)
+        {
+            config.sprites = static_cast<std::uint32_t>(std::stoul(params[++i]));
+        }
+        else if (param == "--update-ms" && i + 1 < count)
+        {
+            config.updateMilliseconds = std::stof(params[++i]);
+        }
+        else if (param == "--frames" && i + 1 < count)
+        {
+            config.frames = static_cast<std::uint32_t>(std::stoul(params[++i]));
+        }
+    }
+
+    return config;
+}
+
+/**
+ * Times frames of the same scene with and without the render thread, one per run, so the overlap it buys can be
+ * measured on real hardware:
+ *
+ *     render_thread_benchmark
+ *     render_thread_benchmark --render-thread
+ *
+ * With the render thread, a frame should take about as long as the slower of the update and the drawing, rather
+ * than both together.
+ */
+int main(int argc, char* argv[])
+{
+    Config config = loadRunConfig(argc, argv);
+
+    PB::SetRenderThreadEnabled(config.renderThread);
+    PB::Init("PuppetBox - Render Thread Benchmark", 800, 600, 1000);
+
+    PB::Run([config]() {
+        PB::CreateScene(std::make_shared<BenchmarkScene>("Benchmark", config));
+        PB::SetActiveScene("Benchmark");
+
+        return true;
+    });
+
+    return 0;
+}
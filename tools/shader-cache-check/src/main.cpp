@@ -0,0 +1,347 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "OpenGLGfxApi.h"
+#include "Shader.h"
+#include "ShaderBinaryCache.h"
+
+/**
+ * Stops polling a shader program that never reports ready, rather than hanging the check.
+ */
+constexpr double READY_TIMEOUT_MILLISECONDS = 10000.0;
+
+const std::string VERTEX_CODE = R"(#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 2) in vec2 aTexCoord;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+out vec2 TexCoord;
+
+void main()
+{
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    TexCoord = aTexCoord;
+}
+)";
+
+const std::string FRAGMENT_CODE = R"(#version 330 core
+in vec2 TexCoord;
+
+uniform sampler2D diffuseMap;
+
+out vec4 FragColor;
+
+void main()
+{
+    vec4 color = texture(diffuseMap, TexCoord);
+
+    if (color.a < 0.1)
+    {
+        discard;
+    }
+
+    FragColor = color;
+}
+)";
+
+struct Config
+{
+    std::string cachePath = "shader-cache-check.pbcache";
+};
+
+struct Context
+{
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+};
+
+Config loadRunConfig(std::uint32_t count, char** params)
+{
+    Config config{};
+
+    for (std::uint32_t i = 1; i < count; ++i)
+    {
+        const std::string param = params[i];
+
+        if (param == "--cache" && i + 1 < count)
+        {
+            config.cachePath = params[++i];
+        }
+    }
+
+    return config;
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Creates a core profile context with no surface at all, on Mesa's surfaceless platform where it is
+ * available, so the check runs without a display.
+ */
+bool createContext(Context& context)
+{
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+    context.display = getPlatformDisplay != nullptr
+                      ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+                      : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0;
+    EGLint minor = 0;
+
+    if (context.display == EGL_NO_DISPLAY || !eglInitialize(context.display, &major, &minor)
+        || !eglBindAPI(EGL_OPENGL_API))
+    {
+        std::cerr << "Could not initialize EGL" << std::endl;
+        return false;
+    }
+
+    const EGLint configAttributes[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    eglChooseConfig(context.display, configAttributes, &config, 1, &configCount);
+
+    const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 4,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+    };
+
+    context.context = eglCreateContext(
+            context.display,
+            configCount > 0 ? config : nullptr,
+            EGL_NO_CONTEXT,
+            contextAttributes);
+
+    if (context.context == EGL_NO_CONTEXT
+        || !eglMakeCurrent(context.display, EGL_NO_SURFACE, EGL_NO_SURFACE, context.context))
+    {
+        std::cerr << "Could not create a surfaceless OpenGL 4.3 core context" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void destroyContext(Context& context)
+{
+    if (context.context != EGL_NO_CONTEXT)
+    {
+        eglMakeCurrent(context.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(context.display, context.context);
+    }
+
+    if (context.display != EGL_NO_DISPLAY)
+    {
+        eglTerminate(context.display);
+    }
+}
+
+/**
+ * Compiles the check's shader program from source as the asset library does, polling the gfx API until the
+ * program is ready rather than blocking on it.
+ */
+bool compileShader(PB::OpenGLGfxApi& gfxApi, PB::Shader& shader, std::uint32_t* notReadyPolls)
+{
+    if (!gfxApi.beginShader(shader, VERTEX_CODE, "", FRAGMENT_CODE))
+    {
+        std::cerr << "Could not start compiling '" << shader.name() << "'" << std::endl;
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    while (!gfxApi.isShaderReady(shader))
+    {
+        ++*notReadyPolls;
+
+        if (millisecondsSince(start) > READY_TIMEOUT_MILLISECONDS)
+        {
+            std::cerr << "'" << shader.name() << "' was never reported ready" << std::endl;
+            return false;
+        }
+    }
+
+    return gfxApi.finishShader(shader);
+}
+
+/**
+ * Checks a binary stored in, and saved with, one cache is found by a cache loading the same file for the same
+ * driver, and that the driver takes it back into a usable shader program.
+ */
+bool checkRoundTrip(PB::OpenGLGfxApi& gfxApi, const Config& config, std::uint64_t sourceKey)
+{
+    std::remove(config.cachePath.c_str());
+
+    PB::Shader compiled{"Check/Shader/Compiled"};
+    std::uint32_t notReadyPolls = 0;
+    PB::ShaderBinary binary{};
+
+    const auto compileStart = std::chrono::steady_clock::now();
+
+    if (!compileShader(gfxApi, compiled, &notReadyPolls))
+    {
+        return false;
+    }
+
+    const double compileMilliseconds = millisecondsSince(compileStart);
+
+    if (!gfxApi.getShaderBinary(compiled, &binary))
+    {
+        std::cerr << "The driver gave no binary for '" << compiled.name() << "'" << std::endl;
+        return false;
+    }
+
+    {
+        PB::ShaderBinaryCache cache{config.cachePath, gfxApi.driverId()};
+
+        if (cache.load())
+        {
+            std::cerr << "Loaded a cache that was just removed" << std::endl;
+            return false;
+        }
+
+        cache.store(sourceKey, binary);
+
+        if (!cache.save())
+        {
+            return false;
+        }
+    }
+
+    PB::ShaderBinaryCache cache{config.cachePath, gfxApi.driverId()};
+    PB::ShaderBinary cached{};
+    PB::Shader loaded{"Check/Shader/Loaded"};
+
+    const auto loadStart = std::chrono::steady_clock::now();
+
+    if (!cache.load() || !cache.find(sourceKey, &cached))
+    {
+        std::cerr << "The saved binary was not found in '" << config.cachePath << "'" << std::endl;
+        return false;
+    }
+
+    if (cached.format != binary.format || cached.bytes != binary.bytes)
+    {
+        std::cerr << "The binary read from '" << config.cachePath << "' differs from the one saved" << std::endl;
+        return false;
+    }
+
+    if (!gfxApi.loadShaderBinary(loaded, cached))
+    {
+        std::cerr << "The driver rejected the cached binary" << std::endl;
+        return false;
+    }
+
+    const double loadMilliseconds = millisecondsSince(loadStart);
+
+    if (!loaded.uniform<PB::mat4>("projection").isValid() || !loaded.uniform<std::int32_t>("diffuseMap").isValid())
+    {
+        std::cerr << "The shader program loaded from its binary is missing its uniforms" << std::endl;
+        return false;
+    }
+
+    std::cout << "Round trip: compiled in " << compileMilliseconds << " ms (" << notReadyPolls
+              << " polls before ready), " << binary.bytes.size() << " byte binary loaded from the cache in "
+              << loadMilliseconds << " ms" << std::endl;
+
+    gfxApi.freeShader(compiled);
+    gfxApi.freeShader(loaded);
+
+    return true;
+}
+
+/**
+ * Checks a cache written by another driver is dropped whole, and stays dropped once rewritten for this one.
+ */
+bool checkDriverMismatch(PB::OpenGLGfxApi& gfxApi, const Config& config, std::uint64_t sourceKey)
+{
+    PB::ShaderBinary binary{};
+
+    {
+        PB::ShaderBinaryCache cache{config.cachePath, gfxApi.driverId() + "|updated"};
+
+        if (cache.load() || cache.find(sourceKey, &binary))
+        {
+            std::cerr << "A cache written by another driver was used" << std::endl;
+            return false;
+        }
+    }
+
+    PB::ShaderBinaryCache cache{config.cachePath, gfxApi.driverId()};
+
+    if (cache.load() || cache.find(sourceKey, &binary))
+    {
+        std::cerr << "The cache still had the binary after another driver rewrote it" << std::endl;
+        return false;
+    }
+
+    std::cout << "Driver mismatch: cache dropped" << std::endl;
+
+    return true;
+}
+
+/**
+ * Checks the shader binary cache against a real driver: a binary saved by one run is loaded by the next, and a
+ * different driver discards the cache.  Meant to run on a software driver such as Mesa's llvmpipe, where
+ * shader program binaries are supported without a GPU.
+ */
+int main(int argc, char* argv[])
+{
+    Config config = loadRunConfig(argc, argv);
+    Context context{};
+
+    if (!createContext(context))
+    {
+        destroyContext(context);
+        return 1;
+    }
+
+    bool success;
+
+    {
+        PB::OpenGLGfxApi gfxApi{};
+        gfxApi.setRenderDimensions(64, 64);
+
+        success = gfxApi.init(reinterpret_cast<PB::ProcAddress>(eglGetProcAddress));
+
+        if (success && !gfxApi.supportsShaderBinaries())
+        {
+            std::cerr << "'" << gfxApi.driverId() << "' doesn't support program binaries" << std::endl;
+            success = false;
+        }
+
+        if (success)
+        {
+            std::cout << std::fixed << std::setprecision(2);
+            std::cout << "Driver: " << gfxApi.driverId() << std::endl;
+
+            const std::uint64_t sourceKey = PB::ShaderBinaryCache::sourceKey(VERTEX_CODE, "", FRAGMENT_CODE);
+
+            success = checkRoundTrip(gfxApi, config, sourceKey) && checkDriverMismatch(gfxApi, config, sourceKey);
+        }
+
+        gfxApi.shutdown();
+    }
+
+    destroyContext(context);
+    std::remove(config.cachePath.c_str());
+
+    return success ? 0 : 1;
+}